@@ -0,0 +1,375 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined( _WIN32 )
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <dirent.h>
+	#include <sys/stat.h>
+#endif
+
+#include "../Game/Utils/assetPackFormat.h"
+
+// Bundles everything in a directory into a single asset pack that the game can memory map instead of opening each file
+//  on its own. See assetPackFormat.h for the layout.
+//  Define ASSET_PACKER_NO_MAIN to use packer_PackDirectory from somewhere else, the benchmarks do this.
+
+#define PATH_LENGTH 512
+
+typedef struct {
+	char name[ASSET_PACK_MAX_NAME_LENGTH]; // relative to the packed directory, normalized
+	char path[PATH_LENGTH];
+	uint64_t size;
+	uint32_t hash;
+} FileToPack;
+
+static FileToPack* files = NULL;
+static size_t numFiles = 0;
+static size_t filesCapacity = 0;
+
+static bool verbose = false;
+
+static bool endsWith( const char* strToTest, const char* strValue )
+{
+	size_t valLen = strlen( strValue );
+	size_t testLen = strlen( strToTest );
+
+	if( valLen > testLen ) {
+		return false;
+	}
+
+	return ( strcmp( strToTest + ( testLen - valLen ), strValue ) == 0 );
+}
+
+static bool addFile( const char* path, const char* name, uint64_t size )
+{
+	// don't pack any packs, most likely an old version of the one we're creating
+	if( endsWith( name, ".pak" ) ) {
+		return true;
+	}
+
+	if( numFiles >= filesCapacity ) {
+		size_t newCapacity = ( filesCapacity == 0 ) ? 64 : ( filesCapacity * 2 );
+		FileToPack* newFiles = realloc( files, newCapacity * sizeof( FileToPack ) );
+		if( newFiles == NULL ) {
+			fprintf( stderr, "Unable to allocate file list.\n" );
+			return false;
+		}
+		files = newFiles;
+		filesCapacity = newCapacity;
+	}
+
+	FileToPack* file = &( files[numFiles] );
+	if( assetPack_NormalizeName( name, file->name, sizeof( file->name ) ) == 0 ) {
+		fprintf( stderr, "File name too long to pack: %s\n", name );
+		return false;
+	}
+	if( snprintf( file->path, sizeof( file->path ), "%s", path ) >= (int)sizeof( file->path ) ) {
+		fprintf( stderr, "File path too long to pack: %s\n", path );
+		return false;
+	}
+	file->size = size;
+	file->hash = assetPack_HashName( file->name );
+	++numFiles;
+
+	return true;
+}
+
+// puts dir/name into out, if either is empty only the other one is used, returns false if it doesn't fit
+static bool joinPath( char* out, size_t outSize, const char* dir, const char* name )
+{
+	int len;
+	if( dir[0] == 0 ) {
+		len = snprintf( out, outSize, "%s", name );
+	} else if( name[0] == 0 ) {
+		len = snprintf( out, outSize, "%s", dir );
+	} else {
+		len = snprintf( out, outSize, "%s/%s", dir, name );
+	}
+	return ( len >= 0 ) && ( (size_t)len < outSize );
+}
+
+// walks through the directory and everything under it, relDir is the path relative to the root, empty for the root
+static bool gatherFiles( const char* rootDir, const char* relDir )
+{
+	char dirPath[PATH_LENGTH];
+	if( !joinPath( dirPath, sizeof( dirPath ), rootDir, relDir ) ) {
+		fprintf( stderr, "Directory path too long, skipping: %s/%s\n", rootDir, relDir );
+		return true;
+	}
+
+#if defined( _WIN32 )
+	char search[PATH_LENGTH];
+	if( !joinPath( search, sizeof( search ), dirPath, "*" ) ) {
+		fprintf( stderr, "Directory path too long, skipping: %s\n", dirPath );
+		return true;
+	}
+
+	WIN32_FIND_DATAA findData;
+	HANDLE find = FindFirstFileA( search, &findData );
+	if( find == INVALID_HANDLE_VALUE ) {
+		fprintf( stderr, "Unable to open directory %s\n", dirPath );
+		return false;
+	}
+
+	bool success = true;
+	do {
+		const char* entryName = findData.cFileName;
+		if( ( strcmp( entryName, "." ) == 0 ) || ( strcmp( entryName, ".." ) == 0 ) ) {
+			continue;
+		}
+
+		char relPath[PATH_LENGTH];
+		char fullPath[PATH_LENGTH];
+		if( !joinPath( relPath, sizeof( relPath ), relDir, entryName ) ||
+			!joinPath( fullPath, sizeof( fullPath ), dirPath, entryName ) ) {
+			fprintf( stderr, "File path too long, skipping: %s/%s\n", dirPath, entryName );
+			continue;
+		}
+
+		if( findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) {
+			success = gatherFiles( rootDir, relPath );
+		} else {
+			uint64_t size = ( (uint64_t)findData.nFileSizeHigh << 32 ) | (uint64_t)findData.nFileSizeLow;
+			success = addFile( fullPath, relPath, size );
+		}
+	} while( success && FindNextFileA( find, &findData ) );
+	FindClose( find );
+
+	return success;
+#else
+	DIR* dir = opendir( dirPath );
+	if( dir == NULL ) {
+		fprintf( stderr, "Unable to open directory %s\n", dirPath );
+		return false;
+	}
+
+	bool success = true;
+	struct dirent* entry;
+	while( success && ( ( entry = readdir( dir ) ) != NULL ) ) {
+		const char* entryName = entry->d_name;
+		if( ( strcmp( entryName, "." ) == 0 ) || ( strcmp( entryName, ".." ) == 0 ) ) {
+			continue;
+		}
+
+		char relPath[PATH_LENGTH];
+		char fullPath[PATH_LENGTH];
+		if( !joinPath( relPath, sizeof( relPath ), relDir, entryName ) ||
+			!joinPath( fullPath, sizeof( fullPath ), dirPath, entryName ) ) {
+			fprintf( stderr, "File path too long, skipping: %s/%s\n", dirPath, entryName );
+			continue;
+		}
+
+		struct stat fileStat;
+		if( stat( fullPath, &fileStat ) < 0 ) {
+			fprintf( stderr, "Unable to read %s\n", fullPath );
+			success = false;
+		} else if( S_ISDIR( fileStat.st_mode ) ) {
+			success = gatherFiles( rootDir, relPath );
+		} else if( S_ISREG( fileStat.st_mode ) ) {
+			success = addFile( fullPath, relPath, (uint64_t)fileStat.st_size );
+		}
+	}
+	closedir( dir );
+
+	return success;
+#endif
+}
+
+static int compareFiles( const void* left, const void* right )
+{
+	return strcmp( ( (const FileToPack*)left )->name, ( (const FileToPack*)right )->name );
+}
+
+static uint64_t align( uint64_t value )
+{
+	return ( value + ( ASSET_PACK_ALIGNMENT - 1 ) ) & ~(uint64_t)( ASSET_PACK_ALIGNMENT - 1 );
+}
+
+static bool writePadding( FILE* out, uint64_t amount )
+{
+	static const uint8_t zeroes[ASSET_PACK_ALIGNMENT] = { 0 };
+	while( amount > 0 ) {
+		size_t chunk = ( amount > sizeof( zeroes ) ) ? sizeof( zeroes ) : (size_t)amount;
+		if( fwrite( zeroes, 1, chunk, out ) != chunk ) {
+			return false;
+		}
+		amount -= chunk;
+	}
+	return true;
+}
+
+static bool copyFile( FILE* out, const FileToPack* file )
+{
+	FILE* in = fopen( file->path, "rb" );
+	if( in == NULL ) {
+		fprintf( stderr, "Unable to open %s\n", file->path );
+		return false;
+	}
+
+	static uint8_t buffer[64 * 1024];
+	uint64_t copied = 0;
+	size_t amtRead;
+	while( ( amtRead = fread( buffer, 1, sizeof( buffer ), in ) ) > 0 ) {
+		if( fwrite( buffer, 1, amtRead, out ) != amtRead ) {
+			fclose( in );
+			fprintf( stderr, "Unable to write %s to the pack\n", file->path );
+			return false;
+		}
+		copied += amtRead;
+	}
+	fclose( in );
+
+	if( copied != file->size ) {
+		fprintf( stderr, "Size of %s changed while packing\n", file->path );
+		return false;
+	}
+
+	return true;
+}
+
+static bool writePack( const char* outFileName )
+{
+	// sorting keeps the output the same between runs, which makes it easier to tell if anything actually changed
+	qsort( files, numFiles, sizeof( FileToPack ), compareFiles );
+
+	// keep the table at most half full so the probes stay short
+	uint32_t tableSize = 16;
+	while( tableSize < ( numFiles * 2 ) ) {
+		tableSize *= 2;
+	}
+
+	AssetPackEntry* table = calloc( tableSize, sizeof( AssetPackEntry ) );
+	if( table == NULL ) {
+		fprintf( stderr, "Unable to allocate table of contents.\n" );
+		return false;
+	}
+
+	uint64_t namesOffset = sizeof( AssetPackHeader ) + ( (uint64_t)tableSize * sizeof( AssetPackEntry ) );
+	uint64_t namesSize = 0;
+	for( size_t i = 0; i < numFiles; ++i ) {
+		namesSize += strlen( files[i].name ) + 1;
+	}
+
+	uint64_t nameOffset = 0;
+	uint64_t dataOffset = align( namesOffset + namesSize );
+	uint32_t mask = tableSize - 1;
+	for( size_t i = 0; i < numFiles; ++i ) {
+		uint32_t slot = files[i].hash & mask;
+		while( table[slot].nameLength != 0 ) {
+			slot = ( slot + 1 ) & mask;
+		}
+
+		uint32_t nameLength = (uint32_t)strlen( files[i].name );
+		table[slot].hash = files[i].hash;
+		table[slot].nameLength = nameLength;
+		table[slot].nameOffset = nameOffset;
+		table[slot].dataOffset = dataOffset;
+		table[slot].dataSize = files[i].size;
+
+		nameOffset += nameLength + 1;
+		dataOffset = align( dataOffset + files[i].size );
+	}
+
+	FILE* out = fopen( outFileName, "wb" );
+	if( out == NULL ) {
+		fprintf( stderr, "Unable to open %s for writing.\n", outFileName );
+		free( table );
+		return false;
+	}
+
+	AssetPackHeader header;
+	memset( &header, 0, sizeof( header ) );
+	header.magic = ASSET_PACK_MAGIC;
+	header.version = ASSET_PACK_VERSION;
+	header.numEntries = (uint32_t)numFiles;
+	header.tableSize = tableSize;
+	header.namesOffset = namesOffset;
+	header.namesSize = namesSize;
+
+	bool success = ( fwrite( &header, sizeof( header ), 1, out ) == 1 ) &&
+		( fwrite( table, sizeof( AssetPackEntry ), tableSize, out ) == tableSize );
+
+	for( size_t i = 0; success && ( i < numFiles ); ++i ) {
+		size_t len = strlen( files[i].name ) + 1;
+		success = ( fwrite( files[i].name, 1, len, out ) == len );
+	}
+
+	uint64_t written = namesOffset + namesSize;
+	for( size_t i = 0; success && ( i < numFiles ); ++i ) {
+		success = writePadding( out, align( written ) - written );
+		written = align( written );
+
+		success = success && copyFile( out, &( files[i] ) );
+		written += files[i].size;
+
+		if( success && verbose ) {
+			fprintf( stdout, "  %s (%llu bytes)\n", files[i].name, (unsigned long long)files[i].size );
+		}
+	}
+
+	if( fclose( out ) != 0 ) {
+		success = false;
+	}
+	free( table );
+
+	if( !success ) {
+		fprintf( stderr, "Error writing %s.\n", outFileName );
+		remove( outFileName );
+	}
+
+	return success;
+}
+
+// packs everything in srcDir into outFileName, returns the number of files packed or -1 if there was a problem
+int packer_PackDirectory( const char* srcDir, const char* outFileName )
+{
+	numFiles = 0;
+
+	if( !gatherFiles( srcDir, "" ) ) {
+		return -1;
+	}
+
+	if( !writePack( outFileName ) ) {
+		return -1;
+	}
+
+	return (int)numFiles;
+}
+
+#ifndef ASSET_PACKER_NO_MAIN
+int main( int argc, char** argv )
+{
+	int argIdx = 1;
+	if( ( argc > 1 ) && ( strcmp( "-v", argv[1] ) == 0 ) ) {
+		verbose = true;
+		++argIdx;
+	}
+
+	if( ( argc == 2 ) && ( strcmp( "-h", argv[1] ) == 0 ) ) {
+		fprintf( stdout, "Bundles all the files in a directory into a single asset pack the game can load from.\n" );
+		fprintf( stdout, "Names are stored relative to the directory, so it should be the one the game runs from.\n" );
+		fprintf( stdout, "Useage: AssetPacker [-v] source_directory output_file\n" );
+		return 0;
+	}
+
+	if( ( argc - argIdx ) != 2 ) {
+		fprintf( stderr, "Invalid arguments, use -h to get help.\n" );
+		return 1;
+	}
+
+	int count = packer_PackDirectory( argv[argIdx], argv[argIdx + 1] );
+	if( count < 0 ) {
+		return 1;
+	}
+
+	fprintf( stdout, "Packed %i files into %s\n", count, argv[argIdx + 1] );
+	free( files );
+
+	return 0;
+}
+#endif
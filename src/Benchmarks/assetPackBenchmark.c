@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#if defined( _WIN32 )
+	#include <direct.h>
+	#define makeDir( path ) _mkdir( path )
+	#define removeDir( path ) _rmdir( path )
+#else
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#define makeDir( path ) mkdir( path, 0755 )
+	#define removeDir( path ) rmdir( path )
+#endif
+
+#include <SDL_rwops.h>
+
+#include "benchmarkUtil.h"
+
+#include "../Game/System/memory.h"
+#include "../Game/System/random.h"
+#include "../Game/Utils/assetPack.h"
+#include "../Game/Utils/helpers.h"
+
+// use the packer to build the pack we read from, so it's testing what the game would actually load
+#define ASSET_PACKER_NO_MAIN
+#include "../AssetPacker/assetPacker.c"
+
+// Headless benchmarks for loading assets at start up, compares opening and reading each loose file against mounting the
+//  asset pack and using views into it. The files are generated and will be in the OS file cache after the first repeat,
+//  so this measures the per file overhead of the system calls and copies, not the disk.
+
+#define DEFAULT_NUM_FILES 256
+#define DEFAULT_NUM_ITERATIONS 10
+
+#define DATA_DIR "assetPackBenchData"
+#define PACK_FILE "assetPackBench.pak"
+#define NUM_SUB_DIRS 8
+#define MIN_FILE_SIZE ( 1 * 1024 )
+#define MAX_FILE_SIZE ( 64 * 1024 )
+#define TOUCH_STRIDE 64
+
+static size_t numBenchFiles = DEFAULT_NUM_FILES;
+static size_t numIterations = DEFAULT_NUM_ITERATIONS;
+
+typedef struct {
+	char name[64]; // relative to the data directory, the same as how the game refers to them
+	char path[128];
+} BenchFile;
+
+static BenchFile* benchFiles = NULL;
+static uint8_t* readBuffer = NULL;
+
+static RandomGroup benchRandom;
+
+static volatile uint32_t sink = 0;
+
+// reads enough of the data that every page is touched, the same for all the cases so the work done on them matches
+static uint32_t touch( const uint8_t* data, size_t size )
+{
+	uint32_t sum = 0;
+	for( size_t i = 0; i < size; i += TOUCH_STRIDE ) {
+		sum += data[i];
+	}
+	return sum;
+}
+
+static bool createData( void )
+{
+	benchFiles = mem_Allocate( sizeof( BenchFile ) * numBenchFiles );
+	readBuffer = mem_Allocate( MAX_FILE_SIZE );
+	uint8_t* fileData = mem_Allocate( MAX_FILE_SIZE );
+
+	makeDir( DATA_DIR );
+	for( int i = 0; i < NUM_SUB_DIRS; ++i ) {
+		char dirPath[64];
+		snprintf( dirPath, sizeof( dirPath ), DATA_DIR"/dir%i", i );
+		makeDir( dirPath );
+	}
+
+	rand_Seed( &benchRandom, 0x5EED );
+	bool success = true;
+	for( size_t i = 0; success && ( i < numBenchFiles ); ++i ) {
+		snprintf( benchFiles[i].name, sizeof( benchFiles[i].name ), "dir%i/file%04i.dat", (int)( i % NUM_SUB_DIRS ), (int)i );
+		snprintf( benchFiles[i].path, sizeof( benchFiles[i].path ), DATA_DIR"/%s", benchFiles[i].name );
+
+		size_t size = MIN_FILE_SIZE + ( rand_GetU32( &benchRandom ) % ( MAX_FILE_SIZE - MIN_FILE_SIZE ) );
+		for( size_t b = 0; b < size; ++b ) {
+			fileData[b] = (uint8_t)rand_GetU32( &benchRandom );
+		}
+
+		FILE* file = fopen( benchFiles[i].path, "wb" );
+		success = ( file != NULL ) && ( fwrite( fileData, 1, size, file ) == size );
+		if( file != NULL ) {
+			fclose( file );
+		}
+	}
+	mem_Release( fileData );
+
+	if( !success ) {
+		fprintf( stderr, "Unable to create the benchmark data.\n" );
+		return false;
+	}
+
+	if( packer_PackDirectory( DATA_DIR, PACK_FILE ) != (int)numBenchFiles ) {
+		fprintf( stderr, "Unable to pack the benchmark data.\n" );
+		return false;
+	}
+
+	return true;
+}
+
+static void destroyData( void )
+{
+	if( benchFiles != NULL ) {
+		for( size_t i = 0; i < numBenchFiles; ++i ) {
+			remove( benchFiles[i].path );
+		}
+	}
+	for( int i = 0; i < NUM_SUB_DIRS; ++i ) {
+		char dirPath[64];
+		snprintf( dirPath, sizeof( dirPath ), DATA_DIR"/dir%i", i );
+		removeDir( dirPath );
+	}
+	removeDir( DATA_DIR );
+	remove( PACK_FILE );
+
+	mem_Release( benchFiles );
+	mem_Release( readBuffer );
+	free( files ); // the packer's file list
+}
+
+static void noSetUp( void )
+{
+}
+
+static void noTearDown( void )
+{
+}
+
+// ***** opening each loose file and reading it into memory, what the loaders did before
+static size_t looseFiles_Run( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		for( size_t i = 0; i < numBenchFiles; ++i ) {
+			SDL_RWops* rwops = SDL_RWFromFile( benchFiles[i].path, "rb" );
+			size_t size = (size_t)SDL_RWsize( rwops );
+			size_t amtRead = SDL_RWread( rwops, readBuffer, 1, size );
+			SDL_RWclose( rwops );
+			sink += touch( readBuffer, amtRead );
+		}
+	}
+	return numBenchFiles * numIterations;
+}
+
+// ***** mounting the pack and using the views directly, includes the mount so the start up cost is counted
+static size_t packViews_Run( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		assetPack_Mount( PACK_FILE );
+		for( size_t i = 0; i < numBenchFiles; ++i ) {
+			const uint8_t* data;
+			size_t size;
+			if( assetPack_GetFile( benchFiles[i].name, &data, &size ) ) {
+				sink += touch( data, size );
+			}
+		}
+		assetPack_Unmount( );
+	}
+	return numBenchFiles * numIterations;
+}
+
+// ***** reading through the RWops from the pack, what the loaders that still copy the data do
+static void packRWops_SetUp( void )
+{
+	assetPack_Mount( PACK_FILE );
+}
+
+static void packRWops_TearDown( void )
+{
+	assetPack_Unmount( );
+}
+
+static size_t packRWops_Run( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		for( size_t i = 0; i < numBenchFiles; ++i ) {
+			SDL_RWops* rwops = assetPack_OpenFile( benchFiles[i].name );
+			size_t size = (size_t)SDL_RWsize( rwops );
+			size_t amtRead = SDL_RWread( rwops, readBuffer, 1, size );
+			SDL_RWclose( rwops );
+			sink += touch( readBuffer, amtRead );
+		}
+	}
+	return numBenchFiles * numIterations;
+}
+
+static BenchmarkCase cases[] = {
+	{ "loose files (open + read)", noSetUp, looseFiles_Run, noTearDown },
+	{ "pack (mount + views)", noSetUp, packViews_Run, noTearDown },
+	{ "pack (rwops + read)", packRWops_SetUp, packRWops_Run, packRWops_TearDown },
+};
+
+int main( int argc, char** argv )
+{
+	BenchmarkOptions options;
+	int parseResult = bench_ParseOptions( argc, argv, "asset pack loading", &options );
+	if( parseResult != 0 ) {
+		return ( parseResult < 0 ) ? 1 : 0;
+	}
+
+	if( options.count > 0 ) numBenchFiles = options.count;
+	if( options.iterations > 0 ) numIterations = options.iterations;
+
+	mem_Init( 64 * 1024 * 1024 );
+
+	int result = 1;
+	if( createData( ) ) {
+		result = bench_RunCases( "assetPack", cases, ARRAY_SIZE( cases ), &options );
+	}
+	destroyData( );
+
+	mem_CleanUp( );
+
+	return result;
+}
@@ -0,0 +1,36 @@
+/*
+Copy of the string keyed hash map as it was before the stored hashes and key arenas were added, only used to compare against in
+ hashMapBenchmark.c. Don't use this in the game.
+*/
+
+#ifndef OLD_HASH_MAP_H
+#define OLD_HASH_MAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+typedef uint32_t (*OldHashFunc)( const char* );
+
+typedef struct {
+	char* key;
+	uint8_t probeLength;
+} OldHashMapKey;
+
+typedef struct {
+	size_t capacity;
+	OldHashMapKey* keys;
+	int* values;
+	uint32_t probeLimit;
+	OldHashFunc hashFunc;
+} OldHashMap;
+
+void oldHashMap_Init( OldHashMap* hashMap, uint32_t estimatedSize, OldHashFunc hashFunc );
+void oldHashMap_Set( OldHashMap* hashMap, const char* key, int value );
+bool oldHashMap_Find( OldHashMap* hashMap, const char* key, int* outValue );
+bool oldHashMap_Exists( OldHashMap* hashMap, const char* key );
+void oldHashMap_Remove( OldHashMap* hashMap, const char* key );
+void oldHashMap_RemoveFirstByValue( OldHashMap* hashMap, int value );
+void oldHashMap_Clear( OldHashMap* hashMap );
+
+#endif /* inclusion guard */
@@ -0,0 +1,211 @@
+#include "benchmarkUtil.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <float.h>
+
+#include <SDL_timer.h>
+
+#if defined( __linux__ )
+	#include <unistd.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <linux/perf_event.h>
+#endif
+
+#define DEFAULT_REPEATS 3
+
+// ***** Performance counters
+#if defined( __linux__ )
+static int perfFD = -1;
+
+static bool perfStart( void )
+{
+	if( perfFD < 0 ) {
+		struct perf_event_attr attr;
+		memset( &attr, 0, sizeof( attr ) );
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof( attr );
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+
+		perfFD = (int)syscall( __NR_perf_event_open, &attr, 0, -1, -1, 0 );
+		if( perfFD < 0 ) {
+			return false;
+		}
+	}
+
+	ioctl( perfFD, PERF_EVENT_IOC_RESET, 0 );
+	ioctl( perfFD, PERF_EVENT_IOC_ENABLE, 0 );
+	return true;
+}
+
+static int64_t perfStop( void )
+{
+	if( perfFD < 0 ) {
+		return -1;
+	}
+
+	uint64_t count = 0;
+	ioctl( perfFD, PERF_EVENT_IOC_DISABLE, 0 );
+	if( read( perfFD, &count, sizeof( count ) ) != sizeof( count ) ) {
+		return -1;
+	}
+	return (int64_t)count;
+}
+
+static void perfCleanUp( void )
+{
+	if( perfFD >= 0 ) {
+		close( perfFD );
+		perfFD = -1;
+	}
+}
+#else
+static bool perfStart( void ) { return false; }
+static int64_t perfStop( void ) { return -1; }
+static void perfCleanUp( void ) { }
+#endif
+
+// ***** Options
+static void displayHelp( const char* description )
+{
+	fprintf( stdout, "Headless benchmarks for the %s.\n", description );
+	fprintf( stdout, "Options:\n" );
+	fprintf( stdout, "  -n count       size of the data set used by each case\n" );
+	fprintf( stdout, "  -i iterations  number of passes done over the data set\n" );
+	fprintf( stdout, "  -r repeats     number of times each case is run, defaults to %i\n", DEFAULT_REPEATS );
+	fprintf( stdout, "  -csv file      append the results to a CSV file\n" );
+	fprintf( stdout, "  -perf          also record hardware cache misses, Linux only\n" );
+	fprintf( stdout, "  -filter text   only run cases with names containing text\n" );
+}
+
+int bench_ParseOptions( int argc, char** argv, const char* description, BenchmarkOptions* outOptions )
+{
+	memset( outOptions, 0, sizeof( BenchmarkOptions ) );
+	outOptions->repeats = DEFAULT_REPEATS;
+
+	for( int i = 1; i < argc; ++i ) {
+		bool hasNext = ( i + 1 ) < argc;
+		if( strcmp( "-h", argv[i] ) == 0 ) {
+			displayHelp( description );
+			return 1;
+		} else if( ( strcmp( "-n", argv[i] ) == 0 ) && hasNext ) {
+			outOptions->count = (size_t)strtoul( argv[++i], NULL, 10 );
+		} else if( ( strcmp( "-i", argv[i] ) == 0 ) && hasNext ) {
+			outOptions->iterations = (size_t)strtoul( argv[++i], NULL, 10 );
+		} else if( ( strcmp( "-r", argv[i] ) == 0 ) && hasNext ) {
+			outOptions->repeats = atoi( argv[++i] );
+		} else if( ( strcmp( "-csv", argv[i] ) == 0 ) && hasNext ) {
+			outOptions->csvFileName = argv[++i];
+		} else if( ( strcmp( "-filter", argv[i] ) == 0 ) && hasNext ) {
+			outOptions->filter = argv[++i];
+		} else if( strcmp( "-perf", argv[i] ) == 0 ) {
+			outOptions->usePerfCounters = true;
+		} else {
+			fprintf( stderr, "Invalid argument %s, use -h to get help.\n", argv[i] );
+			return -1;
+		}
+	}
+
+	if( outOptions->repeats <= 0 ) {
+		fprintf( stderr, "Invalid arguments, repeats must be greater than 0.\n" );
+		return -1;
+	}
+
+	return 0;
+}
+
+// ***** Running
+int bench_RunCases( const char* suiteName, const BenchmarkCase* cases, size_t numCases, const BenchmarkOptions* options )
+{
+	FILE* csvFile = NULL;
+	if( options->csvFileName != NULL ) {
+		csvFile = fopen( options->csvFileName, "a+" );
+		if( csvFile == NULL ) {
+			fprintf( stderr, "Unable to open %s for writing.\n", options->csvFileName );
+			return 1;
+		}
+
+		// only write the header if the file is new
+		fseek( csvFile, 0, SEEK_END );
+		if( ftell( csvFile ) == 0 ) {
+			fprintf( csvFile, "timestamp,suite,case,ops,best_ns_per_op,mean_ns_per_op,cache_misses_per_op\n" );
+		}
+	}
+
+	bool perfAvailable = options->usePerfCounters;
+	long long timestamp = (long long)time( NULL );
+
+	fprintf( stdout, "%-48s %12s %14s %14s %16s\n", suiteName, "ops", "best ns/op", "mean ns/op", "cache miss/op" );
+
+	for( size_t c = 0; c < numCases; ++c ) {
+		const BenchmarkCase* bc = &( cases[c] );
+		if( ( options->filter != NULL ) && ( strstr( bc->name, options->filter ) == NULL ) ) {
+			continue;
+		}
+
+		double bestNSPerOp = DBL_MAX;
+		double totalNSPerOp = 0.0;
+		double bestMissesPerOp = -1.0;
+		size_t ops = 0;
+
+		for( int r = 0; r < options->repeats; ++r ) {
+			if( bc->setUp != NULL ) bc->setUp( );
+
+			if( perfAvailable && !perfStart( ) ) {
+				fprintf( stderr, "Unable to open hardware performance counters, cache misses will not be reported.\n" );
+				perfAvailable = false;
+			}
+
+			Uint64 start = SDL_GetPerformanceCounter( );
+			ops = bc->run( );
+			Uint64 end = SDL_GetPerformanceCounter( );
+
+			int64_t misses = perfAvailable ? perfStop( ) : -1;
+
+			if( bc->tearDown != NULL ) bc->tearDown( );
+
+			if( ops == 0 ) ops = 1;
+			double ns = ( (double)( end - start ) * 1e9 ) / (double)SDL_GetPerformanceFrequency( );
+			double nsPerOp = ns / (double)ops;
+			totalNSPerOp += nsPerOp;
+			if( nsPerOp < bestNSPerOp ) {
+				bestNSPerOp = nsPerOp;
+				if( misses >= 0 ) {
+					bestMissesPerOp = (double)misses / (double)ops;
+				}
+			}
+		}
+
+		double meanNSPerOp = totalNSPerOp / (double)options->repeats;
+
+		if( bestMissesPerOp >= 0.0 ) {
+			fprintf( stdout, "%-48s %12llu %14.2f %14.2f %16.4f\n", bc->name, (unsigned long long)ops, bestNSPerOp, meanNSPerOp, bestMissesPerOp );
+		} else {
+			fprintf( stdout, "%-48s %12llu %14.2f %14.2f %16s\n", bc->name, (unsigned long long)ops, bestNSPerOp, meanNSPerOp, "-" );
+		}
+
+		if( csvFile != NULL ) {
+			// leave the cache misses empty if we weren't able to read them
+			fprintf( csvFile, "%lld,%s,\"%s\",%llu,%.3f,%.3f,", timestamp, suiteName, bc->name, (unsigned long long)ops, bestNSPerOp, meanNSPerOp );
+			if( bestMissesPerOp >= 0.0 ) {
+				fprintf( csvFile, "%.4f", bestMissesPerOp );
+			}
+			fprintf( csvFile, "\n" );
+		}
+	}
+
+	perfCleanUp( );
+
+	if( csvFile != NULL ) {
+		fclose( csvFile );
+	}
+
+	return 0;
+}
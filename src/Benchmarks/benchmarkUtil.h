@@ -0,0 +1,33 @@
+#ifndef BENCHMARK_UTIL_H
+#define BENCHMARK_UTIL_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// Shared harness for the headless benchmarks. Each case has it's set up and tear down called around every repeat,
+//  only the run function is timed. The run function returns the number of operations it did so we can report ns/op.
+
+typedef struct {
+	const char* name;
+	void (*setUp)( void );
+	size_t (*run)( void );
+	void (*tearDown)( void );
+} BenchmarkCase;
+
+typedef struct {
+	size_t count;			// size of the data set, 0 means use the suite's default
+	size_t iterations;		// number of passes over the data set, 0 means use the suite's default
+	int repeats;			// how many times each case is run, the best and the mean are reported
+	bool usePerfCounters;	// read the hardware cache miss counter around each run, only supported on Linux
+	const char* csvFileName;	// if not NULL results are appended to this file
+	const char* filter;		// if not NULL only cases whose name contains this are run
+} BenchmarkOptions;
+
+// parses the standard command line arguments
+//  returns < 0 if the arguments were invalid, > 0 if the help was displayed, and 0 if the benchmarks should be run
+int bench_ParseOptions( int argc, char** argv, const char* description, BenchmarkOptions* outOptions );
+
+// runs all the cases and reports the results, returns 0 on success
+int bench_RunCases( const char* suiteName, const BenchmarkCase* cases, size_t numCases, const BenchmarkOptions* options );
+
+#endif // inclusion guard
@@ -0,0 +1,336 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include <SDL_timer.h>
+
+#include "benchmarkUtil.h"
+
+#include "../Game/System/memory.h"
+#include "../Game/System/random.h"
+#include "../Game/System/ECPS/entityComponentProcessSystem.h"
+#include "../Game/Utils/stretchyBuffer.h"
+#include "../Game/Utils/helpers.h"
+
+// Headless micro-benchmarks for the entity-component-process system, doesn't need a window or a graphics context.
+//  Each case gets a fresh ECPS, only the run function is timed.
+
+#define DEFAULT_NUM_ENTITIES 20000
+#define DEFAULT_NUM_ITERATIONS 50
+#define NUM_OPTIONAL_COMPONENTS 4 // entities are spread across 2^NUM_OPTIONAL_COMPONENTS packaged arrays
+
+typedef struct {
+	float x, y;
+} BenchPos;
+
+typedef struct {
+	float x, y;
+} BenchVel;
+
+typedef struct {
+	float scale;
+} BenchExtra;
+
+typedef struct {
+	int value;
+} BenchTag;
+
+typedef struct {
+	uint8_t data[16];
+} BenchOptional;
+
+static ECPS benchECPS;
+
+static ComponentID posCompID = INVALID_COMPONENT_ID;
+static ComponentID velCompID = INVALID_COMPONENT_ID;
+static ComponentID extraCompID = INVALID_COMPONENT_ID;
+static ComponentID tagCompID = INVALID_COMPONENT_ID;
+static ComponentID optionalCompIDs[NUM_OPTIONAL_COMPONENTS];
+
+static Process moveProc;
+static Process destroyProc;
+
+static EntityID* sbEntityIDs = NULL;
+static EntityID* sbLookupIDs = NULL;
+
+static size_t numEntities = DEFAULT_NUM_ENTITIES;
+static size_t numIterations = DEFAULT_NUM_ITERATIONS;
+
+static RandomGroup benchRandom;
+
+static volatile float sink = 0.0f;
+
+// ***** Shared set up
+
+static void move( ECPS* ecps, const Entity* entity )
+{
+	BenchPos* pos = NULL;
+	BenchVel* vel = NULL;
+
+	ecps_GetComponentFromEntity( entity, posCompID, (void**)&pos );
+	ecps_GetComponentFromEntity( entity, velCompID, (void**)&vel );
+
+	pos->x += vel->x;
+	pos->y += vel->y;
+}
+
+static void destroy( ECPS* ecps, const Entity* entity )
+{
+	ecps_DestroyEntity( ecps, entity );
+}
+
+static void startECPS( void )
+{
+	ecps_StartInitialization( &benchECPS ); {
+		posCompID = ecps_AddComponentType( &benchECPS, "POS", sizeof( BenchPos ), ALIGN_OF( BenchPos ), NULL, NULL );
+		velCompID = ecps_AddComponentType( &benchECPS, "VEL", sizeof( BenchVel ), ALIGN_OF( BenchVel ), NULL, NULL );
+		extraCompID = ecps_AddComponentType( &benchECPS, "EXTRA", sizeof( BenchExtra ), ALIGN_OF( BenchExtra ), NULL, NULL );
+		tagCompID = ecps_AddComponentType( &benchECPS, "TAG", sizeof( BenchTag ), ALIGN_OF( BenchTag ), NULL, NULL );
+		for( int i = 0; i < NUM_OPTIONAL_COMPONENTS; ++i ) {
+			char name[8];
+			snprintf( name, sizeof( name ), "OPT%i", i );
+			optionalCompIDs[i] = ecps_AddComponentType( &benchECPS, name, sizeof( BenchOptional ), ALIGN_OF( BenchOptional ), NULL, NULL );
+		}
+
+		ecps_CreateProcess( &benchECPS, "MOVE", NULL, move, NULL, &moveProc, 2, posCompID, velCompID );
+		ecps_CreateProcess( &benchECPS, "DESTROY", NULL, destroy, NULL, &destroyProc, 1, posCompID );
+	} ecps_FinishInitialization( &benchECPS );
+
+	rand_Seed( &benchRandom, 0x5EED );
+	sb_Clear( sbEntityIDs );
+	sb_Clear( sbLookupIDs );
+}
+
+static void stopECPS( void )
+{
+	ecps_CleanUp( &benchECPS );
+}
+
+// creates numEntities entities with a position and velocity, spread out over the optional components
+static void createSpreadEntities( void )
+{
+	BenchPos pos = { 0.0f, 0.0f };
+	BenchVel vel = { 1.0f, 0.5f };
+
+	for( size_t i = 0; i < numEntities; ++i ) {
+		Entity entity;
+		EntityID id = ecps_CreateEntity( &benchECPS, 2, posCompID, &pos, velCompID, &vel );
+		ecps_GetEntityByID( &benchECPS, id, &entity );
+		for( int o = 0; o < NUM_OPTIONAL_COMPONENTS; ++o ) {
+			if( i & ( (size_t)1 << o ) ) {
+				ecps_AddComponentToEntity( &benchECPS, &entity, optionalCompIDs[o], NULL );
+			}
+		}
+		sb_Push( sbEntityIDs, id );
+	}
+}
+
+// ***** Entity creation
+static void createEntity_SetUp( void )
+{
+	startECPS( );
+}
+
+static size_t createEntity_Run( void )
+{
+	BenchPos pos = { 0.0f, 0.0f };
+	BenchVel vel = { 1.0f, 0.5f };
+	for( size_t i = 0; i < numEntities; ++i ) {
+		ecps_CreateEntity( &benchECPS, 2, posCompID, &pos, velCompID, &vel );
+	}
+	return numEntities;
+}
+
+// ***** Adding and removing components
+static void addRemoveComponent_SetUp( void )
+{
+	startECPS( );
+
+	BenchPos pos = { 0.0f, 0.0f };
+	for( size_t i = 0; i < numEntities; ++i ) {
+		sb_Push( sbEntityIDs, ecps_CreateEntity( &benchECPS, 1, posCompID, &pos ) );
+	}
+}
+
+static size_t addRemoveComponent_Run( void )
+{
+	BenchVel vel = { 1.0f, 0.5f };
+	size_t count = sb_Count( sbEntityIDs );
+	for( size_t i = 0; i < count; ++i ) {
+		Entity entity;
+		ecps_GetEntityByID( &benchECPS, sbEntityIDs[i], &entity );
+		ecps_AddComponentToEntity( &benchECPS, &entity, velCompID, &vel );
+		ecps_RemoveComponentFromEntity( &benchECPS, &entity, velCompID );
+	}
+	return count * 2;
+}
+
+// ***** Running a process over many packaged arrays
+static void runProcess_SetUp( void )
+{
+	startECPS( );
+	createSpreadEntities( );
+}
+
+static size_t runProcess_Run( void )
+{
+	for( size_t i = 0; i < numIterations; ++i ) {
+		ecps_RunProcess( &benchECPS, &moveProc );
+	}
+	return numEntities * numIterations;
+}
+
+// ***** Destroying every entity from inside a process, goes through the command buffer
+static size_t midProcessDestroy_Run( void )
+{
+	ecps_RunProcess( &benchECPS, &destroyProc );
+	return numEntities;
+}
+
+// ***** Random access by id
+static void randomAccess_SetUp( void )
+{
+	startECPS( );
+	createSpreadEntities( );
+
+	// generate the lookups ahead of time so we're not timing the random number generation
+	size_t count = sb_Count( sbEntityIDs );
+	for( size_t i = 0; i < numEntities * numIterations; ++i ) {
+		sb_Push( sbLookupIDs, sbEntityIDs[rand_GetU32( &benchRandom ) % count] );
+	}
+}
+
+static size_t randomAccess_Run( void )
+{
+	size_t count = sb_Count( sbLookupIDs );
+	for( size_t i = 0; i < count; ++i ) {
+		BenchPos* pos = NULL;
+		if( ecps_GetComponentFromEntityByID( &benchECPS, sbLookupIDs[i], posCompID, (void**)&pos ) ) {
+			sink += pos->x;
+		}
+	}
+	return count;
+}
+
+// ***** Query iteration compared to a custom process, tagged entities are skipped and the extra component is optional
+static void filtered_SetUp( void )
+{
+	startECPS( );
+
+	// spread the entities across four packaged arrays: { pos, vel }, { pos, vel, extra }, { pos, vel, tag }, { pos, vel, extra, tag }
+	BenchPos pos = { 0.0f, 0.0f };
+	BenchVel vel = { 1.0f, 0.5f };
+	BenchExtra extra = { 2.0f };
+	BenchTag tag = { 1 };
+	for( size_t i = 0; i < numEntities; ++i ) {
+		switch( i % 4 ) {
+		case 0:
+			ecps_CreateEntity( &benchECPS, 2, posCompID, &pos, velCompID, &vel );
+			break;
+		case 1:
+			ecps_CreateEntity( &benchECPS, 3, posCompID, &pos, velCompID, &vel, extraCompID, &extra );
+			break;
+		case 2:
+			ecps_CreateEntity( &benchECPS, 3, posCompID, &pos, velCompID, &vel, tagCompID, &tag );
+			break;
+		case 3:
+			ecps_CreateEntity( &benchECPS, 4, posCompID, &pos, velCompID, &vel, extraCompID, &extra, tagCompID, &tag );
+			break;
+		}
+	}
+}
+
+static void filteredProc( ECPS* ecps, const Entity* entity )
+{
+	BenchPos* pos = NULL;
+	BenchVel* vel = NULL;
+	BenchExtra* extra = NULL;
+
+	if( ecps_DoesEntityHaveComponent( entity, tagCompID ) ) return;
+
+	ecps_GetComponentFromEntity( entity, posCompID, (void**)&pos );
+	ecps_GetComponentFromEntity( entity, velCompID, (void**)&vel );
+
+	float scale = 1.0f;
+	if( ecps_GetComponentFromEntity( entity, extraCompID, (void**)&extra ) ) {
+		scale = extra->scale;
+	}
+
+	pos->x += vel->x * scale;
+	pos->y += vel->y * scale;
+	sink += pos->x;
+}
+
+static size_t customProcess_Run( void )
+{
+	for( size_t i = 0; i < numIterations; ++i ) {
+		ecps_RunCustomProcess( &benchECPS, NULL, filteredProc, NULL, 2, posCompID, velCompID );
+	}
+	return numEntities * numIterations;
+}
+
+static size_t query_Run( void )
+{
+	Query query;
+	ecps_CreateQuery( &benchECPS, "BENCH", &query, 2, 1, 1, posCompID, velCompID, tagCompID, extraCompID );
+
+	for( size_t i = 0; i < numIterations; ++i ) {
+		Entity entity;
+		void* comps[3];
+		ecps_QueryStart( &benchECPS, &query );
+		while( ecps_QueryNext( &benchECPS, &query, &entity, comps ) ) {
+			BenchPos* pos = (BenchPos*)comps[0];
+			BenchVel* vel = (BenchVel*)comps[1];
+			BenchExtra* extra = (BenchExtra*)comps[2];
+
+			float scale = ( extra != NULL ) ? extra->scale : 1.0f;
+
+			pos->x += vel->x * scale;
+			pos->y += vel->y * scale;
+			sink += pos->x;
+		}
+	}
+
+	ecps_DestroyQuery( &query );
+
+	return numEntities * numIterations;
+}
+
+static BenchmarkCase cases[] = {
+	{ "ecps_CreateEntity", createEntity_SetUp, createEntity_Run, stopECPS },
+	{ "ecps_Add/RemoveComponentToEntity", addRemoveComponent_SetUp, addRemoveComponent_Run, stopECPS },
+	{ "ecps_RunProcess (16 arrays)", runProcess_SetUp, runProcess_Run, stopECPS },
+	{ "ecps_RunProcess (mid-process destroy)", runProcess_SetUp, midProcessDestroy_Run, stopECPS },
+	{ "ecps_GetComponentFromEntityByID (random)", randomAccess_SetUp, randomAccess_Run, stopECPS },
+	{ "ecps_RunCustomProcess (filtered)", filtered_SetUp, customProcess_Run, stopECPS },
+	{ "ecps_QueryNext (filtered)", filtered_SetUp, query_Run, stopECPS },
+};
+
+int main( int argc, char** argv )
+{
+	BenchmarkOptions options;
+	int parseResult = bench_ParseOptions( argc, argv, "entity-component-process system", &options );
+	if( parseResult != 0 ) {
+		return ( parseResult < 0 ) ? 1 : 0;
+	}
+
+	if( options.count > 0 ) numEntities = options.count;
+	if( options.iterations > 0 ) numIterations = options.iterations;
+
+	if( numEntities >= UINT16_MAX ) {
+		fprintf( stderr, "Invalid arguments, entity count must be less than %i.\n", UINT16_MAX );
+		return 1;
+	}
+
+	mem_Init( 512 * 1024 * 1024 );
+
+	int result = bench_RunCases( "ecps", cases, ARRAY_SIZE( cases ), &options );
+
+	sb_Release( sbEntityIDs );
+	sb_Release( sbLookupIDs );
+	mem_CleanUp( );
+
+	return result;
+}
@@ -0,0 +1,272 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "benchmarkUtil.h"
+#include "baseline/oldHashMap.h"
+
+#include "../Game/System/memory.h"
+#include "../Game/System/random.h"
+#include "../Game/Utils/hashMap.h"
+#include "../Game/Utils/stringArena.h"
+#include "../Game/Utils/stretchyBuffer.h"
+#include "../Game/Utils/helpers.h"
+
+// Headless micro-benchmarks comparing the string keyed hash map against the version before stored hashes and key arenas were
+//  added (in baseline/). Keys look like the image paths used with imgIDMap, so they share long prefixes.
+
+#define DEFAULT_NUM_KEYS 4096
+#define DEFAULT_NUM_ITERATIONS 50
+#define KEY_LENGTH 40
+#define INITIAL_SIZE 64 // same as imgIDMap, the old version can't start empty
+
+static size_t numKeys = DEFAULT_NUM_KEYS;
+static size_t numIterations = DEFAULT_NUM_ITERATIONS;
+
+// all keys are stored in one block, each KEY_LENGTH long
+static char* keys = NULL;
+static char* missingKeys = NULL;
+static uint32_t* sbLookupOrder = NULL;
+
+static HashMap newMap;
+static OldHashMap oldMap;
+static StringArena keyArena;
+
+static RandomGroup benchRandom;
+
+static volatile int sink = 0;
+
+#define KEY( i ) ( keys + ( (i) * KEY_LENGTH ) )
+#define MISSING_KEY( i ) ( missingKeys + ( (i) * KEY_LENGTH ) )
+
+static void createKeys( void )
+{
+	keys = mem_Allocate( numKeys * KEY_LENGTH );
+	missingKeys = mem_Allocate( numKeys * KEY_LENGTH );
+	for( size_t i = 0; i < numKeys; ++i ) {
+		snprintf( KEY( i ), KEY_LENGTH, "Images/Tiles/tile_%05u.png", (unsigned int)i );
+		snprintf( MISSING_KEY( i ), KEY_LENGTH, "Images/Tiles/tile_%05u.jpg", (unsigned int)i );
+	}
+
+	// look things up in a random order so we're not just walking through memory
+	rand_Seed( &benchRandom, 0x5EED );
+	sb_Clear( sbLookupOrder );
+	for( size_t i = 0; i < numKeys; ++i ) {
+		sb_Push( sbLookupOrder, rand_GetU32( &benchRandom ) % (uint32_t)numKeys );
+	}
+}
+
+static void destroyKeys( void )
+{
+	mem_Release( keys );
+	mem_Release( missingKeys );
+	keys = NULL;
+	missingKeys = NULL;
+}
+
+// ***** Old implementation
+static void old_SetUp( void )
+{
+	createKeys( );
+	oldHashMap_Init( &oldMap, INITIAL_SIZE, NULL );
+	for( size_t i = 0; i < numKeys; ++i ) {
+		oldHashMap_Set( &oldMap, KEY( i ), (int)i );
+	}
+}
+
+static void old_TearDown( void )
+{
+	oldHashMap_Clear( &oldMap );
+	destroyKeys( );
+}
+
+static void oldInsert_SetUp( void )
+{
+	createKeys( );
+}
+
+static size_t oldInsert_Run( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		oldHashMap_Init( &oldMap, INITIAL_SIZE, NULL );
+		for( size_t i = 0; i < numKeys; ++i ) {
+			oldHashMap_Set( &oldMap, KEY( i ), (int)i );
+		}
+		oldHashMap_Clear( &oldMap );
+	}
+	return numKeys * numIterations;
+}
+
+static void oldInsert_TearDown( void )
+{
+	destroyKeys( );
+}
+
+static size_t oldHit_Run( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		for( size_t i = 0; i < numKeys; ++i ) {
+			int value;
+			if( oldHashMap_Find( &oldMap, KEY( sbLookupOrder[i] ), &value ) ) {
+				sink += value;
+			}
+		}
+	}
+	return numKeys * numIterations;
+}
+
+static size_t oldMiss_Run( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		for( size_t i = 0; i < numKeys; ++i ) {
+			int value;
+			if( oldHashMap_Find( &oldMap, MISSING_KEY( sbLookupOrder[i] ), &value ) ) {
+				sink += value;
+			}
+		}
+	}
+	return numKeys * numIterations;
+}
+
+// ***** Current implementation
+static void new_SetUp( void )
+{
+	createKeys( );
+	hashMap_Init( &newMap, INITIAL_SIZE, NULL );
+	for( size_t i = 0; i < numKeys; ++i ) {
+		hashMap_Set( &newMap, KEY( i ), (int)i );
+	}
+}
+
+static void new_TearDown( void )
+{
+	hashMap_Clear( &newMap );
+	destroyKeys( );
+}
+
+static void newArena_SetUp( void )
+{
+	createKeys( );
+	strArena_Init( &keyArena, 0 );
+	hashMap_InitWithArena( &newMap, INITIAL_SIZE, NULL, &keyArena );
+	for( size_t i = 0; i < numKeys; ++i ) {
+		hashMap_Set( &newMap, KEY( i ), (int)i );
+	}
+}
+
+static void newArena_TearDown( void )
+{
+	hashMap_Clear( &newMap );
+	strArena_Clear( &keyArena );
+	destroyKeys( );
+}
+
+static void newInsert_SetUp( void )
+{
+	createKeys( );
+	strArena_Init( &keyArena, 0 );
+}
+
+static size_t newInsert_Run( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		hashMap_Init( &newMap, INITIAL_SIZE, NULL );
+		for( size_t i = 0; i < numKeys; ++i ) {
+			hashMap_Set( &newMap, KEY( i ), (int)i );
+		}
+		hashMap_Clear( &newMap );
+	}
+	return numKeys * numIterations;
+}
+
+static size_t newArenaInsert_Run( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		hashMap_InitWithArena( &newMap, INITIAL_SIZE, NULL, &keyArena );
+		for( size_t i = 0; i < numKeys; ++i ) {
+			hashMap_Set( &newMap, KEY( i ), (int)i );
+		}
+		hashMap_Clear( &newMap );
+		strArena_Clear( &keyArena );
+	}
+	return numKeys * numIterations;
+}
+
+static void newInsert_TearDown( void )
+{
+	strArena_Clear( &keyArena );
+	destroyKeys( );
+}
+
+static size_t newHit_Run( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		for( size_t i = 0; i < numKeys; ++i ) {
+			int value;
+			if( hashMap_Find( &newMap, KEY( sbLookupOrder[i] ), &value ) ) {
+				sink += value;
+			}
+		}
+	}
+	return numKeys * numIterations;
+}
+
+static size_t newMiss_Run( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		for( size_t i = 0; i < numKeys; ++i ) {
+			int value;
+			if( hashMap_Find( &newMap, MISSING_KEY( sbLookupOrder[i] ), &value ) ) {
+				sink += value;
+			}
+		}
+	}
+	return numKeys * numIterations;
+}
+
+// ***** Current implementation using the old hash function, to separate the gains from the hash and from the stored hashes
+static void newDJB2_SetUp( void )
+{
+	createKeys( );
+	hashMap_Init( &newMap, INITIAL_SIZE, hashMap_HashStringDJB2 );
+	for( size_t i = 0; i < numKeys; ++i ) {
+		hashMap_Set( &newMap, KEY( i ), (int)i );
+	}
+}
+
+static BenchmarkCase cases[] = {
+	{ "old insert", oldInsert_SetUp, oldInsert_Run, oldInsert_TearDown },
+	{ "old hit", old_SetUp, oldHit_Run, old_TearDown },
+	{ "old miss", old_SetUp, oldMiss_Run, old_TearDown },
+	{ "new insert", newInsert_SetUp, newInsert_Run, newInsert_TearDown },
+	{ "new insert (key arena)", newInsert_SetUp, newArenaInsert_Run, newInsert_TearDown },
+	{ "new hit", new_SetUp, newHit_Run, new_TearDown },
+	{ "new hit (key arena)", newArena_SetUp, newHit_Run, newArena_TearDown },
+	{ "new hit (DJB2)", newDJB2_SetUp, newHit_Run, new_TearDown },
+	{ "new miss", new_SetUp, newMiss_Run, new_TearDown },
+	{ "new miss (key arena)", newArena_SetUp, newMiss_Run, newArena_TearDown },
+	{ "new miss (DJB2)", newDJB2_SetUp, newMiss_Run, new_TearDown },
+};
+
+int main( int argc, char** argv )
+{
+	BenchmarkOptions options;
+	int parseResult = bench_ParseOptions( argc, argv, "string keyed hash map", &options );
+	if( parseResult != 0 ) {
+		return ( parseResult < 0 ) ? 1 : 0;
+	}
+
+	if( options.count > 0 ) numKeys = options.count;
+	if( options.iterations > 0 ) numIterations = options.iterations;
+
+	mem_Init( 256 * 1024 * 1024 );
+
+	int result = bench_RunCases( "hashMap", cases, ARRAY_SIZE( cases ), &options );
+
+	sb_Release( sbLookupOrder );
+	mem_CleanUp( );
+
+	return result;
+}
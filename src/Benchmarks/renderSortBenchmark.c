@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "benchmarkUtil.h"
+
+#include "../Game/System/memory.h"
+#include "../Game/System/random.h"
+#include "../Game/Graphics/renderSort.h"
+#include "../Game/Utils/helpers.h"
+
+// Headless micro-benchmarks for sorting the triangle renderer's lists, compares the radix sort over keys that
+//  triRenderer_Render uses against qsort over the full triangles, which is what it used to do.
+
+#define DEFAULT_NUM_TRIANGLES ( 2048 * 2 ) // MAX_TRIS in triRendering.c
+#define DEFAULT_NUM_ITERATIONS 200
+
+#define NUM_SHADERS 4
+#define NUM_TEXTURES 64
+#define NUM_SCISSORS 4
+
+// same layout as the Triangle in triRendering.c, so the qsort cases move the same amount of memory
+typedef struct {
+	uint32_t vertexIndices[3];
+	float zPos;
+	uint32_t camFlags;
+
+	uint32_t texture;
+	float floatVal0;
+
+	int shaderType;
+
+	int scissorID;
+} BenchTriangle;
+
+static size_t numTriangles = DEFAULT_NUM_TRIANGLES;
+static size_t numIterations = DEFAULT_NUM_ITERATIONS;
+
+static BenchTriangle* sourceTris = NULL;
+static BenchTriangle* workTris = NULL;
+static RenderSortEntry* entries = NULL;
+static RenderSortEntry* scratch = NULL;
+
+static RandomGroup benchRandom;
+
+static volatile uint32_t sink = 0;
+
+static void setUp( void )
+{
+	sourceTris = mem_Allocate( sizeof( BenchTriangle ) * numTriangles );
+	workTris = mem_Allocate( sizeof( BenchTriangle ) * numTriangles );
+	entries = mem_Allocate( sizeof( RenderSortEntry ) * numTriangles );
+	scratch = mem_Allocate( sizeof( RenderSortEntry ) * numTriangles );
+
+	// sprites tend to come in runs that share state, so add them in small groups
+	rand_Seed( &benchRandom, 0x5EED );
+	BenchTriangle tri;
+	memset( &tri, 0, sizeof( tri ) );
+	for( size_t i = 0; i < numTriangles; ++i ) {
+		if( ( i % 8 ) == 0 ) {
+			tri.shaderType = (int)( rand_GetU32( &benchRandom ) % NUM_SHADERS );
+			tri.texture = 1 + ( rand_GetU32( &benchRandom ) % NUM_TEXTURES );
+			tri.scissorID = (int)( rand_GetU32( &benchRandom ) % NUM_SCISSORS ) - 1;
+			tri.floatVal0 = ( tri.shaderType >= 2 ) ? 0.5f : 0.0f;
+		}
+		tri.zPos = (float)( (int)( rand_GetU32( &benchRandom ) % 20 ) - 10 ) + ( (float)i / (float)( 2 * ( numTriangles + 1 ) ) );
+		tri.camFlags = 1;
+		tri.vertexIndices[0] = (uint32_t)( i * 3 );
+		tri.vertexIndices[1] = (uint32_t)( i * 3 ) + 1;
+		tri.vertexIndices[2] = (uint32_t)( i * 3 ) + 2;
+		sourceTris[i] = tri;
+	}
+}
+
+static void tearDown( void )
+{
+	mem_Release( sourceTris );
+	mem_Release( workTris );
+	mem_Release( entries );
+	mem_Release( scratch );
+}
+
+// ***** qsort over the triangles
+static int sortByRenderState( const void* p1, const void* p2 )
+{
+	BenchTriangle* tri1 = (BenchTriangle*)p1;
+	BenchTriangle* tri2 = (BenchTriangle*)p2;
+
+	int stDiff = ( tri1->shaderType - tri2->shaderType );
+	if( stDiff != 0 ) {
+		return stDiff;
+	}
+
+	if( tri1->texture < tri2->texture ) {
+		return -1;
+	} else if( tri1->texture > tri2->texture ) {
+		return 1;
+	}
+
+	return ( tri1->scissorID - tri2->scissorID );
+}
+
+static int sortByDepth( const void* p1, const void* p2 )
+{
+	BenchTriangle* tri1 = (BenchTriangle*)p1;
+	BenchTriangle* tri2 = (BenchTriangle*)p2;
+	return ( ( ( tri1->zPos ) - ( tri2->zPos ) ) > 0.0f ) ? 1 : -1;
+}
+
+static size_t qsortState_Run( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		memcpy( workTris, sourceTris, sizeof( BenchTriangle ) * numTriangles );
+		qsort( workTris, numTriangles, sizeof( BenchTriangle ), sortByRenderState );
+		sink += workTris[0].texture;
+	}
+	return numTriangles * numIterations;
+}
+
+static size_t qsortDepth_Run( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		memcpy( workTris, sourceTris, sizeof( BenchTriangle ) * numTriangles );
+		qsort( workTris, numTriangles, sizeof( BenchTriangle ), sortByDepth );
+		sink += workTris[0].texture;
+	}
+	return numTriangles * numIterations;
+}
+
+// ***** radix sort over the keys, includes building the keys
+static size_t radixState_Run( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		for( size_t i = 0; i < numTriangles; ++i ) {
+			BenchTriangle* tri = &( sourceTris[i] );
+			entries[i].idx = (uint32_t)i;
+			entries[i].key = renderSort_StateKey( (uint32_t)tri->shaderType, tri->texture, tri->scissorID, tri->floatVal0, tri->zPos );
+		}
+		RenderSortEntry* sorted = renderSort_Sort( entries, scratch, numTriangles );
+		sink += sorted[0].idx;
+	}
+	return numTriangles * numIterations;
+}
+
+static size_t radixDepth_Run( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		for( size_t i = 0; i < numTriangles; ++i ) {
+			entries[i].idx = (uint32_t)i;
+			entries[i].key = renderSort_DepthKey( sourceTris[i].zPos );
+		}
+		RenderSortEntry* sorted = renderSort_Sort( entries, scratch, numTriangles );
+		sink += sorted[0].idx;
+	}
+	return numTriangles * numIterations;
+}
+
+static BenchmarkCase cases[] = {
+	{ "qsort triangles (render state)", setUp, qsortState_Run, tearDown },
+	{ "radix sort keys (render state)", setUp, radixState_Run, tearDown },
+	{ "qsort triangles (depth)", setUp, qsortDepth_Run, tearDown },
+	{ "radix sort keys (depth)", setUp, radixDepth_Run, tearDown },
+};
+
+int main( int argc, char** argv )
+{
+	BenchmarkOptions options;
+	int parseResult = bench_ParseOptions( argc, argv, "triangle renderer sorting", &options );
+	if( parseResult != 0 ) {
+		return ( parseResult < 0 ) ? 1 : 0;
+	}
+
+	if( options.count > 0 ) numTriangles = options.count;
+	if( options.iterations > 0 ) numIterations = options.iterations;
+
+	mem_Init( 64 * 1024 * 1024 );
+
+	int result = bench_RunCases( "renderSort", cases, ARRAY_SIZE( cases ), &options );
+
+	mem_CleanUp( );
+
+	return result;
+}
@@ -0,0 +1,229 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "benchmarkUtil.h"
+
+#include "../Game/System/memory.h"
+#include "../Game/System/random.h"
+#include "../Game/System/jobQueue.h"
+#include "../Game/Graphics/glPlatform.h"
+#include "../Game/Graphics/glDebugging.h"
+#include "../Game/Graphics/textureUpload.h"
+#include "../Game/Graphics/textureAtlas.h"
+#include "../Game/Utils/helpers.h"
+
+// Headless benchmarks for getting loaded images onto the GPU, built with GL_RECORDER so every GL call is recorded
+//  instead of made. Covers spreading texture uploads across frames and packing images into the atlas. After each case
+//  the frames taken, uploads, and bytes uploaded per frame are reported.
+// Built without THREAD_SUPPORT, so the band copies are run by jq_ProcessMainThreadJobs each frame like the game does
+//  on platforms without threads.
+
+#if !defined( GL_RECORDER )
+	#error "The texture benchmark has to be built with GL_RECORDER defined."
+#endif
+
+#define DEFAULT_NUM_ITEMS 256
+#define DEFAULT_NUM_ITERATIONS 10
+
+#define UPLOAD_IMAGE_SIZE 256
+#define MIN_ATLAS_IMAGE_SIZE 8
+#define MAX_ATLAS_IMAGE_SIZE 64
+
+static size_t numItems = DEFAULT_NUM_ITEMS;
+static size_t numIterations = DEFAULT_NUM_ITERATIONS;
+static const char* currCaseName = "";
+
+static RandomGroup benchRandom;
+
+// all the images share the same pixels, they only have to be big enough for the largest one
+static uint8_t* pixels = NULL;
+static LoadedImage* images = NULL;
+static int* handles = NULL;
+
+static size_t numDone = 0;
+static size_t numFailed = 0;
+
+static void createImages( int minSize, int maxSize )
+{
+	pixels = mem_Allocate( (size_t)maxSize * (size_t)maxSize * 4 );
+	memset( pixels, 0xFF, (size_t)maxSize * (size_t)maxSize * 4 );
+
+	images = mem_Allocate( sizeof( LoadedImage ) * numItems );
+	handles = mem_Allocate( sizeof( int ) * numItems );
+
+	rand_Seed( &benchRandom, 0x5A7E );
+	for( size_t i = 0; i < numItems; ++i ) {
+		images[i].data = pixels;
+		images[i].width = rand_GetRangeS32( &benchRandom, minSize, maxSize );
+		images[i].height = rand_GetRangeS32( &benchRandom, minSize, maxSize );
+		images[i].reqComp = 4;
+		images[i].comp = 4;
+		images[i].flags = LIF_BORROWED_DATA;
+		handles[i] = -1;
+	}
+}
+
+static void tearDown( void )
+{
+	GLRecStats stats;
+	glRec_GetStats( &stats );
+	if( stats.frames > 0 ) {
+		printf( "  %s per frame: %.1f uploads, %.0f bytes uploaded, %.1f object changes\n", currCaseName,
+			(double)stats.uploads / stats.frames, (double)stats.uploadBytes / stats.frames,
+			(double)stats.objectChanges / stats.frames );
+	}
+	if( numFailed > 0 ) {
+		printf( "  %s: %i failed\n", currCaseName, (int)numFailed );
+	}
+
+	mem_Release( handles );
+	handles = NULL;
+	mem_Release( images );
+	images = NULL;
+	mem_Release( pixels );
+	pixels = NULL;
+}
+
+// ***** upload, queues all the images at once and processes frames until they're all in textures
+static void uploadDone( void* data, bool success, Texture* texture )
+{
+	++numDone;
+	if( success ) {
+		GL( glDeleteTextures( 1, &( texture->textureID ) ) );
+	} else {
+		++numFailed;
+	}
+}
+
+static void upload_SetUp( void )
+{
+	createImages( UPLOAD_IMAGE_SIZE / 2, UPLOAD_IMAGE_SIZE );
+	numFailed = 0;
+	texUpload_Init( );
+	glRec_ResetStats( );
+}
+
+static void upload_TearDown( void )
+{
+	GLRecStats stats;
+	glRec_GetStats( &stats );
+	printf( "  upload: %.1f frames to upload everything\n", (double)stats.frames / (double)numIterations );
+
+	texUpload_CleanUp( );
+	tearDown( );
+}
+
+static size_t upload_Run( void )
+{
+	currCaseName = "upload";
+	for( size_t it = 0; it < numIterations; ++it ) {
+		numDone = 0;
+		for( size_t i = 0; i < numItems; ++i ) {
+			if( !texUpload_Queue( &( images[i] ), GL_NEAREST, uploadDone, NULL ) ) {
+				++numDone;
+				++numFailed;
+			}
+		}
+
+		while( numDone < numItems ) {
+			jq_ProcessMainThreadJobs( );
+			texUpload_Process( );
+			glRec_EndFrame( );
+		}
+	}
+	return numItems * numIterations;
+}
+
+// ***** atlas, fills the atlas then removes and adds back half the images each pass, like screens loading and
+//  unloading their images, each pass is a frame
+static void atlas_SetUp( void )
+{
+	createImages( MIN_ATLAS_IMAGE_SIZE, MAX_ATLAS_IMAGE_SIZE );
+	numFailed = 0;
+	texAtlas_Init( );
+	glRec_ResetStats( );
+}
+
+static void atlas_TearDown( void )
+{
+	int numPages;
+	float filled;
+	texAtlas_GetUsage( &numPages, &filled );
+	printf( "  atlas: %i pages, %.1f%% filled\n", numPages, filled * 100.0f );
+
+	// releases everything that's still packed
+	texAtlas_CleanUp( );
+	tearDown( );
+}
+
+static void atlasAdd( size_t idx )
+{
+	AtlasResult result;
+	handles[idx] = texAtlas_Add( &( images[idx] ), &result );
+	if( handles[idx] < 0 ) {
+		++numFailed;
+	}
+}
+
+static size_t atlas_Run( void )
+{
+	currCaseName = "atlas";
+	size_t ops = 0;
+
+	for( size_t i = 0; i < numItems; ++i ) {
+		atlasAdd( i );
+	}
+	ops += numItems;
+	glRec_EndFrame( );
+
+	for( size_t it = 0; it < numIterations; ++it ) {
+		size_t start = it % 2;
+		for( size_t i = start; i < numItems; i += 2 ) {
+			if( handles[i] >= 0 ) {
+				texAtlas_Remove( handles[i] );
+				handles[i] = -1;
+			}
+		}
+		for( size_t i = start; i < numItems; i += 2 ) {
+			atlasAdd( i );
+			++ops;
+		}
+		glRec_EndFrame( );
+	}
+
+	return ops;
+}
+
+static BenchmarkCase cases[] = {
+	{ "upload textures", upload_SetUp, upload_Run, upload_TearDown },
+	{ "atlas add and remove", atlas_SetUp, atlas_Run, atlas_TearDown },
+};
+
+int main( int argc, char** argv )
+{
+	BenchmarkOptions options;
+	int parseResult = bench_ParseOptions( argc, argv, "texture uploads and the atlas with recorded GL", &options );
+	if( parseResult != 0 ) {
+		return ( parseResult < 0 ) ? 1 : 0;
+	}
+
+	if( options.count > 0 ) numItems = options.count;
+	if( options.iterations > 0 ) numIterations = options.iterations;
+
+	mem_Init( 64 * 1024 * 1024 );
+
+	glInit( );
+
+	int result = 1;
+	if( ( jq_Initialize( 1 ) >= 0 ) && ( texAtlas_Init( ) >= 0 ) ) {
+		result = bench_RunCases( "texture", cases, ARRAY_SIZE( cases ), &options );
+	}
+
+	jq_ShutDown( );
+	mem_CleanUp( );
+
+	return result;
+}
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "benchmarkUtil.h"
+
+#include "../Game/System/memory.h"
+#include "../Game/System/random.h"
+#include "../Game/Math/matrix4.h"
+#include "../Game/Math/vector2.h"
+#include "../Game/Graphics/triCulling.h"
+#include "../Game/Utils/helpers.h"
+
+// Headless micro-benchmarks for culling the triangle renderer's lists, compares transforming and testing each triangle
+//  against every camera as it's added, which is what addTriangle used to do, against the batched culling that
+//  triRenderer_Render does now. The world is larger than the screen so some triangles are off screen, some on it,
+//  and some straddle the edges.
+
+#define DEFAULT_NUM_TRIANGLES ( 2048 * 8 ) // TRI_RENDERER_DEFAULT_MAX_TRIS
+#define DEFAULT_NUM_ITERATIONS 100
+
+#define SCREEN_WIDTH 800.0f
+#define SCREEN_HEIGHT 600.0f
+#define WORLD_SCALE 3.0f
+#define MAX_TRI_SIZE 64.0f
+
+#define NUM_CAMERAS 2
+#define WORLD_CAMERA_FLAGS 0x1
+#define UI_CAMERA_FLAGS 0x2
+
+static size_t numTriangles = DEFAULT_NUM_TRIANGLES;
+static size_t numIterations = DEFAULT_NUM_ITERATIONS;
+
+static Matrix4 vpMatrices[NUM_CAMERAS];
+static uint32_t cameraFlags[NUM_CAMERAS] = { WORLD_CAMERA_FLAGS, UI_CAMERA_FLAGS };
+static CullCamera cullCameras[NUM_CAMERAS];
+
+static Vector2* positions = NULL; // three per triangle
+static CullTriangles tris;
+static uint8_t* visible = NULL;
+
+static RandomGroup benchRandom;
+
+static volatile size_t sink = 0;
+
+static void setUp( void )
+{
+	positions = mem_Allocate( sizeof( Vector2 ) * 3 * numTriangles );
+	for( int i = 0; i < 3; ++i ) {
+		tris.x[i] = mem_Allocate( sizeof( float ) * numTriangles );
+		tris.y[i] = mem_Allocate( sizeof( float ) * numTriangles );
+	}
+	tris.camFlags = mem_Allocate( sizeof( uint32_t ) * numTriangles );
+	visible = mem_Allocate( sizeof( uint8_t ) * numTriangles );
+
+	// world camera is scrolled into the middle of the world, the ui camera just covers the screen
+	Matrix4 proj, view;
+	mat4_CreateOrthographicProjection( 0.0f, SCREEN_WIDTH, 0.0f, SCREEN_HEIGHT, -1000.0f, 1000.0f, &proj );
+	mat4_CreateTranslation( -SCREEN_WIDTH, -SCREEN_HEIGHT, 0.0f, &view );
+	mat4_Multiply( &proj, &view, &( vpMatrices[0] ) );
+	vpMatrices[1] = proj;
+
+	for( int i = 0; i < NUM_CAMERAS; ++i ) {
+		triCull_SetupCamera( &( vpMatrices[i] ), cameraFlags[i], &( cullCameras[i] ) );
+	}
+
+	// mostly world sprites with some ui on top
+	rand_Seed( &benchRandom, 0xC011 );
+	for( size_t i = 0; i < numTriangles; ++i ) {
+		bool isUI = ( rand_GetU32( &benchRandom ) % 8 ) == 0;
+		float scale = isUI ? 1.0f : WORLD_SCALE;
+		float baseX = rand_GetRangeFloat( &benchRandom, 0.0f, SCREEN_WIDTH * scale );
+		float baseY = rand_GetRangeFloat( &benchRandom, 0.0f, SCREEN_HEIGHT * scale );
+		for( int v = 0; v < 3; ++v ) {
+			Vector2* pos = &( positions[( i * 3 ) + v] );
+			pos->x = baseX + rand_GetRangeFloat( &benchRandom, -MAX_TRI_SIZE, MAX_TRI_SIZE );
+			pos->y = baseY + rand_GetRangeFloat( &benchRandom, -MAX_TRI_SIZE, MAX_TRI_SIZE );
+			tris.x[v][i] = pos->x;
+			tris.y[v][i] = pos->y;
+		}
+		tris.camFlags[i] = isUI ? UI_CAMERA_FLAGS : WORLD_CAMERA_FLAGS;
+	}
+}
+
+static void tearDown( void )
+{
+	mem_Release( positions );
+	for( int i = 0; i < 3; ++i ) {
+		mem_Release( tris.x[i] );
+		mem_Release( tris.y[i] );
+	}
+	mem_Release( tris.camFlags );
+	mem_Release( visible );
+}
+
+// ***** per triangle, same as addTriangle did before culling was batched
+static size_t perTriangle_Run( void )
+{
+	size_t numVisible = 0;
+	for( size_t it = 0; it < numIterations; ++it ) {
+		for( size_t i = 0; i < numTriangles; ++i ) {
+			bool anyInside = false;
+			for( int c = 0; ( c < NUM_CAMERAS ) && !anyInside; ++c ) {
+				if( cameraFlags[c] & tris.camFlags[i] ) {
+					Vector2 p0, p1, p2;
+					mat4_TransformVec2Pos( &( vpMatrices[c] ), &( positions[( i * 3 ) + 0] ), &p0 );
+					mat4_TransformVec2Pos( &( vpMatrices[c] ), &( positions[( i * 3 ) + 1] ), &p1 );
+					mat4_TransformVec2Pos( &( vpMatrices[c] ), &( positions[( i * 3 ) + 2] ), &p2 );
+					anyInside = triCull_TestTriangle( &p0, &p1, &p2 );
+				}
+			}
+			visible[i] = anyInside ? 1 : 0;
+			numVisible += anyInside ? 1 : 0;
+		}
+	}
+	sink += numVisible;
+	return numTriangles * numIterations;
+}
+
+// ***** batched
+static size_t batched_Run( void )
+{
+	size_t numVisible = 0;
+	for( size_t it = 0; it < numIterations; ++it ) {
+		numVisible += triCull_Cull( cullCameras, NUM_CAMERAS, &tris, numTriangles, visible );
+	}
+	sink += numVisible;
+	return numTriangles * numIterations;
+}
+
+static BenchmarkCase cases[] = {
+	{ "cull per triangle", setUp, perTriangle_Run, tearDown },
+	{ "cull batched", setUp, batched_Run, tearDown },
+};
+
+int main( int argc, char** argv )
+{
+	BenchmarkOptions options;
+	int parseResult = bench_ParseOptions( argc, argv, "triangle renderer culling", &options );
+	if( parseResult != 0 ) {
+		return ( parseResult < 0 ) ? 1 : 0;
+	}
+
+	if( options.count > 0 ) numTriangles = options.count;
+	if( options.iterations > 0 ) numIterations = options.iterations;
+
+	mem_Init( 64 * 1024 * 1024 );
+
+	int result = bench_RunCases( "triCull", cases, ARRAY_SIZE( cases ), &options );
+
+	mem_CleanUp( );
+
+	return result;
+}
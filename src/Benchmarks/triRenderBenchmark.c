@@ -0,0 +1,355 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "benchmarkUtil.h"
+
+#include "../Game/System/memory.h"
+#include "../Game/System/random.h"
+#include "../Game/Graphics/glPlatform.h"
+#include "../Game/Graphics/triRendering.h"
+#include "../Game/Graphics/camera.h"
+#include "../Game/Graphics/scissor.h"
+#include "../Game/Graphics/textureAtlas.h"
+#include "../Game/Utils/helpers.h"
+
+// Headless benchmarks for the whole triangle renderer, built with GL_RECORDER so every GL call is recorded instead of
+//  made. The time is the CPU side cost of adding and rendering a frame, after each case the draw calls, state changes,
+//  and bytes uploaded per frame are reported. Pass -capture file to write the command stream of the first frame of each
+//  case to file.case name.txt so it can be diffed between versions.
+
+#if !defined( GL_RECORDER )
+	#error "The triangle renderer benchmark has to be built with GL_RECORDER defined."
+#endif
+
+#define DEFAULT_NUM_ITEMS 4096
+#define DEFAULT_NUM_ITERATIONS 100
+
+#define SCREEN_WIDTH 800
+#define SCREEN_HEIGHT 600
+#define WORLD_SCALE 2.0f
+#define MAX_ITEM_SIZE 64.0f
+#define NUM_TEXTURES 8
+#define NUM_IMAGES 64
+#define IMAGE_SIZE 32
+
+#define WORLD_CAMERA 0
+#define UI_CAMERA 1
+#define WORLD_CAMERA_FLAGS 0x1
+#define UI_CAMERA_FLAGS 0x2
+
+static size_t numItems = DEFAULT_NUM_ITEMS;
+static size_t numIterations = DEFAULT_NUM_ITERATIONS;
+static const char* captureBaseName = NULL;
+
+typedef struct {
+	TriSprite sprite;
+	GLuint texture;
+	uint32_t camFlags;
+	int8_t depth;
+	int transparent;
+} Item;
+
+static Item* items = NULL;
+static AtlasResult images[NUM_IMAGES];
+static int groupID = -1;
+static const char* currCaseName = "";
+
+static RandomGroup benchRandom;
+
+static void createItems( void )
+{
+	items = mem_Allocate( sizeof( Item ) * numItems );
+
+	// mostly world sprites with some ui on top, a few textures so there's something to batch
+	rand_Seed( &benchRandom, 0x7215 );
+	for( size_t i = 0; i < numItems; ++i ) {
+		Item* item = &( items[i] );
+		bool isUI = ( rand_GetU32( &benchRandom ) % 8 ) == 0;
+		float scale = isUI ? 1.0f : WORLD_SCALE;
+
+		item->sprite.pos.x = rand_GetRangeFloat( &benchRandom, 0.0f, SCREEN_WIDTH * scale );
+		item->sprite.pos.y = rand_GetRangeFloat( &benchRandom, 0.0f, SCREEN_HEIGHT * scale );
+		item->sprite.size.x = rand_GetRangeFloat( &benchRandom, 4.0f, MAX_ITEM_SIZE );
+		item->sprite.size.y = rand_GetRangeFloat( &benchRandom, 4.0f, MAX_ITEM_SIZE );
+		item->sprite.offset = VEC2_ZERO;
+		item->sprite.rotation = rand_GetRangeFloat( &benchRandom, 0.0f, 6.28f );
+		item->sprite.uvMin = VEC2_ZERO;
+		item->sprite.uvMax = VEC2_ONE;
+		item->sprite.col = CLR_WHITE;
+		item->sprite.floatVal0 = 0.0f;
+		item->texture = 1 + ( rand_GetU32( &benchRandom ) % NUM_TEXTURES );
+		item->camFlags = isUI ? UI_CAMERA_FLAGS : WORLD_CAMERA_FLAGS;
+		item->depth = (int8_t)( rand_GetU32( &benchRandom ) % 4 );
+		item->transparent = ( rand_GetU32( &benchRandom ) % 4 ) == 0;
+	}
+}
+
+static void setUp( void )
+{
+	createItems( );
+	triRenderer_Clear( );
+	glRec_ResetStats( );
+}
+
+static void tearDown( void )
+{
+	GLRecStats stats;
+	glRec_GetStats( &stats );
+	if( stats.frames > 0 ) {
+		printf( "  %s per frame: %.1f draw calls, %.1f state changes, %.1f uploads, %.0f bytes uploaded\n", currCaseName,
+			(double)stats.drawCalls / stats.frames, (double)stats.stateChanges / stats.frames,
+			(double)stats.uploads / stats.frames, (double)stats.uploadBytes / stats.frames );
+	}
+
+	mem_Release( items );
+	items = NULL;
+}
+
+static void startFrameCapture( size_t frame )
+{
+	if( ( captureBaseName != NULL ) && ( frame == 0 ) ) {
+		char fileName[256];
+		snprintf( fileName, sizeof( fileName ), "%s.%s.txt", captureBaseName, currCaseName );
+		glRec_StartCapture( fileName );
+	}
+}
+
+static void endFrame( size_t frame )
+{
+	triRenderer_Render( 0.0f );
+	triRenderer_Clear( );
+	glRec_EndFrame( );
+
+	if( ( captureBaseName != NULL ) && ( frame == 0 ) ) {
+		glRec_StopCapture( );
+	}
+}
+
+// ***** sprites
+static size_t renderSprites( void )
+{
+	for( size_t it = 0; it < numIterations; ++it ) {
+		startFrameCapture( it );
+		for( size_t i = 0; i < numItems; ++i ) {
+			Item* item = &( items[i] );
+			triRenderer_AddSprite( &( item->sprite ), ST_DEFAULT, item->texture, 0, item->camFlags, item->depth, item->transparent );
+		}
+		endFrame( it );
+	}
+	return numItems * numIterations;
+}
+
+static size_t sprites_Run( void )
+{
+	currCaseName = "sprites";
+	return renderSprites( );
+}
+
+// ***** tweened sprites, added once per tick and drawn for a couple of frames like when the display runs faster than
+//  the simulation, the time is per tick
+#define FRAMES_PER_TICK 2
+
+static size_t tweenedSprites_Run( void )
+{
+	currCaseName = "tweened sprites";
+	for( size_t it = 0; it < numIterations; ++it ) {
+		startFrameCapture( it );
+		for( size_t i = 0; i < numItems; ++i ) {
+			Item* item = &( items[i] );
+			TriSprite end = item->sprite;
+			end.pos.x += 8.0f;
+			end.rotation += 0.1f;
+			triRenderer_AddTweenedSprite( &( item->sprite ), &end, ST_DEFAULT, item->texture, 0, item->camFlags, item->depth, item->transparent );
+		}
+		triRenderer_FinishTick( );
+
+		for( int f = 1; f <= FRAMES_PER_TICK; ++f ) {
+			triRenderer_ClearFrame( );
+			triRenderer_Render( (float)f / (float)FRAMES_PER_TICK );
+			glRec_EndFrame( );
+		}
+		triRenderer_Clear( );
+
+		if( ( captureBaseName != NULL ) && ( it == 0 ) ) {
+			glRec_StopCapture( );
+		}
+	}
+	return numItems * numIterations;
+}
+
+// ***** triangles, each sprite is split into two triangles like images used to be
+static size_t triangles_Run( void )
+{
+	currCaseName = "triangles";
+	for( size_t it = 0; it < numIterations; ++it ) {
+		startFrameCapture( it );
+		for( size_t i = 0; i < numItems; ++i ) {
+			Item* item = &( items[i] );
+			Vector2 halfSize;
+			vec2_Scale( &( item->sprite.size ), 0.5f, &halfSize );
+			Vector2 pos = item->sprite.pos;
+
+			TriVert verts[4];
+			verts[0] = triVert( vec2( pos.x - halfSize.x, pos.y - halfSize.y ), item->sprite.uvMin, item->sprite.col );
+			verts[1] = triVert( vec2( pos.x - halfSize.x, pos.y + halfSize.y ), vec2( item->sprite.uvMin.x, item->sprite.uvMax.y ), item->sprite.col );
+			verts[2] = triVert( vec2( pos.x + halfSize.x, pos.y - halfSize.y ), vec2( item->sprite.uvMax.x, item->sprite.uvMin.y ), item->sprite.col );
+			verts[3] = triVert( vec2( pos.x + halfSize.x, pos.y + halfSize.y ), item->sprite.uvMax, item->sprite.col );
+
+			triRenderer_Add( verts[0], verts[1], verts[2], ST_DEFAULT, item->texture, 0.0f, 0, item->camFlags, item->depth, item->transparent );
+			triRenderer_Add( verts[1], verts[2], verts[3], ST_DEFAULT, item->texture, 0.0f, 0, item->camFlags, item->depth, item->transparent );
+		}
+		endFrame( it );
+	}
+	return numItems * numIterations;
+}
+
+// ***** group, everything is recorded once and the group is added each frame
+static void group_SetUp( void )
+{
+	setUp( );
+
+	groupID = triRenderer_CreateGroup( );
+	for( size_t i = 0; i < numItems; ++i ) {
+		Item* item = &( items[i] );
+		triRenderer_AddSpriteToGroup( groupID, &( item->sprite ), ST_DEFAULT, item->texture, 0 );
+	}
+}
+
+static void group_TearDown( void )
+{
+	triRenderer_DestroyGroup( groupID );
+	groupID = -1;
+	tearDown( );
+}
+
+static size_t group_Run( void )
+{
+	currCaseName = "group";
+	for( size_t it = 0; it < numIterations; ++it ) {
+		startFrameCapture( it );
+		triRenderer_AddGroup( groupID, VEC2_ZERO, 0, WORLD_CAMERA_FLAGS, 0 );
+		endFrame( it );
+	}
+	return numItems * numIterations;
+}
+
+// ***** images, the items are spread over a larger set of images like the ones loaded by the game, either each with its
+//  own texture or all of them packed into the atlas, to compare how many draw calls the atlas saves
+static void images_SetUp( bool useAtlas )
+{
+	setUp( );
+
+	LoadedImage image;
+	image.width = IMAGE_SIZE;
+	image.height = IMAGE_SIZE;
+	image.reqComp = 4;
+	image.comp = 4;
+	image.flags = LIF_TRANSLUCENCY_KNOWN;
+	image.data = mem_Allocate( IMAGE_SIZE * IMAGE_SIZE * 4 );
+	memset( image.data, 0xFF, IMAGE_SIZE * IMAGE_SIZE * 4 );
+
+	texAtlas_Init( );
+	for( int i = 0; i < NUM_IMAGES; ++i ) {
+		if( !useAtlas || ( texAtlas_Add( &image, &( images[i] ) ) < 0 ) ) {
+			images[i].minUV = VEC2_ZERO;
+			images[i].maxUV = VEC2_ONE;
+			images[i].texture.textureID = (GLuint)( 1 + i );
+		}
+	}
+	mem_Release( image.data );
+
+	for( size_t i = 0; i < numItems; ++i ) {
+		Item* item = &( items[i] );
+		AtlasResult* img = &( images[rand_GetU32( &benchRandom ) % NUM_IMAGES] );
+		item->texture = img->texture.textureID;
+		item->sprite.uvMin = img->minUV;
+		item->sprite.uvMax = img->maxUV;
+	}
+
+	// only count what's done each frame, not copying the images into the pages
+	glRec_ResetStats( );
+}
+
+static void separateImages_SetUp( void )
+{
+	images_SetUp( false );
+}
+
+static void atlasImages_SetUp( void )
+{
+	images_SetUp( true );
+}
+
+static void images_TearDown( void )
+{
+	texAtlas_CleanUp( );
+	tearDown( );
+}
+
+static size_t separateImages_Run( void )
+{
+	currCaseName = "separate images";
+	return renderSprites( );
+}
+
+static size_t atlasImages_Run( void )
+{
+	currCaseName = "atlas images";
+	return renderSprites( );
+}
+
+static BenchmarkCase cases[] = {
+	{ "render sprites", setUp, sprites_Run, tearDown },
+	{ "render tweened sprites", setUp, tweenedSprites_Run, tearDown },
+	{ "render triangles", setUp, triangles_Run, tearDown },
+	{ "render group", group_SetUp, group_Run, group_TearDown },
+	{ "render separate images", separateImages_SetUp, separateImages_Run, images_TearDown },
+	{ "render atlas images", atlasImages_SetUp, atlasImages_Run, images_TearDown },
+};
+
+int main( int argc, char** argv )
+{
+	// pull out the argument only this benchmark uses before handing the rest to the standard parsing
+	int numArgs = 0;
+	for( int i = 0; i < argc; ++i ) {
+		if( ( strcmp( "-capture", argv[i] ) == 0 ) && ( ( i + 1 ) < argc ) ) {
+			captureBaseName = argv[++i];
+		} else {
+			argv[numArgs++] = argv[i];
+		}
+	}
+
+	BenchmarkOptions options;
+	int parseResult = bench_ParseOptions( numArgs, argv, "triangle renderer with recorded GL, -capture file writes out the command streams", &options );
+	if( parseResult != 0 ) {
+		return ( parseResult < 0 ) ? 1 : 0;
+	}
+
+	if( options.count > 0 ) numItems = options.count;
+	if( options.iterations > 0 ) numIterations = options.iterations;
+
+	mem_Init( 64 * 1024 * 1024 );
+
+	glInit( );
+	cam_Init( );
+	cam_SetProjectionMatrices( SCREEN_WIDTH, SCREEN_HEIGHT, false );
+	cam_TurnOnFlags( WORLD_CAMERA, WORLD_CAMERA_FLAGS );
+	cam_TurnOnFlags( UI_CAMERA, UI_CAMERA_FLAGS );
+	cam_SetState( WORLD_CAMERA, vec2( SCREEN_WIDTH * 0.5f, SCREEN_HEIGHT * 0.5f ), 1.0f );
+	// the cameras lerp over the time given here, without it the view projection matrices end up invalid
+	cam_FinalizeStates( 1.0f / 60.0f );
+	cam_Update( 1.0f / 60.0f );
+	scissor_Init( SCREEN_WIDTH, SCREEN_HEIGHT );
+
+	int result = 1;
+	if( triRenderer_Init( SCREEN_WIDTH, SCREEN_HEIGHT ) >= 0 ) {
+		result = bench_RunCases( "triRender", cases, ARRAY_SIZE( cases ), &options );
+	}
+
+	mem_CleanUp( );
+
+	return result;
+}
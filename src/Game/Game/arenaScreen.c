@@ -97,6 +97,10 @@ typedef struct {
 
 static MapTile map[MAP_WIDTH * MAP_HEIGHT];
 
+// the tiles are drawn from a group that's only recorded again when something that changes how they look changes
+static int mapGroup = -1;
+static bool mapGroupDirty = true;
+
 #define DICE_SIDES 6
 #define DICE_SUCCESS 4
 static int rollDicePool( int dice )
@@ -831,6 +835,7 @@ static void setMapImages( )
 			break;
 		}
 	}
+	mapGroupDirty = true;
 }
 
 #define LAKE_CHANCE 0.5f
@@ -1090,6 +1095,7 @@ static void mapVisProcess( )
 		HexGridCoord mapCoord = hex_Flat_RectIndexToCoord( i, MAP_WIDTH, MAP_HEIGHT );
 		map[i].isVisible = isVisible( base, mapCoord, -1 );
 	}
+	mapGroupDirty = true;
 }
 
 #define HEX_SIZE ( 45.0f / 2.0f )
@@ -1097,7 +1103,8 @@ static void mapVisProcess( )
 HexGridCoord lookAtTile = { 0, 0 };
 Vector2 mapOffset = { ( 170.0f + ( 630.0f / 2.0f ) ), ( 430.0f / 2.0f ) };
 
-static Vector2 getDrawPos( HexGridCoord coord )
+// where the origin of the map is drawn
+static Vector2 getMapBasePos( void )
 {
 	Vector2 basePos;
 	if( ( inputType == IT_LOOK ) || ( inputType == IT_AIM ) ) {
@@ -1117,9 +1124,22 @@ static Vector2 getDrawPos( HexGridCoord coord )
 
 	vec2_Subtract( &mapOffset, &basePos, &basePos );
 
-	Vector2 drawPos = hex_Flat_GridToPosition( HEX_SIZE, coord );
-	drawPos.x = (float)( (int)drawPos.x );
-	drawPos.y = (float)( (int)drawPos.y );
+	return basePos;
+}
+
+// position of the tile relative to the origin of the map
+static Vector2 getTileOffset( HexGridCoord coord )
+{
+	Vector2 tilePos = hex_Flat_GridToPosition( HEX_SIZE, coord );
+	tilePos.x = (float)( (int)tilePos.x );
+	tilePos.y = (float)( (int)tilePos.y );
+	return tilePos;
+}
+
+static Vector2 getDrawPos( HexGridCoord coord )
+{
+	Vector2 basePos = getMapBasePos( );
+	Vector2 drawPos = getTileOffset( coord );
 	vec2_Add( &drawPos, &basePos, &drawPos );
 
 	return drawPos;
@@ -1207,21 +1227,12 @@ static bool isVisible( HexGridCoord lookFrom, HexGridCoord target, int32_t maxDi
 	return true;
 }
 
-static void drawMap( )
+static void drawMapTiles( Vector2 basePos )
 {
-	HexGridCoord focus = sbObjects[PLAYER_OBJ_IDX].pos;
-	if( ( inputType == IT_LOOK ) || ( inputType == IT_AIM ) ) {
-		focus = lookAtTile;
-	}
-
-	Vector2 basePos = hex_Flat_GridToPosition( HEX_SIZE, focus );
-	vec2_Subtract( &mapOffset, &basePos, &basePos );
-
-	int numDrawn = 0;
-
 	for( int i = 0; i < ( MAP_WIDTH * MAP_HEIGHT ); ++i ) {
 		HexGridCoord c = hex_Flat_RectIndexToCoord( i, MAP_WIDTH, MAP_HEIGHT );
-		Vector2 pos = getDrawPos( c );
+		Vector2 pos = getTileOffset( c );
+		vec2_Add( &pos, &basePos, &pos );
 
 		float grey = 0.0f;
 		if( !map[i].isVisible ) {
@@ -1234,6 +1245,31 @@ static void drawMap( )
 			img_Draw( smokeImg, GAME_CAMERA_FLAGS, pos, pos, 0 );
 		}
 	}
+}
+
+static void drawMap( )
+{
+	HexGridCoord focus = sbObjects[PLAYER_OBJ_IDX].pos;
+	if( ( inputType == IT_LOOK ) || ( inputType == IT_AIM ) ) {
+		focus = lookAtTile;
+	}
+
+	Vector2 basePos = hex_Flat_GridToPosition( HEX_SIZE, focus );
+	vec2_Subtract( &mapOffset, &basePos, &basePos );
+
+	// the tiles only change when the map or what the player can see changes, so they're recorded into a group and
+	//  only the group is drawn each frame, the group is also cleared if any of the tile images are reloaded
+	if( mapGroup >= 0 ) {
+		if( mapGroupDirty || triRenderer_IsGroupStale( mapGroup ) ) {
+			img_BeginGroup( mapGroup );
+			drawMapTiles( VEC2_ZERO );
+			img_EndGroup( );
+			mapGroupDirty = false;
+		}
+		img_DrawGroup( mapGroup, GAME_CAMERA_FLAGS, getMapBasePos( ), 0 );
+	} else {
+		drawMapTiles( getMapBasePos( ) );
+	}
 
 	if( ( inputType == IT_LOOK ) || ( inputType == IT_AIM ) ) {
 		Vector2 focusPos = hex_Flat_GridToPosition( HEX_SIZE, focus );
@@ -1322,6 +1358,7 @@ static void endPlayerTurn( void )
 	for( size_t i = 0; i < ARRAY_SIZE( map ); ++i ) {
 		if( map[i].smokeLeft > 0 ) {
 			--map[i].smokeLeft;
+			mapGroupDirty = true;
 		}
 	}
 
@@ -1703,6 +1740,7 @@ static void processOverdriveInput( SDL_Keycode symbol )
 			HexGridCoord n = hex_GetNeighbor( sbObjects[PLAYER_OBJ_IDX].pos, i );
 			map[hex_Flat_CoordToRectIndex( n, MAP_WIDTH, MAP_HEIGHT )].smokeLeft = player.smokeDuration;
 		}
+		mapGroupDirty = true;
 		appendToTextBuffer( "You overdrive your smoke screen, giving you some cover." );
 		if( rand_GetNormalizedFloat( NULL ) <= player.smoke.chanceOfDamage ) {
 			appendToTextBuffer( "You've damaged your smoke screen." );
@@ -1987,6 +2025,9 @@ static int arenaScreen_Enter( void )
 
 	drawHelp = false;
 
+	mapGroup = triRenderer_CreateGroup( );
+	mapGroupDirty = true;
+
 	createLevel( );
 
 	snd_PlayStreaming( music, 0.5f, 0.0f );
@@ -1996,6 +2037,11 @@ static int arenaScreen_Enter( void )
 
 static int arenaScreen_Exit( void )
 {
+	if( mapGroup >= 0 ) {
+		triRenderer_DestroyGroup( mapGroup );
+		mapGroup = -1;
+	}
+
 	return 1;
 }
 
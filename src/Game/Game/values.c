@@ -4,6 +4,7 @@
 #include "../UI/text.h"
 #include "../System/platformLog.h"
 #include "../Utils/stretchyBuffer.h"
+#include "../Utils/helpers.h"
 #include "../Graphics/graphics.h"
 #include "../Graphics/images.h"
 #include "../sound.h"
@@ -130,6 +131,15 @@ void initPlayer( void )
 	{ ( id ) = snd_LoadSample( file, 1, false ); if( ( id ) < 0 ) { \
 		llog( LOG_ERROR, "Error loading sample sound file file %s.", file ); return false; } else { llog( LOG_INFO, "Successfully loaded sound %s.", file ); } }
 
+// streamed in the background, the id is valid right away but the placeholder is used until it's loaded
+#define STREAM_AND_TEST_IMG( file, shaderType, priority, id ) \
+	{ ( id ) = img_ThreadedLoad( file, shaderType, priority ); if( ( id ) < 0 ) { \
+		llog( LOG_ERROR, "Error streaming image file %s.", file ); return false; } }
+
+#define STREAM_AND_TEST_SOUND( file, priority, id ) \
+	{ ( id ) = snd_ThreadedLoadSample( file, 1, false, priority ); if( ( id ) < 0 ) { \
+		llog( LOG_ERROR, "Error streaming sample sound file %s.", file ); return false; } }
+
 int playerImg = -1;
 int* sbBoxBorder = NULL;
 int smallTreeImg = -1;
@@ -183,30 +193,26 @@ int fontDisplay = -1;
 
 bool loadAssets( void )
 {
-	int count;
+	// everything needed for the first frame is loaded up front, anything drawn into the map group has to be as well
+	//  since the group keeps whatever was drawn when it was recorded
+	// the sprite sheets are parsed and decoded together on the worker threads
+	SpriteSheetLoad sheets[] = {
+		{ "Images/display_box.ss", ST_DEFAULT, &sbBoxBorder },
+	};
+	if( img_LoadSpriteSheetBatch( sheets, ARRAY_SIZE( sheets ) ) > 0 ) {
+		for( size_t i = 0; i < ARRAY_SIZE( sheets ); ++i ) {
+			if( sheets[i].count < 0 ) {
+				llog( LOG_ERROR, "Error loading sprite sheet file %s.", sheets[i].fileName );
+			}
+		}
+		return false;
+	}
 
 	LOAD_AND_TEST_IMG( "Images/player_mech.png", ST_DEFAULT, playerImg );
-	LOAD_AND_TEST_IMG( "Images/player_mech_dead.png", ST_DEFAULT, playerDeadImg );
-	LOAD_AND_TEST_SS( "Images/display_box.ss", ST_DEFAULT, sbBoxBorder, count );
 	LOAD_AND_TEST_IMG( "Images/small_tree.png", ST_DEFAULT, smallTreeImg );
 	LOAD_AND_TEST_IMG( "Images/small_tree_dead.png", ST_DEFAULT, smallTreeDeadImg );
-	LOAD_AND_TEST_IMG( "Images/projectile.png", ST_DEFAULT, projectileImg );
-	LOAD_AND_TEST_IMG( "Images/shield.png", ST_DEFAULT, shieldImg );
 	LOAD_AND_TEST_IMG( "Images/smoke.png", ST_DEFAULT, smokeImg );
 
-	LOAD_AND_TEST_IMG( "Images/weak_enemy.png", ST_DEFAULT, weakNmyImg );
-	LOAD_AND_TEST_IMG( "Images/weak_enemy_dead.png", ST_DEFAULT, weakNmyDeadImg );
-	LOAD_AND_TEST_IMG( "Images/strong_enemy.png", ST_DEFAULT, strongNmyImg );
-	LOAD_AND_TEST_IMG( "Images/strong_enemy_dead.png", ST_DEFAULT, strongNmyDeadImg );
-	LOAD_AND_TEST_IMG( "Images/armored_enemy.png", ST_DEFAULT, armorNmyImg );
-	LOAD_AND_TEST_IMG( "Images/armored_enemy_dead.png", ST_DEFAULT, armorNmyDeadImg );
-	LOAD_AND_TEST_IMG( "Images/spitter_enemy.png", ST_DEFAULT, rangeNmyImg );
-	LOAD_AND_TEST_IMG( "Images/spitter_enemy_dead.png", ST_DEFAULT, rangeNmyDeadImg );
-	LOAD_AND_TEST_IMG( "Images/explosive_enemy.png", ST_DEFAULT, boomerNmyImg );
-	LOAD_AND_TEST_IMG( "Images/explosive_enemy_dead.png", ST_DEFAULT, boomerNmyDeadImg );
-	LOAD_AND_TEST_IMG( "Images/shrieker_enemy.png", ST_DEFAULT, alarmNmyImg );
-	LOAD_AND_TEST_IMG( "Images/shrieker_enemy_dead.png", ST_DEFAULT, alarmNmyDeadImg );
-
 	LOAD_AND_TEST_IMG( "Images/hex_water.png", ST_DEFAULT, waterTile );
 	LOAD_AND_TEST_IMG( "Images/hex_ground.png", ST_DEFAULT, groundTile );
 	LOAD_AND_TEST_IMG( "Images/hex_hilite.png", ST_DEFAULT, tileHilite );
@@ -226,16 +232,35 @@ bool loadAssets( void )
 
 	LOAD_AND_TEST_MUSIC( "Sounds/bu-puppies-of-the-goats.ogg", music );
 
-	LOAD_AND_TEST_SOUND( "Sounds/broke_player.ogg", playerBreakSnd );
-	LOAD_AND_TEST_SOUND( "Sounds/creature_shoot.ogg", creatureShootSnd );
-	LOAD_AND_TEST_SOUND( "Sounds/dead_creature.ogg", creatureDeadSnd );
-	LOAD_AND_TEST_SOUND( "Sounds/dead_player.ogg", playerDeadSnd );
-	LOAD_AND_TEST_SOUND( "Sounds/explosion.ogg", explosionSnd );
-	LOAD_AND_TEST_SOUND( "Sounds/hurt_creature.ogg", creatureDamageSnd );
-	LOAD_AND_TEST_SOUND( "Sounds/hurt_player.ogg", playerDamageSnd );
-	LOAD_AND_TEST_SOUND( "Sounds/invalid.ogg", invalidSnd );
-	LOAD_AND_TEST_SOUND( "Sounds/player_shoot.ogg", playerShootSnd );
-	LOAD_AND_TEST_SOUND( "Sounds/repair.ogg", playerRepairSnd );
+	// the rest can be streamed in while the game starts, the things that show up soonest first
+	STREAM_AND_TEST_IMG( "Images/weak_enemy.png", ST_DEFAULT, LOAD_PRIORITY_HIGH, weakNmyImg );
+	STREAM_AND_TEST_IMG( "Images/strong_enemy.png", ST_DEFAULT, LOAD_PRIORITY_HIGH, strongNmyImg );
+	STREAM_AND_TEST_IMG( "Images/armored_enemy.png", ST_DEFAULT, LOAD_PRIORITY_HIGH, armorNmyImg );
+	STREAM_AND_TEST_IMG( "Images/spitter_enemy.png", ST_DEFAULT, LOAD_PRIORITY_HIGH, rangeNmyImg );
+	STREAM_AND_TEST_IMG( "Images/explosive_enemy.png", ST_DEFAULT, LOAD_PRIORITY_HIGH, boomerNmyImg );
+	STREAM_AND_TEST_IMG( "Images/shrieker_enemy.png", ST_DEFAULT, LOAD_PRIORITY_HIGH, alarmNmyImg );
+
+	STREAM_AND_TEST_IMG( "Images/projectile.png", ST_DEFAULT, LOAD_PRIORITY_NORMAL, projectileImg );
+	STREAM_AND_TEST_IMG( "Images/shield.png", ST_DEFAULT, LOAD_PRIORITY_NORMAL, shieldImg );
+
+	STREAM_AND_TEST_SOUND( "Sounds/creature_shoot.ogg", LOAD_PRIORITY_NORMAL, creatureShootSnd );
+	STREAM_AND_TEST_SOUND( "Sounds/explosion.ogg", LOAD_PRIORITY_NORMAL, explosionSnd );
+	STREAM_AND_TEST_SOUND( "Sounds/hurt_creature.ogg", LOAD_PRIORITY_NORMAL, creatureDamageSnd );
+	STREAM_AND_TEST_SOUND( "Sounds/hurt_player.ogg", LOAD_PRIORITY_NORMAL, playerDamageSnd );
+	STREAM_AND_TEST_SOUND( "Sounds/invalid.ogg", LOAD_PRIORITY_NORMAL, invalidSnd );
+	STREAM_AND_TEST_SOUND( "Sounds/player_shoot.ogg", LOAD_PRIORITY_NORMAL, playerShootSnd );
+	STREAM_AND_TEST_SOUND( "Sounds/repair.ogg", LOAD_PRIORITY_NORMAL, playerRepairSnd );
+
+	STREAM_AND_TEST_IMG( "Images/player_mech_dead.png", ST_DEFAULT, LOAD_PRIORITY_LOW, playerDeadImg );
+	STREAM_AND_TEST_IMG( "Images/weak_enemy_dead.png", ST_DEFAULT, LOAD_PRIORITY_LOW, weakNmyDeadImg );
+	STREAM_AND_TEST_IMG( "Images/strong_enemy_dead.png", ST_DEFAULT, LOAD_PRIORITY_LOW, strongNmyDeadImg );
+	STREAM_AND_TEST_IMG( "Images/armored_enemy_dead.png", ST_DEFAULT, LOAD_PRIORITY_LOW, armorNmyDeadImg );
+	STREAM_AND_TEST_IMG( "Images/spitter_enemy_dead.png", ST_DEFAULT, LOAD_PRIORITY_LOW, rangeNmyDeadImg );
+	STREAM_AND_TEST_IMG( "Images/explosive_enemy_dead.png", ST_DEFAULT, LOAD_PRIORITY_LOW, boomerNmyDeadImg );
+	STREAM_AND_TEST_IMG( "Images/shrieker_enemy_dead.png", ST_DEFAULT, LOAD_PRIORITY_LOW, alarmNmyDeadImg );
+	STREAM_AND_TEST_SOUND( "Sounds/broke_player.ogg", LOAD_PRIORITY_LOW, playerBreakSnd );
+	STREAM_AND_TEST_SOUND( "Sounds/dead_creature.ogg", LOAD_PRIORITY_LOW, creatureDeadSnd );
+	STREAM_AND_TEST_SOUND( "Sounds/dead_player.ogg", LOAD_PRIORITY_LOW, playerDeadSnd );
 
 	return true;
 }
\ No newline at end of file
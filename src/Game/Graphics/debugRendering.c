@@ -8,6 +8,7 @@
 #include "camera.h"
 #include "shaderManager.h"
 #include "glDebugging.h"
+#include "renderStats.h"
 #include "../System/platformLog.h"
 
 static GLuint debugVAO;
@@ -226,6 +227,7 @@ void debugRenderer_Render( void )
 		GL( glDisable( GL_BLEND ) );
 
 		GL( glUseProgram( debugShaderProgram.programID ) );
+		RSTATS_ADD( shaderBinds, 1 );
 		GL( glBindVertexArray( debugVAO ) );
 
 		// using glGetIntegerv with GL_ARAY_BUFFER_BINDING returns the correct buffer name
@@ -235,6 +237,8 @@ void debugRenderer_Render( void )
 		// or i don't understand OpenGL as well as i think i do (most likely)
 		GL( glBindBuffer( GL_ARRAY_BUFFER, debugVBO ) );
 		GL( glBufferSubData( GL_ARRAY_BUFFER, 0, sizeof( DebugVertex ) * ( lastDebugVert + 1 ), debugBuffer ) );
+		RSTATS_ADD( bytesUploaded, sizeof( DebugVertex ) * ( lastDebugVert + 1 ) );
+		RSTATS_ADD( debugVerts, lastDebugVert + 1 );
 
 		for( int currCamera = cam_StartIteration( ); currCamera != -1; currCamera = cam_GetNextActiveCam( ) ) {
 			unsigned int camFlags = cam_GetFlags( currCamera );
@@ -252,6 +256,8 @@ void debugRenderer_Render( void )
 
 			GL( glBufferSubData( GL_ELEMENT_ARRAY_BUFFER, 0, sizeof( GLuint ) * ( lastDebugIndex + 1 ), debugIndicesBuffer ) );
 			GL( glDrawElements( GL_LINES, lastDebugIndex + 1, GL_UNSIGNED_INT, NULL ) );
+			RSTATS_ADD( bytesUploaded, sizeof( GLuint ) * ( lastDebugIndex + 1 ) );
+			RSTATS_ADD( drawCalls, 1 );
 		}
 
 		GL( glBindVertexArray( 0 ) );
@@ -111,6 +111,9 @@ static void drawGeomTrailTris( GeomTrail* trail, float t )
 	// now generate the trail
 	GLuint textureID;
 	img_GetTextureID( trail->img, &textureID );
+	Vector2 uvMin = VEC2_ZERO;
+	Vector2 uvMax = VEC2_ONE;
+	img_GetUVs( trail->img, &uvMin, &uvMax );
 
 	Vector2 currPos;
 	Vector2 nextPos;
@@ -214,10 +217,13 @@ static void drawGeomTrailTris( GeomTrail* trail, float t )
 		vec2_AddScaled( &( trailRenderGeom[i+1].pos ), &( trailRenderGeom[i+1].norm ), halfWidth1, &(vert2.pos) );
 		vec2_AddScaled( &( trailRenderGeom[i+1].pos ), &( trailRenderGeom[i+1].norm ), -halfWidth1, &(vert3.pos) );
 
-		vert0.uv = vec2( t0, 1.0f );
-		vert1.uv = vec2( t0, 0.0f );
-		vert2.uv = vec2( t1, 1.0f );
-		vert3.uv = vec2( t1, 0.0f );
+		// the image may only be part of the texture
+		float u0 = lerp( uvMin.x, uvMax.x, t0 );
+		float u1 = lerp( uvMin.x, uvMax.x, t1 );
+		vert0.uv = vec2( u0, uvMax.y );
+		vert1.uv = vec2( u0, uvMin.y );
+		vert2.uv = vec2( u1, uvMax.y );
+		vert3.uv = vec2( u1, uvMin.y );
 
 		Color color0;
 		Color color1;
@@ -21,13 +21,17 @@
 #include "glDebugging.h"
 
 #include "../System/platformLog.h"
+#include "textureCache.h"
+#include "../Utils/assetPack.h"
 
 // Clean up anything that was created in a loaded image.
 void gfxUtil_ReleaseLoadedImage( LoadedImage* image )
 {
 	assert( image != NULL );
 
-	stbi_image_free( image->data );
+	if( !( image->flags & LIF_BORROWED_DATA ) ) {
+		stbi_image_free( image->data );
+	}
 }
 
 // Converts the LoadedImage into a texture, putting everything in outTexture. All LoadedImages are assumed to be in RGBA format.
@@ -63,9 +67,15 @@ int gfxUtil_CreateTextureFromLoadedImage( GLenum texFormat, LoadedImage* image,
 	outTexture->height = image->height;
 	outTexture->flags = 0;
 
-	// check to see if there are any translucent pixels in the image
-	for( int i = 3; ( i < ( image->width * image->height ) ) && !( outTexture->flags & TF_IS_TRANSPARENT ); i += 4 ) {
-		if( ( image->data[i] > 0x00 ) && ( image->data[i] < 0xFF ) ) {
+	// check to see if there are any translucent pixels in the image, unless it was already done when it was cached
+	if( image->flags & LIF_TRANSLUCENCY_KNOWN ) {
+		if( image->flags & LIF_IS_TRANSLUCENT ) {
+			outTexture->flags |= TF_IS_TRANSPARENT;
+		}
+	} else {
+		size_t stride = (size_t)image->reqComp;
+		size_t numBytes = (size_t)image->width * (size_t)image->height * stride;
+		if( gfxUtil_HasTranslucentPixels( image->data, numBytes, stride ) ) {
 			outTexture->flags |= TF_IS_TRANSPARENT;
 		}
 	}
@@ -73,6 +83,17 @@ int gfxUtil_CreateTextureFromLoadedImage( GLenum texFormat, LoadedImage* image,
 	return 0;
 }
 
+// Checks to see if any of the pixels are partially transparent, the alpha is assumed to be the last component.
+bool gfxUtil_HasTranslucentPixels( const uint8_t* data, size_t numBytes, size_t stride )
+{
+	for( size_t i = stride - 1; i < numBytes; i += stride ) {
+		if( ( data[i] > 0x00 ) && ( data[i] < 0xFF ) ) {
+			return true;
+		}
+	}
+	return false;
+}
+
 // Loads the data from fileName into outLoadedImage, used as an intermediary between loading and creating a texture.
 //  Returns >= 0 on success, < 0 on failure.
 int gfxUtil_LoadImage( const char* fileName, LoadedImage* outLoadedImage )
@@ -84,6 +105,23 @@ int gfxUtil_LoadImage( const char* fileName, LoadedImage* outLoadedImage )
 
 	outLoadedImage->reqComp = 4;
 	outLoadedImage->data = NULL;
+	outLoadedImage->flags = 0;
+
+	// a pre-decoded copy skips the decoding entirely
+	if( texCache_Load( fileName, outLoadedImage ) ) {
+		return 0;
+	}
+
+	// if it's in the asset pack decode it straight out of there, no need to open or copy anything
+	const uint8_t* packedData;
+	size_t packedSize;
+	if( assetPack_GetFile( fileName, &packedData, &packedSize ) ) {
+		if( gfxUtil_LoadImageFromMemory( packedData, packedSize, outLoadedImage->reqComp, outLoadedImage ) < 0 ) {
+			llog( LOG_INFO, "Unable to load packed image %s!", fileName );
+			return -1;
+		}
+		return 0;
+	}
 
 #if defined( __ANDROID__ )
 	// android has the assets stored in the apk, so we'll have to access that, SDL will handle whether it's a file stored in
@@ -136,6 +174,7 @@ int gfxUtil_LoadImageFromMemory( const uint8_t* data, size_t dataSize, int requi
 	}
 
 	outLoadedImage->reqComp = requiredComponents;
+	outLoadedImage->flags = 0;
 	outLoadedImage->data = stbi_load_from_memory( data, (int)dataSize,
 		&( outLoadedImage->width ), &( outLoadedImage->height ), &( outLoadedImage->comp ), outLoadedImage->reqComp );
 
@@ -172,7 +211,7 @@ int gfxUtil_LoadTexture( const char* fileName, Texture* outTexture )
 
 clean_up:
 	//SDL_FreeSurface( loadSurface );
-	stbi_image_free( image.data );
+	gfxUtil_ReleaseLoadedImage( &image );
 	return returnCode;
 }
 
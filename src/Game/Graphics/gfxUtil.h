@@ -2,6 +2,8 @@
 #define GFX_UTIL_H
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include "../Graphics/glPlatform.h"
 #include "../Math/vector2.h"
 #include <SDL_surface.h>
@@ -24,9 +26,16 @@ typedef struct {
 	Texture texture;
 } AtlasResult;
 
+enum LoadedImageFlags {
+	LIF_TRANSLUCENCY_KNOWN = 0x1, // already checked for translucent pixels, so it doesn't need to be done again
+	LIF_IS_TRANSLUCENT = 0x2,
+	LIF_BORROWED_DATA = 0x4 // data points into something else, like the asset pack, and isn't freed with the image
+};
+
 typedef struct {
 	uint8_t* data;
 	int width, height, reqComp, comp;
+	int flags;
 } LoadedImage;
 
 // Clean up anything that was created in a loaded image.
@@ -36,6 +45,10 @@ void gfxUtil_ReleaseLoadedImage( LoadedImage* image );
 //  Returns >= 0 if everything went fine, < 0 if something went wrong.
 int gfxUtil_CreateTextureFromLoadedImage( GLenum texFormat, LoadedImage* image, Texture* outTexture, GLint filter );
 
+// Checks to see if any of the pixels are partially transparent, the alpha is assumed to be the last component.
+//  Safe to use from the loading threads.
+bool gfxUtil_HasTranslucentPixels( const uint8_t* data, size_t numBytes, size_t stride );
+
 // Loads the data from fileName into outLoadedImage, used as an intermediary between loading and creating a texture.
 //  Returns >= 0 on success, < 0 on failure.
 int gfxUtil_LoadImage( const char* fileName, LoadedImage* outLoadedImage );
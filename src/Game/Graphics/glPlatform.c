@@ -4,7 +4,12 @@
 
 int glInit( void )
 {
-#if defined( WIN32 )
+#if defined( GL_RECORDER )
+	llog( LOG_INFO, "Using the GL recorder, nothing will be drawn." );
+	glRec_Init( );
+	return 0;
+
+#elif defined( WIN32 )
 
 	int loadVal = ogl_LoadFunctions( );
 	if( loadVal == ogl_LOAD_FAILED ) {
@@ -6,7 +6,7 @@
 /*
 Handles the platform specific OpenGL stuff.
 */
-#if defined( __ANDROID__ ) || defined( __EMSCRIPTEN__ )
+#if ( defined( __ANDROID__ ) || defined( __EMSCRIPTEN__ ) ) && !defined( GL_RECORDER )
 
 #include <GLES3/gl3.h>
 #if defined( __EMSCRIPTEN__ )
@@ -36,6 +36,28 @@ Handles the platform specific OpenGL stuff.
 	"	gl_Position = transform * vec4( vVertex, 1.0f );\n" \
 	"}\n"
 
+// expands each instance into a scaled and rotated quad, matches what img_Render used to do on the CPU
+#define SPRITE_VERTEX_SHADER \
+	"#version 300 es\n" \
+	"uniform mat4 transform; // view projection matrix\n" \
+	"layout(location = 0) in vec2 vCorner; // corner of the unit square centered on the origin\n" \
+	"layout(location = 1) in vec4 vPosRot; // x, y, z, rotation\n" \
+	"layout(location = 2) in vec4 vSizeOffset; // width, height, offset x, offset y\n" \
+	"layout(location = 3) in vec4 vColor;\n" \
+	"layout(location = 4) in vec4 vUVRect; // min u, min v, max u, max v\n" \
+	"out vec2 vTex;\n" \
+	"out vec4 vCol;\n" \
+	"void main( void )\n" \
+	"{\n" \
+	"	float c = cos( vPosRot.w );\n" \
+	"	float s = sin( vPosRot.w );\n" \
+	"	vec2 local = ( vCorner * vSizeOffset.xy ) + vSizeOffset.zw;\n" \
+	"	vec2 pos = vec2( ( c * local.x ) - ( s * local.y ), ( s * local.x ) + ( c * local.y ) ) + vPosRot.xy;\n" \
+	"	vTex = mix( vUVRect.xy, vUVRect.zw, vCorner + vec2( 0.5f, 0.5f ) );\n" \
+	"	vCol = vColor;\n" \
+	"	gl_Position = transform * vec4( pos, vPosRot.z, 1.0f );\n" \
+	"}\n"
+
 #define DEFAULT_FRAG_SHADER \
 	"#version 300 es\n" \
 	"in mediump vec2 vTex;\n" \
@@ -118,9 +140,13 @@ Handles the platform specific OpenGL stuff.
 	"	outCol.a = smoothstep( edgeDist - edgeWidth, edgeDist + edgeWidth, dist );\n" \
 	"}\n"
 
-#elif defined( WIN32 )
+#elif defined( WIN32 ) || defined( GL_RECORDER )
 #include "../Others/gl_core.h"
-#include <SDL_opengl.h>
+#if defined( GL_RECORDER )
+	#include "glRecorder.h"
+#else
+	#include <SDL_opengl.h>
+#endif
 
 #define PROFILE SDL_GL_CONTEXT_PROFILE_CORE
 
@@ -140,6 +166,28 @@ Handles the platform specific OpenGL stuff.
 	"	gl_Position = transform * vec4( vVertex, 1.0f );\n" \
 	"}\n"
 
+// expands each instance into a scaled and rotated quad, matches what img_Render used to do on the CPU
+#define SPRITE_VERTEX_SHADER \
+	"#version 330\n" \
+	"uniform mat4 transform; // view projection matrix\n" \
+	"layout(location = 0) in vec2 vCorner; // corner of the unit square centered on the origin\n" \
+	"layout(location = 1) in vec4 vPosRot; // x, y, z, rotation\n" \
+	"layout(location = 2) in vec4 vSizeOffset; // width, height, offset x, offset y\n" \
+	"layout(location = 3) in vec4 vColor;\n" \
+	"layout(location = 4) in vec4 vUVRect; // min u, min v, max u, max v\n" \
+	"out vec2 vTex;\n" \
+	"out vec4 vCol;\n" \
+	"void main( void )\n" \
+	"{\n" \
+	"	float c = cos( vPosRot.w );\n" \
+	"	float s = sin( vPosRot.w );\n" \
+	"	vec2 local = ( vCorner * vSizeOffset.xy ) + vSizeOffset.zw;\n" \
+	"	vec2 pos = vec2( ( c * local.x ) - ( s * local.y ), ( s * local.x ) + ( c * local.y ) ) + vPosRot.xy;\n" \
+	"	vTex = mix( vUVRect.xy, vUVRect.zw, vCorner + vec2( 0.5f, 0.5f ) );\n" \
+	"	vCol = vColor;\n" \
+	"	gl_Position = transform * vec4( pos, vPosRot.z, 1.0f );\n" \
+	"}\n"
+
 #define DEFAULT_FRAG_SHADER \
 	"#version 330\n" \
 	"in vec2 vTex;\n" \
@@ -0,0 +1,606 @@
+#include "glPlatform.h"
+
+#if defined( GL_RECORDER )
+
+#include <assert.h>
+#include <string.h>
+#include <SDL_rwops.h>
+
+#include "../System/memory.h"
+#include "../System/platformLog.h"
+#include "../Utils/stretchyBuffer.h"
+
+typedef enum {
+	CAT_STATE,
+	CAT_UPLOAD,
+	CAT_DRAW,
+	CAT_OBJECT,
+	CAT_QUERY
+} CommandCategory;
+
+static const char* commandNames[] = {
+#define GL_RECORDER_NAME( name ) "gl" #name,
+	GL_RECORDER_COMMANDS( GL_RECORDER_NAME )
+#undef GL_RECORDER_NAME
+};
+
+static GLRecStats stats;
+
+static bool capturing = false;
+static GLRecCommand* sbCommands = NULL;
+static char captureFileName[256];
+
+// every object type gets ids from the same counter, so an id is never reused
+static GLuint nextObjectID = 1;
+static GLint nextUniformLocation = 0;
+static uintptr_t nextSync = 1;
+
+// memory handed out by glMapBufferRange, every mapped buffer shares it since we just need somewhere to write. Buffers
+//  can stay mapped across frames, so if it has to grow while something is still mapped the old memory is kept until
+//  everything is unmapped.
+static void* mapMemory = NULL;
+static size_t mapMemorySize = 0;
+static int numMapped = 0;
+static void** sbRetiredMapMemory = NULL;
+
+static uint32_t floatBits( GLfloat f )
+{
+	uint32_t bits;
+	memcpy( &bits, &f, sizeof( bits ) );
+	return bits;
+}
+
+static uint32_t pointerBits( const void* p )
+{
+	return (uint32_t)( (uintptr_t)p );
+}
+
+static void record( GLRecCommandType type, CommandCategory category, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3, size_t bytes )
+{
+	++stats.commands;
+	switch( category ) {
+	case CAT_STATE:
+		++stats.stateChanges;
+		break;
+	case CAT_UPLOAD:
+		++stats.uploads;
+		stats.uploadBytes += bytes;
+		break;
+	case CAT_DRAW:
+		++stats.drawCalls;
+		break;
+	case CAT_OBJECT:
+		++stats.objectChanges;
+		break;
+	case CAT_QUERY:
+		++stats.queries;
+		break;
+	}
+
+	if( !capturing ) {
+		return;
+	}
+
+	GLRecCommand cmd;
+	cmd.type = type;
+	cmd.args[0] = a0;
+	cmd.args[1] = a1;
+	cmd.args[2] = a2;
+	cmd.args[3] = a3;
+	cmd.bytes = (uint32_t)bytes;
+	sb_Push( sbCommands, cmd );
+}
+
+static void genObjects( GLRecCommandType type, GLsizei n, GLuint* ids )
+{
+	for( GLsizei i = 0; i < n; ++i ) {
+		ids[i] = nextObjectID++;
+	}
+	record( type, CAT_OBJECT, (uint32_t)n, ( n > 0 ) ? ids[0] : 0, 0, 0, 0 );
+}
+
+static void deleteObjects( GLRecCommandType type, GLsizei n, const GLuint* ids )
+{
+	record( type, CAT_OBJECT, (uint32_t)n, ( n > 0 ) ? ids[0] : 0, 0, 0, 0 );
+}
+
+void glRec_Init( void )
+{
+	memset( &stats, 0, sizeof( stats ) );
+	nextObjectID = 1;
+	nextUniformLocation = 0;
+	nextSync = 1;
+}
+
+void glRec_StartCapture( const char* fileName )
+{
+	sb_Clear( sbCommands );
+	capturing = true;
+
+	captureFileName[0] = 0;
+	if( fileName != NULL ) {
+		SDL_strlcpy( captureFileName, fileName, sizeof( captureFileName ) );
+	}
+}
+
+static void writeCapture( void )
+{
+	SDL_RWops* rwopsFile = SDL_RWFromFile( captureFileName, "w" );
+	if( rwopsFile == NULL ) {
+		llog( LOG_ERROR, "Unable to open GL recorder capture file %s: %s", captureFileName, SDL_GetError( ) );
+		return;
+	}
+
+	char line[128];
+	for( size_t i = 0; i < sb_Count( sbCommands ); ++i ) {
+		GLRecCommand* cmd = &( sbCommands[i] );
+		int len = SDL_snprintf( line, sizeof( line ), "%s 0x%x 0x%x 0x%x 0x%x %u\n", commandNames[cmd->type],
+			cmd->args[0], cmd->args[1], cmd->args[2], cmd->args[3], cmd->bytes );
+		SDL_RWwrite( rwopsFile, line, 1, (size_t)len );
+	}
+
+	SDL_RWclose( rwopsFile );
+	llog( LOG_INFO, "Wrote %i GL commands to %s", (int)sb_Count( sbCommands ), captureFileName );
+}
+
+void glRec_StopCapture( void )
+{
+	if( capturing && ( captureFileName[0] != 0 ) ) {
+		writeCapture( );
+	}
+	capturing = false;
+}
+
+const GLRecCommand* glRec_GetCommands( size_t* outCount )
+{
+	assert( outCount != NULL );
+	(*outCount) = sb_Count( sbCommands );
+	return sbCommands;
+}
+
+const char* glRec_GetCommandName( GLRecCommandType type )
+{
+	assert( ( type >= 0 ) && ( type < NUM_GL_RECORDER_COMMANDS ) );
+	return commandNames[type];
+}
+
+void glRec_EndFrame( void )
+{
+	++stats.frames;
+	if( capturing ) {
+		GLRecCommand cmd;
+		memset( &cmd, 0, sizeof( cmd ) );
+		cmd.type = GLRC_FrameMarker;
+		cmd.args[0] = (uint32_t)stats.frames;
+		sb_Push( sbCommands, cmd );
+	}
+}
+
+void glRec_GetStats( GLRecStats* outStats )
+{
+	assert( outStats != NULL );
+	(*outStats) = stats;
+}
+
+void glRec_ResetStats( void )
+{
+	memset( &stats, 0, sizeof( stats ) );
+}
+
+//********** State
+void glRec_ActiveTexture( GLenum texture )
+{
+	record( GLRC_ActiveTexture, CAT_STATE, texture, 0, 0, 0, 0 );
+}
+
+void glRec_AttachShader( GLuint program, GLuint shader )
+{
+	record( GLRC_AttachShader, CAT_STATE, program, shader, 0, 0, 0 );
+}
+
+void glRec_BindBuffer( GLenum target, GLuint buffer )
+{
+	record( GLRC_BindBuffer, CAT_STATE, target, buffer, 0, 0, 0 );
+}
+
+void glRec_BindFramebuffer( GLenum target, GLuint framebuffer )
+{
+	record( GLRC_BindFramebuffer, CAT_STATE, target, framebuffer, 0, 0, 0 );
+}
+
+void glRec_BindRenderbuffer( GLenum target, GLuint renderbuffer )
+{
+	record( GLRC_BindRenderbuffer, CAT_STATE, target, renderbuffer, 0, 0, 0 );
+}
+
+void glRec_BindTexture( GLenum target, GLuint texture )
+{
+	record( GLRC_BindTexture, CAT_STATE, target, texture, 0, 0, 0 );
+}
+
+void glRec_BindVertexArray( GLuint ren_array )
+{
+	record( GLRC_BindVertexArray, CAT_STATE, ren_array, 0, 0, 0, 0 );
+}
+
+void glRec_BlendEquation( GLenum mode )
+{
+	record( GLRC_BlendEquation, CAT_STATE, mode, 0, 0, 0, 0 );
+}
+
+void glRec_BlendFunc( GLenum sfactor, GLenum dfactor )
+{
+	record( GLRC_BlendFunc, CAT_STATE, sfactor, dfactor, 0, 0, 0 );
+}
+
+void glRec_ClearColor( GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha )
+{
+	record( GLRC_ClearColor, CAT_STATE, floatBits( red ), floatBits( green ), floatBits( blue ), floatBits( alpha ), 0 );
+}
+
+void glRec_ColorMask( GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha )
+{
+	record( GLRC_ColorMask, CAT_STATE, red, green, blue, alpha, 0 );
+}
+
+void glRec_CompileShader( GLuint shader )
+{
+	record( GLRC_CompileShader, CAT_STATE, shader, 0, 0, 0, 0 );
+}
+
+void glRec_DepthFunc( GLenum func )
+{
+	record( GLRC_DepthFunc, CAT_STATE, func, 0, 0, 0, 0 );
+}
+
+void glRec_DepthMask( GLboolean flag )
+{
+	record( GLRC_DepthMask, CAT_STATE, flag, 0, 0, 0, 0 );
+}
+
+void glRec_Disable( GLenum cap )
+{
+	record( GLRC_Disable, CAT_STATE, cap, 0, 0, 0, 0 );
+}
+
+void glRec_DrawBuffers( GLsizei n, const GLenum* bufs )
+{
+	record( GLRC_DrawBuffers, CAT_STATE, (uint32_t)n, ( n > 0 ) ? bufs[0] : 0, 0, 0, 0 );
+}
+
+void glRec_Enable( GLenum cap )
+{
+	record( GLRC_Enable, CAT_STATE, cap, 0, 0, 0, 0 );
+}
+
+void glRec_EnableVertexAttribArray( GLuint index )
+{
+	record( GLRC_EnableVertexAttribArray, CAT_STATE, index, 0, 0, 0, 0 );
+}
+
+void glRec_FramebufferRenderbuffer( GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer )
+{
+	record( GLRC_FramebufferRenderbuffer, CAT_STATE, target, attachment, renderbuffertarget, renderbuffer, 0 );
+}
+
+void glRec_LinkProgram( GLuint program )
+{
+	record( GLRC_LinkProgram, CAT_STATE, program, 0, 0, 0, 0 );
+}
+
+void glRec_PixelStorei( GLenum pname, GLint param )
+{
+	record( GLRC_PixelStorei, CAT_STATE, pname, (uint32_t)param, 0, 0, 0 );
+}
+
+void glRec_ReadBuffer( GLenum src )
+{
+	record( GLRC_ReadBuffer, CAT_STATE, src, 0, 0, 0, 0 );
+}
+
+void glRec_Scissor( GLint x, GLint y, GLsizei width, GLsizei height )
+{
+	record( GLRC_Scissor, CAT_STATE, (uint32_t)x, (uint32_t)y, (uint32_t)width, (uint32_t)height, 0 );
+}
+
+void glRec_ShaderSource( GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length )
+{
+	record( GLRC_ShaderSource, CAT_STATE, shader, (uint32_t)count, 0, 0, 0 );
+}
+
+void glRec_TexParameteri( GLenum target, GLenum pname, GLint param )
+{
+	record( GLRC_TexParameteri, CAT_STATE, target, pname, (uint32_t)param, 0, 0 );
+}
+
+void glRec_Uniform1f( GLint location, GLfloat v0 )
+{
+	record( GLRC_Uniform1f, CAT_STATE, (uint32_t)location, floatBits( v0 ), 0, 0, 0 );
+}
+
+void glRec_Uniform1i( GLint location, GLint v0 )
+{
+	record( GLRC_Uniform1i, CAT_STATE, (uint32_t)location, (uint32_t)v0, 0, 0, 0 );
+}
+
+void glRec_UniformMatrix4fv( GLint location, GLsizei count, GLboolean transpose, const GLfloat* value )
+{
+	// the translation is usually what changes between calls, so keep that
+	record( GLRC_UniformMatrix4fv, CAT_STATE, (uint32_t)location, (uint32_t)count, floatBits( value[12] ), floatBits( value[13] ), 0 );
+}
+
+void glRec_UseProgram( GLuint program )
+{
+	record( GLRC_UseProgram, CAT_STATE, program, 0, 0, 0, 0 );
+}
+
+void glRec_VertexAttribDivisor( GLuint index, GLuint divisor )
+{
+	record( GLRC_VertexAttribDivisor, CAT_STATE, index, divisor, 0, 0, 0 );
+}
+
+void glRec_VertexAttribPointer( GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer )
+{
+	record( GLRC_VertexAttribPointer, CAT_STATE, index, (uint32_t)size, (uint32_t)stride, pointerBits( pointer ), 0 );
+}
+
+void glRec_Viewport( GLint x, GLint y, GLsizei width, GLsizei height )
+{
+	record( GLRC_Viewport, CAT_STATE, (uint32_t)x, (uint32_t)y, (uint32_t)width, (uint32_t)height, 0 );
+}
+
+//********** Uploads
+void glRec_BufferData( GLenum target, GLsizeiptr size, const void* data, GLenum usage )
+{
+	// allocating without any data doesn't send anything
+	record( GLRC_BufferData, CAT_UPLOAD, target, (uint32_t)size, usage, 0, ( data != NULL ) ? (size_t)size : 0 );
+}
+
+void glRec_BufferSubData( GLenum target, GLintptr offset, GLsizeiptr size, const void* data )
+{
+	record( GLRC_BufferSubData, CAT_UPLOAD, target, (uint32_t)offset, (uint32_t)size, 0, (size_t)size );
+}
+
+void* glRec_MapBufferRange( GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access )
+{
+	// we assume anything mapped will be written to, so it's counted as an upload
+	record( GLRC_MapBufferRange, CAT_UPLOAD, target, (uint32_t)offset, (uint32_t)length, access, (size_t)length );
+
+	if( (size_t)length > mapMemorySize ) {
+		void* newMem = ( numMapped > 0 ) ? mem_Allocate( (size_t)length ) : mem_Resize( mapMemory, (size_t)length );
+		if( newMem == NULL ) {
+			llog( LOG_ERROR, "Unable to allocate memory for GL recorder buffer mapping." );
+			return NULL;
+		}
+		if( numMapped > 0 ) {
+			sb_Push( sbRetiredMapMemory, mapMemory );
+		}
+		mapMemory = newMem;
+		mapMemorySize = (size_t)length;
+	}
+
+	++numMapped;
+	return mapMemory;
+}
+
+GLboolean glRec_UnmapBuffer( GLenum target )
+{
+	record( GLRC_UnmapBuffer, CAT_STATE, target, 0, 0, 0, 0 );
+
+	if( numMapped > 0 ) {
+		--numMapped;
+	}
+	if( numMapped == 0 ) {
+		for( size_t i = 0; i < sb_Count( sbRetiredMapMemory ); ++i ) {
+			mem_Release( sbRetiredMapMemory[i] );
+		}
+		sb_Clear( sbRetiredMapMemory );
+	}
+
+	return GL_TRUE;
+}
+
+void glRec_TexImage2D( GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels )
+{
+	// close enough for all the formats we use
+	size_t bytesPerPixel = ( format == GL_RED ) ? 1 : ( ( format == GL_RGB ) ? 3 : 4 );
+	size_t bytes = ( pixels != NULL ) ? ( (size_t)width * (size_t)height * bytesPerPixel ) : 0;
+	record( GLRC_TexImage2D, CAT_UPLOAD, target, (uint32_t)width, (uint32_t)height, format, bytes );
+}
+
+void glRec_TexSubImage2D( GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels )
+{
+	size_t bytesPerPixel = ( format == GL_RED ) ? 1 : ( ( format == GL_RGB ) ? 3 : 4 );
+	size_t bytes = ( pixels != NULL ) ? ( (size_t)width * (size_t)height * bytesPerPixel ) : 0;
+	record( GLRC_TexSubImage2D, CAT_UPLOAD, target, (uint32_t)width, (uint32_t)height, format, bytes );
+}
+
+void glRec_RenderbufferStorage( GLenum target, GLenum internalformat, GLsizei width, GLsizei height )
+{
+	record( GLRC_RenderbufferStorage, CAT_OBJECT, target, internalformat, (uint32_t)width, (uint32_t)height, 0 );
+}
+
+//********** Draws
+void glRec_BlitFramebuffer( GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter )
+{
+	record( GLRC_BlitFramebuffer, CAT_DRAW, (uint32_t)( srcX1 - srcX0 ), (uint32_t)( srcY1 - srcY0 ), mask, filter, 0 );
+}
+
+void glRec_Clear( GLbitfield mask )
+{
+	record( GLRC_Clear, CAT_DRAW, mask, 0, 0, 0, 0 );
+}
+
+void glRec_DrawArraysInstanced( GLenum mode, GLint first, GLsizei count, GLsizei instancecount )
+{
+	stats.verticesDrawn += (size_t)count * (size_t)instancecount;
+	record( GLRC_DrawArraysInstanced, CAT_DRAW, mode, (uint32_t)first, (uint32_t)count, (uint32_t)instancecount, 0 );
+}
+
+void glRec_DrawElements( GLenum mode, GLsizei count, GLenum type, const void* indices )
+{
+	stats.verticesDrawn += (size_t)count;
+	record( GLRC_DrawElements, CAT_DRAW, mode, (uint32_t)count, type, pointerBits( indices ), 0 );
+}
+
+//********** Objects
+GLuint glRec_CreateProgram( void )
+{
+	GLuint id = nextObjectID++;
+	record( GLRC_CreateProgram, CAT_OBJECT, id, 0, 0, 0, 0 );
+	return id;
+}
+
+GLuint glRec_CreateShader( GLenum type )
+{
+	GLuint id = nextObjectID++;
+	record( GLRC_CreateShader, CAT_OBJECT, type, id, 0, 0, 0 );
+	return id;
+}
+
+void glRec_DeleteBuffers( GLsizei n, const GLuint* buffers )
+{
+	deleteObjects( GLRC_DeleteBuffers, n, buffers );
+}
+
+void glRec_DeleteFramebuffers( GLsizei n, const GLuint* framebuffers )
+{
+	deleteObjects( GLRC_DeleteFramebuffers, n, framebuffers );
+}
+
+void glRec_DeleteProgram( GLuint program )
+{
+	record( GLRC_DeleteProgram, CAT_OBJECT, program, 0, 0, 0, 0 );
+}
+
+void glRec_DeleteRenderbuffers( GLsizei n, const GLuint* renderbuffers )
+{
+	deleteObjects( GLRC_DeleteRenderbuffers, n, renderbuffers );
+}
+
+void glRec_DeleteShader( GLuint shader )
+{
+	record( GLRC_DeleteShader, CAT_OBJECT, shader, 0, 0, 0, 0 );
+}
+
+void glRec_DeleteSync( GLsync sync )
+{
+	record( GLRC_DeleteSync, CAT_OBJECT, pointerBits( sync ), 0, 0, 0, 0 );
+}
+
+void glRec_DeleteTextures( GLsizei n, const GLuint* textures )
+{
+	deleteObjects( GLRC_DeleteTextures, n, textures );
+}
+
+void glRec_DeleteVertexArrays( GLsizei n, const GLuint* arrays )
+{
+	deleteObjects( GLRC_DeleteVertexArrays, n, arrays );
+}
+
+GLsync glRec_FenceSync( GLenum condition, GLbitfield flags )
+{
+	GLsync sync = (GLsync)( nextSync++ );
+	record( GLRC_FenceSync, CAT_OBJECT, condition, pointerBits( sync ), 0, 0, 0 );
+	return sync;
+}
+
+void glRec_GenBuffers( GLsizei n, GLuint* buffers )
+{
+	genObjects( GLRC_GenBuffers, n, buffers );
+}
+
+void glRec_GenFramebuffers( GLsizei n, GLuint* framebuffers )
+{
+	genObjects( GLRC_GenFramebuffers, n, framebuffers );
+}
+
+void glRec_GenRenderbuffers( GLsizei n, GLuint* renderbuffers )
+{
+	genObjects( GLRC_GenRenderbuffers, n, renderbuffers );
+}
+
+void glRec_GenTextures( GLsizei n, GLuint* textures )
+{
+	genObjects( GLRC_GenTextures, n, textures );
+}
+
+void glRec_GenVertexArrays( GLsizei n, GLuint* arrays )
+{
+	genObjects( GLRC_GenVertexArrays, n, arrays );
+}
+
+//********** Queries, these return whatever lets the caller carry on as if everything worked
+GLenum glRec_CheckFramebufferStatus( GLenum target )
+{
+	record( GLRC_CheckFramebufferStatus, CAT_QUERY, target, 0, 0, 0, 0 );
+	return GL_FRAMEBUFFER_COMPLETE;
+}
+
+GLenum glRec_ClientWaitSync( GLsync sync, GLbitfield flags, GLuint64 timeout )
+{
+	record( GLRC_ClientWaitSync, CAT_QUERY, pointerBits( sync ), flags, 0, 0, 0 );
+	return GL_ALREADY_SIGNALED;
+}
+
+void glRec_GetActiveUniform( GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name )
+{
+	record( GLRC_GetActiveUniform, CAT_QUERY, program, index, 0, 0, 0 );
+	if( length != NULL ) (*length) = 0;
+	if( size != NULL ) (*size) = 0;
+	if( type != NULL ) (*type) = GL_FLOAT;
+	if( ( name != NULL ) && ( bufSize > 0 ) ) name[0] = 0;
+}
+
+GLenum glRec_GetError( void )
+{
+	return GL_NO_ERROR;
+}
+
+void glRec_GetIntegerv( GLenum pname, GLint* data )
+{
+	record( GLRC_GetIntegerv, CAT_QUERY, pname, 0, 0, 0, 0 );
+	switch( pname ) {
+	case GL_MAX_RENDERBUFFER_SIZE:
+	case GL_MAX_TEXTURE_SIZE:
+		(*data) = 16384;
+		break;
+	default:
+		(*data) = 0;
+		break;
+	}
+}
+
+void glRec_GetProgramiv( GLuint program, GLenum pname, GLint* params )
+{
+	record( GLRC_GetProgramiv, CAT_QUERY, program, pname, 0, 0, 0 );
+	(*params) = ( pname == GL_LINK_STATUS ) ? GL_TRUE : 0;
+}
+
+void glRec_GetShaderInfoLog( GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog )
+{
+	record( GLRC_GetShaderInfoLog, CAT_QUERY, shader, 0, 0, 0, 0 );
+	if( length != NULL ) (*length) = 0;
+	if( ( infoLog != NULL ) && ( bufSize > 0 ) ) infoLog[0] = 0;
+}
+
+void glRec_GetShaderiv( GLuint shader, GLenum pname, GLint* params )
+{
+	record( GLRC_GetShaderiv, CAT_QUERY, shader, pname, 0, 0, 0 );
+	(*params) = ( pname == GL_COMPILE_STATUS ) ? GL_TRUE : 0;
+}
+
+GLint glRec_GetUniformLocation( GLuint program, const GLchar* name )
+{
+	GLint location = nextUniformLocation++;
+	record( GLRC_GetUniformLocation, CAT_QUERY, program, (uint32_t)location, 0, 0, 0 );
+	return location;
+}
+
+GLboolean glRec_IsShader( GLuint shader )
+{
+	record( GLRC_IsShader, CAT_QUERY, shader, 0, 0, 0, 0 );
+	return ( shader != 0 ) ? GL_TRUE : GL_FALSE;
+}
+
+#endif /* GL_RECORDER */
@@ -0,0 +1,341 @@
+#ifndef GL_RECORDER_H
+#define GL_RECORDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+Headless stand in for OpenGL, used when built with GL_RECORDER defined. Every GL function the game uses is replaced
+ with one that records the call instead of making it, so the renderer can be run and measured without a window or a
+ GPU. Nothing is drawn, objects are just handed out ids and queries return values that let everything keep going.
+The stats are always kept, the full command stream is only kept while capturing. The command stream can be written
+ out as text so runs can be diffed against each other.
+Only included by glPlatform.h after gl_core.h, so the GL types and enums are the same as the desktop build.
+*/
+
+// every GL function the recorder replaces
+#define GL_RECORDER_COMMANDS( X ) \
+	X( ActiveTexture ) \
+	X( AttachShader ) \
+	X( BindBuffer ) \
+	X( BindFramebuffer ) \
+	X( BindRenderbuffer ) \
+	X( BindTexture ) \
+	X( BindVertexArray ) \
+	X( BlendEquation ) \
+	X( BlendFunc ) \
+	X( BlitFramebuffer ) \
+	X( BufferData ) \
+	X( BufferSubData ) \
+	X( CheckFramebufferStatus ) \
+	X( Clear ) \
+	X( ClearColor ) \
+	X( ClientWaitSync ) \
+	X( ColorMask ) \
+	X( CompileShader ) \
+	X( CreateProgram ) \
+	X( CreateShader ) \
+	X( DeleteBuffers ) \
+	X( DeleteFramebuffers ) \
+	X( DeleteProgram ) \
+	X( DeleteRenderbuffers ) \
+	X( DeleteShader ) \
+	X( DeleteSync ) \
+	X( DeleteTextures ) \
+	X( DeleteVertexArrays ) \
+	X( DepthFunc ) \
+	X( DepthMask ) \
+	X( Disable ) \
+	X( DrawArraysInstanced ) \
+	X( DrawBuffers ) \
+	X( DrawElements ) \
+	X( Enable ) \
+	X( EnableVertexAttribArray ) \
+	X( FenceSync ) \
+	X( FramebufferRenderbuffer ) \
+	X( GenBuffers ) \
+	X( GenFramebuffers ) \
+	X( GenRenderbuffers ) \
+	X( GenTextures ) \
+	X( GenVertexArrays ) \
+	X( GetActiveUniform ) \
+	X( GetError ) \
+	X( GetIntegerv ) \
+	X( GetProgramiv ) \
+	X( GetShaderInfoLog ) \
+	X( GetShaderiv ) \
+	X( GetUniformLocation ) \
+	X( IsShader ) \
+	X( LinkProgram ) \
+	X( MapBufferRange ) \
+	X( PixelStorei ) \
+	X( ReadBuffer ) \
+	X( RenderbufferStorage ) \
+	X( Scissor ) \
+	X( ShaderSource ) \
+	X( TexImage2D ) \
+	X( TexParameteri ) \
+	X( TexSubImage2D ) \
+	X( Uniform1f ) \
+	X( Uniform1i ) \
+	X( UniformMatrix4fv ) \
+	X( UnmapBuffer ) \
+	X( UseProgram ) \
+	X( VertexAttribDivisor ) \
+	X( VertexAttribPointer ) \
+	X( Viewport ) \
+	X( FrameMarker )
+
+typedef enum {
+#define GL_RECORDER_ENUM( name ) GLRC_##name,
+	GL_RECORDER_COMMANDS( GL_RECORDER_ENUM )
+#undef GL_RECORDER_ENUM
+	NUM_GL_RECORDER_COMMANDS
+} GLRecCommandType;
+
+typedef struct {
+	GLRecCommandType type;
+	uint32_t args[4]; // the first few arguments of the call, floats are stored as their bits so they compare exactly
+	uint32_t bytes; // how much data the call sent to the GPU
+} GLRecCommand;
+
+typedef struct {
+	int frames;
+	int commands;
+	int drawCalls;
+	int stateChanges; // binds, enables, uniforms, and anything else that changes how things are drawn
+	int uploads;
+	int objectChanges; // objects created or destroyed
+	int queries;
+	size_t uploadBytes;
+	size_t verticesDrawn; // vertices or indices for each draw, multiplied by the number of instances
+} GLRecStats;
+
+void glRec_Init( void );
+
+// starts keeping every command in memory, if fileName isn't NULL they're written to it as text when the capture stops
+void glRec_StartCapture( const char* fileName );
+void glRec_StopCapture( void );
+
+// the commands recorded since the capture was started
+const GLRecCommand* glRec_GetCommands( size_t* outCount );
+const char* glRec_GetCommandName( GLRecCommandType type );
+
+// adds a marker between frames to the command stream, and counts the frame in the stats
+void glRec_EndFrame( void );
+
+void glRec_GetStats( GLRecStats* outStats );
+void glRec_ResetStats( void );
+
+// gl_core.h defines these as the loaded function pointers, point them at the recorder instead
+#undef glActiveTexture
+#define glActiveTexture glRec_ActiveTexture
+#undef glAttachShader
+#define glAttachShader glRec_AttachShader
+#undef glBindBuffer
+#define glBindBuffer glRec_BindBuffer
+#undef glBindFramebuffer
+#define glBindFramebuffer glRec_BindFramebuffer
+#undef glBindRenderbuffer
+#define glBindRenderbuffer glRec_BindRenderbuffer
+#undef glBindTexture
+#define glBindTexture glRec_BindTexture
+#undef glBindVertexArray
+#define glBindVertexArray glRec_BindVertexArray
+#undef glBlendEquation
+#define glBlendEquation glRec_BlendEquation
+#undef glBlendFunc
+#define glBlendFunc glRec_BlendFunc
+#undef glBlitFramebuffer
+#define glBlitFramebuffer glRec_BlitFramebuffer
+#undef glBufferData
+#define glBufferData glRec_BufferData
+#undef glBufferSubData
+#define glBufferSubData glRec_BufferSubData
+#undef glCheckFramebufferStatus
+#define glCheckFramebufferStatus glRec_CheckFramebufferStatus
+#undef glClear
+#define glClear glRec_Clear
+#undef glClearColor
+#define glClearColor glRec_ClearColor
+#undef glClientWaitSync
+#define glClientWaitSync glRec_ClientWaitSync
+#undef glColorMask
+#define glColorMask glRec_ColorMask
+#undef glCompileShader
+#define glCompileShader glRec_CompileShader
+#undef glCreateProgram
+#define glCreateProgram glRec_CreateProgram
+#undef glCreateShader
+#define glCreateShader glRec_CreateShader
+#undef glDeleteBuffers
+#define glDeleteBuffers glRec_DeleteBuffers
+#undef glDeleteFramebuffers
+#define glDeleteFramebuffers glRec_DeleteFramebuffers
+#undef glDeleteProgram
+#define glDeleteProgram glRec_DeleteProgram
+#undef glDeleteRenderbuffers
+#define glDeleteRenderbuffers glRec_DeleteRenderbuffers
+#undef glDeleteShader
+#define glDeleteShader glRec_DeleteShader
+#undef glDeleteSync
+#define glDeleteSync glRec_DeleteSync
+#undef glDeleteTextures
+#define glDeleteTextures glRec_DeleteTextures
+#undef glDeleteVertexArrays
+#define glDeleteVertexArrays glRec_DeleteVertexArrays
+#undef glDepthFunc
+#define glDepthFunc glRec_DepthFunc
+#undef glDepthMask
+#define glDepthMask glRec_DepthMask
+#undef glDisable
+#define glDisable glRec_Disable
+#undef glDrawArraysInstanced
+#define glDrawArraysInstanced glRec_DrawArraysInstanced
+#undef glDrawBuffers
+#define glDrawBuffers glRec_DrawBuffers
+#undef glDrawElements
+#define glDrawElements glRec_DrawElements
+#undef glEnable
+#define glEnable glRec_Enable
+#undef glEnableVertexAttribArray
+#define glEnableVertexAttribArray glRec_EnableVertexAttribArray
+#undef glFenceSync
+#define glFenceSync glRec_FenceSync
+#undef glFramebufferRenderbuffer
+#define glFramebufferRenderbuffer glRec_FramebufferRenderbuffer
+#undef glGenBuffers
+#define glGenBuffers glRec_GenBuffers
+#undef glGenFramebuffers
+#define glGenFramebuffers glRec_GenFramebuffers
+#undef glGenRenderbuffers
+#define glGenRenderbuffers glRec_GenRenderbuffers
+#undef glGenTextures
+#define glGenTextures glRec_GenTextures
+#undef glGenVertexArrays
+#define glGenVertexArrays glRec_GenVertexArrays
+#undef glGetActiveUniform
+#define glGetActiveUniform glRec_GetActiveUniform
+#undef glGetError
+#define glGetError glRec_GetError
+#undef glGetIntegerv
+#define glGetIntegerv glRec_GetIntegerv
+#undef glGetProgramiv
+#define glGetProgramiv glRec_GetProgramiv
+#undef glGetShaderInfoLog
+#define glGetShaderInfoLog glRec_GetShaderInfoLog
+#undef glGetShaderiv
+#define glGetShaderiv glRec_GetShaderiv
+#undef glGetUniformLocation
+#define glGetUniformLocation glRec_GetUniformLocation
+#undef glIsShader
+#define glIsShader glRec_IsShader
+#undef glLinkProgram
+#define glLinkProgram glRec_LinkProgram
+#undef glMapBufferRange
+#define glMapBufferRange glRec_MapBufferRange
+#undef glPixelStorei
+#define glPixelStorei glRec_PixelStorei
+#undef glReadBuffer
+#define glReadBuffer glRec_ReadBuffer
+#undef glRenderbufferStorage
+#define glRenderbufferStorage glRec_RenderbufferStorage
+#undef glScissor
+#define glScissor glRec_Scissor
+#undef glShaderSource
+#define glShaderSource glRec_ShaderSource
+#undef glTexImage2D
+#define glTexImage2D glRec_TexImage2D
+#undef glTexParameteri
+#define glTexParameteri glRec_TexParameteri
+#undef glTexSubImage2D
+#define glTexSubImage2D glRec_TexSubImage2D
+#undef glUniform1f
+#define glUniform1f glRec_Uniform1f
+#undef glUniform1i
+#define glUniform1i glRec_Uniform1i
+#undef glUniformMatrix4fv
+#define glUniformMatrix4fv glRec_UniformMatrix4fv
+#undef glUnmapBuffer
+#define glUnmapBuffer glRec_UnmapBuffer
+#undef glUseProgram
+#define glUseProgram glRec_UseProgram
+#undef glVertexAttribDivisor
+#define glVertexAttribDivisor glRec_VertexAttribDivisor
+#undef glVertexAttribPointer
+#define glVertexAttribPointer glRec_VertexAttribPointer
+#undef glViewport
+#define glViewport glRec_Viewport
+
+void glRec_ActiveTexture( GLenum texture );
+void glRec_AttachShader( GLuint program, GLuint shader );
+void glRec_BindBuffer( GLenum target, GLuint buffer );
+void glRec_BindFramebuffer( GLenum target, GLuint framebuffer );
+void glRec_BindRenderbuffer( GLenum target, GLuint renderbuffer );
+void glRec_BindTexture( GLenum target, GLuint texture );
+void glRec_BindVertexArray( GLuint ren_array );
+void glRec_BlendEquation( GLenum mode );
+void glRec_BlendFunc( GLenum sfactor, GLenum dfactor );
+void glRec_BlitFramebuffer( GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter );
+void glRec_BufferData( GLenum target, GLsizeiptr size, const void* data, GLenum usage );
+void glRec_BufferSubData( GLenum target, GLintptr offset, GLsizeiptr size, const void* data );
+GLenum glRec_CheckFramebufferStatus( GLenum target );
+void glRec_Clear( GLbitfield mask );
+void glRec_ClearColor( GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha );
+GLenum glRec_ClientWaitSync( GLsync sync, GLbitfield flags, GLuint64 timeout );
+void glRec_ColorMask( GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha );
+void glRec_CompileShader( GLuint shader );
+GLuint glRec_CreateProgram( void );
+GLuint glRec_CreateShader( GLenum type );
+void glRec_DeleteBuffers( GLsizei n, const GLuint* buffers );
+void glRec_DeleteFramebuffers( GLsizei n, const GLuint* framebuffers );
+void glRec_DeleteProgram( GLuint program );
+void glRec_DeleteRenderbuffers( GLsizei n, const GLuint* renderbuffers );
+void glRec_DeleteShader( GLuint shader );
+void glRec_DeleteSync( GLsync sync );
+void glRec_DeleteTextures( GLsizei n, const GLuint* textures );
+void glRec_DeleteVertexArrays( GLsizei n, const GLuint* arrays );
+void glRec_DepthFunc( GLenum func );
+void glRec_DepthMask( GLboolean flag );
+void glRec_Disable( GLenum cap );
+void glRec_DrawArraysInstanced( GLenum mode, GLint first, GLsizei count, GLsizei instancecount );
+void glRec_DrawBuffers( GLsizei n, const GLenum* bufs );
+void glRec_DrawElements( GLenum mode, GLsizei count, GLenum type, const void* indices );
+void glRec_Enable( GLenum cap );
+void glRec_EnableVertexAttribArray( GLuint index );
+GLsync glRec_FenceSync( GLenum condition, GLbitfield flags );
+void glRec_FramebufferRenderbuffer( GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer );
+void glRec_GenBuffers( GLsizei n, GLuint* buffers );
+void glRec_GenFramebuffers( GLsizei n, GLuint* framebuffers );
+void glRec_GenRenderbuffers( GLsizei n, GLuint* renderbuffers );
+void glRec_GenTextures( GLsizei n, GLuint* textures );
+void glRec_GenVertexArrays( GLsizei n, GLuint* arrays );
+void glRec_GetActiveUniform( GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name );
+GLenum glRec_GetError( void );
+void glRec_GetIntegerv( GLenum pname, GLint* data );
+void glRec_GetProgramiv( GLuint program, GLenum pname, GLint* params );
+void glRec_GetShaderInfoLog( GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog );
+void glRec_GetShaderiv( GLuint shader, GLenum pname, GLint* params );
+GLint glRec_GetUniformLocation( GLuint program, const GLchar* name );
+GLboolean glRec_IsShader( GLuint shader );
+void glRec_LinkProgram( GLuint program );
+void* glRec_MapBufferRange( GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access );
+void glRec_PixelStorei( GLenum pname, GLint param );
+void glRec_ReadBuffer( GLenum src );
+void glRec_RenderbufferStorage( GLenum target, GLenum internalformat, GLsizei width, GLsizei height );
+void glRec_Scissor( GLint x, GLint y, GLsizei width, GLsizei height );
+void glRec_ShaderSource( GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length );
+void glRec_TexImage2D( GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels );
+void glRec_TexParameteri( GLenum target, GLenum pname, GLint param );
+void glRec_TexSubImage2D( GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels );
+void glRec_Uniform1f( GLint location, GLfloat v0 );
+void glRec_Uniform1i( GLint location, GLint v0 );
+void glRec_UniformMatrix4fv( GLint location, GLsizei count, GLboolean transpose, const GLfloat* value );
+GLboolean glRec_UnmapBuffer( GLenum target );
+void glRec_UseProgram( GLuint program );
+void glRec_VertexAttribDivisor( GLuint index, GLuint divisor );
+void glRec_VertexAttribPointer( GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer );
+void glRec_Viewport( GLint x, GLint y, GLsizei width, GLsizei height );
+
+#endif /* inclusion guard */
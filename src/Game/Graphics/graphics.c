@@ -13,10 +13,13 @@
 #include "shaderManager.h"
 
 #include "images.h"
+#include "textureUpload.h"
+#include "textureAtlas.h"
 #include "debugRendering.h"
 #include "spineGfx.h"
 #include "triRendering.h"
 #include "scissor.h"
+#include "renderStats.h"
 
 #include "../IMGUI/nuklearWrapper.h"
 
@@ -30,6 +33,7 @@ static SDL_GLContext glContext;
 
 static float currentTime;
 static float endTime;
+static bool tickSubmitNeeded = false; // set when there's a new tick's worth of things to draw
 
 // both the clear colors default to black
 static Color gameClearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
@@ -152,6 +156,11 @@ int gfx_Init( SDL_Window* window, int desiredRenderWidth, int desiredRenderHeigh
 	}
 	llog( LOG_INFO, "Images initialized." );
 
+	if( texUpload_Init( ) < 0 ) {
+		return -1;
+	}
+	llog( LOG_INFO, "Texture uploads initialized." );
+
 	if( debugRenderer_Init( ) < 0 ) {
 		return -1;
 	}
@@ -217,8 +226,18 @@ void gfx_GetRenderSize( int* renderWidthOut, int* renderHeightOut )
 
 void gfx_CleanUp( void )
 {
+	// may be called before the context was created if the start up failed
+	if( glContext == NULL ) {
+		return;
+	}
+
+	texUpload_CleanUp( );
+	texAtlas_CleanUp( );
 	GL( glDeleteRenderbuffers( RBO_COUNT, &( mainRenderRBOs[0] ) ) ); 
 	GL( glDeleteFramebuffers( 1, &mainRenderFBO ) );
+
+	SDL_GL_DeleteContext( glContext );
+	glContext = NULL;
 }
 
 /*
@@ -252,6 +271,33 @@ void gfx_ClearDrawCommands( float timeToEnd )
 	
 	endTime = timeToEnd;
 	currentTime = 0.0f;
+	tickSubmitNeeded = true;
+}
+
+// draw all the stuff that routes through the triangle rendering, the images and spine instances are only added once
+//  per tick with where they start and end, the triangle renderer interpolates between them for each frame
+static void renderTriangles( float t )
+{
+	if( tickSubmitNeeded ) {
+		tickSubmitNeeded = false;
+
+		spine_UpdateInstances( endTime );
+
+		triRenderer_Clear( );
+			img_Render( );
+			spine_RenderInstances( );
+		triRenderer_FinishTick( );
+
+		spine_FlipInstancePositions( );
+	}
+
+	// anything these add is regenerated every frame
+	triRenderer_ClearFrame( );
+	for( size_t i = 0; i < sb_Count( sbAdditionalDrawFuncs ); ++i ) {
+		sbAdditionalDrawFuncs[i]( t );
+	}
+
+	triRenderer_Render( t );
 }
 
 static void dynamicSizeRender( float dt, float t )
@@ -267,18 +313,7 @@ static void dynamicSizeRender( float dt, float t )
 		GL( glColorMask( GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE ) );
 		GL( glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT ) );
 
-		spine_UpdateInstances( dt );
-		spine_FlipInstancePositions( );
-	
-		// draw all the stuff that routes through the triangle rendering
-		triRenderer_Clear( );
-			img_Render( t );
-			spine_RenderInstances( t );
-
-			for( size_t i = 0; i < sb_Count( sbAdditionalDrawFuncs ); ++i ) {
-				sbAdditionalDrawFuncs[i]( t );
-			}
-		triRenderer_Render( );
+		renderTriangles( t );
 
 		// in game ui stuff
 		//  note: this sets the glViewport, so if the render width and height of the imgui instance doesn't match the
@@ -315,18 +350,7 @@ static void staticSizeRender( float dt, float t )
 	glColorMask( GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE );
 	glClear( GL_COLOR_BUFFER_BIT );
 
-	spine_UpdateInstances( dt );
-	spine_FlipInstancePositions( );
-	
-	// draw all the stuff that routes through the triangle rendering
-	triRenderer_Clear( );
-		img_Render( t );
-		spine_RenderInstances( t );
-
-		for( size_t i = 0; i < sb_Count( sbAdditionalDrawFuncs ); ++i ) {
-			sbAdditionalDrawFuncs[i]( t );
-		}
-	triRenderer_Render( );
+	renderTriangles( t );
 
 	// now draw all the debug stuff over everything
 	debugRenderer_Render( );
@@ -347,6 +371,8 @@ void gfx_Render( float dt )
 #else
 	dynamicSizeRender( dt, t );
 #endif
+
+	rstats_EndFrame( );
 }
 
 void gfx_AddDrawTrisFunc( GfxDrawTrisFunc newFunc )
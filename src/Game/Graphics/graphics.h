@@ -16,6 +16,11 @@ Initial setup for the rendering instruction buffer.
 */
 int gfx_Init( SDL_Window* window, int renderWidth, int renderHeight );
 
+/*
+Frees up everything created on the GPU and destroys the context, has to be called before the window is destroyed.
+*/
+void gfx_CleanUp( void );
+
 /*
 Resizes everything for the specified window size. Used to calculate render area.
 */
@@ -47,7 +52,9 @@ Resets the render buffer.
 */
 void gfx_Render( float deltaTime );
 
-// Used to add additional calls to pass triangles to be rendered.
+// Used to add additional calls to pass triangles to be rendered. These are called every frame and anything they add is
+//  only drawn for that frame, things that can be added once per tick with where they start and end should do that
+//  instead.
 void gfx_AddDrawTrisFunc( GfxDrawTrisFunc newFunc );
 void gfx_RemoveDrawTrisFunc( GfxDrawTrisFunc oldFunc );
 
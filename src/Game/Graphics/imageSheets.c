@@ -1,25 +1,268 @@
 #include "imageSheets.h"
 
 #include <SDL_rwops.h>
+#include <assert.h>
 #include <ctype.h>
 #include <string.h>
 #include <stdlib.h>
 
 #include "images.h"
 #include "gfxUtil.h"
+#include "glDebugging.h"
+#include "spriteSheetFormat.h"
 
 #include "../Utils/stretchyBuffer.h"
 #include "../System/platformLog.h"
+#include "../System/memory.h"
 #include "../Utils/helpers.h"
+#include "../Utils/assetPack.h"
+#include "../Utils/mappedFile.h"
+#include "../Utils/tokenizer.h"
+#include "../Utils/symbols.h"
+#include "../System/fileWatcher.h"
 
-// TODO: Convert this from a text format to binary.
+typedef struct {
+	char imageFileName[256];
+	Vector2* sbMins;
+	Vector2* sbMaxes;
+	Symbol* sbIDs;
+} SheetDefinition;
 
-typedef enum {
-	RS_VERSION,
-	RS_FILENAME,
-	RS_SPRITES,
-	RS_FINISHED
-} ReadState;
+static void cleanUpSheetDefinition( SheetDefinition* definition )
+{
+	sb_Release( definition->sbMins );
+	sb_Release( definition->sbMaxes );
+	sb_Release( definition->sbIDs );
+}
+
+// the image file name is relative to the sheet, so replace the sheet's file name with it
+static void setImageFileName( const char* fileName, StringSlice imageName, SheetDefinition* outDefinition )
+{
+	size_t dirLen = 0;
+	const char* fileNameLoc = SDL_strrchr( fileName, '/' );
+	if( fileNameLoc != NULL ) {
+		dirLen = (size_t)( fileNameLoc - fileName ) + 1;
+		if( dirLen >= ARRAY_SIZE( outDefinition->imageFileName ) ) {
+			dirLen = ARRAY_SIZE( outDefinition->imageFileName ) - 1;
+		}
+		memcpy( outDefinition->imageFileName, fileName, dirLen );
+	}
+
+	tok_Copy( imageName, outDefinition->imageFileName + dirLen, ARRAY_SIZE( outDefinition->imageFileName ) - dirLen );
+}
+
+static void addSprite( SheetDefinition* definition, Symbol id, int x, int y, int w, int h )
+{
+	Vector2 min, max;
+	min.x = (float)x;
+	min.y = (float)y;
+	max.x = min.x + (float)w;
+	max.y = min.y + (float)h;
+
+	sb_Push( definition->sbIDs, id );
+	sb_Push( definition->sbMins, min );
+	sb_Push( definition->sbMaxes, max );
+}
+
+/*
+Reads the text version of the definition.
+ format version 2
+  image file name
+  spriteID rect.x rect.y rect.w rect.h
+  final blank line
+*/
+static bool parseTextSheet( const char* fileName, const MappedFile* file, SheetDefinition* outDefinition )
+{
+	Tokenizer tok;
+	tok_Init( &tok, (const char*)file->data, file->size );
+
+	// there's only the one version to read for now
+	StringSlice line;
+	if( !tok_NextLine( &tok, &line ) || !tok_NextLine( &tok, &line ) ) {
+		llog( LOG_ERROR, "Missing image file name in sprite sheet definition file: %s", fileName );
+		return false;
+	}
+	setImageFileName( fileName, tok_Trim( line ), outDefinition );
+
+	while( tok_NextLine( &tok, &line ) ) {
+		StringSlice rest = line;
+		StringSlice id, x, y, w, h;
+		int rect[4];
+		if( !tok_NextToken( &rest, " \t", &id ) ||
+			!tok_NextToken( &rest, " \t", &x ) || !tok_ToInt( x, &( rect[0] ) ) ||
+			!tok_NextToken( &rest, " \t", &y ) || !tok_ToInt( y, &( rect[1] ) ) ||
+			!tok_NextToken( &rest, " \t", &w ) || !tok_ToInt( w, &( rect[2] ) ) ||
+			!tok_NextToken( &rest, " \t", &h ) || !tok_ToInt( h, &( rect[3] ) ) ) {
+			llog( LOG_ERROR, "Invalid sprite definition \"%.*s\" in sprite sheet definition file: %s", (int)line.length, line.start, fileName );
+			return false;
+		}
+
+		addSprite( outDefinition, sym_InternSlice( id.start, id.length ), rect[0], rect[1], rect[2], rect[3] );
+	}
+
+	return true;
+}
+
+/*
+Reads the binary version of the definition built by the SheetCompiler tool, see spriteSheetFormat.h. If the text
+ version is around the binary is only used if it was built from it.
+ Returns false if there's no binary version or it can't be used, the text should be parsed instead.
+*/
+static bool loadBinarySheet( const char* fileName, const MappedFile* textFile, SheetDefinition* outDefinition )
+{
+	char binFileName[256];
+	if( SDL_snprintf( binFileName, sizeof( binFileName ), "%s%s", fileName, SHEET_BIN_EXTENSION ) >= (int)sizeof( binFileName ) ) {
+		return false;
+	}
+
+	MappedFile binFile;
+	if( !assetPack_MapFile( binFileName, &binFile ) ) {
+		return false;
+	}
+
+	bool success = false;
+
+	// everything is checked before any of it is used, so a bad file can't leave a partial definition behind
+	const SheetBinHeader* header = (const SheetBinHeader*)binFile.data;
+	if( ( binFile.size < sizeof( SheetBinHeader ) ) || ( header->magic != SHEET_BIN_MAGIC ) ||
+		( header->version != SHEET_BIN_VERSION ) || ( sheetBin_FileSize( header ) != binFile.size ) ) {
+		llog( LOG_WARN, "Binary sprite sheet %s is invalid, using the text version.", binFileName );
+		goto clean_up;
+	}
+
+	if( ( textFile != NULL ) && ( sheetBin_HashData( textFile->data, textFile->size ) != header->sourceHash ) ) {
+		llog( LOG_INFO, "Binary sprite sheet %s is out of date, using the text version.", binFileName );
+		goto clean_up;
+	}
+
+	const SheetBinSprite* sprites = (const SheetBinSprite*)( binFile.data + sizeof( SheetBinHeader ) );
+	const char* strings = (const char*)( sprites + header->numSprites );
+	if( ( (uint64_t)header->imageNameOffset + header->imageNameLength ) > header->stringsSize ) {
+		llog( LOG_WARN, "Binary sprite sheet %s is invalid, using the text version.", binFileName );
+		goto clean_up;
+	}
+	for( uint32_t i = 0; i < header->numSprites; ++i ) {
+		if( ( (uint64_t)sprites[i].idOffset + sprites[i].idLength ) > header->stringsSize ) {
+			llog( LOG_WARN, "Binary sprite sheet %s is invalid, using the text version.", binFileName );
+			goto clean_up;
+		}
+	}
+
+	StringSlice imageName = { strings + header->imageNameOffset, header->imageNameLength };
+	setImageFileName( fileName, imageName, outDefinition );
+
+	sb_Reserve( outDefinition->sbIDs, header->numSprites );
+	sb_Reserve( outDefinition->sbMins, header->numSprites );
+	sb_Reserve( outDefinition->sbMaxes, header->numSprites );
+	for( uint32_t i = 0; i < header->numSprites; ++i ) {
+		const SheetBinSprite* sprite = &( sprites[i] );
+		addSprite( outDefinition, sym_InternSlice( strings + sprite->idOffset, sprite->idLength ), sprite->x, sprite->y, sprite->w, sprite->h );
+	}
+
+	success = true;
+
+clean_up:
+	mappedFile_Close( &binFile );
+	return success;
+}
+
+/*
+Reads in the sprite sheet definition, doesn't touch anything that needs to be done on the main thread. The binary
+ version is used if there's an up to date one, otherwise the text is parsed straight out of the mapped file.
+ Returns whether it was successful, the definition needs to be cleaned up either way.
+*/
+static bool parseSpriteSheet( const char* fileName, SheetDefinition* outDefinition )
+{
+	memset( outDefinition, 0, sizeof( *outDefinition ) );
+
+	MappedFile textFile;
+	bool hasText = assetPack_MapFile( fileName, &textFile );
+
+	bool success = loadBinarySheet( fileName, hasText ? &textFile : NULL, outDefinition );
+	if( !success ) {
+		if( hasText ) {
+			success = parseTextSheet( fileName, &textFile, outDefinition );
+		} else {
+			llog( LOG_ERROR, "Unable to open sprite sheet definition file: %s", fileName );
+		}
+	}
+
+	mappedFile_Close( &textFile );
+	return success;
+}
+
+// sheets that are reloaded when their definition or image changes
+typedef struct {
+	int* imgArray; // the array given back when the sheet was loaded, used to find the sheet again
+	char fileName[256];
+	char imageFileName[256];
+	ShaderType shaderType;
+	int sheetWatchID;
+	int imageWatchID;
+} WatchedSheet;
+
+static WatchedSheet* sbWatchedSheets = NULL;
+
+static void sheetFileChanged( const char* fileName, void* data );
+
+static int findWatchedSheet( int* imgArray )
+{
+	for( size_t i = 0; i < sb_Count( sbWatchedSheets ); ++i ) {
+		if( sbWatchedSheets[i].imgArray == imgArray ) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+static void watchSheet( const char* fileName, const char* imageFileName, ShaderType shaderType, int* imgArray )
+{
+	if( imgArray == NULL ) {
+		return;
+	}
+
+	WatchedSheet sheet;
+	sheet.imgArray = imgArray;
+	SDL_strlcpy( sheet.fileName, fileName, ARRAY_SIZE( sheet.fileName ) );
+	SDL_strlcpy( sheet.imageFileName, imageFileName, ARRAY_SIZE( sheet.imageFileName ) );
+	sheet.shaderType = shaderType;
+	sheet.sheetWatchID = fw_Watch( fileName, sheetFileChanged, imgArray );
+	sheet.imageWatchID = fw_Watch( imageFileName, sheetFileChanged, imgArray );
+
+	if( ( sheet.sheetWatchID >= 0 ) || ( sheet.imageWatchID >= 0 ) ) {
+		sb_Push( sbWatchedSheets, sheet );
+	}
+}
+
+static void unwatchSheet( int* imgArray )
+{
+	int idx = findWatchedSheet( imgArray );
+	if( idx < 0 ) {
+		return;
+	}
+
+	fw_Unwatch( sbWatchedSheets[idx].sheetWatchID );
+	fw_Unwatch( sbWatchedSheets[idx].imageWatchID );
+	sb_Remove( sbWatchedSheets, idx );
+}
+
+/*
+Creates the images for the sheet from the already decoded image, putting the ids into imgOutArray.
+ Returns the number of images created if it was successful, otherwise returns -1.
+*/
+static int splitSheet( const char* fileName, SheetDefinition* definition, LoadedImage* loadedImage, ShaderType shaderType, int** imgOutArray )
+{
+	int numSprites = (int)sb_Count( definition->sbMins );
+	sb_Add( *imgOutArray, numSprites );
+
+	if( img_SplitLoadedImageWithSymbols( loadedImage, numSprites, shaderType, definition->sbMins, definition->sbMaxes, definition->sbIDs, ( *imgOutArray ) ) < 0 ) {
+		sb_Release( *imgOutArray );
+		llog( LOG_ERROR, "Problem splitting image for sprite sheet definition file: %s", fileName );
+		return -1;
+	}
+
+	return numSprites;
+}
 
 /*
 This opens up the sprite sheet file and loads all the images, putting the ids into imgOutArray. The returned array
@@ -29,128 +272,248 @@ This opens up the sprite sheet file and loads all the images, putting the ids in
 */
 int img_LoadSpriteSheet( char* fileName, ShaderType shaderType, int** imgOutArray )
 {
-	int returnVal = 0;
-	Vector2* sbMins = NULL;
-	Vector2* sbMaxes = NULL;
-	char** sbIDs = NULL;
-	char* fileText = NULL;
-
-	char buffer[512];
-	SDL_RWops* rwopsFile = SDL_RWFromFile( fileName, "r" );
-	if( rwopsFile == NULL ) {
-		returnVal = -1;
-		llog( LOG_ERROR, "Unable to open sprite sheet definition file: %s", fileName );
+	int returnVal = -1;
+
+	SheetDefinition definition;
+	LoadedImage loadedImage;
+	loadedImage.data = NULL;
+	loadedImage.flags = 0;
+
+	if( !parseSpriteSheet( fileName, &definition ) ) {
 		goto clean_up;
 	}
 
-	// format version 2
-	//  image file name
-	//  spriteID rect.x rect.y rect.w rect.h
-	//  final blank line
-	int version;
-	int numSpritesRead = 0;
+	if( gfxUtil_LoadImage( definition.imageFileName, &loadedImage ) < 0 ) {
+		llog( LOG_ERROR, "Problem loading image %s for sprite sheet definition file: %s", definition.imageFileName, fileName );
+		goto clean_up;
+	}
+
+	returnVal = splitSheet( fileName, &definition, &loadedImage, shaderType, imgOutArray );
+	if( returnVal >= 0 ) {
+		watchSheet( fileName, definition.imageFileName, shaderType, (*imgOutArray) );
+	}
+
+clean_up:
+	gfxUtil_ReleaseLoadedImage( &loadedImage );
+	cleanUpSheetDefinition( &definition );
+
+	return returnVal;
+}
+
+typedef struct {
+	char* fileName;
+	ShaderType shaderType;
+	int** imgOutArray;
+	int* outCount;
+	int* reloadArray; // images of the sheet being reloaded, NULL if it's a new load
+	SheetDefinition definition;
+	LoadedImage loadedImage;
+} SheetLoadData;
+
+static void cleanUpSheetLoadData( SheetLoadData* loadData )
+{
+	gfxUtil_ReleaseLoadedImage( &( loadData->loadedImage ) );
+	cleanUpSheetDefinition( &( loadData->definition ) );
+	mem_Release( loadData->fileName );
+	mem_Release( loadData );
+}
+
+static SheetLoadData* createSheetLoadData( const char* fileName, ShaderType shaderType, int** imgOutArray, int* outCount )
+{
+	SheetLoadData* loadData = mem_Allocate( sizeof( SheetLoadData ) );
+	if( loadData == NULL ) {
+		llog( LOG_WARN, "Unable to create data for threaded sprite sheet load for file %s", fileName );
+		return NULL;
+	}
+	memset( loadData, 0, sizeof( SheetLoadData ) );
+
+	size_t fileNameLen = strlen( fileName );
+	loadData->fileName = mem_Allocate( fileNameLen + 1 );
+	if( loadData->fileName == NULL ) {
+		llog( LOG_WARN, "Unable to create file name storage for threaded sprite sheet load for file %s", fileName );
+		mem_Release( loadData );
+		return NULL;
+	}
+	SDL_strlcpy( loadData->fileName, fileName, fileNameLen + 1 );
+
+	loadData->shaderType = shaderType;
+	loadData->imgOutArray = imgOutArray;
+	loadData->outCount = outCount;
+
+	return loadData;
+}
+
+static bool loadSheet( void* data )
+{
+	SheetLoadData* loadData = (SheetLoadData*)data;
+
+	if( !parseSpriteSheet( loadData->fileName, &( loadData->definition ) ) ) {
+		return false;
+	}
+
+	if( gfxUtil_LoadImage( loadData->definition.imageFileName, &( loadData->loadedImage ) ) < 0 ) {
+		llog( LOG_ERROR, "Problem loading image %s for sprite sheet definition file: %s", loadData->definition.imageFileName, loadData->fileName );
+		return false;
+	}
+
+	return true;
+}
+
+static void bindSheet( void* data, bool loaded )
+{
+	SheetLoadData* loadData = (SheetLoadData*)data;
+
+	int count = -1;
+	if( loaded ) {
+		count = splitSheet( loadData->fileName, &( loadData->definition ), &( loadData->loadedImage ), loadData->shaderType, loadData->imgOutArray );
+	}
+
+	if( count >= 0 ) {
+		watchSheet( loadData->fileName, loadData->definition.imageFileName, loadData->shaderType, *( loadData->imgOutArray ) );
+	}
 
-	ReadState currentState = RS_VERSION;
+	if( loadData->outCount != NULL ) {
+		(*( loadData->outCount )) = count;
+	}
+
+	cleanUpSheetLoadData( loadData );
+}
 
-	// first read in the text from the file, should never be too large
-	int readAmt;
-	while( ( readAmt = SDL_RWread( rwopsFile, (void*)buffer, sizeof( char ), ( sizeof( buffer ) / sizeof( buffer[0] ) ) ) ) != 0 ) {
-		char* c = sb_Add( fileText, readAmt );
-		for( int i = 0; i < readAmt; ++i ) {
-			*c++ = buffer[i];
+static bool arrayContains( int* sbArray, int value )
+{
+	for( size_t i = 0; i < sb_Count( sbArray ); ++i ) {
+		if( sbArray[i] == value ) {
+			return true;
 		}
 	}
-	sb_Push( fileText, 0 );
+	return false;
+}
 
-	const char* delim = "\r\n";
-	char* line = strtok( fileText, delim );
-	char* fileNameLoc;
-	char* idEndLoc;
-	char* rectStart;
-	char workingBuffer[256] = { 0 };
-	size_t idLen;
-	char* id;
-	Vector2 min, max;
+// swaps the new version of the sheet into the images that were already created for it, matching them by id
+static void replaceSheet( WatchedSheet* sheet, SheetLoadData* loadData )
+{
+	SheetDefinition* definition = &( loadData->definition );
+
+	Texture texture;
+	if( gfxUtil_CreateTextureFromLoadedImage( GL_RGBA, &( loadData->loadedImage ), &texture, GL_NEAREST ) < 0 ) {
+		llog( LOG_WARN, "Unable to reload sprite sheet %s, keeping the old one.", sheet->fileName );
+		return;
+	}
 
-	// now go through individual lines, parsing stuff as necessary
-	while( line != NULL ) {
-		switch( currentState ) {
-		case RS_VERSION:
-			version = SDL_strtol( line, NULL, 10 );
-			currentState = RS_FILENAME;
-			break;
-		case RS_FILENAME:
-			// assuming the file name will be local the .ss file, so we need to rip the directory off it and
-			//  append the file name to it
-			// line will be the file name for the image, attempt to create the texture
-			SDL_strlcpy( workingBuffer, fileName, ARRAY_SIZE( workingBuffer ) );
-			fileNameLoc = SDL_strrchr( workingBuffer, '/' );
-
-			if( fileNameLoc != NULL ) {
-				++fileNameLoc;
-				(*fileNameLoc) = 0; // move the null terminator
-				SDL_strlcat( workingBuffer, line, ARRAY_SIZE( workingBuffer ) );
-			}
-			currentState = RS_SPRITES;
-			break;
-		case RS_SPRITES:
-			// id
-			idEndLoc = SDL_strchr( line, ' ' );
-			idLen = (uintptr_t)idEndLoc - (uintptr_t)line + 1;
-			id = mem_Allocate( idLen );
-			SDL_strlcpy( id, line, idLen );
-
-			sb_Push( sbIDs, id );
-
-			rectStart = idEndLoc + 1;
-
-			// x, y, w, h
-			min.x = (float)SDL_strtol( rectStart, &rectStart, 10 );
-			++rectStart;
-			min.y = (float)SDL_strtol( rectStart, &rectStart, 10 );
-			++rectStart;
-			max.x = min.x + ( (float)SDL_strtol( rectStart, &rectStart, 10 ) );
-			++rectStart;
-			max.y = min.y + ( (float)SDL_strtol( rectStart, &rectStart, 10 ) );
-
-			sb_Push( sbMins, min );
-			sb_Push( sbMaxes, max );
-
-			++numSpritesRead;
-
-			break;
+	int numReplaced = 0;
+	int numNew = 0;
+	for( size_t i = 0; i < sb_Count( definition->sbIDs ); ++i ) {
+		int imgID = img_GetExistingBySymbol( definition->sbIDs[i] );
+		if( !arrayContains( sheet->imgArray, imgID ) ) {
+			++numNew;
+		} else if( img_ReplaceTexture( imgID, &texture, &( definition->sbMins[i] ), &( definition->sbMaxes[i] ) ) >= 0 ) {
+			++numReplaced;
 		}
-		line = strtok( NULL, delim );
 	}
 
-	sb_Add( *imgOutArray, numSpritesRead );
+	if( numNew > 0 ) {
+		llog( LOG_WARN, "Sprite sheet %s has %i sprites that weren't there when it was loaded, they won't be usable until it's loaded again.", sheet->fileName, numNew );
+	}
 
-	// now go through and create all the images
-	if( img_SplitImageFile( workingBuffer, numSpritesRead, shaderType, sbMins, sbMaxes, sbIDs, ( *imgOutArray ) ) < 0 ) {
-		sb_Release( *imgOutArray );
-		returnVal = -1;
-		llog( LOG_ERROR, "Problem splitting image for sprite sheet definition file: %s", fileName );
-		goto clean_up;
+	if( numReplaced == 0 ) {
+		GL( glDeleteTextures( 1, &( texture.textureID ) ) );
 	}
 
-	returnVal = numSpritesRead;
+	// the definition may be using a different image now
+	if( strcmp( sheet->imageFileName, definition->imageFileName ) != 0 ) {
+		fw_Unwatch( sheet->imageWatchID );
+		SDL_strlcpy( sheet->imageFileName, definition->imageFileName, ARRAY_SIZE( sheet->imageFileName ) );
+		sheet->imageWatchID = fw_Watch( sheet->imageFileName, sheetFileChanged, sheet->imgArray );
+	}
+}
 
-clean_up:
+static void bindReloadedSheet( void* data, bool loaded )
+{
+	SheetLoadData* loadData = (SheetLoadData*)data;
+
+	// the sheet may have been unloaded while it was being reloaded
+	int sheetIdx = findWatchedSheet( loadData->reloadArray );
+	if( !loaded ) {
+		llog( LOG_WARN, "Unable to reload sprite sheet %s, keeping the old one.", loadData->fileName );
+	} else if( sheetIdx >= 0 ) {
+		replaceSheet( &( sbWatchedSheets[sheetIdx] ), loadData );
+	}
 
-	sb_Release( fileText );
+	cleanUpSheetLoadData( loadData );
+}
 
-	sb_Release( sbMins );
-	sb_Release( sbMaxes );
-	for( size_t i = 0; i < sb_Count( sbIDs ); ++i ) {
-		mem_Release( sbIDs[i] );
+// parses the sheet and decodes its image in the background, the images keep using the old version until it's done
+static void sheetFileChanged( const char* fileName, void* data )
+{
+	int sheetIdx = findWatchedSheet( (int*)data );
+	if( sheetIdx < 0 ) {
+		return;
 	}
-	sb_Release( sbIDs );
 
-	if( rwopsFile != NULL ) {
-		SDL_RWclose( rwopsFile );
+	WatchedSheet* sheet = &( sbWatchedSheets[sheetIdx] );
+	SheetLoadData* loadData = createSheetLoadData( sheet->fileName, sheet->shaderType, NULL, NULL );
+	if( loadData == NULL ) {
+		return;
 	}
+	loadData->reloadArray = sheet->imgArray;
 
-	return returnVal;
+	if( !lq_Add( LOAD_PRIORITY_HIGH, sheet->fileName, loadSheet, bindReloadedSheet, loadData ) ) {
+		cleanUpSheetLoadData( loadData );
+	}
+}
+
+/*
+Streams the sprite sheet in the background, the definition is parsed and the image decoded on a worker thread.
+ Returns whether the load was started.
+*/
+bool img_ThreadedLoadSpriteSheet( const char* fileName, ShaderType shaderType, LoadPriority priority, int** imgOutArray )
+{
+	assert( fileName != NULL );
+	assert( imgOutArray != NULL );
+
+	SheetLoadData* loadData = createSheetLoadData( fileName, shaderType, imgOutArray, NULL );
+	if( loadData == NULL ) {
+		return false;
+	}
+
+	if( !lq_Add( priority, fileName, loadSheet, bindSheet, loadData ) ) {
+		cleanUpSheetLoadData( loadData );
+		return false;
+	}
+
+	return true;
+}
+
+/*
+Loads a group of sprite sheets at once. The definitions are parsed and the images decoded on the worker threads in
+ parallel, only the textures and images are created on the calling thread. Doesn't return until they're all done.
+ Returns the number of sheets that failed to load.
+*/
+int img_LoadSpriteSheetBatch( SpriteSheetLoad* loads, int numLoads )
+{
+	assert( ( loads != NULL ) || ( numLoads == 0 ) );
+
+	int numFailed = 0;
+
+	void** sbLoadData = NULL;
+	for( int i = 0; i < numLoads; ++i ) {
+		loads[i].count = -1;
+		SheetLoadData* loadData = createSheetLoadData( loads[i].fileName, loads[i].shaderType, loads[i].imgOutArray, &( loads[i].count ) );
+		if( loadData != NULL ) {
+			sb_Push( sbLoadData, loadData );
+		}
+	}
+
+	lq_LoadBatch( loadSheet, bindSheet, sbLoadData, (int)sb_Count( sbLoadData ) );
+	sb_Release( sbLoadData );
+
+	for( int i = 0; i < numLoads; ++i ) {
+		if( loads[i].count < 0 ) {
+			++numFailed;
+		}
+	}
+
+	return numFailed;
 }
 
 /*
@@ -159,6 +522,8 @@ Cleans up all the images created from img_LoadSpriteSheet( ). The pointer passed
 */
 void img_UnloadSpriteSheet( int* imgArray )
 {
+	unwatchSheet( imgArray );
+
 	// free all the images
 	int length = sb_Count( imgArray );
 	for( int i = 0; i < length; ++i ) {
@@ -167,4 +532,4 @@ void img_UnloadSpriteSheet( int* imgArray )
 
 	// free the array
 	sb_Release( imgArray );
-}
\ No newline at end of file
+}
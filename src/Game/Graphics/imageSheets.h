@@ -1,17 +1,43 @@
 #ifndef IMAGE_SHEETS_H
 #define IMAGE_SHEETS_H
 
+#include <stdbool.h>
 #include "triRendering.h"
+#include "../System/loadQueue.h"
 
 /*
 This opens up the sprite sheet file and loads all the images, putting image ids into imgOutArray. The returned array
  uses the stretchy buffer file, so you can use that to find the size, but you shouldn't do anything that modifies
  the size of it.
  The returned integers are ids for the images source files.
+ The sheet and its image are watched, if either changes the existing images are updated to use the new version.
  Returns the number of images loaded if it was successful, otherwise returns -1.
 */
 int img_LoadSpriteSheet( char* fileName, ShaderType shaderType, int** imgOutArray );
 
+/*
+Streams the sprite sheet in the background, the definition is parsed and the image decoded on a worker thread. The
+ number of images isn't known until the definition is read, so unlike the other threaded loads there's nothing to use
+ right away. (*imgOutArray) is left alone until the sheet is loaded and then set the same as img_LoadSpriteSheet would,
+ so imgOutArray has to stay valid until then and the sheet can't be unloaded before it's set.
+ Returns whether the load was started.
+*/
+bool img_ThreadedLoadSpriteSheet( const char* fileName, ShaderType shaderType, LoadPriority priority, int** imgOutArray );
+
+typedef struct {
+	const char* fileName;
+	ShaderType shaderType;
+	int** imgOutArray;
+	int count; // set by img_LoadSpriteSheetBatch to the number of images loaded, -1 if the sheet failed
+} SpriteSheetLoad;
+
+/*
+Loads a group of sprite sheets at once. The definitions are parsed and the images decoded on the worker threads in
+ parallel, only the textures and images are created on the calling thread. Doesn't return until they're all done.
+ Returns the number of sheets that failed to load.
+*/
+int img_LoadSpriteSheetBatch( SpriteSheetLoad* loads, int numLoads );
+
 /*
 Cleans up all the images created from img_LoadSpriteSheet( ). The pointer passed in will be invalid after this
  is called.
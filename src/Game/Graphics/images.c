@@ -8,37 +8,65 @@
 
 #include "../Math/matrix4.h"
 #include "gfxUtil.h"
+#include "glDebugging.h"
+#include "textureAtlas.h"
+#include "textureUpload.h"
 #include "scissor.h"
+#include "renderStats.h"
 #include "../System/platformLog.h"
 #include "../Math/mathUtil.h"
 
 #include "../System/jobQueue.h"
 #include "../System/jobRingQueue.h"
 #include "../System/memory.h"
+#include "../System/loadQueue.h"
+#include "../System/fileWatcher.h"
 
-#include "../Utils/hashMap.h"
+#include "../Utils/typedHashMap.h"
+#include "../Utils/symbols.h"
+#include "../Utils/assetCache.h"
+#include "../Utils/stretchyBuffer.h"
 
 /* Image loading types and variables */
-#define MAX_IMAGES 512
+
+// handles are the index into the image table with the generation of the slot above it, so a handle to an image that's
+//  been cleaned up won't match whatever gets the slot next
+#define IMAGE_INDEX_BITS 20
+#define IMAGE_INDEX_MASK ( ( 1 << IMAGE_INDEX_BITS ) - 1 )
+#define IMAGE_GENERATION_MASK 0x7FF // keeps the handles positive
+#define MAX_IMAGES ( IMAGE_INDEX_MASK + 1 )
 
 enum {
 	IMGFLAG_IN_USE = 0x1,
 	IMGFLAG_HAS_TRANSPARENCY = 0x2,
 };
 
+// everything needed to create a draw instruction, kept separate so drawing doesn't have to pull in the rest
 typedef struct {
 	GLuint textureObj;
+	int flags;
 	Vector2 uvMin;
 	Vector2 uvMax;
 	Vector2 size;
 	Vector2 offset;
-	int flags;
+	LoadState loadState;
+	ShaderType shaderType;
+	int generation;
+} ImageDrawData;
+
+typedef struct {
 	int packageID;
 	int nextInPackage;
-	ShaderType shaderType;
+	int atlasHandle; // -1 if the image isn't in the texture atlas
+	Symbol id; // INVALID_SYMBOL if the image wasn't given an id
+	int nextFree; // next unused slot if this one is unused, -1 if it's the last one
+	int watchID; // -1 if the file the image was loaded from isn't being watched for changes
 } Image;
 
-static Image images[MAX_IMAGES];
+// both grow together, an image's index is the same in each
+static ImageDrawData* sbImageDrawData = NULL;
+static Image* sbImages = NULL;
+static int firstFreeImage = -1;
 
 /* Rendering types and variables */
 #define MAX_RENDER_INSTRUCTIONS ( 1024 * 8 )
@@ -67,6 +95,25 @@ typedef struct {
 static DrawInstruction renderBuffer[MAX_RENDER_INSTRUCTIONS];
 static int lastDrawInstruction;
 
+// while recording a group draws are built here and then added to the group instead of the render buffer
+static int recordingGroup = -1;
+static DrawInstruction recordedInstruction;
+
+// groups drawn this tick, they're passed on to the triangle renderer in img_Render along with everything else so they
+//  end up in the same order they were drawn in
+#define MAX_QUEUED_GROUP_DRAWS 32
+typedef struct {
+	int groupID;
+	uint32_t camFlags;
+	Vector2 offset;
+	int8_t depth;
+	int scissorID;
+	int beforeInstruction; // added before the draw instruction at this index
+} QueuedGroupDraw;
+
+static QueuedGroupDraw queuedGroupDraws[MAX_QUEUED_GROUP_DRAWS];
+static int numQueuedGroupDraws = 0;
+
 static const DrawInstruction DEFAULT_DRAW_INSTRUCTION = {
 	0, -1,
 	{ { 0.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f } },
@@ -77,7 +124,61 @@ static const DrawInstruction DEFAULT_DRAW_INSTRUCTION = {
 
 static GLint maxTextureSize;
 
-static HashMap imgIDMap;
+TYPED_HASH_MAP_DECLARE( ImageIDMap, imgIDMap, Symbol, int )
+TYPED_HASH_MAP_DEFINE( ImageIDMap, imgIDMap, Symbol, int, HASH_MAP_HASH_U32, HASH_MAP_EQUALS_VALUE )
+
+static ImageIDMap imgIDMap;
+
+// how many images are using each texture that isn't an atlas page, the texture is deleted when the last one is released
+TYPED_HASH_MAP_DECLARE( TextureRefMap, texRefMap, GLuint, int )
+TYPED_HASH_MAP_DEFINE( TextureRefMap, texRefMap, GLuint, int, HASH_MAP_HASH_U32, HASH_MAP_EQUALS_VALUE )
+
+static TextureRefMap texRefMap;
+
+// images loaded from files, so each file is only loaded once no matter how many times it's asked for
+static AssetCache imgCache;
+
+// drawn instead of images that are still being streamed in
+static int placeholderImage = -1;
+
+static int toHandle( int idx )
+{
+	return ( sbImageDrawData[idx].generation << IMAGE_INDEX_BITS ) | idx;
+}
+
+/*
+Gets the index in the image table for the handle.
+ Returns -1 if the handle isn't for an image that's currently in use.
+*/
+static int toIndex( int handle )
+{
+	if( handle < 0 ) {
+		return -1;
+	}
+
+	int idx = handle & IMAGE_INDEX_MASK;
+	if( ( idx >= (int)sb_Count( sbImageDrawData ) ) || !( sbImageDrawData[idx].flags & IMGFLAG_IN_USE ) ||
+		( sbImageDrawData[idx].generation != ( handle >> IMAGE_INDEX_BITS ) ) ) {
+		return -1;
+	}
+
+	return idx;
+}
+
+// stores the image under the already interned id
+static void setImageSymbol( int idx, Symbol symbol )
+{
+	sbImages[idx].id = symbol;
+	if( symbol != INVALID_SYMBOL ) {
+		imgIDMap_Set( &imgIDMap, symbol, toHandle( idx ) );
+	}
+}
+
+// interns the id and stores the image under it
+static void setImageID( int idx, const char* id )
+{
+	setImageSymbol( idx, sym_Intern( id ) );
+}
 
 /*
 Initializes images.
@@ -85,256 +186,448 @@ Initializes images.
 */
 int img_Init( void )
 {
-	glGetIntegerv( GL_MAX_TEXTURE_SIZE, &maxTextureSize );
-	memset( images, 0, sizeof(images) );
-	hashMap_Init( &imgIDMap, 64, NULL );
-	return 0;
+	GL( glGetIntegerv( GL_MAX_TEXTURE_SIZE, &maxTextureSize ) );
+	sb_Reserve( sbImageDrawData, 512 );
+	sb_Reserve( sbImages, 512 );
+	firstFreeImage = -1;
+	imgIDMap_Init( &imgIDMap, 64 );
+	texRefMap_Init( &texRefMap, 64 );
+	assetCache_Init( &imgCache, 64 );
+	return texAtlas_Init( );
 }
 
 /*
-Finds the first unused image index.
- Returns a postive value on success, a negative on failure.
+Claims an unused slot in the image table, growing it if there are none, and marks it as in use. Everything is set to
+ the defaults, the caller sets up the rest.
+ Returns the index on success, a negative on failure.
 */
-static int findAvailableImageIndex( )
+static int claimImageIndex( void )
 {
-	int newIdx = 0;
+	int newIdx = firstFreeImage;
+	if( newIdx >= 0 ) {
+		firstFreeImage = sbImages[newIdx].nextFree;
+	} else {
+		newIdx = (int)sb_Count( sbImages );
+		if( newIdx >= MAX_IMAGES ) {
+			return -1;
+		}
 
-	while( ( newIdx < MAX_IMAGES ) && ( images[newIdx].flags & IMGFLAG_IN_USE ) ) {
-		++newIdx;
+		sb_Add( sbImageDrawData, 1 );
+		sb_Add( sbImages, 1 );
+		sbImageDrawData[newIdx].generation = 0;
 	}
 
-	if( newIdx >= MAX_IMAGES ) {
-		newIdx = -1;
+	// advance the generation so any handles to the last image in this slot are no longer valid, 0 is skipped so a
+	//  zeroed handle is never valid
+	int generation = ( sbImageDrawData[newIdx].generation + 1 ) & IMAGE_GENERATION_MASK;
+	if( generation == 0 ) {
+		generation = 1;
 	}
 
+	ImageDrawData* drawData = &( sbImageDrawData[newIdx] );
+	drawData->textureObj = 0;
+	drawData->flags = IMGFLAG_IN_USE;
+	drawData->uvMin = VEC2_ZERO;
+	drawData->uvMax = VEC2_ONE;
+	drawData->size = VEC2_ZERO;
+	drawData->offset = VEC2_ZERO;
+	drawData->loadState = LOAD_STATE_NONE;
+	drawData->shaderType = ST_DEFAULT;
+	drawData->generation = generation;
+
+	Image* image = &( sbImages[newIdx] );
+	image->packageID = -1;
+	image->nextInPackage = -1;
+	image->atlasHandle = -1;
+	image->id = INVALID_SYMBOL;
+	image->nextFree = -1;
+	image->watchID = -1;
+
 	return newIdx;
 }
 
+static void addTextureRef( GLuint texture )
+{
+	int* refCount = texRefMap_Get( &texRefMap, texture );
+	if( refCount != NULL ) {
+		++(*refCount);
+	} else {
+		texRefMap_Set( &texRefMap, texture, 1 );
+	}
+}
+
+// sets up the image at idx to use the texture, atlasHandle is -1 if the texture is the image's own
+static void setupImage( int idx, AtlasResult* atlasResult, int atlasHandle, ShaderType shaderType )
+{
+	if( atlasHandle < 0 ) {
+		addTextureRef( atlasResult->texture.textureID );
+	}
+
+	ImageDrawData* drawData = &( sbImageDrawData[idx] );
+	drawData->textureObj = atlasResult->texture.textureID;
+	drawData->size.v[0] = (float)atlasResult->texture.width;
+	drawData->size.v[1] = (float)atlasResult->texture.height;
+	drawData->offset = VEC2_ZERO;
+	drawData->flags = IMGFLAG_IN_USE;
+	drawData->loadState = LOAD_STATE_NONE;
+	drawData->uvMin = atlasResult->minUV;
+	drawData->uvMax = atlasResult->maxUV;
+	drawData->shaderType = shaderType;
+	if( atlasResult->texture.flags & TF_IS_TRANSPARENT ) {
+		drawData->flags |= IMGFLAG_HAS_TRANSPARENCY;
+	}
+
+	sbImages[idx].packageID = -1;
+	sbImages[idx].nextInPackage = -1;
+	sbImages[idx].atlasHandle = atlasHandle;
+}
+
 /*
-Loads the image stored at file name.
+Sets up the image at idx from the loaded image. Small images are packed into the texture atlas so they can be batched
+ with each other, anything that doesn't fit gets its own texture.
+ Returns < 0 on failure.
+*/
+static int setupFromLoadedImage( int idx, LoadedImage* loadedImg, ShaderType shaderType )
+{
+	AtlasResult atlasResult;
+	int atlasHandle = texAtlas_Add( loadedImg, &atlasResult );
+	if( atlasHandle < 0 ) {
+		if( gfxUtil_CreateTextureFromLoadedImage( GL_RGBA, loadedImg, &( atlasResult.texture ), GL_NEAREST ) < 0 ) {
+			return -1;
+		}
+		atlasResult.minUV = VEC2_ZERO;
+		atlasResult.maxUV = VEC2_ONE;
+	}
+
+	setupImage( idx, &atlasResult, atlasHandle, shaderType );
+
+	return 0;
+}
+
+static void resetImage( int idx );
+static void removeDrawInstructions( int imgID );
+static void releaseTexture( int idx );
+static void imageFileChanged( const char* fileName, void* data );
+
+/*
+Loads the image stored at file name. If the image has already been loaded a reference to it is added and it's returned,
+ every load has to be matched by an img_Clean.
  Returns the index of the image on success.
  Returns -1 on failure, and prints a message to the log.
 */
 int img_Load( const char* fileName, ShaderType shaderType )
 {
-	int newIdx = -1;
+	int newHandle = -1;
 
 	// if we've already loaded the image don't load it again
-	if( hashMap_Find( &imgIDMap, fileName, &newIdx ) ) {
-		return newIdx;
+	Symbol key = sym_Intern( fileName );
+	if( assetCache_AddRef( &imgCache, key, &newHandle ) ) {
+		return newHandle;
+	}
+
+	LoadedImage loadedImg;
+	if( gfxUtil_LoadImage( fileName, &loadedImg ) < 0 ) {
+		llog( LOG_INFO, "Unable to load image %s!", fileName );
+		return -1;
 	}
 
-	// find the first empty spot, make sure we won't go over our maximum
-	newIdx = findAvailableImageIndex( );
+	int newIdx = claimImageIndex( );
 	if( newIdx < 0 ) {
 		llog( LOG_INFO, "Unable to load image %s! Image storage full.", fileName );
+		gfxUtil_ReleaseLoadedImage( &loadedImg );
 		return -1;
 	}
 
-	Texture texture;
-	if( gfxUtil_LoadTexture( fileName, &texture ) < 0 ) {
+	int result = setupFromLoadedImage( newIdx, &loadedImg, shaderType );
+	gfxUtil_ReleaseLoadedImage( &loadedImg );
+	if( result < 0 ) {
 		llog( LOG_INFO, "Unable to load image %s!", fileName );
-		newIdx = -1;
+		resetImage( newIdx );
 		return -1;
 	}
 
-	images[newIdx].textureObj = texture.textureID;
-	images[newIdx].size.v[0] = (float)texture.width;
-	images[newIdx].size.v[1] = (float)texture.height;
-	images[newIdx].offset = VEC2_ZERO;
-	images[newIdx].packageID = -1;
-	images[newIdx].flags = IMGFLAG_IN_USE;
-	images[newIdx].nextInPackage = -1;
-	images[newIdx].uvMin = VEC2_ZERO;
-	images[newIdx].uvMax = VEC2_ONE;
-	images[newIdx].shaderType = shaderType;
-	if( texture.flags & TF_IS_TRANSPARENT ) {
-		images[newIdx].flags |= IMGFLAG_HAS_TRANSPARENCY;
-	}
-
-	hashMap_Set( &imgIDMap, fileName, newIdx );
+	setImageID( newIdx, fileName );
+	newHandle = toHandle( newIdx );
+	assetCache_Store( &imgCache, key, newHandle );
+	sbImages[newIdx].watchID = fw_Watch( fileName, imageFileChanged, (void*)(intptr_t)newHandle );
 
-	return newIdx;
+	return newHandle;
 }
 
 int img_CreateFromLoadedImage( LoadedImage* loadedImg, ShaderType shaderType, const char* id )
 {
-	int newIdx = -1;
-
-	newIdx = findAvailableImageIndex( );
+	int newIdx = claimImageIndex( );
 	if( newIdx < 0 ) {
 		llog( LOG_INFO, "Unable to create image! Image storage full." );
 		return -1;
 	}
 
-	Texture texture;
-	if( gfxUtil_CreateTextureFromLoadedImage( GL_RGBA, loadedImg, &texture, GL_NEAREST ) < 0 ) {
+	if( setupFromLoadedImage( newIdx, loadedImg, shaderType ) < 0 ) {
 		llog( LOG_INFO, "Unable to create image!" );
+		resetImage( newIdx );
 		return -1;
 	}
 
-	images[newIdx].textureObj = texture.textureID;
-	images[newIdx].size.v[0] = (float)texture.width;
-	images[newIdx].size.v[1] = (float)texture.height;
-	images[newIdx].offset = VEC2_ZERO;
-	images[newIdx].packageID = -1;
-	images[newIdx].flags = IMGFLAG_IN_USE;
-	images[newIdx].nextInPackage = -1;
-	images[newIdx].uvMin = VEC2_ZERO;
-	images[newIdx].uvMax = VEC2_ONE;
-	images[newIdx].shaderType = shaderType;
-	if( texture.flags & TF_IS_TRANSPARENT ) {
-		images[newIdx].flags |= IMGFLAG_HAS_TRANSPARENCY;
-	}
+	setImageID( newIdx, id );
 
-	if( id != NULL ) {
-		hashMap_Set( &imgIDMap, id, newIdx );
-	}
-
-	return newIdx;
+	return toHandle( newIdx );
 }
 
 int img_CreateFromTexture( Texture* texture, ShaderType shaderType, const char* id )
 {
-	int newIdx = -1;;
-
-	newIdx = findAvailableImageIndex( );
+	int newIdx = claimImageIndex( );
 	if( newIdx < 0 ) {
 		llog( LOG_INFO, "Unable to create image! Image storage full." );
 		return -1;
 	}
 
-	images[newIdx].textureObj = texture->textureID;
-	images[newIdx].size.v[0] = (float)texture->width;
-	images[newIdx].size.v[1] = (float)texture->height;
-	images[newIdx].offset = VEC2_ZERO;
-	images[newIdx].packageID = -1;
-	images[newIdx].flags = IMGFLAG_IN_USE;
-	images[newIdx].nextInPackage = -1;
-	images[newIdx].uvMin = VEC2_ZERO;
-	images[newIdx].uvMax = VEC2_ONE;
-	images[newIdx].shaderType = shaderType;
+	addTextureRef( texture->textureID );
+
+	ImageDrawData* drawData = &( sbImageDrawData[newIdx] );
+	drawData->textureObj = texture->textureID;
+	drawData->size.v[0] = (float)texture->width;
+	drawData->size.v[1] = (float)texture->height;
+	drawData->shaderType = shaderType;
 	if( texture->flags & TF_IS_TRANSPARENT ) {
-		images[newIdx].flags |= IMGFLAG_HAS_TRANSPARENCY;
+		drawData->flags |= IMGFLAG_HAS_TRANSPARENCY;
 	}
 
-	if( id != NULL ) {
-		hashMap_Set( &imgIDMap, id, newIdx );
-	}
+	setImageID( newIdx, id );
 
-	return newIdx;
+	return toHandle( newIdx );
 }
 
 typedef struct {
 	char* fileName;
+	int handle;
 	ShaderType shaderType;
-	int* outIdx;
 	LoadedImage loadedImage;
 } ThreadedLoadImageData;
 
-static void bindImageJob( void* data )
+static void cleanUpThreadedLoadImageData( ThreadedLoadImageData* loadData )
 {
-	if( data == NULL ) {
-		llog( LOG_INFO, "No data, unable to bind." );
-		return;
-	}
+	gfxUtil_ReleaseLoadedImage( &( loadData->loadedImage ) );
+	mem_Release( loadData->fileName );
+	mem_Release( loadData );
+}
 
+static void imageUploaded( void* data, bool success, Texture* texture )
+{
 	ThreadedLoadImageData* loadData = (ThreadedLoadImageData*)data;
 
-	(*(loadData->outIdx)) = -1;
+	// the slot stays reserved until the upload is done as well
+	int idx = toIndex( loadData->handle );
+	assert( idx >= 0 );
 
-	if( loadData->loadedImage.data == NULL ) {
-		llog( LOG_INFO, "Failed to load image %s", loadData->fileName );
-		goto clean_up;
+	if( sbImageDrawData[idx].loadState == LOAD_STATE_CANCELLED ) {
+		if( success ) {
+			GL( glDeleteTextures( 1, &( texture->textureID ) ) );
+		}
+		resetImage( idx );
+	} else if( !success ) {
+		llog( LOG_INFO, "Unable to upload image %s!", loadData->fileName );
+		sbImageDrawData[idx].loadState = LOAD_STATE_FAILED;
+	} else {
+		AtlasResult result;
+		result.texture = (*texture);
+		result.minUV = VEC2_ZERO;
+		result.maxUV = VEC2_ONE;
+		setupImage( idx, &result, -1, loadData->shaderType );
 	}
 
-	// find the first empty spot, make sure we won't go over our maximum
-	int newIdx = findAvailableImageIndex( );
-	if( newIdx < 0 ) {
-		llog( LOG_INFO, "Unable to bind image %s! Image storage full.", loadData->fileName );
-		goto clean_up;
-	}
+	cleanUpThreadedLoadImageData( loadData );
+}
 
-	Texture texture;
-	if( gfxUtil_CreateTextureFromLoadedImage( GL_RGBA, &( loadData->loadedImage ), &texture, GL_NEAREST ) < 0 ) {
+static void bindImage( void* data, bool loaded )
+{
+	ThreadedLoadImageData* loadData = (ThreadedLoadImageData*)data;
+
+	// the slot stays reserved until the load is done, so the handle will always be valid here
+	int idx = toIndex( loadData->handle );
+	assert( idx >= 0 );
+
+	AtlasResult atlasResult;
+	int atlasHandle;
+
+	if( sbImageDrawData[idx].loadState == LOAD_STATE_CANCELLED ) {
+		// everything that wanted it was cleaned up while it was loading
+		resetImage( idx );
+	} else if( !loaded ) {
 		llog( LOG_INFO, "Unable to bind image %s!", loadData->fileName );
-		goto clean_up;
-	}
-
-	images[newIdx].textureObj = texture.textureID;
-	images[newIdx].size.v[0] = (float)texture.width;
-	images[newIdx].size.v[1] = (float)texture.height;
-	images[newIdx].offset = VEC2_ZERO;
-	images[newIdx].packageID = -1;
-	images[newIdx].flags = IMGFLAG_IN_USE;
-	images[newIdx].nextInPackage = -1;
-	images[newIdx].uvMin = VEC2_ZERO;
-	images[newIdx].uvMax = VEC2_ONE;
-	images[newIdx].shaderType = loadData->shaderType;
-	if( texture.flags & TF_IS_TRANSPARENT ) {
-		images[newIdx].flags |= IMGFLAG_HAS_TRANSPARENCY;
+		sbImageDrawData[idx].loadState = LOAD_STATE_FAILED;
+	} else if( ( atlasHandle = texAtlas_Add( &( loadData->loadedImage ), &atlasResult ) ) >= 0 ) {
+		setupImage( idx, &atlasResult, atlasHandle, loadData->shaderType );
+	} else if( texUpload_Queue( &( loadData->loadedImage ), GL_NEAREST, imageUploaded, loadData ) ) {
+		// too large for the atlas, the upload is spread over the next few frames and the slot stays pending until it's done
+		return;
+	} else if( gfxUtil_CreateTextureFromLoadedImage( GL_RGBA, &( loadData->loadedImage ), &( atlasResult.texture ), GL_NEAREST ) >= 0 ) {
+		atlasResult.minUV = VEC2_ZERO;
+		atlasResult.maxUV = VEC2_ONE;
+		setupImage( idx, &atlasResult, -1, loadData->shaderType );
+	} else {
+		llog( LOG_INFO, "Unable to bind image %s!", loadData->fileName );
+		sbImageDrawData[idx].loadState = LOAD_STATE_FAILED;
 	}
-	(*(loadData->outIdx)) = newIdx;
 
-	llog( LOG_INFO, "Setting outIdx to %i", newIdx );
+	cleanUpThreadedLoadImageData( loadData );
+}
 
-clean_up:
-	gfxUtil_ReleaseLoadedImage( &( loadData->loadedImage ) );
-	mem_Release( loadData->fileName );
-	mem_Release( loadData );
+static bool loadImage( void* data )
+{
+	ThreadedLoadImageData* loadData = (ThreadedLoadImageData*)data;
+	return ( gfxUtil_LoadImage( loadData->fileName, &( loadData->loadedImage ) ) >= 0 );
 }
 
-static void loadImageJob( void* data )
+static ThreadedLoadImageData* createThreadedLoadImageData( const char* fileName )
 {
+	ThreadedLoadImageData* data = mem_Allocate( sizeof( ThreadedLoadImageData ) );
 	if( data == NULL ) {
-		llog( LOG_INFO, "No data, unable to load." );
-		return;
+		llog( LOG_WARN, "Unable to create data for threaded image load for file %s", fileName );
+		return NULL;
 	}
 
-	ThreadedLoadImageData* loadData = (ThreadedLoadImageData*)data;
-	// will worry about handling a bad load when we get back to the main thread
-	gfxUtil_LoadImage( loadData->fileName, &( loadData->loadedImage ) );
+	size_t fileNameLen = strlen( fileName );
+	data->fileName = mem_Allocate( fileNameLen + 1 );
+	if( data->fileName == NULL ) {
+		llog( LOG_WARN, "Unable to create file name storage for threaded image load for file %s", fileName );
+		mem_Release( data );
+		return NULL;
+	}
+	SDL_strlcpy( data->fileName, fileName, fileNameLen + 1 );
+
+	data->handle = -1;
+	data->shaderType = ST_DEFAULT;
+	data->loadedImage.data = NULL;
 
-	// binding needs to be done on the main thread
-	jq_AddMainThreadJob( bindImageJob, data );
+	return data;
 }
 
 /*
-Loads the image in a seperate thread. Puts the resulting image index into outIdx.
- Returns -1 if there was an issue, 0 otherwise.
+Streams the image in the background. The returned index can be used right away, until the image is loaded the
+ placeholder is drawn in its place. If the image is already loaded or loading a reference to it is added instead.
+ Returns -1 if the load couldn't be started.
 */
-void img_ThreadedLoad( const char* fileName, ShaderType shaderType, int* outIdx )
+int img_ThreadedLoad( const char* fileName, ShaderType shaderType, LoadPriority priority )
 {
 	assert( fileName != NULL );
 
-	// set it to something that won't draw anything
-	(*outIdx) = -1;
+	int newHandle = -1;
 
-	// this isn't something that should be happening all the time, so allocating and freeing
-	//  should be fine, if we want to do continous streaming it would probably be better to
-	//  make a specialty queue for it
-	ThreadedLoadImageData* data = mem_Allocate( sizeof( ThreadedLoadImageData ) );
+	Symbol key = sym_Intern( fileName );
+	if( assetCache_AddRef( &imgCache, key, &newHandle ) ) {
+		return newHandle;
+	}
+
+	ThreadedLoadImageData* data = createThreadedLoadImageData( fileName );
 	if( data == NULL ) {
-		llog( LOG_WARN, "Unable to create data for threaded image load for file %s", fileName );
-		return;
+		return -1;
 	}
 
-	size_t fileNameLen = strlen( fileName );
-	data->fileName = mem_Allocate( fileNameLen + 1 );
-	if( data->fileName == NULL ) {
-		llog( LOG_WARN, "Unable to create file name storage for threaded image lead for fle %s", fileName );
+	int newIdx = claimImageIndex( );
+	if( newIdx < 0 ) {
+		llog( LOG_INFO, "Unable to load image %s! Image storage full.", fileName );
+		mem_Release( data->fileName );
 		mem_Release( data );
-		return;
+		return -1;
 	}
-	SDL_strlcpy( data->fileName, fileName, fileNameLen );
 
+	newHandle = toHandle( newIdx );
+	data->handle = newHandle;
 	data->shaderType = shaderType;
-	data->outIdx = outIdx;
-	data->loadedImage.data = NULL;
 
-	if( !jq_AddJob( loadImageJob, data ) ) {
+	if( !lq_Add( priority, fileName, loadImage, bindImage, data ) ) {
+		resetImage( newIdx );
+		mem_Release( data->fileName );
 		mem_Release( data );
+		return -1;
 	}
+
+	// the slot is reserved so it can be used until the load is done
+	sbImageDrawData[newIdx].loadState = LOAD_STATE_PENDING;
+	sbImageDrawData[newIdx].uvMax = VEC2_ZERO;
+	sbImageDrawData[newIdx].shaderType = shaderType;
+
+	setImageID( newIdx, fileName );
+	assetCache_Store( &imgCache, key, newHandle );
+	sbImages[newIdx].watchID = fw_Watch( fileName, imageFileChanged, (void*)(intptr_t)newHandle );
+
+	return newHandle;
+}
+
+// swaps in the new version of the image, the new texture is created first so if there's a problem the old one is kept
+static void replaceFromLoadedImage( int idx, LoadedImage* loadedImg, const char* fileName )
+{
+	AtlasResult atlasResult;
+	int atlasHandle = texAtlas_Add( loadedImg, &atlasResult );
+	if( atlasHandle < 0 ) {
+		if( gfxUtil_CreateTextureFromLoadedImage( GL_RGBA, loadedImg, &( atlasResult.texture ), GL_NEAREST ) < 0 ) {
+			llog( LOG_WARN, "Unable to reload image %s, keeping the old one.", fileName );
+			return;
+		}
+		atlasResult.minUV = VEC2_ZERO;
+		atlasResult.maxUV = VEC2_ONE;
+	}
+
+	// anything already waiting to be drawn is using the old texture
+	removeDrawInstructions( toHandle( idx ) );
+	triRenderer_ClearGroupsUsingTextureArea( sbImageDrawData[idx].textureObj, sbImageDrawData[idx].uvMin, sbImageDrawData[idx].uvMax );
+	releaseTexture( idx );
+
+	Vector2 offset = sbImageDrawData[idx].offset;
+	setupImage( idx, &atlasResult, atlasHandle, sbImageDrawData[idx].shaderType );
+	sbImageDrawData[idx].offset = offset;
+}
+
+static void bindReloadedImage( void* data, bool loaded )
+{
+	ThreadedLoadImageData* loadData = (ThreadedLoadImageData*)data;
+
+	// the image may have been cleaned up while it was being reloaded
+	int idx = toIndex( loadData->handle );
+	if( !loaded ) {
+		llog( LOG_WARN, "Unable to reload image %s, keeping the old one.", loadData->fileName );
+	} else if( ( idx >= 0 ) && ( sbImageDrawData[idx].loadState == LOAD_STATE_NONE ) ) {
+		replaceFromLoadedImage( idx, &( loadData->loadedImage ), loadData->fileName );
+	}
+
+	cleanUpThreadedLoadImageData( loadData );
+}
+
+// decodes the changed file in the background, the image keeps using the old version until it's done
+static void imageFileChanged( const char* fileName, void* data )
+{
+	int handle = (int)(intptr_t)data;
+
+	// anything still loading will be swapped in when it's done
+	int idx = toIndex( handle );
+	if( ( idx < 0 ) || ( sbImageDrawData[idx].loadState != LOAD_STATE_NONE ) ) {
+		return;
+	}
+
+	ThreadedLoadImageData* loadData = createThreadedLoadImageData( fileName );
+	if( loadData == NULL ) {
+		return;
+	}
+	loadData->handle = handle;
+
+	if( !lq_Add( LOAD_PRIORITY_HIGH, fileName, loadImage, bindReloadedImage, loadData ) ) {
+		cleanUpThreadedLoadImageData( loadData );
+	}
+}
+
+void img_SetPlaceholder( int imgID )
+{
+	placeholderImage = imgID;
+}
+
+bool img_IsLoading( int imgID )
+{
+	int idx = toIndex( imgID );
+	if( idx < 0 ) {
+		return false;
+	}
+
+	return ( sbImageDrawData[idx].loadState == LOAD_STATE_PENDING );
 }
 
 /*
@@ -342,89 +635,160 @@ Creates an image from a surface.
 */
 int img_Create( SDL_Surface* surface, ShaderType shaderType, const char* id )
 {
-	int newIdx;
-
 	assert( surface != NULL );
 
-	newIdx = findAvailableImageIndex( );
+	Texture texture;
+	if( gfxUtil_CreateTextureFromSurface( surface, &texture ) < 0 ) {
+		llog( LOG_INFO, "Unable to convert surface to texture! SDL Error: %s", SDL_GetError( ) );
+		return -1;
+	}
+
+	int newIdx = claimImageIndex( );
 	if( newIdx < 0 ) {
 		llog( LOG_INFO, "Unable to create image from surface! Image storage full." );
+		GL( glDeleteTextures( 1, &( texture.textureID ) ) );
 		return -1;
 	}
 
-	Texture texture;
-	if( gfxUtil_CreateTextureFromSurface( surface, &texture ) < 0 ) {
-		llog( LOG_INFO, "Unable to convert surface to texture! SDL Error: %s", SDL_GetError( ) );
-		return -1;
-	} else {
-		images[newIdx].size.v[0] = (float)texture.width;
-		images[newIdx].size.v[1] = (float)texture.height;
-		images[newIdx].offset = VEC2_ZERO;
-		images[newIdx].packageID = -1;
-		images[newIdx].flags = IMGFLAG_IN_USE;
-		images[newIdx].nextInPackage = -1;
-		images[newIdx].uvMin = VEC2_ZERO;
-		images[newIdx].uvMax = VEC2_ONE;
-		images[newIdx].shaderType = shaderType;
-		if( texture.flags & TF_IS_TRANSPARENT ) {
-			images[newIdx].flags |= IMGFLAG_HAS_TRANSPARENCY;
+	addTextureRef( texture.textureID );
+
+	ImageDrawData* drawData = &( sbImageDrawData[newIdx] );
+	drawData->textureObj = texture.textureID;
+	drawData->size.v[0] = (float)texture.width;
+	drawData->size.v[1] = (float)texture.height;
+	drawData->shaderType = shaderType;
+	if( texture.flags & TF_IS_TRANSPARENT ) {
+		drawData->flags |= IMGFLAG_HAS_TRANSPARENCY;
+	}
+
+	setImageID( newIdx, id );
+
+	return toHandle( newIdx );
+}
+
+// removes anything we're wanting to draw with the image, everything left stays in the order it was drawn and the
+//  queued group draws are moved so they're still between the same instructions
+static void removeDrawInstructions( int imgID )
+{
+	int numKept = 0;
+	int nextGroupDraw = 0;
+	for( int bufIdx = 0; bufIdx <= lastDrawInstruction; ++bufIdx ) {
+		while( ( nextGroupDraw < numQueuedGroupDraws ) && ( queuedGroupDraws[nextGroupDraw].beforeInstruction <= bufIdx ) ) {
+			queuedGroupDraws[nextGroupDraw].beforeInstruction = numKept;
+			++nextGroupDraw;
+		}
+
+		if( renderBuffer[bufIdx].imageObj != imgID ) {
+			if( numKept != bufIdx ) {
+				renderBuffer[numKept] = renderBuffer[bufIdx];
+			}
+			++numKept;
 		}
 	}
 
-	if( id != NULL ) {
-		hashMap_Set( &imgIDMap, id, newIdx );
+	for( ; nextGroupDraw < numQueuedGroupDraws; ++nextGroupDraw ) {
+		queuedGroupDraws[nextGroupDraw].beforeInstruction = numKept;
 	}
 
-	return newIdx;
+	lastDrawInstruction = numKept - 1;
+}
+
+// gives back the space the image was using in the atlas, or deletes its texture if no other image is using it
+static void releaseTexture( int idx )
+{
+	if( sbImages[idx].atlasHandle >= 0 ) {
+		// the page is shared, just give the space back
+		texAtlas_Remove( sbImages[idx].atlasHandle );
+		sbImages[idx].atlasHandle = -1;
+	} else if( sbImageDrawData[idx].textureObj != 0 ) {
+		// only delete it if this is the last image using that texture
+		GLuint texture = sbImageDrawData[idx].textureObj;
+		int* refCount = texRefMap_Get( &texRefMap, texture );
+		if( refCount != NULL ) {
+			--(*refCount);
+			if( (*refCount) > 0 ) {
+				return;
+			}
+			texRefMap_Remove( &texRefMap, texture );
+		}
+
+		GL( glDeleteTextures( 1, &texture ) );
+	}
 }
 
 /*
-Cleans up an image at the specified index, trying to render with it after this won't work.
+Cleans up an image, trying to render with it after this won't work. Images loaded from files are only cleaned up once
+ every load of them has been cleaned.
 */
-void img_Clean( int idx )
+void img_Clean( int imgID )
 {
-	assert( idx < MAX_IMAGES );
-	assert( idx >= 0 );
-	assert( images[idx].flags & IMGFLAG_IN_USE );
+	int idx = toIndex( imgID );
+	assert( ( idx >= 0 ) && "Cleaning up an image that isn't in use." );
 
-	int bufIdx;
+	if( idx < 0 ) {
+		return;
+	}
 
-	if( ( idx < 0 ) || ( ( images[idx].size.v[0] == 0.0f ) && ( images[idx].size.v[1] == 0.0f ) ) || ( idx >= MAX_IMAGES ) ) {
+	if( !assetCache_Release( &imgCache, sbImages[idx].id, imgID ) ) {
 		return;
 	}
 
-	/* clean up anything we're wanting to draw */
-	for( bufIdx = 0; bufIdx <= lastDrawInstruction; ++bufIdx ) {
-		if( renderBuffer[bufIdx].imageObj == idx ) {
-			if( lastDrawInstruction > 0 ) {
-				renderBuffer[bufIdx] = renderBuffer[lastDrawInstruction-1];
-			}
-			--lastDrawInstruction;
-			--bufIdx;
-		}
+	ImageDrawData* drawData = &( sbImageDrawData[idx] );
+
+	if( drawData->loadState == LOAD_STATE_PENDING ) {
+		// the slot is still needed for the load, it's freed when the load finishes
+		drawData->loadState = LOAD_STATE_CANCELLED;
+		return;
 	}
 
-	// see if this is the last image using that texture
-	//  TODO: See if this needs to be sped up
-	int deleteTexture = 1;
-	for( int i = 0; ( i < MAX_IMAGES ) && deleteTexture; ++i ) {
-		if( ( images[i].flags & IMGFLAG_IN_USE ) && ( images[i].textureObj == images[idx].textureObj ) ) {
-			deleteTexture = 0;
-		}
+	if( drawData->loadState == LOAD_STATE_CANCELLED ) {
+		return;
 	}
 
-	if( deleteTexture ) {
-		glDeleteTextures( 1, &( images[idx].textureObj ) );
+	if( drawData->loadState == LOAD_STATE_FAILED ) {
+		// nothing was created for it, anything drawn with it was using the placeholder
+		resetImage( idx );
+		return;
 	}
-	images[idx].size = VEC2_ZERO;
-	images[idx].flags = 0;
-	images[idx].packageID = -1;
-	images[idx].nextInPackage = -1;
-	images[idx].uvMin = VEC2_ZERO;
-	images[idx].uvMax = VEC2_ZERO;
-	images[idx].shaderType = ST_DEFAULT;
 
-	hashMap_RemoveFirstByValue( &imgIDMap, idx );
+	if( ( drawData->size.v[0] == 0.0f ) && ( drawData->size.v[1] == 0.0f ) ) {
+		return;
+	}
+
+	removeDrawInstructions( imgID );
+	triRenderer_ClearGroupsUsingTextureArea( drawData->textureObj, drawData->uvMin, drawData->uvMax );
+	releaseTexture( idx );
+	resetImage( idx );
+}
+
+// frees up the slot, doesn't clean up anything the image was using
+static void resetImage( int idx )
+{
+	// only remove the id if a newer image hasn't replaced it
+	int* storedHandle = imgIDMap_Get( &imgIDMap, sbImages[idx].id );
+	if( ( storedHandle != NULL ) && ( (*storedHandle) == toHandle( idx ) ) ) {
+		imgIDMap_Remove( &imgIDMap, sbImages[idx].id );
+	}
+
+	fw_Unwatch( sbImages[idx].watchID );
+	sbImages[idx].watchID = -1;
+
+	// the generation is kept so the next image in this slot gets a different handle
+	sbImageDrawData[idx].textureObj = 0;
+	sbImageDrawData[idx].size = VEC2_ZERO;
+	sbImageDrawData[idx].flags = 0;
+	sbImageDrawData[idx].uvMin = VEC2_ZERO;
+	sbImageDrawData[idx].uvMax = VEC2_ZERO;
+	sbImageDrawData[idx].shaderType = ST_DEFAULT;
+	sbImageDrawData[idx].loadState = LOAD_STATE_NONE;
+
+	sbImages[idx].packageID = -1;
+	sbImages[idx].nextInPackage = -1;
+	sbImages[idx].atlasHandle = -1;
+	sbImages[idx].id = INVALID_SYMBOL;
+
+	sbImages[idx].nextFree = firstFreeImage;
+	firstFreeImage = idx;
 }
 
 /*
@@ -433,48 +797,84 @@ Finds the next unused package ID.
 int findUnusedPackage( void )
 {
 	int packageID = 0;
-	for( int i = 0; i < MAX_IMAGES; ++i ) {
-		if( ( images[i].flags & IMGFLAG_IN_USE ) && ( images[i].packageID <= packageID ) ) {
-			packageID = images[i].packageID + 1;
+	int count = (int)sb_Count( sbImages );
+	for( int i = 0; i < count; ++i ) {
+		if( ( sbImageDrawData[i].flags & IMGFLAG_IN_USE ) && ( sbImages[i].packageID <= packageID ) ) {
+			packageID = sbImages[i].packageID + 1;
 		}
 	}
 	return packageID;
 }
 
-/*
-Splits the texture. Returns a negative number if there's a problem.
-*/
-int split( Texture* texture, int packageID, ShaderType shaderType, int count, Vector2* mins, Vector2* maxes, char** imgIDs, int* retIDs )
+// sets up the image at idx to use the area of the texture between min and max
+static void setupSplitImage( int idx, Texture* texture, Vector2* min, Vector2* max )
 {
 	Vector2 inverseSize;
 	inverseSize.x = 1.0f / (float)texture->width;
 	inverseSize.y = 1.0f / (float)texture->height;
 
+	addTextureRef( texture->textureID );
+
+	ImageDrawData* drawData = &( sbImageDrawData[idx] );
+	drawData->textureObj = texture->textureID;
+	vec2_Subtract( max, min, &( drawData->size ) );
+	vec2_HadamardProd( min, &inverseSize, &( drawData->uvMin ) );
+	vec2_HadamardProd( max, &inverseSize, &( drawData->uvMax ) );
+	if( texture->flags & TF_IS_TRANSPARENT ) {
+		drawData->flags |= IMGFLAG_HAS_TRANSPARENCY;
+	}
+}
+
+/*
+Points the image at the area of the texture between min and max without changing its id, used to swap in images that
+ have been reloaded. The old texture is deleted if nothing else is using it.
+ Returns < 0 if the image isn't valid or hasn't finished loading.
+*/
+int img_ReplaceTexture( int imgID, Texture* texture, Vector2* min, Vector2* max )
+{
+	assert( texture != NULL );
+
+	int idx = toIndex( imgID );
+	if( ( idx < 0 ) || ( sbImageDrawData[idx].loadState != LOAD_STATE_NONE ) ) {
+		return -1;
+	}
+
+	removeDrawInstructions( imgID );
+	triRenderer_ClearGroupsUsingTextureArea( sbImageDrawData[idx].textureObj, sbImageDrawData[idx].uvMin, sbImageDrawData[idx].uvMax );
+	releaseTexture( idx );
+
+	sbImageDrawData[idx].flags &= ~IMGFLAG_HAS_TRANSPARENCY;
+	setupSplitImage( idx, texture, min, max );
+
+	return 0;
+}
+
+/*
+Splits the texture, the ids can either be strings or already interned, both can be NULL.
+ Returns a negative number if there's a problem.
+*/
+int split( Texture* texture, int packageID, ShaderType shaderType, int count, Vector2* mins, Vector2* maxes, char** imgIDs,
+	Symbol* imgSymbols, int* retIDs )
+{
 	for( int i = 0; i < count; ++i ) {
-		int newIdx = findAvailableImageIndex( );
+		int newIdx = claimImageIndex( );
 		if( newIdx < 0 ) {
 			llog( LOG_ERROR, "Problem finding available image to split into." );
 			img_CleanPackage( packageID );
 			return -1;
 		}
 
-		images[newIdx].textureObj = texture->textureID;
-		vec2_Subtract( &( maxes[i] ), &( mins[i] ), &( images[newIdx].size ) );
-		images[newIdx].offset = VEC2_ZERO;
-		images[newIdx].packageID = packageID;
-		images[newIdx].flags = IMGFLAG_IN_USE;
-		vec2_HadamardProd( &( mins[i] ), &inverseSize, &( images[newIdx].uvMin ) );
-		vec2_HadamardProd( &( maxes[i] ), &inverseSize, &( images[newIdx].uvMax ) );
-		images[newIdx].shaderType = shaderType;
-		if( texture->flags & TF_IS_TRANSPARENT ) {
-			images[newIdx].flags |= IMGFLAG_HAS_TRANSPARENCY;
-		}
+		setupSplitImage( newIdx, texture, &( mins[i] ), &( maxes[i] ) );
+		sbImageDrawData[newIdx].shaderType = shaderType;
+		sbImages[newIdx].packageID = packageID;
 
-		if( ( imgIDs != NULL ) && ( imgIDs[i] != NULL ) ) {
-			hashMap_Set( &imgIDMap, imgIDs[i], newIdx );
+		if( imgSymbols != NULL ) {
+			setImageSymbol( newIdx, imgSymbols[i] );
+		} else if( ( imgIDs != NULL ) && ( imgIDs[i] != NULL ) ) {
+			setImageID( newIdx, imgIDs[i] );
 		}
 
-		retIDs[i] = newIdx;
+		retIDs[i] = toHandle( newIdx );
 	}
 
 	return 0;
@@ -485,22 +885,290 @@ Takes in a file name and some rectangles. It's assumed the length of mins, maxes
  Returns package ID used to clean up later, returns -1 if there's a problem.
 */
 int img_SplitImageFile( char* fileName, int count, ShaderType shaderType, Vector2* mins, Vector2* maxes, char** imgIDs, int* retIDs )
+{
+	LoadedImage loadedImage;
+	if( gfxUtil_LoadImage( fileName, &loadedImage ) < 0 ) {
+		llog( LOG_ERROR, "Problem loading image %s", fileName );
+		return -1;
+	}
+
+	int packageID = img_SplitLoadedImage( &loadedImage, count, shaderType, mins, maxes, imgIDs, retIDs );
+	gfxUtil_ReleaseLoadedImage( &loadedImage );
+
+	return packageID;
+}
+
+static int splitLoadedImage( LoadedImage* loadedImage, int count, ShaderType shaderType, Vector2* mins, Vector2* maxes,
+	char** imgIDs, Symbol* imgSymbols, int* retIDs )
 {
 	int currPackageID = findUnusedPackage( );
 
 	Texture texture;
-	if( gfxUtil_LoadTexture( fileName, &texture ) < 0 ) {
-		llog( LOG_ERROR, "Problem loading image %s", fileName );
+	if( gfxUtil_CreateTextureFromLoadedImage( GL_RGBA, loadedImage, &texture, GL_NEAREST ) < 0 ) {
+		llog( LOG_ERROR, "Problem creating texture to split." );
 		return -1;
 	}
 
-	if( split( &texture, currPackageID, shaderType, count, mins, maxes, imgIDs, retIDs ) < 0 ) {
+	if( split( &texture, currPackageID, shaderType, count, mins, maxes, imgIDs, imgSymbols, retIDs ) < 0 ) {
 		return -1;
 	}
 
 	return currPackageID;
 }
 
+/*
+Takes in an already decoded image and some rectangles, only creates the texture and the images. It's assumed the length
+ of mins, maxes, and retIDs equals count.
+ Returns package ID used to clean up later, returns -1 if there's a problem.
+*/
+int img_SplitLoadedImage( LoadedImage* loadedImage, int count, ShaderType shaderType, Vector2* mins, Vector2* maxes, char** imgIDs, int* retIDs )
+{
+	return splitLoadedImage( loadedImage, count, shaderType, mins, maxes, imgIDs, NULL, retIDs );
+}
+
+/*
+Same as img_SplitLoadedImage but the ids have already been interned, imgIDs can be NULL.
+*/
+int img_SplitLoadedImageWithSymbols( LoadedImage* loadedImage, int count, ShaderType shaderType, Vector2* mins, Vector2* maxes, Symbol* imgIDs, int* retIDs )
+{
+	return splitLoadedImage( loadedImage, count, shaderType, mins, maxes, NULL, imgIDs, retIDs );
+}
+
+typedef struct {
+	char* fileName;
+	int count;
+	int* handles;
+	Vector2* mins;
+	Vector2* maxes;
+	bool staged; // if the texture can be uploaded over a few frames, the batch loads need it right away
+	LoadedImage loadedImage;
+} SplitImageLoadData;
+
+static void cleanUpSplitImageLoadData( SplitImageLoadData* loadData )
+{
+	if( loadData == NULL ) {
+		return;
+	}
+
+	gfxUtil_ReleaseLoadedImage( &( loadData->loadedImage ) );
+	mem_Release( loadData->fileName );
+	mem_Release( loadData->handles );
+	mem_Release( loadData->mins );
+	mem_Release( loadData->maxes );
+	mem_Release( loadData );
+}
+
+static bool loadSplitImage( void* data )
+{
+	SplitImageLoadData* loadData = (SplitImageLoadData*)data;
+	return ( gfxUtil_LoadImage( loadData->fileName, &( loadData->loadedImage ) ) >= 0 );
+}
+
+// sets up the reserved images once the texture is done, texture is NULL if it couldn't be created, frees the load data
+static void finishSplitImages( SplitImageLoadData* loadData, Texture* texture )
+{
+	bool anyUsed = false;
+	for( int i = 0; i < loadData->count; ++i ) {
+		int idx = toIndex( loadData->handles[i] );
+		assert( idx >= 0 );
+		if( sbImageDrawData[idx].loadState == LOAD_STATE_CANCELLED ) {
+			resetImage( idx );
+		} else if( texture != NULL ) {
+			setupSplitImage( idx, texture, &( loadData->mins[i] ), &( loadData->maxes[i] ) );
+			sbImageDrawData[idx].loadState = LOAD_STATE_NONE;
+			anyUsed = true;
+		} else {
+			sbImageDrawData[idx].loadState = LOAD_STATE_FAILED;
+		}
+	}
+
+	// everything was cleaned up while it was being uploaded
+	if( ( texture != NULL ) && !anyUsed ) {
+		GL( glDeleteTextures( 1, &( texture->textureID ) ) );
+	}
+
+	cleanUpSplitImageLoadData( loadData );
+}
+
+static void splitImageUploaded( void* data, bool success, Texture* texture )
+{
+	SplitImageLoadData* loadData = (SplitImageLoadData*)data;
+
+	if( !success ) {
+		llog( LOG_INFO, "Unable to upload split image %s!", loadData->fileName );
+	}
+
+	finishSplitImages( loadData, success ? texture : NULL );
+}
+
+static void bindSplitImage( void* data, bool loaded )
+{
+	SplitImageLoadData* loadData = (SplitImageLoadData*)data;
+
+	// the slots stay reserved until the load is done, if they've all been cleaned up there's no need for the texture
+	bool anyWanted = false;
+	for( int i = 0; i < loadData->count; ++i ) {
+		int idx = toIndex( loadData->handles[i] );
+		assert( idx >= 0 );
+		if( sbImageDrawData[idx].loadState != LOAD_STATE_CANCELLED ) {
+			anyWanted = true;
+		}
+	}
+
+	// the images stay pending until the upload is done
+	if( loaded && anyWanted && loadData->staged &&
+		texUpload_Queue( &( loadData->loadedImage ), GL_NEAREST, splitImageUploaded, loadData ) ) {
+		return;
+	}
+
+	Texture texture;
+	bool created = false;
+	if( loaded && anyWanted ) {
+		created = ( gfxUtil_CreateTextureFromLoadedImage( GL_RGBA, &( loadData->loadedImage ), &texture, GL_NEAREST ) >= 0 );
+	}
+
+	if( anyWanted && !created ) {
+		llog( LOG_INFO, "Unable to bind split image %s!", loadData->fileName );
+	}
+
+	finishSplitImages( loadData, created ? &texture : NULL );
+}
+
+/*
+Reserves the images for a split that's loaded in the background and creates the data for the load.
+ Returns NULL if there's a problem, nothing is reserved then.
+*/
+static SplitImageLoadData* reserveSplitImages( const char* fileName, int count, ShaderType shaderType, Vector2* mins,
+	Vector2* maxes, char** imgIDs, int* retIDs, int* outPackageID )
+{
+	assert( count > 0 );
+
+	SplitImageLoadData* loadData = mem_Allocate( sizeof( SplitImageLoadData ) );
+	if( loadData == NULL ) {
+		llog( LOG_WARN, "Unable to create data for threaded split of file %s", fileName );
+		return NULL;
+	}
+	memset( loadData, 0, sizeof( SplitImageLoadData ) );
+
+	size_t fileNameLen = strlen( fileName );
+	loadData->fileName = mem_Allocate( fileNameLen + 1 );
+	loadData->handles = mem_Allocate( sizeof( loadData->handles[0] ) * count );
+	loadData->mins = mem_Allocate( sizeof( loadData->mins[0] ) * count );
+	loadData->maxes = mem_Allocate( sizeof( loadData->maxes[0] ) * count );
+	if( ( loadData->fileName == NULL ) || ( loadData->handles == NULL ) || ( loadData->mins == NULL ) || ( loadData->maxes == NULL ) ) {
+		llog( LOG_WARN, "Unable to create storage for threaded split of file %s", fileName );
+		cleanUpSplitImageLoadData( loadData );
+		return NULL;
+	}
+	SDL_strlcpy( loadData->fileName, fileName, fileNameLen + 1 );
+	memcpy( loadData->mins, mins, sizeof( loadData->mins[0] ) * count );
+	memcpy( loadData->maxes, maxes, sizeof( loadData->maxes[0] ) * count );
+	loadData->count = count;
+
+	int packageID = findUnusedPackage( );
+	for( int i = 0; i < count; ++i ) {
+		int newIdx = claimImageIndex( );
+		if( newIdx < 0 ) {
+			llog( LOG_ERROR, "Problem finding available image to split %s into.", fileName );
+			for( int r = 0; r < i; ++r ) {
+				resetImage( toIndex( loadData->handles[r] ) );
+			}
+			cleanUpSplitImageLoadData( loadData );
+			return NULL;
+		}
+
+		// the slot is reserved so it can be used until the load is done
+		sbImageDrawData[newIdx].loadState = LOAD_STATE_PENDING;
+		sbImageDrawData[newIdx].uvMax = VEC2_ZERO;
+		sbImageDrawData[newIdx].shaderType = shaderType;
+		sbImages[newIdx].packageID = packageID;
+
+		if( ( imgIDs != NULL ) && ( imgIDs[i] != NULL ) ) {
+			setImageID( newIdx, imgIDs[i] );
+		}
+
+		loadData->handles[i] = toHandle( newIdx );
+	}
+
+	memcpy( retIDs, loadData->handles, sizeof( retIDs[0] ) * count );
+	(*outPackageID) = packageID;
+
+	return loadData;
+}
+
+/*
+Same as img_SplitImageFile but the image is loaded in the background. The ids put into retIDs can be used right away,
+ until the image is loaded the placeholder is drawn in their place.
+ Returns package ID used to clean up later, returns -1 if the load couldn't be started.
+*/
+int img_ThreadedSplitImageFile( const char* fileName, int count, ShaderType shaderType, Vector2* mins, Vector2* maxes,
+	char** imgIDs, int* retIDs, LoadPriority priority )
+{
+	assert( fileName != NULL );
+
+	int packageID;
+	SplitImageLoadData* loadData = reserveSplitImages( fileName, count, shaderType, mins, maxes, imgIDs, retIDs, &packageID );
+	if( loadData == NULL ) {
+		return -1;
+	}
+	loadData->staged = true;
+
+	if( !lq_Add( priority, fileName, loadSplitImage, bindSplitImage, loadData ) ) {
+		for( int i = 0; i < count; ++i ) {
+			resetImage( toIndex( loadData->handles[i] ) );
+		}
+		cleanUpSplitImageLoadData( loadData );
+		return -1;
+	}
+
+	return packageID;
+}
+
+/*
+Splits a group of image files at once. The images are decoded on the worker threads in parallel, only the textures are
+ created on the calling thread. Doesn't return until they're all done.
+ Returns the number of splits that failed, the packageID of each of those will be -1.
+*/
+int img_SplitImageFileBatch( SplitImageLoad* loads, int numLoads )
+{
+	assert( ( loads != NULL ) || ( numLoads == 0 ) );
+
+	int numFailed = 0;
+
+	void** sbLoadData = NULL;
+	for( int i = 0; i < numLoads; ++i ) {
+		SplitImageLoad* load = &( loads[i] );
+		SplitImageLoadData* loadData = reserveSplitImages( load->fileName, load->count, load->shaderType, load->mins,
+			load->maxes, load->imgIDs, load->retIDs, &( load->packageID ) );
+		if( loadData == NULL ) {
+			load->packageID = -1;
+			++numFailed;
+		} else {
+			sb_Push( sbLoadData, loadData );
+		}
+	}
+
+	lq_LoadBatch( loadSplitImage, bindSplitImage, sbLoadData, (int)sb_Count( sbLoadData ) );
+	sb_Release( sbLoadData );
+
+	// nothing was drawn with them yet, so anything that failed is just cleaned up instead of being left to the placeholder
+	for( int i = 0; i < numLoads; ++i ) {
+		if( ( loads[i].packageID < 0 ) || ( loads[i].count <= 0 ) ) {
+			continue;
+		}
+
+		int idx = toIndex( loads[i].retIDs[0] );
+		if( ( idx >= 0 ) && ( sbImageDrawData[idx].loadState == LOAD_STATE_FAILED ) ) {
+			llog( LOG_ERROR, "Problem splitting image %s", loads[i].fileName );
+			img_CleanPackage( loads[i].packageID );
+			loads[i].packageID = -1;
+			++numFailed;
+		}
+	}
+
+	return numFailed;
+}
+
 /*
 Takes in an RGBA bitmap and some rectangles. It's assumed the length of mins, maxes, and retIDs equals count.
  Returns package ID used to clean up later, returns -1 if there's a problem.
@@ -515,7 +1183,7 @@ int img_SplitRGBABitmap( uint8_t* data, int width, int height, int count, Shader
 		return -1;
 	}
 
-	if( split( &texture, currPackageID, shaderType, count, mins, maxes, NULL, retIDs ) < 0 ) {
+	if( split( &texture, currPackageID, shaderType, count, mins, maxes, NULL, NULL, retIDs ) < 0 ) {
 		return -1;
 	}
 
@@ -536,7 +1204,7 @@ int img_SplitAlphaBitmap( uint8_t* data, int width, int height, int count, Shade
 		return -1;
 	}
 
-	if( split( &texture, currPackageID, shaderType, count, mins, maxes, NULL, retIDs) < 0 ) {
+	if( split( &texture, currPackageID, shaderType, count, mins, maxes, NULL, NULL, retIDs) < 0 ) {
 		return -1;
 	}
 
@@ -548,9 +1216,10 @@ Cleans up all the images in an image package.
 */
 void img_CleanPackage( int packageID )
 {
-	for( int i = 0; i < MAX_IMAGES; ++i ) {
-		if( ( images[i].flags & IMGFLAG_IN_USE ) && ( images[i].packageID == packageID ) ) {
-			img_Clean( i );
+	int count = (int)sb_Count( sbImages );
+	for( int i = 0; i < count; ++i ) {
+		if( ( sbImageDrawData[i].flags & IMGFLAG_IN_USE ) && ( sbImages[i].packageID == packageID ) ) {
+			img_Clean( toHandle( i ) );
 		}
 	}
 }
@@ -558,47 +1227,48 @@ void img_CleanPackage( int packageID )
 /*
 Sets an offset to render the image from. The default is the center of the image.
 */
-void img_SetOffset( int idx, Vector2 offset )
+void img_SetOffset( int imgID, Vector2 offset )
 {
-	assert( idx < MAX_IMAGES );
+	int idx = toIndex( imgID );
 	assert( idx >= 0 );
 
-	if( ( idx < 0 ) || ( !( images[idx].flags & IMGFLAG_IN_USE ) ) || ( idx >= MAX_IMAGES ) ) {
+	if( idx < 0 ) {
 		return;
 	}
 
-	images[idx].offset = offset;
+	sbImageDrawData[idx].offset = offset;
 }
 
 #include "../Utils/helpers.h"
-void img_ForceTransparency( int idx, bool transparent )
+void img_ForceTransparency( int imgID, bool transparent )
 {
-	assert( idx < MAX_IMAGES );
+	int idx = toIndex( imgID );
 	assert( idx >= 0 );
 
-	if( !( images[idx].flags & IMGFLAG_IN_USE ) ) {
+	if( idx < 0 ) {
 		return;
 	}
 
 	if( transparent ) {
-		TURN_ON_BITS( images[idx].flags, IMGFLAG_HAS_TRANSPARENCY );
+		TURN_ON_BITS( sbImageDrawData[idx].flags, IMGFLAG_HAS_TRANSPARENCY );
 	} else {
-		TURN_OFF_BITS( images[idx].flags, IMGFLAG_HAS_TRANSPARENCY );
+		TURN_OFF_BITS( sbImageDrawData[idx].flags, IMGFLAG_HAS_TRANSPARENCY );
 	}
 }
 
 /*
 Gets the size of the image, putting it into the out Vector2. Returns a negative number if there's an issue.
 */
-int img_GetSize( int idx, Vector2* out )
+int img_GetSize( int imgID, Vector2* out )
 {
 	assert( out != NULL );
 
-	if( ( idx < 0 ) || ( !( images[idx].flags & IMGFLAG_IN_USE ) ) || ( idx >= MAX_IMAGES ) ) {
+	int idx = toIndex( imgID );
+	if( idx < 0 ) {
 		return -1;
 	}
 
-	(*out) = images[idx].size;
+	(*out) = sbImageDrawData[idx].size;
 	return 0;
 }
 
@@ -606,26 +1276,52 @@ int img_GetSize( int idx, Vector2* out )
 Gets the texture id for the image, used if you need to render it directly instead of going through this.
  Returns whether out was successfully set or not.
 */
-int img_GetTextureID( int idx, GLuint* out )
+int img_GetTextureID( int imgID, GLuint* out )
 {
 	assert( out != NULL );
 
-	if( ( idx < 0 ) || ( !( images[idx].flags & IMGFLAG_IN_USE ) ) || ( idx >= MAX_IMAGES ) ) {
+	int idx = toIndex( imgID );
+	if( idx < 0 ) {
 		return -1;
 	}
 
-	(*out) = images[idx].textureObj;
+	(*out) = sbImageDrawData[idx].textureObj;
+	return 0;
+}
+
+/*
+Gets the area of the texture the image uses. Returns a negative number if there's an issue.
+*/
+int img_GetUVs( int imgID, Vector2* outMin, Vector2* outMax )
+{
+	assert( outMin != NULL );
+	assert( outMax != NULL );
+
+	int idx = toIndex( imgID );
+	if( idx < 0 ) {
+		return -1;
+	}
+
+	(*outMin) = sbImageDrawData[idx].uvMin;
+	(*outMax) = sbImageDrawData[idx].uvMax;
 	return 0;
 }
 
 // Retrieves a loaded image by it's id, for images loaded from files this will be the local path, for sprite sheet images 
 int img_GetExistingByID( const char* id )
 {
-	int idx;
-	if( !hashMap_Find( &imgIDMap, id, &idx ) ) {
+	// if the id was never interned then nothing could have been stored with it
+	return img_GetExistingBySymbol( sym_Find( id ) );
+}
+
+// Same as img_GetExistingByID but takes an already interned id, use this for lookups that happen often
+int img_GetExistingBySymbol( Symbol id )
+{
+	int handle;
+	if( ( id == INVALID_SYMBOL ) || !imgIDMap_Find( &imgIDMap, id, &handle ) ) {
 		return -1;
 	}
-	return idx;
+	return handle;
 }
 
 /*
@@ -636,60 +1332,101 @@ initializes the structure so only what's used needs to be set, also fill in
 */
 static DrawInstruction* GetNextRenderInstruction( int imgObj, uint32_t camFlags, Vector2 startPos, Vector2 endPos, int8_t depth )
 {
-	// the image hasn't been loaded yet, so don't render anything
 	if( imgObj < 0 ) {
-		// TODO: Use a temporary image.
 		return NULL;
 	}
 
-	if( !( images[imgObj].flags & IMGFLAG_IN_USE ) ) {
+	int idx = toIndex( imgObj );
+	if( idx < 0 ) {
 		llog( LOG_VERBOSE, "Attempting to draw invalid image: %i", imgObj );
 		return NULL;
 	}
 
-	if( ( lastDrawInstruction + 1 ) >= MAX_RENDER_INSTRUCTIONS ) {
-		llog( LOG_VERBOSE, "Render instruction queue full." );
-		return NULL;
+	// the image hasn't been loaded yet, draw the placeholder instead if there is one
+	if( sbImageDrawData[idx].loadState != LOAD_STATE_NONE ) {
+		idx = toIndex( placeholderImage );
+		if( ( idx < 0 ) || ( sbImageDrawData[idx].loadState != LOAD_STATE_NONE ) ) {
+			return NULL;
+		}
+		imgObj = placeholderImage;
 	}
 
-	++lastDrawInstruction;
-	DrawInstruction* ri = &( renderBuffer[lastDrawInstruction] );
+	const ImageDrawData* drawData = &( sbImageDrawData[idx] );
+
+	DrawInstruction* ri;
+	if( recordingGroup >= 0 ) {
+		ri = &recordedInstruction;
+	} else {
+		if( ( lastDrawInstruction + 1 ) >= MAX_RENDER_INSTRUCTIONS ) {
+			llog( LOG_VERBOSE, "Render instruction queue full." );
+			return NULL;
+		}
+
+		++lastDrawInstruction;
+		ri = &( renderBuffer[lastDrawInstruction] );
+	}
 
 	*ri = DEFAULT_DRAW_INSTRUCTION;
-	ri->textureObj = images[imgObj].textureObj;
+	ri->textureObj = drawData->textureObj;
 	ri->imageObj = imgObj;
 	ri->start.pos = startPos;
 	ri->end.pos = endPos;
-	ri->start.scaledSize = images[imgObj].size;
-	ri->end.scaledSize = images[imgObj].size;
+	ri->start.scaledSize = drawData->size;
+	ri->end.scaledSize = drawData->size;
 	ri->start.color = CLR_WHITE;
 	ri->end.color = CLR_WHITE;
 	ri->start.rotation = 0.0f;
 	ri->end.rotation = 0.0f;
-	ri->start.offset = images[imgObj].offset;
-	ri->end.offset = images[imgObj].offset;
+	ri->start.offset = drawData->offset;
+	ri->end.offset = drawData->offset;
 	ri->start.floatVal0 = 0.0f;
 	ri->end.floatVal0 = 0.0f;
-	ri->flags = images[imgObj].flags;
+	ri->flags = drawData->flags;
 	ri->camFlags = camFlags;
-	ri->shaderType = images[imgObj].shaderType;
+	ri->shaderType = drawData->shaderType;
 	ri->depth = depth;
 	ri->scissorID = scissor_GetTopID( );
 	memcpy( ri->uvs, DEFAULT_DRAW_INSTRUCTION.uvs, sizeof( ri->uvs ) );
 
-	ri->uvs[0] = images[imgObj].uvMin;
+	ri->uvs[0] = drawData->uvMin;
 
-	ri->uvs[1].x = images[imgObj].uvMin.x;
-	ri->uvs[1].y = images[imgObj].uvMax.y;
+	ri->uvs[1].x = drawData->uvMin.x;
+	ri->uvs[1].y = drawData->uvMax.y;
 
-	ri->uvs[2].x = images[imgObj].uvMax.x;
-	ri->uvs[2].y = images[imgObj].uvMin.y;
+	ri->uvs[2].x = drawData->uvMax.x;
+	ri->uvs[2].y = drawData->uvMin.y;
 
-	ri->uvs[3] = images[imgObj].uvMax;
+	ri->uvs[3] = drawData->uvMax;
 
 	return ri;
 }
 
+static void instructionToSprite( const DrawInstruction* ri, float t, TriSprite* outSprite )
+{
+	vec2_Lerp( &( ri->start.pos ), &( ri->end.pos ), t, &( outSprite->pos ) );
+	clr_Lerp( &( ri->start.color ), &( ri->end.color ), t, &( outSprite->col ) );
+	vec2_Lerp( &( ri->start.scaledSize ), &( ri->end.scaledSize ), t, &( outSprite->size ) );
+	vec2_Lerp( &( ri->start.offset ), &( ri->end.offset ), t, &( outSprite->offset ) );
+	outSprite->floatVal0 = lerp( ri->start.floatVal0, ri->end.floatVal0, t );
+	outSprite->rotation = radianRotLerp( ri->start.rotation, ri->end.rotation, t );
+	outSprite->uvMin = ri->uvs[0];
+	outSprite->uvMax = ri->uvs[3];
+}
+
+// called once the instruction is completely set up, if we're recording a group this is where it's added to it
+static int finishDrawInstruction( DrawInstruction* ri )
+{
+	if( recordingGroup < 0 ) {
+		return 0;
+	}
+
+	// groups aren't interpolated, so only the starting values are used
+	TriSprite sprite;
+	instructionToSprite( ri, 0.0f, &sprite );
+	int transparent = ( ri->flags & IMGFLAG_HAS_TRANSPARENCY ) != 0;
+	return triRenderer_AddSpriteToGroup( recordingGroup, &sprite, ri->shaderType, ri->textureObj, transparent );
+}
+
 /*
 Adds to the list of images to draw.
 */
@@ -698,7 +1435,7 @@ Adds to the list of images to draw.
 	if( ri == NULL ) { return -1; }
 
 #define DRAW_INSTRUCTION_END \
-	return 0;
+	return finishDrawInstruction( ri );
 
 #define SET_DRAW_INSTRUCTION_SCALE( startX, startY, endX, endY ) \
 	ri->start.scaledSize.x *= startX; \
@@ -968,84 +1705,74 @@ Clears the image draw list.
 void img_ClearDrawInstructions( void )
 {
 	lastDrawInstruction = -1;
+	numQueuedGroupDraws = 0;
+}
+
+void img_BeginGroup( int groupID )
+{
+	assert( recordingGroup < 0 );
+	triRenderer_ClearGroup( groupID );
+	recordingGroup = groupID;
 }
 
-static void createRenderTransform( Vector2* pos, Vector2* scale, float rot,  Vector2* offset, Matrix4* out )
+void img_EndGroup( void )
 {
-	memcpy( out, &IDENTITY_MATRIX, sizeof( Matrix4 ) );
-	// this is the fully multiplied out multiplication of the transform, scale, and z-rotation
-	// pos * rot * offset * scale
-	//  problem here if the scale is different in each dimension (e.g scale = { 16, 24 }), the rotation isn't taken
-	//  into account so you end up with an oddly stretched image
+	recordingGroup = -1;
+}
 
-	
-	float cosRot = cosf( rot );
-	float sinRot = sinf( rot );
+int img_DrawGroup( int groupID, uint32_t camFlags, Vector2 offset, int8_t depth )
+{
+	if( numQueuedGroupDraws >= MAX_QUEUED_GROUP_DRAWS ) {
+		llog( LOG_VERBOSE, "Too many group draws this tick." );
+		return -1;
+	}
 
-	out->m[0] = cosRot * scale->v[0];
-	out->m[1] = sinRot * scale->v[0];
-	out->m[4] = -sinRot * scale->v[1];
-	out->m[5] = cosRot * scale->v[1];
-	//out->m[10] = scale->v[2];
-	out->m[12] = pos->v[0] - ( offset->v[1] * sinRot ) + ( offset->v[0] * cosRot );
-	out->m[13] = pos->v[1] + ( offset->v[0] * sinRot ) + ( offset->v[1] * cosRot );
-	//out->m[14] = -pos->v[2]; //*/
+	QueuedGroupDraw* draw = &( queuedGroupDraws[numQueuedGroupDraws] );
+	++numQueuedGroupDraws;
 
-	// pos * rot * scale * offset
-	/*out->m[0] = cosRot * scale->v[0];
-	out->m[1] = sinRot * scale->v[0];
-	out->m[4] = -sinRot * scale->v[1];
-	out->m[5] = cosRot * scale->v[1];
+	draw->groupID = groupID;
+	draw->camFlags = camFlags;
+	draw->offset = offset;
+	draw->depth = depth;
+	draw->scissorID = scissor_GetTopID( );
+	draw->beforeInstruction = lastDrawInstruction + 1;
 
-	out->m[12] = pos->v[0] + ( offset->v[0] * scale->v[0] * cosRot ) + ( offset->v[1] * scale->v[1] * -sinRot );
-	out->m[13] = pos->v[1] + ( offset->v[0] * scale->v[0] * sinRot ) + ( offset->v[1] * scale->v[1] * cosRot );//*/
+	return 0;
+}
+
+static void addQueuedGroupDraw( const QueuedGroupDraw* draw )
+{
+	triRenderer_AddGroup( draw->groupID, draw->offset, draw->scissorID, draw->camFlags, draw->depth );
 }
 
 /*
 Draw all the images.
 */
-void img_Render( float normTimeElapsed )
+void img_Render( void )
 {
-	Vector2 unitSqVertPos[] = { { -0.5f, -0.5f }, { -0.5f, 0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f } };
-	GLuint indices[] = {
-		0, 1, 2,
-		1, 2, 3,
-	};
+	RSTATS_ADD_TICK( images, lastDrawInstruction + 1 );
 
+	int nextGroupDraw = 0;
 	for( int idx = 0; idx <= lastDrawInstruction; ++idx ) {
-		TriVert verts[4];
-
-		// generate the sprites matrix
-		Matrix4 modelTf;
-		Vector2 pos, sclSz, offset;
-		float rot;
-		Color col;
-		float floatVal0;
-
-		vec2_Lerp( &( renderBuffer[idx].start.pos ), &( renderBuffer[idx].end.pos ), normTimeElapsed, &pos );
-		clr_Lerp( &( renderBuffer[idx].start.color ), &( renderBuffer[idx].end.color ), normTimeElapsed, &col );
-		vec2_Lerp( &( renderBuffer[idx].start.scaledSize ), &( renderBuffer[idx].end.scaledSize ), normTimeElapsed, &sclSz );
-		vec2_Lerp( &( renderBuffer[idx].start.offset ), &( renderBuffer[idx].end.offset ), normTimeElapsed, &offset );
-		floatVal0 = lerp( renderBuffer[idx].start.floatVal0, renderBuffer[idx].end.floatVal0, normTimeElapsed );
-
-		rot = radianRotLerp( renderBuffer[idx].start.rotation, renderBuffer[idx].end.rotation, normTimeElapsed );
-		createRenderTransform( &pos, &sclSz, rot, &offset, &modelTf );
-
-		for( int i = 0; i < 4; ++i ) {
-			mat4_TransformVec2Pos( &modelTf, &( unitSqVertPos[i] ), &( verts[i].pos ) );
-			verts[i].uv = renderBuffer[idx].uvs[i];
-			verts[i].col = col;
+		while( ( nextGroupDraw < numQueuedGroupDraws ) && ( queuedGroupDraws[nextGroupDraw].beforeInstruction <= idx ) ) {
+			addQueuedGroupDraw( &( queuedGroupDraws[nextGroupDraw] ) );
+			++nextGroupDraw;
 		}
 
-		int transparent = ( renderBuffer[idx].flags & IMGFLAG_HAS_TRANSPARENCY ) != 0;
+		DrawInstruction* ri = &( renderBuffer[idx] );
+
+		// the renderer interpolates between these every frame, the end uses the shortest rotation from the start
+		TriSprite start;
+		TriSprite end;
+		instructionToSprite( ri, 0.0f, &start );
+		instructionToSprite( ri, 1.0f, &end );
+
+		int transparent = ( ri->flags & IMGFLAG_HAS_TRANSPARENCY ) != 0;
 
-		triRenderer_Add( verts[indices[0]], verts[indices[1]], verts[indices[2]],
-			renderBuffer[idx].shaderType, renderBuffer[idx].textureObj, floatVal0,
-			renderBuffer[idx].scissorID, renderBuffer[idx].camFlags, renderBuffer[idx].depth,
-			transparent );
-		triRenderer_Add( verts[indices[3]], verts[indices[4]], verts[indices[5]],
-			renderBuffer[idx].shaderType, renderBuffer[idx].textureObj, floatVal0,
-			renderBuffer[idx].scissorID, renderBuffer[idx].camFlags, renderBuffer[idx].depth,
-			transparent );
+		triRenderer_AddTweenedSprite( &start, &end, ri->shaderType, ri->textureObj, ri->scissorID, ri->camFlags, ri->depth, transparent );
 	}
-}
\ No newline at end of file
+
+	for( ; nextGroupDraw < numQueuedGroupDraws; ++nextGroupDraw ) {
+		addQueuedGroupDraw( &( queuedGroupDraws[nextGroupDraw] ) );
+	}
+}
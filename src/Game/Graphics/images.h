@@ -8,6 +8,14 @@
 #include "color.h"
 #include "triRendering.h"
 #include "gfxUtil.h"
+#include "../Utils/symbols.h"
+#include "../System/loadQueue.h"
+
+/*
+Images are referenced by the ids returned when they're created. The id holds which slot the image is stored in along
+ with a count of how many times that slot has been used, so an id for an image that's been cleaned up won't refer to
+ whatever replaces it. Using an old id is treated the same as using an invalid one.
+*/
 
 /*
 Initializes images.
@@ -17,14 +25,28 @@ int img_Init( void );
 
 //************ Threaded functions
 /*
-Loads the image in a seperate thread. Puts the resulting image index into outIdx.
+Streams the image in the background. The returned index can be used right away, until the image is loaded the
+ placeholder is drawn in its place. If the image is already loaded or loading a reference to it is added instead, the
+ same as img_Load.
+ Returns -1 if the load couldn't be started.
 */
-void img_ThreadedLoad( const char* fileName, ShaderType shaderType, int* outIdx );
+int img_ThreadedLoad( const char* fileName, ShaderType shaderType, LoadPriority priority );
 
 //************ End threaded functions
 
 /*
-Loads the image stored at file name.
+Sets the image drawn in place of any image that's still loading or failed to load, -1 draws nothing instead.
+*/
+void img_SetPlaceholder( int imgID );
+
+/*
+Returns whether the image is still being streamed in.
+*/
+bool img_IsLoading( int idx );
+
+/*
+Loads the image stored at file name. The file is watched, if it changes the image is reloaded in the background and
+ swapped in without changing the index.
  Returns the index of the image on success.
  Returns -1 on failure, and prints a message to the log.
 */
@@ -46,7 +68,7 @@ Creates an image from a surface.
 int img_Create( SDL_Surface* surface, ShaderType shaderType, const char* id );
 
 /*
-Cleans up an image at the specified index, trying to render with it after this won't work.
+Cleans up an image, trying to render with it after this won't work.
 */
 void img_Clean( int idx );
 
@@ -56,6 +78,52 @@ Takes in a file name and some rectangles. It's assumed the length of mins, maxes
 */
 int img_SplitImageFile( char* fileName, int count, ShaderType shaderType, Vector2* mins, Vector2* maxes, char** imgIDs, int* retIDs );
 
+/*
+Takes in an already decoded image and some rectangles, only creates the texture and the images. It's assumed the length
+ of mins, maxes, and retIDs equals count.
+ Returns package ID used to clean up later, returns -1 if there's a problem.
+*/
+int img_SplitLoadedImage( LoadedImage* loadedImage, int count, ShaderType shaderType, Vector2* mins, Vector2* maxes, char** imgIDs, int* retIDs );
+
+/*
+Same as img_SplitLoadedImage but the ids have already been interned, imgIDs can be NULL.
+*/
+int img_SplitLoadedImageWithSymbols( LoadedImage* loadedImage, int count, ShaderType shaderType, Vector2* mins, Vector2* maxes, Symbol* imgIDs, int* retIDs );
+
+/*
+Points the image at the area of the texture between min and max without changing its index, used to swap in images
+ that have been reloaded. The old texture is deleted if nothing else is using it.
+ Returns < 0 if the image isn't valid or hasn't finished loading.
+*/
+int img_ReplaceTexture( int imgID, Texture* texture, Vector2* min, Vector2* max );
+
+/*
+Same as img_SplitImageFile but the image is loaded in the background. The ids put into retIDs can be used right away,
+ until the image is loaded the placeholder is drawn in their place. mins, maxes, and imgIDs are copied so they don't
+ have to be kept around.
+ Returns package ID used to clean up later, returns -1 if the load couldn't be started.
+*/
+int img_ThreadedSplitImageFile( const char* fileName, int count, ShaderType shaderType, Vector2* mins, Vector2* maxes,
+	char** imgIDs, int* retIDs, LoadPriority priority );
+
+typedef struct {
+	const char* fileName;
+	int count;
+	ShaderType shaderType;
+	Vector2* mins;
+	Vector2* maxes;
+	char** imgIDs; // can be NULL
+	int* retIDs;
+	int packageID; // set by img_SplitImageFileBatch, -1 if the split failed
+} SplitImageLoad;
+
+/*
+Splits a group of image files at once. The images are decoded on the worker threads in parallel, only the textures are
+ created on the calling thread. Doesn't return until they're all done.
+ Returns the number of splits that failed.
+*/
+int img_SplitImageFileBatch( SplitImageLoad* loads, int numLoads );
+
 /*
 Takes in an RGBA bitmap and some rectangles. It's assumed the length of mins, maxes, and retIDs equals count.
  Returns package ID used to clean up later, returns -1 if there's a problem.
@@ -86,14 +154,23 @@ Gets the size of the image, putting it into the out Vector2. Returns a negative
 int img_GetSize( int idx, Vector2* out );
 
 /*
-Gets the texture id for the image, used if you need to render it directly instead of going through this.
+Gets the texture id for the image, used if you need to render it directly instead of going through this. The texture
+ may be shared with other images, use img_GetUVs to get the part of it this image uses.
  Returns whether out was successfully set or not.
 */
 int img_GetTextureID( int idx, GLuint* out );
 
+/*
+Gets the area of the texture the image uses. Returns a negative number if there's an issue.
+*/
+int img_GetUVs( int idx, Vector2* outMin, Vector2* outMax );
+
 // Retrieves a loaded image by it's id, for images loaded from files this will be the local path, for sprite sheet images 
 int img_GetExistingByID( const char* id );
 
+// Same as img_GetExistingByID but takes an already interned id, use this for lookups that happen often
+int img_GetExistingBySymbol( Symbol id );
+
 /*
 Adds to the list of images to draw.
 */
@@ -137,8 +214,20 @@ Clears the image draw list.
 void img_ClearDrawInstructions( void );
 
 /*
-Draw all the images.
+Records all the img_Draw calls made until img_EndGroup into the group instead of drawing them this frame, anything
+ already in the group is removed first. Groups aren't interpolated, only the starting values of each draw are used
+ and the positions are relative to the offset the group is drawn at. The group is created with
+ triRenderer_CreateGroup and is drawn each tick with img_DrawGroup. If an image used in the group is reloaded or
+ cleaned up the group is cleared and triRenderer_IsGroupStale returns true until it's recorded again.
+*/
+void img_BeginGroup( int groupID );
+void img_EndGroup( void );
+int img_DrawGroup( int groupID, uint32_t camFlags, Vector2 offset, int8_t depth );
+
+/*
+Adds all the images to the triangle renderer, with where they start and end over the tick. Only needs to be called once
+ per tick, the triangle renderer handles the interpolation.
 */
-void img_Render( float normTimeElapsed );
+void img_Render( void );
 
 #endif /* inclusion guard */
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "renderSort.h"
+
+#include <string.h>
+#include <assert.h>
+
+#define SHADER_BITS 4
+#define TEXTURE_BITS 20
+#define SCISSOR_BITS 8
+#define FLOAT_VAL_BITS 16
+#define DEPTH_BITS 16
+
+#define MASK( bits ) ( ( (uint64_t)1 << (bits) ) - 1 )
+
+// converts the float so comparing the results as unsigned integers gives the same ordering as comparing the floats
+static uint32_t orderedFloatBits( float f )
+{
+	uint32_t bits;
+	memcpy( &bits, &f, sizeof( bits ) );
+	return ( bits & 0x80000000 ) ? ~bits : ( bits | 0x80000000 );
+}
+
+uint64_t renderSort_StateKey( uint32_t shader, uint32_t texture, int32_t scissorID, float floatVal0, float depth )
+{
+	// scissor ids start at -1
+	uint64_t scissor = (uint64_t)( (int64_t)scissorID + 1 );
+
+	uint64_t key = (uint64_t)shader & MASK( SHADER_BITS );
+	key = ( key << TEXTURE_BITS ) | ( (uint64_t)texture & MASK( TEXTURE_BITS ) );
+	key = ( key << SCISSOR_BITS ) | ( scissor & MASK( SCISSOR_BITS ) );
+	key = ( key << FLOAT_VAL_BITS ) | ( orderedFloatBits( floatVal0 ) >> ( 32 - FLOAT_VAL_BITS ) );
+	key = ( key << DEPTH_BITS ) | ( orderedFloatBits( depth ) >> ( 32 - DEPTH_BITS ) );
+
+	return key;
+}
+
+uint64_t renderSort_DepthKey( float depth )
+{
+	return ( (uint64_t)orderedFloatBits( depth ) << 32 );
+}
+
+RenderSortEntry* renderSort_Sort( RenderSortEntry* entries, RenderSortEntry* scratch, size_t count )
+{
+	assert( ( count == 0 ) || ( ( entries != NULL ) && ( scratch != NULL ) ) );
+
+	// build the histograms for all eight bytes in one pass
+	size_t histograms[8][256];
+	memset( histograms, 0, sizeof( histograms ) );
+	for( size_t i = 0; i < count; ++i ) {
+		uint64_t key = entries[i].key;
+		for( int b = 0; b < 8; ++b ) {
+			++histograms[b][( key >> ( b * 8 ) ) & 0xFF];
+		}
+	}
+
+	RenderSortEntry* src = entries;
+	RenderSortEntry* dest = scratch;
+
+	for( int b = 0; b < 8; ++b ) {
+		size_t* histogram = histograms[b];
+
+		// if every key has the same value for this byte then this pass wouldn't change anything, most of the upper bytes
+		//  end up being skipped like this
+		if( ( count == 0 ) || ( histogram[( src[0].key >> ( b * 8 ) ) & 0xFF] == count ) ) {
+			continue;
+		}
+
+		// turn the counts into starting offsets
+		size_t total = 0;
+		for( int d = 0; d < 256; ++d ) {
+			size_t c = histogram[d];
+			histogram[d] = total;
+			total += c;
+		}
+
+		for( size_t i = 0; i < count; ++i ) {
+			size_t digit = ( src[i].key >> ( b * 8 ) ) & 0xFF;
+			dest[histogram[digit]++] = src[i];
+		}
+
+		RenderSortEntry* swap = src;
+		src = dest;
+		dest = swap;
+	}
+
+	return src;
+}
@@ -0,0 +1,35 @@
+#ifndef RENDER_SORT_H
+#define RENDER_SORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+Sorting for the triangle renderer. Each triangle gets a packed 64-bit key and we sort ( key, index ) pairs with an
+ LSD radix sort, so only the small entries move around instead of the triangles themselves. Doesn't touch any OpenGL
+ so it can be benchmarked without a context.
+
+Render state keys, most significant bits first:
+ shader (4 bits), texture (20 bits), scissor (8 bits), floatVal0 bucket (16 bits), depth (16 bits)
+Depth keys are just the depth in the upper 32 bits.
+
+Any fields that are truncated can only cause the state to change more often when drawing, the renderer still checks
+ the actual values when batching, so nothing will be drawn with the wrong state.
+*/
+
+typedef struct {
+	uint64_t key;
+	uint32_t idx;
+} RenderSortEntry;
+
+// key used for opaque triangles, groups them by the state needed to render them
+uint64_t renderSort_StateKey( uint32_t shader, uint32_t texture, int32_t scissorID, float floatVal0, float depth );
+
+// key used for transparent triangles, they have to be drawn in depth order
+uint64_t renderSort_DepthKey( float depth );
+
+// sorts the entries by key in ascending order, scratch must be able to hold count entries
+//  returns a pointer to whichever of the two arrays ends up holding the sorted entries
+RenderSortEntry* renderSort_Sort( RenderSortEntry* entries, RenderSortEntry* scratch, size_t count );
+
+#endif /* inclusion guard */
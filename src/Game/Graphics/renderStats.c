@@ -0,0 +1,119 @@
+#include "renderStats.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "../System/platformLog.h"
+
+RenderStats renderStatsFrame;
+RenderStats renderStatsTick;
+
+static RenderStats lastTick;
+
+static RenderStats history[RENDER_STATS_HISTORY];
+static int historyCount = 0;
+static int historyNext = 0;
+
+static int logInterval = 0;
+static int framesSinceLog = 0;
+
+void rstats_EndTick( void )
+{
+	lastTick = renderStatsTick;
+	memset( &renderStatsTick, 0, sizeof( renderStatsTick ) );
+}
+
+void rstats_EndFrame( void )
+{
+#define ADD_TICK_FIELD( name, desc ) renderStatsFrame.name += lastTick.name;
+	RENDER_STATS_FIELDS( ADD_TICK_FIELD )
+#undef ADD_TICK_FIELD
+
+	history[historyNext] = renderStatsFrame;
+	historyNext = ( historyNext + 1 ) % RENDER_STATS_HISTORY;
+	if( historyCount < RENDER_STATS_HISTORY ) {
+		++historyCount;
+	}
+
+	memset( &renderStatsFrame, 0, sizeof( renderStatsFrame ) );
+
+	if( logInterval > 0 ) {
+		++framesSinceLog;
+		if( framesSinceLog >= logInterval ) {
+			framesSinceLog = 0;
+			rstats_LogAverages( );
+		}
+	}
+}
+
+void rstats_GetLastFrame( RenderStats* outStats )
+{
+	assert( outStats != NULL );
+
+	if( historyCount == 0 ) {
+		memset( outStats, 0, sizeof( RenderStats ) );
+		return;
+	}
+
+	int last = ( historyNext + RENDER_STATS_HISTORY - 1 ) % RENDER_STATS_HISTORY;
+	(*outStats) = history[last];
+}
+
+void rstats_GetAverages( RenderStatsAverages* outAverages )
+{
+	assert( outAverages != NULL );
+
+	memset( outAverages, 0, sizeof( RenderStatsAverages ) );
+	outAverages->numFrames = historyCount;
+	if( historyCount == 0 ) {
+		return;
+	}
+
+	for( int i = 0; i < historyCount; ++i ) {
+#define SUM_FIELD( name, desc ) outAverages->name += (float)history[i].name;
+		RENDER_STATS_FIELDS( SUM_FIELD )
+#undef SUM_FIELD
+	}
+
+#define AVERAGE_FIELD( name, desc ) outAverages->name /= (float)historyCount;
+	RENDER_STATS_FIELDS( AVERAGE_FIELD )
+#undef AVERAGE_FIELD
+}
+
+void rstats_Reset( void )
+{
+	memset( &renderStatsFrame, 0, sizeof( renderStatsFrame ) );
+	memset( &renderStatsTick, 0, sizeof( renderStatsTick ) );
+	memset( &lastTick, 0, sizeof( lastTick ) );
+	historyCount = 0;
+	historyNext = 0;
+	framesSinceLog = 0;
+}
+
+float rstats_DrawnPerDrawCall( const RenderStatsAverages* averages )
+{
+	assert( averages != NULL );
+
+	if( averages->drawCalls <= 0.0f ) {
+		return 0.0f;
+	}
+	return ( ( averages->trisSubmitted - averages->trisCulled ) + ( averages->spritesSubmitted - averages->spritesCulled ) ) / averages->drawCalls;
+}
+
+void rstats_LogAverages( void )
+{
+	RenderStatsAverages avg;
+	rstats_GetAverages( &avg );
+
+	llog( LOG_INFO, "Render stats averaged over %i frames:", avg.numFrames );
+#define LOG_FIELD( name, desc ) llog( LOG_INFO, "  %s: %.1f", desc, avg.name );
+	RENDER_STATS_FIELDS( LOG_FIELD )
+#undef LOG_FIELD
+	llog( LOG_INFO, "  drawn per draw call: %.1f", rstats_DrawnPerDrawCall( &avg ) );
+}
+
+void rstats_SetLogInterval( int frames )
+{
+	logInterval = frames;
+	framesSinceLog = 0;
+}
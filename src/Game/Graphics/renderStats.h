@@ -0,0 +1,90 @@
+#ifndef RENDER_STATS_H
+#define RENDER_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+Per frame counts of what the renderers did, filled in by the triangle renderer, images, spine, and the debug renderer.
+ Everything is counted on the main thread as the GL calls are made, so nothing here is synchronized.
+The last RENDER_STATS_HISTORY frames are kept so rolling averages can be shown in the overlay or logged.
+*/
+
+#define RENDER_STATS_HISTORY 60
+
+// name, description
+#define RENDER_STATS_FIELDS( X ) \
+	X( drawCalls, "draw calls" ) \
+	X( shaderBinds, "shader binds" ) \
+	X( textureBinds, "texture binds" ) \
+	X( scissorChanges, "scissor changes" ) \
+	X( bytesUploaded, "bytes uploaded" ) \
+	X( trisSubmitted, "triangles submitted" ) \
+	X( trisCulled, "triangles culled" ) \
+	X( spritesSubmitted, "sprites submitted" ) \
+	X( spritesCulled, "sprites culled" ) \
+	X( groupDraws, "group draws" ) \
+	X( images, "images" ) \
+	X( spineInstances, "spine instances" ) \
+	X( spineTris, "spine triangles" ) \
+	X( debugVerts, "debug vertices" )
+
+#define RENDER_STATS_COUNT_FIELD( name, desc ) uint32_t name;
+typedef struct {
+	RENDER_STATS_FIELDS( RENDER_STATS_COUNT_FIELD )
+} RenderStats;
+#undef RENDER_STATS_COUNT_FIELD
+
+#define RENDER_STATS_AVERAGE_FIELD( name, desc ) float name;
+typedef struct {
+	RENDER_STATS_FIELDS( RENDER_STATS_AVERAGE_FIELD )
+	int numFrames; // how many frames went into the averages, less than RENDER_STATS_HISTORY until the history fills
+} RenderStatsAverages;
+#undef RENDER_STATS_AVERAGE_FIELD
+
+// the frame currently being counted, use RSTATS_ADD instead of touching this directly
+extern RenderStats renderStatsFrame;
+
+#define RSTATS_ADD( field, amount ) ( renderStatsFrame.field += (uint32_t)( amount ) )
+
+// the tick currently being counted, for things that are only added once per tick instead of every frame, like the images
+//  and spine instances, use RSTATS_ADD_TICK instead of touching this directly
+extern RenderStats renderStatsTick;
+
+#define RSTATS_ADD_TICK( field, amount ) ( renderStatsTick.field += (uint32_t)( amount ) )
+
+/*
+Finishes counting the current tick, what was counted is added to every frame until the next tick is finished. Called
+ from triRenderer_FinishTick.
+*/
+void rstats_EndTick( void );
+
+/*
+Finishes counting the current frame, adding it to the history and starting a new one. Called at the end of gfx_Render.
+*/
+void rstats_EndFrame( void );
+
+void rstats_GetLastFrame( RenderStats* outStats );
+void rstats_GetAverages( RenderStatsAverages* outAverages );
+void rstats_Reset( void );
+
+// how many triangles and sprites made it to the screen for each draw call, the higher the better batching is working
+float rstats_DrawnPerDrawCall( const RenderStatsAverages* averages );
+
+/*
+Writes the rolling averages to the log. If the interval is > 0 this is done automatically every interval frames.
+*/
+void rstats_LogAverages( void );
+void rstats_SetLogInterval( int frames );
+
+/*
+Optional nuklear window showing the last frame and the rolling averages, rstats_DoOverlay does nothing unless the
+ overlay has been turned on. Has to be called between nk_input_end and the render of the context. These are in
+ renderStatsOverlay.c.
+*/
+struct nk_context;
+void rstats_ShowOverlay( bool show );
+void rstats_ToggleOverlay( void );
+void rstats_DoOverlay( struct nk_context* ctx );
+
+#endif /* inclusion guard */
@@ -0,0 +1,55 @@
+#include "renderStats.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "../IMGUI/nuklearHeader.h"
+
+// kept apart from the counting so things that don't use nuklear, like the benchmarks, can still be built with the stats
+
+static bool overlayShown = false;
+
+void rstats_ShowOverlay( bool show )
+{
+	overlayShown = show;
+}
+
+void rstats_ToggleOverlay( void )
+{
+	overlayShown = !overlayShown;
+}
+
+void rstats_DoOverlay( struct nk_context* ctx )
+{
+	assert( ctx != NULL );
+
+	if( !overlayShown ) {
+		return;
+	}
+
+	RenderStats last;
+	RenderStatsAverages avg;
+	rstats_GetLastFrame( &last );
+	rstats_GetAverages( &avg );
+
+	if( nk_begin( ctx, "Render Stats", nk_rect( 10.0f, 10.0f, 300.0f, 400.0f ),
+			NK_WINDOW_BORDER | NK_WINDOW_MOVABLE | NK_WINDOW_SCALABLE | NK_WINDOW_MINIMIZABLE | NK_WINDOW_TITLE ) ) {
+
+		nk_layout_row_dynamic( ctx, 14.0f, 3 );
+		nk_label( ctx, "", NK_TEXT_LEFT );
+		nk_label( ctx, "last", NK_TEXT_RIGHT );
+		nk_labelf( ctx, NK_TEXT_RIGHT, "avg of %i", avg.numFrames );
+
+#define OVERLAY_FIELD( name, desc ) \
+		nk_label( ctx, desc, NK_TEXT_LEFT ); \
+		nk_labelf( ctx, NK_TEXT_RIGHT, "%u", (unsigned int)last.name ); \
+		nk_labelf( ctx, NK_TEXT_RIGHT, "%.1f", avg.name );
+		RENDER_STATS_FIELDS( OVERLAY_FIELD )
+#undef OVERLAY_FIELD
+
+		nk_label( ctx, "drawn per draw", NK_TEXT_LEFT );
+		nk_label( ctx, "", NK_TEXT_RIGHT );
+		nk_labelf( ctx, NK_TEXT_RIGHT, "%.1f", rstats_DrawnPerDrawCall( &avg ) );
+	}
+	nk_end( ctx );
+}
@@ -240,7 +240,7 @@ size_t shaders_Load( const ShaderDefinition* shaderDefs, size_t numShaderDefs,
 	size_t i;
 
 	// zero out, this also sets all the programs to invalid
-	memset( shaderPrograms, 0, sizeof(GLuint) * numShaderPrograms );
+	memset( shaderPrograms, 0, sizeof(ShaderProgram) * numShaderPrograms );
 
 	numShaders = numShaderDefs;
 	shaders = (struct Shader*)mem_Allocate( sizeof(struct Shader) * numShaders );
@@ -5,8 +5,10 @@
 
 #include "triRendering.h"
 #include "debugRendering.h"
+#include "renderStats.h"
 #include "gfxUtil.h"
 #include "../Utils/helpers.h"
+#include "../Utils/assetPack.h"
 #include "../System/memory.h"
 #include "../System/platformLog.h"
 
@@ -72,7 +74,7 @@ char* _spUtil_readFile( const char* path, int* length )
 {
 	char* data;
 
-	SDL_RWops* rwopsFile = SDL_RWFromFile( path, "rb" );
+	SDL_RWops* rwopsFile = assetPack_OpenFile( path );
 	if( rwopsFile == NULL ) {
 		return NULL;
 	}
@@ -417,7 +419,8 @@ void spine_UpdateInstances( float dt )
 	}
 }
 
-static void drawCharacter( SpineInstance* spine )
+// the skeleton is posed at the start of the tick, the whole thing moves by delta over the tick
+static void drawCharacter( SpineInstance* spine, const Vector2* delta )
 {
 	// just draw bone positions to start with
 	//GLuint texture;
@@ -445,6 +448,7 @@ static void drawCharacter( SpineInstance* spine )
 				spRegionAttachment_computeWorldVertices( regionAttachment, slot->bone, vertices );
 
 				TriVert verts[4];
+				TriVert endVerts[4];
 
 				for( int x = 0; x < 4; ++x ) {
 					verts[x].pos.x = vertices[2*x];
@@ -454,12 +458,18 @@ static void drawCharacter( SpineInstance* spine )
 					verts[x].uv.t = regionAttachment->uvs[(2*x)+1];
 
 					verts[x].col = col;
+
+					endVerts[x] = verts[x];
+					vec2_Add( &( verts[x].pos ), delta, &( endVerts[x].pos ) );
 				}
 
 				texture = (Texture*)((spAtlasRegion*)regionAttachment->rendererObject)->page->rendererObject;
 
-				triRenderer_Add( verts[0], verts[1], verts[2], ST_DEFAULT, texture->textureID, 0.0f, 0, camFlags, depth, texture->flags & TF_IS_TRANSPARENT );
-				triRenderer_Add( verts[0], verts[2], verts[3], ST_DEFAULT, texture->textureID, 0.0f, 0, camFlags, depth, texture->flags & TF_IS_TRANSPARENT );
+				TriVert startTri[3] = { verts[0], verts[2], verts[3] };
+				TriVert endTri[3] = { endVerts[0], endVerts[2], endVerts[3] };
+				triRenderer_AddTweenedVertices( verts, endVerts, ST_DEFAULT, texture->textureID, 0.0f, 0, camFlags, depth, texture->flags & TF_IS_TRANSPARENT );
+				triRenderer_AddTweenedVertices( startTri, endTri, ST_DEFAULT, texture->textureID, 0.0f, 0, camFlags, depth, texture->flags & TF_IS_TRANSPARENT );
+				RSTATS_ADD_TICK( spineTris, 2 );
 			} break;
 		/*case SP_ATTACHMENT_BOUNDING_BOX: {
 				// if we're debugging 
@@ -490,18 +500,25 @@ static void drawCharacter( SpineInstance* spine )
 
 				for( int x = 0; x < meshAttachment->trianglesCount; x+=3 ) {
 					TriVert verts[3];
+					TriVert endVerts[3];
 					
 					for( int j = 0; j < 3; ++j ) {
 						int baseIndex = meshAttachment->triangles[x+j] * 2;
 						verts[j].pos.x = spineVertices[baseIndex];
 						verts[j].pos.y = spineVertices[baseIndex+1];
 
-						verts[x].uv.s = meshAttachment->uvs[baseIndex];
-						verts[x].uv.t = meshAttachment->uvs[baseIndex+1];
+						verts[j].uv.s = meshAttachment->uvs[baseIndex];
+						verts[j].uv.t = meshAttachment->uvs[baseIndex+1];
+
+						verts[j].col = col;
+
+						endVerts[j] = verts[j];
+						vec2_Add( &( verts[j].pos ), delta, &( endVerts[j].pos ) );
 					}
 
 					//debugRenderer_Triangle( camFlags, verts[0], verts[1], verts[2], CLR_GREEN );
-					triRenderer_AddVertices( verts, ST_DEFAULT, texture->textureID, 0.0f, 0, camFlags, depth, texture->flags & TF_IS_TRANSPARENT );
+					triRenderer_AddTweenedVertices( verts, endVerts, ST_DEFAULT, texture->textureID, 0.0f, 0, camFlags, depth, texture->flags & TF_IS_TRANSPARENT );
+					RSTATS_ADD_TICK( spineTris, 1 );
 				}
 			} break;
 		default:
@@ -514,18 +531,22 @@ static void drawCharacter( SpineInstance* spine )
 /*
 Draws all the spine instances.
 */
-void spine_RenderInstances( float normTimeElapsed )
+void spine_RenderInstances( void )
 {
 	for( int i = 0; i <= lastInstance; ++i ) {
 		if( instances[i].skeleton == NULL ) {
 			continue;
 		}
 
-		Vector2 pos;
-		vec2_Lerp( &( instances[i].startPos ), &( instances[i].endPos ), normTimeElapsed, &pos );
-		instances[i].skeleton->x = pos.x;
-		instances[i].skeleton->y = pos.y;
+		// the positions of the bones only depend on the root, so the end of the tick is just the start moved
+		instances[i].skeleton->x = instances[i].startPos.x;
+		instances[i].skeleton->y = instances[i].startPos.y;
+		spSkeleton_updateWorldTransform( instances[i].skeleton );
+
+		Vector2 delta;
+		vec2_Subtract( &( instances[i].endPos ), &( instances[i].startPos ), &delta );
 
-		drawCharacter( &( instances[i] ) );
+		drawCharacter( &( instances[i] ), &delta );
+		RSTATS_ADD_TICK( spineInstances, 1 );
 	}
 }
\ No newline at end of file
@@ -87,8 +87,9 @@ Updates all the instance animations.
 void spine_UpdateInstances( float dt );
 
 /*
-Draws all the spine instances.
+Adds all the spine instances to the triangle renderer, moving from their start position to their end position over
+ the tick. Only needs to be called once per tick, the animations are stepped by spine_UpdateInstances.
 */
-void spine_RenderInstances( float normTimeElapsed );
+void spine_RenderInstances( void );
 
 #endif
\ No newline at end of file
@@ -0,0 +1,20 @@
+#include "spriteSheetFormat.h"
+
+uint64_t sheetBin_HashData( const uint8_t* data, size_t size )
+{
+	uint64_t hash = 0xCBF29CE484222325ull;
+	for( size_t i = 0; i < size; ++i ) {
+		hash ^= data[i];
+		hash *= 0x100000001B3ull;
+	}
+	return hash;
+}
+
+size_t sheetBin_FileSize( const SheetBinHeader* header )
+{
+	uint64_t size = sizeof( SheetBinHeader ) + ( (uint64_t)header->numSprites * sizeof( SheetBinSprite ) ) + header->stringsSize;
+	if( size > SIZE_MAX ) {
+		return SIZE_MAX;
+	}
+	return (size_t)size;
+}
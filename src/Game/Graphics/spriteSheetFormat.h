@@ -0,0 +1,49 @@
+#ifndef SPRITE_SHEET_FORMAT_H
+#define SPRITE_SHEET_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+Layout of the binary sprite sheet files, shared between the game and the SheetCompiler tool so it doesn't need anything
+ else from the game to build.
+A binary sheet holds the same thing as the text definition already parsed, so loading one is just checking the header
+ and reading the sprites in place. They're stored next to the text definition with SHEET_BIN_EXTENSION appended, e.g.
+ "Images/display_box.ss.bin".
+ header
+ sprites, numSprites SheetBinSprite
+ strings, stringsSize bytes, holds the image file name and the sprite ids, none of them are null terminated
+The header stores a hash of the text definition, when the text is around the binary is only used if they still match.
+Everything is stored little endian, which is all we run on.
+*/
+
+#define SHEET_BIN_MAGIC 0x42535344 // "DSSB"
+#define SHEET_BIN_VERSION 1
+#define SHEET_BIN_EXTENSION ".bin"
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t sourceHash;
+	uint32_t numSprites;
+	uint32_t stringsSize;
+	uint32_t imageNameOffset; // into the strings
+	uint32_t imageNameLength;
+} SheetBinHeader;
+
+typedef struct {
+	uint32_t idOffset; // into the strings
+	uint32_t idLength;
+	int32_t x;
+	int32_t y;
+	int32_t w;
+	int32_t h;
+} SheetBinSprite;
+
+// FNV-1a of the text definition
+uint64_t sheetBin_HashData( const uint8_t* data, size_t size );
+
+// size of the whole file, SIZE_MAX if the counts in the header are too large
+size_t sheetBin_FileSize( const SheetBinHeader* header );
+
+#endif /* inclusion guard */
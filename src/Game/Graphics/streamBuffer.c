@@ -0,0 +1,159 @@
+#include "streamBuffer.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "glDebugging.h"
+#include "renderStats.h"
+#include "../System/platformLog.h"
+
+// keeps all the writes aligned for any of the vertex attribute types
+#define STREAM_BUFFER_ALIGNMENT 16
+
+// how long to wait for the GPU before complaining, in nanoseconds
+#define FENCE_TIMEOUT 1000000000
+
+#define ALIGN_UP( v ) ( ( (v) + ( STREAM_BUFFER_ALIGNMENT - 1 ) ) & ~(size_t)( STREAM_BUFFER_ALIGNMENT - 1 ) )
+
+static void releaseFences( StreamBuffer* stream )
+{
+#ifndef STREAM_BUFFER_NO_MAPPING
+	for( int i = 0; i < STREAM_BUFFER_NUM_REGIONS; ++i ) {
+		if( stream->fences[i] != NULL ) {
+			GL( glDeleteSync( stream->fences[i] ) );
+			stream->fences[i] = NULL;
+		}
+	}
+#endif
+}
+
+int streamBuffer_Init( StreamBuffer* stream, GLenum target, size_t regionSize )
+{
+	assert( stream != NULL );
+
+	memset( stream, 0, sizeof( StreamBuffer ) );
+	stream->regionSize = ALIGN_UP( regionSize > 0 ? regionSize : STREAM_BUFFER_ALIGNMENT );
+
+	GL( glGenBuffers( 1, &( stream->buffer ) ) );
+	if( stream->buffer == 0 ) {
+		llog( LOG_ERROR, "Unable to create stream buffer." );
+		return -1;
+	}
+
+	GL( glBindBuffer( target, stream->buffer ) );
+	GL( glBufferData( target, stream->regionSize * STREAM_BUFFER_NUM_REGIONS, NULL, GL_STREAM_DRAW ) );
+
+	return 0;
+}
+
+void streamBuffer_Destroy( StreamBuffer* stream )
+{
+	assert( stream != NULL );
+
+	releaseFences( stream );
+	if( stream->buffer != 0 ) {
+		GL( glDeleteBuffers( 1, &( stream->buffer ) ) );
+	}
+	memset( stream, 0, sizeof( StreamBuffer ) );
+}
+
+void streamBuffer_BeginFrame( StreamBuffer* stream )
+{
+	assert( stream != NULL );
+
+	stream->currRegion = ( stream->currRegion + 1 ) % STREAM_BUFFER_NUM_REGIONS;
+	stream->used = 0;
+
+#ifndef STREAM_BUFFER_NO_MAPPING
+	GLsync fence = stream->fences[stream->currRegion];
+	if( fence != NULL ) {
+		GLenum result;
+		GLR( result, glClientWaitSync( fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT ) );
+		if( ( result == GL_TIMEOUT_EXPIRED ) || ( result == GL_WAIT_FAILED ) ) {
+			llog( LOG_WARN, "Problem waiting for stream buffer region to be free." );
+		}
+		GL( glDeleteSync( fence ) );
+		stream->fences[stream->currRegion] = NULL;
+	}
+#endif
+}
+
+void streamBuffer_EndFrame( StreamBuffer* stream )
+{
+	assert( stream != NULL );
+
+#ifndef STREAM_BUFFER_NO_MAPPING
+	if( stream->used > 0 ) {
+		GLR( stream->fences[stream->currRegion], glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 ) );
+	}
+#endif
+}
+
+// recreates the storage so each region can hold at least minRegionSize bytes, the old storage is orphaned so anything
+//  already drawn with it is still fine
+static void grow( StreamBuffer* stream, size_t minRegionSize )
+{
+	size_t newSize = stream->regionSize * 2;
+	while( newSize < minRegionSize ) {
+		newSize *= 2;
+	}
+
+	llog( LOG_VERBOSE, "Growing stream buffer regions from %u to %u bytes.", (unsigned int)stream->regionSize, (unsigned int)newSize );
+
+	releaseFences( stream );
+	stream->regionSize = ALIGN_UP( newSize );
+	stream->currRegion = 0;
+	stream->used = 0;
+
+	GL( glBufferData( GL_COPY_WRITE_BUFFER, stream->regionSize * STREAM_BUFFER_NUM_REGIONS, NULL, GL_STREAM_DRAW ) );
+}
+
+bool streamBuffer_Write( StreamBuffer* stream, const void* data, size_t size, size_t* outOffset )
+{
+	assert( stream != NULL );
+	assert( ( data != NULL ) || ( size == 0 ) );
+	assert( outOffset != NULL );
+
+	// use the copy target so we don't change the index buffer bound to the current vertex array
+	GL( glBindBuffer( GL_COPY_WRITE_BUFFER, stream->buffer ) );
+
+	size_t start = ALIGN_UP( stream->used );
+	if( ( start + size ) > stream->regionSize ) {
+		grow( stream, size );
+		start = 0;
+	}
+
+	size_t offset = ( stream->regionSize * (size_t)stream->currRegion ) + start;
+	(*outOffset) = offset;
+	stream->used = start + size;
+
+	if( size == 0 ) {
+		return true;
+	}
+
+	RSTATS_ADD( bytesUploaded, size );
+
+#ifdef STREAM_BUFFER_NO_MAPPING
+	GL( glBufferSubData( GL_COPY_WRITE_BUFFER, (GLintptr)offset, (GLsizeiptr)size, data ) );
+#else
+	// the fences guarantee the GPU isn't using this region, so there's no need for the driver to synchronize
+	void* mapped;
+	GLR( mapped, glMapBufferRange( GL_COPY_WRITE_BUFFER, (GLintptr)offset, (GLsizeiptr)size,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT ) );
+	if( mapped == NULL ) {
+		llog( LOG_ERROR, "Unable to map stream buffer." );
+		return false;
+	}
+
+	memcpy( mapped, data, size );
+
+	GLboolean unmapped;
+	GLR( unmapped, glUnmapBuffer( GL_COPY_WRITE_BUFFER ) );
+	if( unmapped == GL_FALSE ) {
+		llog( LOG_ERROR, "Stream buffer contents were lost while mapped." );
+		return false;
+	}
+#endif
+
+	return true;
+}
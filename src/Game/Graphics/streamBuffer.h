@@ -0,0 +1,50 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "glPlatform.h"
+
+/*
+Buffer for data that's regenerated every frame. The buffer is split into regions, each frame writes into the next
+ region so we never write over anything the GPU may still be reading. When mapping is available the writes are done
+ with unsynchronized maps and a fence is placed at the end of each frame, if the GPU falls far enough behind that it's
+ still using the region we're about to write to we wait for it.
+WebGL doesn't support mapping buffers, so there it uses glBufferSubData into the regions instead.
+*/
+
+#if defined( __EMSCRIPTEN__ )
+	#define STREAM_BUFFER_NO_MAPPING
+#endif
+
+#define STREAM_BUFFER_NUM_REGIONS 3
+
+typedef struct {
+	GLuint buffer;
+	size_t regionSize; // in bytes
+	int currRegion;
+	size_t used; // bytes written to the current region
+#ifndef STREAM_BUFFER_NO_MAPPING
+	GLsync fences[STREAM_BUFFER_NUM_REGIONS];
+#endif
+} StreamBuffer;
+
+// creates the buffer and binds it to target, so if it's being used as an index buffer the vertex array should be bound
+//  returns < 0 if there's a problem
+int streamBuffer_Init( StreamBuffer* stream, GLenum target, size_t regionSize );
+void streamBuffer_Destroy( StreamBuffer* stream );
+
+// moves on to the next region, if the GPU is still using it this will wait until it's done
+void streamBuffer_BeginFrame( StreamBuffer* stream );
+
+// marks the current region as being used by everything drawn since streamBuffer_BeginFrame was called
+void streamBuffer_EndFrame( StreamBuffer* stream );
+
+// copies the data into the current region, outOffset is set to where it was written in bytes from the start of the buffer
+//  if there isn't enough space left in the region the buffer is grown, this loses anything written earlier in the frame
+//  so only use offsets from writes made before drawing with them
+//  returns false if there's a problem
+bool streamBuffer_Write( StreamBuffer* stream, const void* data, size_t size, size_t* outOffset );
+
+#endif /* inclusion guard */
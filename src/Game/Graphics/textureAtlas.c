@@ -0,0 +1,445 @@
+#include "textureAtlas.h"
+
+#include <assert.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "glPlatform.h"
+#include "glDebugging.h"
+#include "renderStats.h"
+#include "../System/memory.h"
+#include "../System/platformLog.h"
+#include "../Utils/stretchyBuffer.h"
+
+#define ATLAS_PAGE_SIZE 1024
+#define MAX_ATLAS_PAGES 8
+
+typedef struct {
+	int x, y, w, h;
+} AtlasRect;
+
+// a span of the skyline, everything from x to x + width is filled up to y
+typedef struct {
+	int x, y, width;
+} SkylineNode;
+
+typedef struct {
+	GLuint texture;
+	SkylineNode* sbSkyline;
+	AtlasRect* sbFreeRects;
+	int numRects;
+	int usedArea;
+} AtlasPage;
+
+typedef struct {
+	int page; // -1 if the entry isn't in use
+	AtlasRect rect; // includes the padding
+} AtlasEntry;
+
+static AtlasPage pages[MAX_ATLAS_PAGES];
+static int numPages = 0;
+static int pageSize = ATLAS_PAGE_SIZE;
+
+static AtlasEntry* sbEntries = NULL;
+
+int texAtlas_Init( void )
+{
+	GLint maxTextureSize = 0;
+	GL( glGetIntegerv( GL_MAX_TEXTURE_SIZE, &maxTextureSize ) );
+	pageSize = ATLAS_PAGE_SIZE;
+	if( ( maxTextureSize > 0 ) && ( maxTextureSize < pageSize ) ) {
+		pageSize = maxTextureSize;
+	}
+
+	memset( pages, 0, sizeof( pages ) );
+	numPages = 0;
+	sb_Clear( sbEntries );
+
+	return 0;
+}
+
+/*
+Deletes all the page textures and forgets everything that was packed into them, any handles from texAtlas_Add are
+ invalid afterwards.
+*/
+void texAtlas_CleanUp( void )
+{
+	for( int i = 0; i < numPages; ++i ) {
+		if( pages[i].texture != 0 ) {
+			GL( glDeleteTextures( 1, &( pages[i].texture ) ) );
+		}
+		sb_Release( pages[i].sbSkyline );
+		sb_Release( pages[i].sbFreeRects );
+	}
+	memset( pages, 0, sizeof( pages ) );
+	numPages = 0;
+	sb_Release( sbEntries );
+}
+
+static void resetPage( AtlasPage* page )
+{
+	sb_Clear( page->sbSkyline );
+	sb_Clear( page->sbFreeRects );
+
+	SkylineNode base = { 0, 0, pageSize };
+	sb_Push( page->sbSkyline, base );
+
+	page->numRects = 0;
+	page->usedArea = 0;
+}
+
+static AtlasPage* createPage( void )
+{
+	if( numPages >= MAX_ATLAS_PAGES ) {
+		return NULL;
+	}
+
+	AtlasPage* page = &( pages[numPages] );
+
+	GL( glGenTextures( 1, &( page->texture ) ) );
+	if( page->texture == 0 ) {
+		llog( LOG_ERROR, "Unable to create texture object for atlas page." );
+		return NULL;
+	}
+
+	// same settings gfxUtil_CreateTextureFromLoadedImage uses for loaded images
+	GL( glBindTexture( GL_TEXTURE_2D, page->texture ) );
+	GL( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST ) );
+	GL( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST ) );
+	GL( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE ) );
+	GL( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE ) );
+	GL( glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, pageSize, pageSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL ) );
+
+	resetPage( page );
+	++numPages;
+
+	llog( LOG_VERBOSE, "Created texture atlas page %i, %ix%i", numPages - 1, pageSize, pageSize );
+
+	return page;
+}
+
+// finds the lowest spot on the skyline that the rectangle fits at, returns the index of the node it starts on or -1
+static int findSkylineSpot( AtlasPage* page, int w, int h, int* outX, int* outY )
+{
+	int bestNode = -1;
+	int bestY = pageSize;
+	int bestX = pageSize;
+
+	size_t count = sb_Count( page->sbSkyline );
+	for( size_t i = 0; i < count; ++i ) {
+		int x = page->sbSkyline[i].x;
+		if( ( x + w ) > pageSize ) {
+			break;
+		}
+
+		// the rectangle has to sit on the highest node it spans
+		int y = 0;
+		int widthLeft = w;
+		for( size_t j = i; ( j < count ) && ( widthLeft > 0 ); ++j ) {
+			if( page->sbSkyline[j].y > y ) {
+				y = page->sbSkyline[j].y;
+			}
+			widthLeft -= page->sbSkyline[j].width;
+		}
+
+		if( ( ( y + h ) <= pageSize ) && ( ( y < bestY ) || ( ( y == bestY ) && ( x < bestX ) ) ) ) {
+			bestNode = (int)i;
+			bestY = y;
+			bestX = x;
+		}
+	}
+
+	(*outX) = bestX;
+	(*outY) = bestY;
+	return bestNode;
+}
+
+static void addToSkyline( AtlasPage* page, int nodeIdx, int x, int y, int w, int h )
+{
+	SkylineNode newNode = { x, y + h, w };
+	sb_Insert( page->sbSkyline, (size_t)nodeIdx, newNode );
+
+	// shrink or remove the nodes now under the new one
+	size_t i = (size_t)nodeIdx + 1;
+	while( i < sb_Count( page->sbSkyline ) ) {
+		SkylineNode* prev = &( page->sbSkyline[i - 1] );
+		SkylineNode* node = &( page->sbSkyline[i] );
+		int prevEnd = prev->x + prev->width;
+		if( node->x >= prevEnd ) {
+			break;
+		}
+
+		int shrink = prevEnd - node->x;
+		node->x += shrink;
+		node->width -= shrink;
+		if( node->width > 0 ) {
+			break;
+		}
+		sb_Remove( page->sbSkyline, i );
+	}
+
+	// merge neighbors at the same height
+	for( i = 0; ( i + 1 ) < sb_Count( page->sbSkyline ); ) {
+		if( page->sbSkyline[i].y == page->sbSkyline[i + 1].y ) {
+			page->sbSkyline[i].width += page->sbSkyline[i + 1].width;
+			sb_Remove( page->sbSkyline, i + 1 );
+		} else {
+			++i;
+		}
+	}
+}
+
+// finds the smallest free rectangle the size fits in, returns its index or -1
+static int findFreeRect( AtlasPage* page, int w, int h )
+{
+	int best = -1;
+	int bestArea = 0;
+	for( size_t i = 0; i < sb_Count( page->sbFreeRects ); ++i ) {
+		AtlasRect* freeRect = &( page->sbFreeRects[i] );
+		if( ( freeRect->w >= w ) && ( freeRect->h >= h ) ) {
+			int area = freeRect->w * freeRect->h;
+			if( ( best < 0 ) || ( area < bestArea ) ) {
+				best = (int)i;
+				bestArea = area;
+			}
+		}
+	}
+	return best;
+}
+
+// takes the size out of the top left of the free rectangle, what's left over is split along the shorter axis
+static void useFreeRect( AtlasPage* page, int freeIdx, int w, int h )
+{
+	AtlasRect freeRect = page->sbFreeRects[freeIdx];
+	sb_Remove( page->sbFreeRects, (size_t)freeIdx );
+
+	int leftOverW = freeRect.w - w;
+	int leftOverH = freeRect.h - h;
+
+	AtlasRect right;
+	AtlasRect bottom;
+	if( leftOverW > leftOverH ) {
+		right.x = freeRect.x + w; right.y = freeRect.y; right.w = leftOverW; right.h = freeRect.h;
+		bottom.x = freeRect.x; bottom.y = freeRect.y + h; bottom.w = w; bottom.h = leftOverH;
+	} else {
+		right.x = freeRect.x + w; right.y = freeRect.y; right.w = leftOverW; right.h = h;
+		bottom.x = freeRect.x; bottom.y = freeRect.y + h; bottom.w = freeRect.w; bottom.h = leftOverH;
+	}
+
+	if( ( right.w > 0 ) && ( right.h > 0 ) ) {
+		sb_Push( page->sbFreeRects, right );
+	}
+	if( ( bottom.w > 0 ) && ( bottom.h > 0 ) ) {
+		sb_Push( page->sbFreeRects, bottom );
+	}
+}
+
+// puts the rectangle back in the free list, merging it with any free rectangles that share a whole edge with it
+static void releaseRect( AtlasPage* page, AtlasRect rect )
+{
+	bool merged = true;
+	while( merged ) {
+		merged = false;
+		for( size_t i = 0; i < sb_Count( page->sbFreeRects ); ++i ) {
+			AtlasRect* freeRect = &( page->sbFreeRects[i] );
+			if( ( freeRect->y == rect.y ) && ( freeRect->h == rect.h ) && ( ( ( freeRect->x + freeRect->w ) == rect.x ) || ( ( rect.x + rect.w ) == freeRect->x ) ) ) {
+				rect.x = ( freeRect->x < rect.x ) ? freeRect->x : rect.x;
+				rect.w += freeRect->w;
+				merged = true;
+			} else if( ( freeRect->x == rect.x ) && ( freeRect->w == rect.w ) && ( ( ( freeRect->y + freeRect->h ) == rect.y ) || ( ( rect.y + rect.h ) == freeRect->y ) ) ) {
+				rect.y = ( freeRect->y < rect.y ) ? freeRect->y : rect.y;
+				rect.h += freeRect->h;
+				merged = true;
+			}
+
+			if( merged ) {
+				sb_Remove( page->sbFreeRects, i );
+				break;
+			}
+		}
+	}
+
+	sb_Push( page->sbFreeRects, rect );
+}
+
+// tries to find space on the page, fills in outRect and returns whether it was successful
+static bool packOnPage( AtlasPage* page, int w, int h, AtlasRect* outRect )
+{
+	int freeIdx = findFreeRect( page, w, h );
+	if( freeIdx >= 0 ) {
+		outRect->x = page->sbFreeRects[freeIdx].x;
+		outRect->y = page->sbFreeRects[freeIdx].y;
+		useFreeRect( page, freeIdx, w, h );
+	} else {
+		int x, y;
+		int nodeIdx = findSkylineSpot( page, w, h, &x, &y );
+		if( nodeIdx < 0 ) {
+			return false;
+		}
+		addToSkyline( page, nodeIdx, x, y, w, h );
+		outRect->x = x;
+		outRect->y = y;
+	}
+
+	outRect->w = w;
+	outRect->h = h;
+	return true;
+}
+
+// copies the image into a buffer with the edge pixels repeated out through the padding, then uploads it
+static void uploadImage( AtlasPage* page, AtlasRect* rect, LoadedImage* image )
+{
+	size_t rowSize = (size_t)rect->w * 4;
+	uint8_t* padded = mem_Allocate( rowSize * (size_t)rect->h );
+	if( padded == NULL ) {
+		llog( LOG_ERROR, "Unable to allocate buffer for atlas upload." );
+		return;
+	}
+
+	size_t srcRowSize = (size_t)image->width * 4;
+	for( int py = 0; py < rect->h; ++py ) {
+		int sy = py - ATLAS_PADDING;
+		if( sy < 0 ) sy = 0;
+		if( sy >= image->height ) sy = image->height - 1;
+
+		uint8_t* dest = padded + ( rowSize * (size_t)py );
+		uint8_t* src = image->data + ( srcRowSize * (size_t)sy );
+
+		memcpy( dest + ( ATLAS_PADDING * 4 ), src, srcRowSize );
+		for( int p = 0; p < ATLAS_PADDING; ++p ) {
+			memcpy( dest + ( p * 4 ), src, 4 );
+			memcpy( dest + ( ( ATLAS_PADDING + image->width + p ) * 4 ), src + srcRowSize - 4, 4 );
+		}
+	}
+
+	GL( glBindTexture( GL_TEXTURE_2D, page->texture ) );
+	GL( glTexSubImage2D( GL_TEXTURE_2D, 0, rect->x, rect->y, rect->w, rect->h, GL_RGBA, GL_UNSIGNED_BYTE, padded ) );
+	RSTATS_ADD( bytesUploaded, rowSize * (size_t)rect->h );
+
+	mem_Release( padded );
+}
+
+static int findUnusedEntry( void )
+{
+	for( size_t i = 0; i < sb_Count( sbEntries ); ++i ) {
+		if( sbEntries[i].page < 0 ) {
+			return (int)i;
+		}
+	}
+
+	AtlasEntry newEntry = { -1, { 0, 0, 0, 0 } };
+	sb_Push( sbEntries, newEntry );
+	return (int)( sb_Count( sbEntries ) - 1 );
+}
+
+int texAtlas_Add( LoadedImage* image, AtlasResult* outResult )
+{
+	assert( image != NULL );
+	assert( outResult != NULL );
+
+	if( ( image->data == NULL ) || ( image->reqComp != 4 ) ) {
+		return -1;
+	}
+
+	// large images don't gain much from sharing a texture and would use up the pages quickly
+	int w = image->width + ( ATLAS_PADDING * 2 );
+	int h = image->height + ( ATLAS_PADDING * 2 );
+	if( ( w > ( pageSize / 2 ) ) || ( h > ( pageSize / 2 ) ) ) {
+		return -1;
+	}
+
+	AtlasRect rect;
+	int pageIdx = -1;
+	for( int i = 0; ( i < numPages ) && ( pageIdx < 0 ); ++i ) {
+		if( packOnPage( &( pages[i] ), w, h, &rect ) ) {
+			pageIdx = i;
+		}
+	}
+
+	if( pageIdx < 0 ) {
+		AtlasPage* newPage = createPage( );
+		if( ( newPage == NULL ) || !packOnPage( newPage, w, h, &rect ) ) {
+			return -1;
+		}
+		pageIdx = numPages - 1;
+	}
+
+	AtlasPage* page = &( pages[pageIdx] );
+	++page->numRects;
+	page->usedArea += w * h;
+
+	uploadImage( page, &rect, image );
+
+	int handle = findUnusedEntry( );
+	sbEntries[handle].page = pageIdx;
+	sbEntries[handle].rect = rect;
+
+	float invSize = 1.0f / (float)pageSize;
+	outResult->minUV.x = (float)( rect.x + ATLAS_PADDING ) * invSize;
+	outResult->minUV.y = (float)( rect.y + ATLAS_PADDING ) * invSize;
+	outResult->maxUV.x = (float)( rect.x + ATLAS_PADDING + image->width ) * invSize;
+	outResult->maxUV.y = (float)( rect.y + ATLAS_PADDING + image->height ) * invSize;
+	outResult->texture.textureID = page->texture;
+	outResult->texture.width = image->width;
+	outResult->texture.height = image->height;
+	outResult->texture.flags = 0;
+
+	// check to see if there are any translucent pixels in the image, unless it was already done when it was cached
+	if( image->flags & LIF_TRANSLUCENCY_KNOWN ) {
+		if( image->flags & LIF_IS_TRANSLUCENT ) {
+			outResult->texture.flags |= TF_IS_TRANSPARENT;
+		}
+	} else {
+		size_t numBytes = (size_t)image->width * (size_t)image->height * 4;
+		for( size_t i = 3; i < numBytes; i += 4 ) {
+			if( ( image->data[i] > 0x00 ) && ( image->data[i] < 0xFF ) ) {
+				outResult->texture.flags |= TF_IS_TRANSPARENT;
+				break;
+			}
+		}
+	}
+
+	return handle;
+}
+
+void texAtlas_Remove( int handle )
+{
+	assert( handle >= 0 );
+	assert( (size_t)handle < sb_Count( sbEntries ) );
+
+	if( ( handle < 0 ) || ( (size_t)handle >= sb_Count( sbEntries ) ) || ( sbEntries[handle].page < 0 ) ) {
+		return;
+	}
+
+	AtlasEntry* entry = &( sbEntries[handle] );
+	AtlasPage* page = &( pages[entry->page] );
+
+	--page->numRects;
+	page->usedArea -= entry->rect.w * entry->rect.h;
+	if( page->numRects <= 0 ) {
+		// nothing left, start over with an empty skyline, the old contents will be overwritten as things are added
+		resetPage( page );
+	} else {
+		releaseRect( page, entry->rect );
+	}
+
+	entry->page = -1;
+}
+
+void texAtlas_GetUsage( int* outNumPages, float* outFilled )
+{
+	assert( outNumPages != NULL );
+	assert( outFilled != NULL );
+
+	(*outNumPages) = numPages;
+	(*outFilled) = 0.0f;
+	if( numPages <= 0 ) {
+		return;
+	}
+
+	int usedArea = 0;
+	for( int i = 0; i < numPages; ++i ) {
+		usedArea += pages[i].usedArea;
+	}
+	(*outFilled) = (float)usedArea / ( (float)pageSize * (float)pageSize * (float)numPages );
+}
@@ -0,0 +1,47 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include "gfxUtil.h"
+
+/*
+Packs loaded images into a few large shared textures so things drawn with different images can still end up in the
+ same batch. Each page is packed using a skyline, space given back when an image is removed is kept in a list of free
+ rectangles on the page and reused before the skyline is grown. When everything on a page has been removed the whole
+ page is reset.
+Every image is surrounded by a border of its own edge pixels so filtering at the edges doesn't pull in the neighbors.
+Only meant to be used from the main thread.
+*/
+
+// border of extruded edge pixels around each image
+#define ATLAS_PADDING 1
+
+/*
+Sets up the atlas, has to be called after the OpenGL context is created.
+ Returns < 0 on an error.
+*/
+int texAtlas_Init( void );
+
+/*
+Deletes all the page textures and resets the packing, has to be called before the OpenGL context is destroyed.
+*/
+void texAtlas_CleanUp( void );
+
+/*
+Copies the RGBA image into one of the pages, creating a new page if none of the current ones have room. The texture in
+ outResult is the page texture, its size is the size of the image.
+ Returns a handle used to remove the image later, or -1 if the image couldn't be packed. If the image is too large or
+ all the pages are full -1 is returned and the image should be given its own texture.
+*/
+int texAtlas_Add( LoadedImage* image, AtlasResult* outResult );
+
+/*
+Frees up the space used by the image so it can be used by another one.
+*/
+void texAtlas_Remove( int handle );
+
+/*
+Gets how many pages have been created and how much of their area is currently in use, from 0 to 1.
+*/
+void texAtlas_GetUsage( int* outNumPages, float* outFilled );
+
+#endif /* inclusion guard */
@@ -0,0 +1,201 @@
+#include "textureCache.h"
+
+#include <SDL_rwops.h>
+#include <assert.h>
+#include <string.h>
+
+#include "textureCacheFormat.h"
+#include "../System/memory.h"
+#include "../System/platformLog.h"
+#include "../Utils/assetPack.h"
+#include "../Utils/lz4Block.h"
+
+#define MAX_CACHE_FILE_NAME 256
+
+static bool validHeader( const TexCacheHeader* header, size_t availableData )
+{
+	if( ( header->magic != TEX_CACHE_MAGIC ) || ( header->version != TEX_CACHE_VERSION ) ||
+		( header->format != TEX_CACHE_FORMAT_RGBA8 ) ) {
+		return false;
+	}
+
+	if( ( header->width == 0 ) || ( header->height == 0 ) || ( header->width > 16384 ) || ( header->height > 16384 ) ) {
+		return false;
+	}
+
+	if( header->dataSize > availableData ) {
+		return false;
+	}
+
+	// uncompressed data has to be exactly the pixels
+	if( !( header->flags & TEX_CACHE_FLAG_LZ4 ) && ( header->dataSize != texCache_PixelDataSize( header ) ) ) {
+		return false;
+	}
+
+	return true;
+}
+
+static bool readAll( SDL_RWops* rwops, void* buffer, size_t size )
+{
+	size_t readTotal = 0;
+	size_t amtRead = 1;
+	while( ( readTotal < size ) && ( amtRead > 0 ) ) {
+		amtRead = SDL_RWread( rwops, (uint8_t*)buffer + readTotal, sizeof( uint8_t ), size - readTotal );
+		readTotal += amtRead;
+	}
+	return ( readTotal == size );
+}
+
+// if we can find the source check that the cache was built from what's there now
+static bool sourceMatches( const char* fileName, uint64_t expectedHash )
+{
+	const uint8_t* packedData;
+	size_t packedSize;
+	if( assetPack_GetFile( fileName, &packedData, &packedSize ) ) {
+		return ( texCache_HashData( packedData, packedSize ) == expectedHash );
+	}
+
+	SDL_RWops* rwopsFile = SDL_RWFromFile( fileName, "rb" );
+	if( rwopsFile == NULL ) {
+		return true;
+	}
+
+	bool matches = false;
+	Sint64 fileSize = SDL_RWsize( rwopsFile );
+	uint8_t* buffer = ( fileSize > 0 ) ? mem_Allocate( (size_t)fileSize ) : NULL;
+	if( ( buffer != NULL ) && readAll( rwopsFile, buffer, (size_t)fileSize ) ) {
+		matches = ( texCache_HashData( buffer, (size_t)fileSize ) == expectedHash );
+	}
+	mem_Release( buffer );
+	SDL_RWclose( rwopsFile );
+
+	return matches;
+}
+
+static uint8_t* decompress( const TexCacheHeader* header, const uint8_t* data )
+{
+	size_t pixelSize = texCache_PixelDataSize( header );
+	uint8_t* pixels = mem_Allocate( pixelSize );
+	if( pixels == NULL ) {
+		return NULL;
+	}
+
+	if( lz4_Decompress( data, (int)header->dataSize, pixels, (int)pixelSize ) != (int)pixelSize ) {
+		mem_Release( pixels );
+		return NULL;
+	}
+
+	return pixels;
+}
+
+static void setLoadedImage( const TexCacheHeader* header, uint8_t* pixels, bool borrowed, LoadedImage* outLoadedImage )
+{
+	outLoadedImage->data = pixels;
+	outLoadedImage->width = (int)header->width;
+	outLoadedImage->height = (int)header->height;
+	outLoadedImage->comp = 4;
+	outLoadedImage->reqComp = 4;
+	outLoadedImage->flags = LIF_TRANSLUCENCY_KNOWN;
+	if( header->flags & TEX_CACHE_FLAG_TRANSLUCENT ) {
+		outLoadedImage->flags |= LIF_IS_TRANSLUCENT;
+	}
+	if( borrowed ) {
+		outLoadedImage->flags |= LIF_BORROWED_DATA;
+	}
+}
+
+// the cache is in the asset pack, use it without copying if we can
+static bool loadFromPack( const char* fileName, const uint8_t* cacheData, size_t cacheSize, LoadedImage* outLoadedImage )
+{
+	if( cacheSize < sizeof( TexCacheHeader ) ) {
+		return false;
+	}
+
+	// the pack keeps file data aligned so the header can be read in place
+	const TexCacheHeader* header = (const TexCacheHeader*)cacheData;
+	if( !validHeader( header, cacheSize - sizeof( TexCacheHeader ) ) || !sourceMatches( fileName, header->sourceHash ) ) {
+		return false;
+	}
+
+	const uint8_t* data = cacheData + sizeof( TexCacheHeader );
+	if( header->flags & TEX_CACHE_FLAG_LZ4 ) {
+		uint8_t* pixels = decompress( header, data );
+		if( pixels == NULL ) {
+			return false;
+		}
+		setLoadedImage( header, pixels, false, outLoadedImage );
+	} else {
+		setLoadedImage( header, (uint8_t*)data, true, outLoadedImage );
+	}
+
+	return true;
+}
+
+static bool loadFromFile( const char* fileName, SDL_RWops* rwopsFile, LoadedImage* outLoadedImage )
+{
+	bool success = false;
+	uint8_t* data = NULL;
+
+	TexCacheHeader header;
+	Sint64 fileSize = SDL_RWsize( rwopsFile );
+	if( ( fileSize < (Sint64)sizeof( header ) ) || !readAll( rwopsFile, &header, sizeof( header ) ) ) {
+		goto clean_up;
+	}
+
+	if( !validHeader( &header, (size_t)fileSize - sizeof( header ) ) || !sourceMatches( fileName, header.sourceHash ) ) {
+		goto clean_up;
+	}
+
+	data = mem_Allocate( header.dataSize );
+	if( ( data == NULL ) || !readAll( rwopsFile, data, header.dataSize ) ) {
+		goto clean_up;
+	}
+
+	if( header.flags & TEX_CACHE_FLAG_LZ4 ) {
+		uint8_t* pixels = decompress( &header, data );
+		if( pixels == NULL ) {
+			goto clean_up;
+		}
+		mem_Release( data );
+		data = pixels;
+	}
+
+	setLoadedImage( &header, data, false, outLoadedImage );
+	data = NULL;
+	success = true;
+
+clean_up:
+	mem_Release( data );
+	return success;
+}
+
+bool texCache_Load( const char* fileName, LoadedImage* outLoadedImage )
+{
+	assert( fileName != NULL );
+	assert( outLoadedImage != NULL );
+
+	char cacheFileName[MAX_CACHE_FILE_NAME];
+	if( SDL_snprintf( cacheFileName, sizeof( cacheFileName ), "%s%s", fileName, TEX_CACHE_EXTENSION ) >= (int)sizeof( cacheFileName ) ) {
+		return false;
+	}
+
+	bool loaded;
+	const uint8_t* cacheData;
+	size_t cacheSize;
+	if( assetPack_GetFile( cacheFileName, &cacheData, &cacheSize ) ) {
+		loaded = loadFromPack( fileName, cacheData, cacheSize, outLoadedImage );
+	} else {
+		SDL_RWops* rwopsFile = SDL_RWFromFile( cacheFileName, "rb" );
+		if( rwopsFile == NULL ) {
+			return false;
+		}
+		loaded = loadFromFile( fileName, rwopsFile, outLoadedImage );
+		SDL_RWclose( rwopsFile );
+	}
+
+	if( !loaded ) {
+		llog( LOG_INFO, "Texture cache for %s is out of date or invalid, decoding the image instead.", fileName );
+	}
+
+	return loaded;
+}
@@ -0,0 +1,22 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <stdbool.h>
+#include "gfxUtil.h"
+
+/*
+Loads images from the pre-decoded cache files built by the TextureCacher tool instead of decoding the source images,
+ see textureCacheFormat.h for the layout. If the cache is in the asset pack and isn't compressed the pixels are used
+ straight out of the pack.
+If the source image can be found its hash is checked against the one stored in the cache, so changing an image without
+ rebuilding the cache will just fall back to decoding it. Without the source the cache is trusted.
+Safe to use from the loading threads.
+*/
+
+/*
+Loads the cached version of fileName into outLoadedImage, the flags will have LIF_TRANSLUCENCY_KNOWN set.
+ Returns false if there's no cache or it's out of date, the source should be decoded instead.
+*/
+bool texCache_Load( const char* fileName, LoadedImage* outLoadedImage );
+
+#endif /* inclusion guard */
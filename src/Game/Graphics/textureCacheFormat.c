@@ -0,0 +1,17 @@
+#include "textureCacheFormat.h"
+
+uint64_t texCache_HashData( const uint8_t* data, size_t size )
+{
+	uint64_t hash = 0xCBF29CE484222325ull;
+	for( size_t i = 0; i < size; ++i ) {
+		hash ^= data[i];
+		hash *= 0x100000001B3ull;
+	}
+	return hash;
+}
+
+size_t texCache_PixelDataSize( const TexCacheHeader* header )
+{
+	// only RGBA8 for now
+	return (size_t)header->width * (size_t)header->height * 4;
+}
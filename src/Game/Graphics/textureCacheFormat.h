@@ -0,0 +1,50 @@
+#ifndef TEXTURE_CACHE_FORMAT_H
+#define TEXTURE_CACHE_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+Layout of the texture cache files, shared between the game and the TextureCacher tool so it doesn't need anything else
+ from the game to build.
+A cache file holds an image already decoded into the format it's uploaded in, so loading it is just a read and a
+ glTexImage2D. They're stored next to the source image with TEX_CACHE_EXTENSION appended, e.g. "Images/tree.png.tex".
+ header
+ pixel data, dataSize bytes, LZ4 compressed if TEX_CACHE_FLAG_LZ4 is set
+The header stores a hash of the source file, when the source is around the cache is only used if they still match.
+Everything is stored little endian, which is all we run on.
+*/
+
+#define TEX_CACHE_MAGIC 0x5844544C // "LTDX"
+#define TEX_CACHE_VERSION 1
+#define TEX_CACHE_EXTENSION ".tex"
+
+enum TexCacheFormat {
+	TEX_CACHE_FORMAT_RGBA8 = 0
+};
+
+enum TexCacheFlags {
+	TEX_CACHE_FLAG_TRANSLUCENT = 0x1, // has pixels that aren't completely clear or solid
+	TEX_CACHE_FLAG_LZ4 = 0x2
+};
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t format;
+	uint32_t flags;
+	uint64_t sourceHash;
+	uint32_t dataSize; // size of the stored data, which is smaller than the pixels if it's compressed
+	uint32_t padding;
+	uint64_t reserved; // keeps the pixel data 16 byte aligned
+} TexCacheHeader;
+
+// FNV-1a of the source file contents
+uint64_t texCache_HashData( const uint8_t* data, size_t size );
+
+// size of the decoded pixels
+size_t texCache_PixelDataSize( const TexCacheHeader* header );
+
+#endif /* inclusion guard */
@@ -0,0 +1,443 @@
+#include "textureUpload.h"
+
+#include <SDL_atomic.h>
+#include <SDL_timer.h>
+#include <assert.h>
+#include <string.h>
+
+#include "glDebugging.h"
+#include "renderStats.h"
+#include "../System/gameTime.h"
+#include "../System/jobQueue.h"
+#include "../System/memory.h"
+#include "../System/platformLog.h"
+#include "../Utils/stretchyBuffer.h"
+
+#define NUM_STAGING_BUFFERS 4
+
+// the most bytes copied into the texture at once, a row of the largest texture OpenGL allows will always fit
+#define BAND_SIZE ( 1024 * 1024 )
+
+#define DEFAULT_FRAME_BUDGET ( 4 * 1024 * 1024 )
+
+typedef struct {
+	LoadedImage* image;
+	TexUploadDoneFunc done;
+	void* data;
+	Texture texture;
+	int nextRow; // first row that hasn't been given to a band yet
+	int rowsDone; // rows that are in the texture
+} Upload;
+
+enum {
+	SBS_FREE,
+	SBS_COPYING,
+	SBS_READY
+};
+
+typedef struct {
+	GLuint buffer;
+	SDL_atomic_t state;
+	void* mapped;
+	Upload* upload;
+	int firstRow;
+	int numRows;
+	bool scan; // whether the worker should look for translucent pixels
+	bool translucent; // set by the worker before the state is set to ready
+} StagingBuffer;
+
+static Upload** sbUploads = NULL;
+#ifndef TEX_UPLOAD_NO_MAPPING
+static StagingBuffer stagingBuffers[NUM_STAGING_BUFFERS];
+#endif
+static size_t frameBudget = DEFAULT_FRAME_BUDGET;
+static TextureUploadStats stats;
+
+static size_t rowSize( const Upload* upload )
+{
+	return (size_t)upload->image->width * 4;
+}
+
+// how many rows go into the next band of the upload
+static int nextBandRows( const Upload* upload )
+{
+	int rows = (int)( BAND_SIZE / rowSize( upload ) );
+	int rowsLeft = upload->image->height - upload->nextRow;
+	assert( rows > 0 );
+	assert( rowsLeft > 0 );
+	return ( rows < rowsLeft ) ? rows : rowsLeft;
+}
+
+static bool withinBudget( size_t bytes )
+{
+	return ( stats.frameBands == 0 ) || ( ( stats.frameBytes + bytes ) <= frameBudget );
+}
+
+// creates the texture with uninitialized storage, the pixels are filled in a band at a time
+static bool createTexture( Upload* upload, GLint filter )
+{
+	GL( glGenTextures( 1, &( upload->texture.textureID ) ) );
+	if( upload->texture.textureID == 0 ) {
+		llog( LOG_INFO, "Unable to create texture object." );
+		return false;
+	}
+
+	GL( glBindTexture( GL_TEXTURE_2D, upload->texture.textureID ) );
+	GL( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter ) );
+	GL( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter ) );
+	GL( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE ) );
+	GL( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE ) );
+	GL( glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, upload->image->width, upload->image->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL ) );
+
+	upload->texture.width = upload->image->width;
+	upload->texture.height = upload->image->height;
+	upload->texture.flags = 0;
+	if( ( upload->image->flags & LIF_TRANSLUCENCY_KNOWN ) && ( upload->image->flags & LIF_IS_TRANSLUCENT ) ) {
+		upload->texture.flags |= TF_IS_TRANSPARENT;
+	}
+
+	return true;
+}
+
+// whether any of the bands still need to look for translucent pixels
+static bool needsScan( const Upload* upload )
+{
+	return !( upload->image->flags & LIF_TRANSLUCENCY_KNOWN ) && !( upload->texture.flags & TF_IS_TRANSPARENT );
+}
+
+// copies the rows into the texture, if an unpack buffer is bound pixels is an offset into it
+static void writeRows( Upload* upload, int firstRow, int numRows, const void* pixels )
+{
+	GL( glBindTexture( GL_TEXTURE_2D, upload->texture.textureID ) );
+	GL( glTexSubImage2D( GL_TEXTURE_2D, 0, 0, firstRow, upload->image->width, numRows, GL_RGBA, GL_UNSIGNED_BYTE, pixels ) );
+
+	size_t bytes = rowSize( upload ) * (size_t)numRows;
+	upload->rowsDone += numRows;
+
+	stats.frameBytes += bytes;
+	++stats.frameBands;
+	stats.bytesQueued -= bytes;
+	stats.totalBytes += bytes;
+	RSTATS_ADD( bytesUploaded, bytes );
+}
+
+// uploads the next band straight from the image
+static void uploadDirect( Upload* upload )
+{
+	int firstRow = upload->nextRow;
+	int numRows = nextBandRows( upload );
+	upload->nextRow += numRows;
+
+	const uint8_t* pixels = upload->image->data + ( rowSize( upload ) * (size_t)firstRow );
+	if( needsScan( upload ) && gfxUtil_HasTranslucentPixels( pixels, rowSize( upload ) * (size_t)numRows, 4 ) ) {
+		upload->texture.flags |= TF_IS_TRANSPARENT;
+	}
+
+	writeRows( upload, firstRow, numRows, pixels );
+}
+
+// called when everything is in the texture or there was a problem, the upload is freed
+static void finishUpload( size_t idx, bool success )
+{
+	Upload* upload = sbUploads[idx];
+	sb_Remove( sbUploads, idx );
+
+	if( success ) {
+		++stats.totalTextures;
+		upload->done( upload->data, true, &( upload->texture ) );
+	} else {
+		stats.bytesQueued -= rowSize( upload ) * (size_t)( upload->image->height - upload->rowsDone );
+		if( upload->texture.textureID != 0 ) {
+			GL( glDeleteTextures( 1, &( upload->texture.textureID ) ) );
+		}
+		upload->done( upload->data, false, NULL );
+	}
+
+	mem_Release( upload );
+}
+
+#ifndef TEX_UPLOAD_NO_MAPPING
+static void copyBand( void* data )
+{
+	StagingBuffer* staging = (StagingBuffer*)data;
+	const LoadedImage* image = staging->upload->image;
+
+	size_t stride = (size_t)image->width * 4;
+	size_t bytes = stride * (size_t)staging->numRows;
+	const uint8_t* pixels = image->data + ( stride * (size_t)staging->firstRow );
+
+	memcpy( staging->mapped, pixels, bytes );
+	if( staging->scan ) {
+		staging->translucent = gfxUtil_HasTranslucentPixels( pixels, bytes, 4 );
+	}
+
+	SDL_AtomicSet( &( staging->state ), SBS_READY );
+}
+
+/*
+Maps the staging buffer and has a worker copy the next band of the upload into it.
+ Returns false if the buffer couldn't be mapped.
+*/
+static bool startBand( StagingBuffer* staging, Upload* upload )
+{
+	int numRows = nextBandRows( upload );
+	size_t bytes = rowSize( upload ) * (size_t)numRows;
+
+	// invalidating lets the driver give us new storage if the GPU is still reading the last band, so we never wait
+	GL( glBindBuffer( GL_PIXEL_UNPACK_BUFFER, staging->buffer ) );
+	GLR( staging->mapped, glMapBufferRange( GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT ) );
+	GL( glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 ) );
+	if( staging->mapped == NULL ) {
+		return false;
+	}
+
+	staging->upload = upload;
+	staging->firstRow = upload->nextRow;
+	staging->numRows = numRows;
+	staging->scan = needsScan( upload );
+	staging->translucent = false;
+	upload->nextRow += numRows;
+
+	SDL_AtomicSet( &( staging->state ), SBS_COPYING );
+	if( !jq_AddJob( copyBand, staging ) ) {
+		copyBand( staging );
+	}
+
+	return true;
+}
+
+// copies the band the worker finished into the texture and frees up the staging buffer
+static void uploadBand( StagingBuffer* staging )
+{
+	Upload* upload = staging->upload;
+
+	GLboolean unmapped;
+	GL( glBindBuffer( GL_PIXEL_UNPACK_BUFFER, staging->buffer ) );
+	GLR( unmapped, glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER ) );
+	if( unmapped == GL_TRUE ) {
+		writeRows( upload, staging->firstRow, staging->numRows, NULL );
+	}
+	// anything else reading pixels would read from the buffer if it was left bound
+	GL( glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 ) );
+
+	if( unmapped == GL_FALSE ) {
+		llog( LOG_WARN, "Texture staging buffer contents were lost while mapped, uploading the band directly." );
+		writeRows( upload, staging->firstRow, staging->numRows, upload->image->data + ( rowSize( upload ) * (size_t)staging->firstRow ) );
+	}
+
+	if( staging->translucent ) {
+		upload->texture.flags |= TF_IS_TRANSPARENT;
+	}
+
+	staging->mapped = NULL;
+	staging->upload = NULL;
+	SDL_AtomicSet( &( staging->state ), SBS_FREE );
+}
+
+static StagingBuffer* findFreeStagingBuffer( void )
+{
+	for( int i = 0; i < NUM_STAGING_BUFFERS; ++i ) {
+		if( SDL_AtomicGet( &( stagingBuffers[i].state ) ) == SBS_FREE ) {
+			return &( stagingBuffers[i] );
+		}
+	}
+	return NULL;
+}
+#endif
+
+int texUpload_Init( void )
+{
+	memset( &stats, 0, sizeof( stats ) );
+
+#ifndef TEX_UPLOAD_NO_MAPPING
+	memset( stagingBuffers, 0, sizeof( stagingBuffers ) );
+	for( int i = 0; i < NUM_STAGING_BUFFERS; ++i ) {
+		SDL_AtomicSet( &( stagingBuffers[i].state ), SBS_FREE );
+
+		GL( glGenBuffers( 1, &( stagingBuffers[i].buffer ) ) );
+		if( stagingBuffers[i].buffer == 0 ) {
+			llog( LOG_ERROR, "Unable to create texture staging buffer." );
+			return -1;
+		}
+
+		GL( glBindBuffer( GL_PIXEL_UNPACK_BUFFER, stagingBuffers[i].buffer ) );
+		GL( glBufferData( GL_PIXEL_UNPACK_BUFFER, BAND_SIZE, NULL, GL_STREAM_DRAW ) );
+	}
+	GL( glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 ) );
+#endif
+
+	return 0;
+}
+
+void texUpload_CleanUp( void )
+{
+#ifndef TEX_UPLOAD_NO_MAPPING
+	for( int i = 0; i < NUM_STAGING_BUFFERS; ++i ) {
+		StagingBuffer* staging = &( stagingBuffers[i] );
+
+		// the worker is still writing into it, help out until it's done
+		while( SDL_AtomicGet( &( staging->state ) ) == SBS_COPYING ) {
+			if( !jq_ProcessNextJob( ) ) {
+				SDL_Delay( 1 );
+			}
+		}
+
+		if( staging->mapped != NULL ) {
+			GLboolean unmapped;
+			GL( glBindBuffer( GL_PIXEL_UNPACK_BUFFER, staging->buffer ) );
+			GLR( unmapped, glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER ) );
+			(void)unmapped;
+			staging->mapped = NULL;
+		}
+		staging->upload = NULL;
+		SDL_AtomicSet( &( staging->state ), SBS_FREE );
+
+		if( staging->buffer != 0 ) {
+			GL( glDeleteBuffers( 1, &( staging->buffer ) ) );
+			staging->buffer = 0;
+		}
+	}
+	GL( glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 ) );
+#endif
+
+	while( sb_Count( sbUploads ) > 0 ) {
+		finishUpload( 0, false );
+	}
+	sb_Release( sbUploads );
+}
+
+void texUpload_SetFrameBudget( size_t bytes )
+{
+	frameBudget = bytes;
+}
+
+bool texUpload_Queue( LoadedImage* image, GLint filter, TexUploadDoneFunc done, void* data )
+{
+	assert( image != NULL );
+	assert( done != NULL );
+
+	// the bands are copied as RGBA rows
+	if( ( image->data == NULL ) || ( image->reqComp != 4 ) || ( image->width <= 0 ) || ( image->height <= 0 ) ) {
+		return false;
+	}
+
+	if( ( (size_t)image->width * 4 ) > BAND_SIZE ) {
+		return false;
+	}
+
+	Upload* upload = mem_Allocate( sizeof( Upload ) );
+	if( upload == NULL ) {
+		llog( LOG_WARN, "Unable to create data for texture upload." );
+		return false;
+	}
+	memset( upload, 0, sizeof( Upload ) );
+
+	upload->image = image;
+	upload->done = done;
+	upload->data = data;
+
+	if( !createTexture( upload, filter ) ) {
+		mem_Release( upload );
+		return false;
+	}
+
+	sb_Push( sbUploads, upload );
+	stats.bytesQueued += rowSize( upload ) * (size_t)image->height;
+
+	return true;
+}
+
+void texUpload_Process( void )
+{
+	Uint64 timer = gt_StartTimer( );
+
+	stats.frameBytes = 0;
+	stats.frameBands = 0;
+
+#ifndef TEX_UPLOAD_NO_MAPPING
+	// upload the bands the workers have finished, oldest uploads first
+	bool budgetLeft = true;
+	for( size_t u = 0; ( u < sb_Count( sbUploads ) ) && budgetLeft; ++u ) {
+		for( int i = 0; i < NUM_STAGING_BUFFERS; ++i ) {
+			StagingBuffer* staging = &( stagingBuffers[i] );
+			if( ( staging->upload != sbUploads[u] ) || ( SDL_AtomicGet( &( staging->state ) ) != SBS_READY ) ) {
+				continue;
+			}
+
+			if( !withinBudget( rowSize( staging->upload ) * (size_t)staging->numRows ) ) {
+				budgetLeft = false;
+				break;
+			}
+
+			uploadBand( staging );
+		}
+	}
+
+	// start copying the next bands into any staging buffers that are free
+	for( size_t u = 0; u < sb_Count( sbUploads ); ++u ) {
+		Upload* upload = sbUploads[u];
+		while( upload->nextRow < upload->image->height ) {
+			StagingBuffer* staging = findFreeStagingBuffer( );
+			if( staging == NULL ) {
+				goto all_staged;
+			}
+
+			if( !startBand( staging, upload ) ) {
+				// can't stage it, send it through the old way if there's room
+				if( !withinBudget( rowSize( upload ) * (size_t)nextBandRows( upload ) ) ) {
+					goto all_staged;
+				}
+				uploadDirect( upload );
+			}
+		}
+	}
+all_staged:
+#else
+	for( size_t u = 0; u < sb_Count( sbUploads ); ++u ) {
+		Upload* upload = sbUploads[u];
+		while( ( upload->nextRow < upload->image->height ) && withinBudget( rowSize( upload ) * (size_t)nextBandRows( upload ) ) ) {
+			uploadDirect( upload );
+		}
+	}
+#endif
+
+	// let everything that's done know
+	for( size_t u = 0; u < sb_Count( sbUploads ); ) {
+		if( sbUploads[u]->rowsDone >= sbUploads[u]->image->height ) {
+			finishUpload( u, true );
+		} else {
+			++u;
+		}
+	}
+
+	stats.frameTime = gt_StopTimer( timer );
+	if( stats.frameTime > stats.maxFrameTime ) {
+		stats.maxFrameTime = stats.frameTime;
+	}
+}
+
+void texUpload_GetStats( TextureUploadStats* outStats )
+{
+	assert( outStats != NULL );
+
+	(*outStats) = stats;
+	outStats->numQueued = (int)sb_Count( sbUploads );
+}
+
+void texUpload_ResetStats( void )
+{
+	stats.totalBytes = 0;
+	stats.totalTextures = 0;
+	stats.maxFrameTime = 0.0f;
+}
+
+void texUpload_LogStats( void )
+{
+	TextureUploadStats current;
+	texUpload_GetStats( &current );
+
+	llog( LOG_INFO, "Texture upload stats:" );
+	llog( LOG_INFO, "  last frame: %u bytes in %i bands, %.4f seconds", (unsigned int)current.frameBytes, current.frameBands, current.frameTime );
+	llog( LOG_INFO, "  waiting: %i textures, %u bytes", current.numQueued, (unsigned int)current.bytesQueued );
+	llog( LOG_INFO, "  total: %i textures, %llu bytes, longest frame %.4f seconds", current.totalTextures, (unsigned long long)current.totalBytes, current.maxFrameTime );
+}
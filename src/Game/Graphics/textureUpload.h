@@ -0,0 +1,73 @@
+#ifndef TEXTURE_UPLOAD_H
+#define TEXTURE_UPLOAD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gfxUtil.h"
+
+/*
+Spreads the uploading of large textures across frames instead of doing it all at once when they're created.
+ Each texture is uploaded in bands of rows. The worker threads copy the bands into a small pool of mapped pixel unpack
+ buffers, and texUpload_Process copies them into the texture from there with glTexSubImage2D. Only as many bytes as
+ the frame budget allows are uploaded each frame, but at least one band always goes so everything finishes eventually.
+The staging buffers are mapped with GL_MAP_INVALIDATE_BUFFER_BIT, so the driver orphans the old storage if the GPU is
+ still reading from it and we never have to wait on it.
+WebGL doesn't support mapping buffers, so there the bands are uploaded straight from the image instead.
+Only meant to be used from the main thread.
+*/
+
+#if defined( __EMSCRIPTEN__ )
+	#define TEX_UPLOAD_NO_MAPPING
+#endif
+
+// called on the main thread once the texture is done, or if there was a problem, texture is NULL if success is false
+typedef void (*TexUploadDoneFunc)( void* data, bool success, Texture* texture );
+
+typedef struct {
+	// the last call to texUpload_Process
+	size_t frameBytes;
+	float frameTime; // in seconds
+	int frameBands;
+
+	// what's still waiting
+	int numQueued;
+	size_t bytesQueued;
+
+	// since texUpload_Init or the last texUpload_ResetStats
+	uint64_t totalBytes;
+	int totalTextures;
+	float maxFrameTime;
+} TextureUploadStats;
+
+/*
+Creates the staging buffers, has to be called after the OpenGL context is created.
+ Returns < 0 on an error.
+*/
+int texUpload_Init( void );
+
+/*
+Cancels everything still queued, the done function for each is called with success set to false.
+*/
+void texUpload_CleanUp( void );
+
+// how many bytes can be sent to the textures each frame
+void texUpload_SetFrameBudget( size_t bytes );
+
+/*
+Queues the RGBA image to be made into a texture. The image has to stay valid until done is called.
+ Returns false if the image couldn't be queued, the texture should be created directly then.
+*/
+bool texUpload_Queue( LoadedImage* image, GLint filter, TexUploadDoneFunc done, void* data );
+
+/*
+Uploads any bands that are ready, up to the frame budget, and starts copying the next ones. Called once a frame.
+*/
+void texUpload_Process( void );
+
+void texUpload_GetStats( TextureUploadStats* outStats );
+void texUpload_ResetStats( void );
+void texUpload_LogStats( void );
+
+#endif /* inclusion guard */
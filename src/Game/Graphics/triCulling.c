@@ -0,0 +1,261 @@
+#include "triCulling.h"
+
+#include <assert.h>
+#include <math.h>
+
+#include "../Math/mathUtil.h"
+
+#ifdef TRI_CULL_USE_SSE
+	#include <emmintrin.h>
+#endif
+
+void triCull_SetupCamera( const Matrix4* vpMat, uint32_t flags, CullCamera* outCamera )
+{
+	assert( vpMat != NULL );
+	assert( outCamera != NULL );
+
+	// same as mat4_TransformVec2Pos
+	outCamera->xx = vpMat->m[0];
+	outCamera->xy = vpMat->m[4];
+	outCamera->xw = vpMat->m[12];
+	outCamera->yx = vpMat->m[1];
+	outCamera->yy = vpMat->m[5];
+	outCamera->yw = vpMat->m[13];
+	outCamera->xScale = sqrtf( ( outCamera->xx * outCamera->xx ) + ( outCamera->xy * outCamera->xy ) );
+	outCamera->yScale = sqrtf( ( outCamera->yx * outCamera->yx ) + ( outCamera->yy * outCamera->yy ) );
+	outCamera->flags = flags;
+}
+
+static bool isTriAxisSeparating( Vector2* p0, Vector2* p1, Vector2* p2 )
+{
+	float temp;
+	Vector2 projTriPt0, projTriPt2;
+	float triPt0Dot, triPt2Dot;
+	float triMin, triMax;
+	float quadMin, quadMax;
+
+	Vector2 orthoAxis;
+	vec2_Subtract( p0, p1, &orthoAxis );
+	temp = orthoAxis.x;
+	orthoAxis.x = -orthoAxis.y;
+	orthoAxis.y = temp;
+	vec2_Normalize( &orthoAxis ); // is this necessary?
+
+	// since we're generating it from p0 and p1 that means they should both project to the same
+	//  value on the axis, so we only need to project p0 and p2
+	vec2_ProjOnto( p0, &orthoAxis, &projTriPt0 );
+	vec2_ProjOnto( p2, &orthoAxis, &projTriPt2 );
+	triPt0Dot = vec2_DotProduct( &orthoAxis, &projTriPt0 );
+	triPt2Dot = vec2_DotProduct( &orthoAxis, &projTriPt2 );
+
+	if( triPt0Dot > triPt2Dot ) {
+		triMin = triPt2Dot;
+		triMax = triPt0Dot;
+	} else {
+		triMin = triPt0Dot;
+		triMax = triPt2Dot;
+	}
+
+	// now find min and max for AABB on this axis, we know all points will be <+/-1,+/-1>
+	float dotPP = orthoAxis.x + orthoAxis.y;
+	float dotPN = orthoAxis.x - orthoAxis.y;
+	float dotNN = -orthoAxis.x - orthoAxis.y;
+	float dotNP = -orthoAxis.x + orthoAxis.y;
+
+	quadMin = MIN( dotPP, MIN( dotPN, MIN( dotNN, dotNP ) ) );
+	quadMax = MAX( dotPP, MAX( dotPN, MAX( dotNN, dotNP ) ) );
+
+	return ( FLT_LT( quadMax, triMin ) || FLT_GT( quadMin, triMax ) );
+}
+
+bool triCull_TestTriangle( Vector2* p0, Vector2* p1, Vector2* p2 )
+{
+	// we'll need an optimized version of the SAT test, since we always know the position and size
+	//  of the AABB we can precompute things
+
+	// first test to see if there is a horizontal or vertical axis that separates
+	if( FLT_LT( p0->x, -1.0f ) && FLT_LT( p1->x, -1.0f ) && FLT_LT( p2->x, -1.0f ) ) return false;
+	if( FLT_GT( p0->x, 1.0f ) && FLT_GT( p1->x, 1.0f ) && FLT_GT( p2->x, 1.0f ) ) return false;
+
+	if( FLT_LT( p0->y, -1.0f ) && FLT_LT( p1->y, -1.0f ) && FLT_LT( p2->y, -1.0f ) ) return false;
+	if( FLT_GT( p0->y, 1.0f ) && FLT_GT( p1->y, 1.0f ) && FLT_GT( p2->y, 1.0f ) ) return false;
+
+	// now test to see if the segments of the triangle generate a separating axis
+	if( isTriAxisSeparating( p0, p1, p2 ) ) return false;
+	if( isTriAxisSeparating( p1, p2, p0 ) ) return false;
+	if( isTriAxisSeparating( p2, p0, p1 ) ) return false;
+
+	return true;
+}
+
+static void transform( const CullCamera* camera, float x, float y, Vector2* out )
+{
+	out->x = ( camera->xx * x ) + ( camera->xy * y ) + camera->xw;
+	out->y = ( camera->yx * x ) + ( camera->yy * y ) + camera->yw;
+}
+
+static bool isVertexOnScreen( const Vector2* p )
+{
+	return ( p->x >= -1.0f ) && ( p->x <= 1.0f ) && ( p->y >= -1.0f ) && ( p->y <= 1.0f );
+}
+
+// handles a single triangle, used for whatever's left over after the SSE version has gone through the blocks of four
+static bool cullSingle( const CullCamera* cameras, int numCameras, const CullTriangles* tris, size_t idx )
+{
+	for( int c = 0; c < numCameras; ++c ) {
+		if( ( cameras[c].flags & tris->camFlags[idx] ) == 0 ) {
+			continue;
+		}
+
+		Vector2 p[3];
+		for( int v = 0; v < 3; ++v ) {
+			transform( &( cameras[c] ), tris->x[v][idx], tris->y[v][idx], &( p[v] ) );
+		}
+
+		// quick accept and reject with the bounding box, then the full test for anything straddling the edges
+		float minX = MIN( p[0].x, MIN( p[1].x, p[2].x ) );
+		float maxX = MAX( p[0].x, MAX( p[1].x, p[2].x ) );
+		float minY = MIN( p[0].y, MIN( p[1].y, p[2].y ) );
+		float maxY = MAX( p[0].y, MAX( p[1].y, p[2].y ) );
+		if( ( minX > 1.0f ) || ( maxX < -1.0f ) || ( minY > 1.0f ) || ( maxY < -1.0f ) ) {
+			continue;
+		}
+
+		if( isVertexOnScreen( &( p[0] ) ) || isVertexOnScreen( &( p[1] ) ) || isVertexOnScreen( &( p[2] ) ) ) {
+			return true;
+		}
+
+		if( triCull_TestTriangle( &( p[0] ), &( p[1] ), &( p[2] ) ) ) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+size_t triCull_Cull( const CullCamera* cameras, int numCameras, const CullTriangles* tris, size_t count, uint8_t* outVisible )
+{
+	assert( ( numCameras == 0 ) || ( cameras != NULL ) );
+	assert( ( count == 0 ) || ( ( tris != NULL ) && ( outVisible != NULL ) ) );
+
+	size_t numVisible = 0;
+	size_t idx = 0;
+
+#ifdef TRI_CULL_USE_SSE
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 negOne = _mm_set1_ps( -1.0f );
+	const __m128i zero = _mm_setzero_si128( );
+
+	for( ; ( idx + 4 ) <= count; idx += 4 ) {
+		__m128 x[3], y[3];
+		for( int v = 0; v < 3; ++v ) {
+			x[v] = _mm_loadu_ps( tris->x[v] + idx );
+			y[v] = _mm_loadu_ps( tris->y[v] + idx );
+		}
+		__m128i triFlags = _mm_loadu_si128( (const __m128i*)( tris->camFlags + idx ) );
+
+		int visibleMask = 0;
+		for( int c = 0; ( c < numCameras ) && ( visibleMask != 0xF ); ++c ) {
+			const CullCamera* cam = &( cameras[c] );
+
+			// lanes where the triangle is drawn by this camera
+			__m128i flagsMatch = _mm_and_si128( triFlags, _mm_set1_epi32( (int)cam->flags ) );
+			int usedMask = ( ~_mm_movemask_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( flagsMatch, zero ) ) ) ) & 0xF;
+			usedMask &= ~visibleMask;
+			if( usedMask == 0 ) {
+				continue;
+			}
+
+			__m128 xx = _mm_set1_ps( cam->xx ), xy = _mm_set1_ps( cam->xy ), xw = _mm_set1_ps( cam->xw );
+			__m128 yx = _mm_set1_ps( cam->yx ), yy = _mm_set1_ps( cam->yy ), yw = _mm_set1_ps( cam->yw );
+
+			__m128 px[3], py[3];
+			__m128 anyOnScreen = _mm_setzero_ps( );
+			for( int v = 0; v < 3; ++v ) {
+				px[v] = _mm_add_ps( _mm_add_ps( _mm_mul_ps( xx, x[v] ), _mm_mul_ps( xy, y[v] ) ), xw );
+				py[v] = _mm_add_ps( _mm_add_ps( _mm_mul_ps( yx, x[v] ), _mm_mul_ps( yy, y[v] ) ), yw );
+
+				__m128 onScreen = _mm_and_ps(
+					_mm_and_ps( _mm_cmpge_ps( px[v], negOne ), _mm_cmple_ps( px[v], one ) ),
+					_mm_and_ps( _mm_cmpge_ps( py[v], negOne ), _mm_cmple_ps( py[v], one ) ) );
+				anyOnScreen = _mm_or_ps( anyOnScreen, onScreen );
+			}
+
+			__m128 minX = _mm_min_ps( px[0], _mm_min_ps( px[1], px[2] ) );
+			__m128 maxX = _mm_max_ps( px[0], _mm_max_ps( px[1], px[2] ) );
+			__m128 minY = _mm_min_ps( py[0], _mm_min_ps( py[1], py[2] ) );
+			__m128 maxY = _mm_max_ps( py[0], _mm_max_ps( py[1], py[2] ) );
+			__m128 offScreen = _mm_or_ps(
+				_mm_or_ps( _mm_cmpgt_ps( minX, one ), _mm_cmplt_ps( maxX, negOne ) ),
+				_mm_or_ps( _mm_cmpgt_ps( minY, one ), _mm_cmplt_ps( maxY, negOne ) ) );
+
+			int offScreenMask = _mm_movemask_ps( offScreen );
+			int acceptMask = _mm_movemask_ps( anyOnScreen ) & ~offScreenMask & usedMask;
+			int straddleMask = usedMask & ~offScreenMask & ~acceptMask;
+
+			visibleMask |= acceptMask;
+
+			// the rare triangles with no vertices on screen whose bounding box still overlaps it need the full test
+			if( straddleMask != 0 ) {
+				float sx[3][4], sy[3][4];
+				for( int v = 0; v < 3; ++v ) {
+					_mm_storeu_ps( sx[v], px[v] );
+					_mm_storeu_ps( sy[v], py[v] );
+				}
+				for( int lane = 0; lane < 4; ++lane ) {
+					if( straddleMask & ( 1 << lane ) ) {
+						Vector2 p0 = { sx[0][lane], sy[0][lane] };
+						Vector2 p1 = { sx[1][lane], sy[1][lane] };
+						Vector2 p2 = { sx[2][lane], sy[2][lane] };
+						if( triCull_TestTriangle( &p0, &p1, &p2 ) ) {
+							visibleMask |= ( 1 << lane );
+						}
+					}
+				}
+			}
+		}
+
+		for( int lane = 0; lane < 4; ++lane ) {
+			uint8_t visible = ( visibleMask >> lane ) & 1;
+			outVisible[idx + lane] = visible;
+			numVisible += visible;
+		}
+	}
+#endif
+
+	for( ; idx < count; ++idx ) {
+		uint8_t visible = cullSingle( cameras, numCameras, tris, idx ) ? 1 : 0;
+		outVisible[idx] = visible;
+		numVisible += visible;
+	}
+
+	return numVisible;
+}
+
+size_t triCull_CullCircles( const CullCamera* cameras, int numCameras, const CullCircles* circles, size_t count, uint8_t* outVisible )
+{
+	assert( ( numCameras == 0 ) || ( cameras != NULL ) );
+	assert( ( count == 0 ) || ( ( circles != NULL ) && ( outVisible != NULL ) ) );
+
+	size_t numVisible = 0;
+	for( size_t idx = 0; idx < count; ++idx ) {
+		uint8_t visible = 0;
+		for( int c = 0; ( c < numCameras ) && !visible; ++c ) {
+			const CullCamera* cam = &( cameras[c] );
+			if( ( cam->flags & circles->camFlags[idx] ) == 0 ) {
+				continue;
+			}
+
+			// the circle becomes an ellipse in clip space, test the box around that against the screen
+			Vector2 center;
+			transform( cam, circles->x[idx], circles->y[idx], &center );
+			float extentX = 1.0f + ( circles->radius[idx] * cam->xScale );
+			float extentY = 1.0f + ( circles->radius[idx] * cam->yScale );
+			visible = ( ( fabsf( center.x ) <= extentX ) && ( fabsf( center.y ) <= extentY ) ) ? 1 : 0;
+		}
+		outVisible[idx] = visible;
+		numVisible += visible;
+	}
+
+	return numVisible;
+}
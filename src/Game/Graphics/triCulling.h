@@ -0,0 +1,57 @@
+#ifndef TRI_CULLING_H
+#define TRI_CULLING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../Math/vector2.h"
+#include "../Math/matrix4.h"
+
+/*
+Batched culling of triangles against the cameras. The triangles are stored as structures of arrays so four can be tested
+ at once using SSE when it's available. Each triangle is first checked against its bounding box in clip space, that
+ rejects anything completely off screen and accepts anything with a vertex on screen, only the triangles that straddle
+ an edge of the screen go through the full separating axis test.
+Doesn't touch any OpenGL so it can be benchmarked without a context.
+*/
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define TRI_CULL_USE_SSE
+#endif
+
+typedef struct {
+	// the parts of the view projection matrix used to transform 2D positions
+	float xx, xy, xw;
+	float yx, yy, yw;
+	float xScale, yScale; // how much a distance in world space is scaled along each axis
+	uint32_t flags;
+} CullCamera;
+
+typedef struct {
+	float* x[3];
+	float* y[3];
+	uint32_t* camFlags;
+} CullTriangles;
+
+// used for anything that can be bounded by a circle, like sprites
+typedef struct {
+	float* x;
+	float* y;
+	float* radius;
+	uint32_t* camFlags;
+} CullCircles;
+
+void triCull_SetupCamera( const Matrix4* vpMat, uint32_t flags, CullCamera* outCamera );
+
+// sets outVisible[i] to whether triangle i can be seen by any of the cameras that have flags matching the triangle's,
+//  returns the number of visible triangles
+size_t triCull_Cull( const CullCamera* cameras, int numCameras, const CullTriangles* tris, size_t count, uint8_t* outVisible );
+
+// same as triCull_Cull but for circles, the test is conservative so some circles just off screen will count as visible
+size_t triCull_CullCircles( const CullCamera* cameras, int numCameras, const CullCircles* circles, size_t count, uint8_t* outVisible );
+
+// test to see if the triangle, already transformed into clip space, intersects the AABB centered on (0,0) with sides of length 2
+bool triCull_TestTriangle( Vector2* p0, Vector2* p1, Vector2* p2 );
+
+#endif /* inclusion guard */
@@ -1,6 +1,10 @@
 #include "triRendering.h"
 
 #include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <string.h>
 
 #include "glPlatform.h"
 
@@ -9,8 +13,20 @@
 #include "shaderManager.h"
 #include "glDebugging.h"
 #include "scissor.h"
+#include "renderSort.h"
+#include "triCulling.h"
+#include "streamBuffer.h"
+#include "renderStats.h"
 #include "../System/platformLog.h"
 #include "../Math/mathUtil.h"
+#include "../System/memory.h"
+#include "../System/jobQueue.h"
+#include "../Utils/stretchyBuffer.h"
+#include "../System/fileWatcher.h"
+
+#ifdef TRI_CULL_USE_SSE
+	#include <xmmintrin.h>
+#endif
 
 typedef struct {
 	Vector3 pos;
@@ -18,8 +34,8 @@ typedef struct {
 	Vector2 uv;
 } Vertex;
 
+// everything used to sort and batch a triangle or sprite
 typedef struct {
-	GLuint vertexIndices[3];
 	float zPos;
 	uint32_t camFlags;
 
@@ -29,37 +45,215 @@ typedef struct {
 	ShaderType shaderType;
 
 	int scissorID;
+} DrawState;
+
+typedef struct {
+	GLuint vertexIndices[3];
+	DrawState state;
 } Triangle;
 
+// per instance data for the sprites, the attributes in SPRITE_VERTEX_SHADER read these in groups of four floats
+//  so the order of the fields matters
+typedef struct {
+	Vector3 pos;
+	float rotation;
+	Vector2 size;
+	Vector2 offset;
+	Color col;
+	Vector2 uvMin;
+	Vector2 uvMax;
+} SpriteInstance;
+
+// a run of sorted triangles or sprites that share the same state, first and count are in indices for triangles and
+//  instances for sprites, a group is always drawn as a batch of its own
+typedef struct {
+	int program;
+	GLuint texture;
+	float floatVal0;
+	int scissorID;
+	bool isSprite;
+	int groupDraw; // index into the list's group draws, -1 if this isn't a group
+	int first;
+	int count;
+} DrawBatch;
+
+// sprites recorded once and kept on the GPU until the group is cleared, the sprites are relative to the position the
+//  group is added at and are drawn in the order they were recorded
+typedef struct {
+	bool inUse;
+	bool needsUpload;
+	bool transparent;
+	bool stale; // cleared because a texture it used went away, needs to be recorded again
+
+	SpriteInstance* sbInstances;
+	DrawState* sbStates;
+	DrawBatch* sbBatches;
+
+	Vector2 boundsMin;
+	Vector2 boundsMax;
+
+	GLuint VAO;
+	GLuint VBO;
+} DrawGroup;
+
+// a group added to a list this frame
+typedef struct {
+	int groupID;
+	Vector2 offset;
+	DrawState state;
+} GroupDraw;
+
 /*
 Ok, so what do we want to optimize for?
 I'd think transferring memory.
 So we have the vertices we transfer at the beginning of the rendering
 Once that is done we generate index buffers to represent what each camera can see
 */
-#define MAX_TRIS ( 2048 * 2 )
-#define MAX_VERTS ( MAX_TRIS * 3 )
+#define INITIAL_TRIS 512
+#define INITIAL_SPRITES 256
+#define NUM_CULL_CAMERAS 16 // same as the most cameras there can be
 
+// the index buffer, sprite instances, and batches for drawing a list with a single camera, these only depend on the
+//  sorted list so they're built on the job queue before anything is drawn
 typedef struct {
-	Vertex startVertices[MAX_VERTS];
-	Vertex endVertices[MAX_VERTS];
+	uint32_t camFlags;
+
+	GLuint* indices;
+	SpriteInstance* instances;
+	DrawBatch* batches;
+
+	int indexCapacity;
+	int instanceCapacity;
+	int batchCapacity;
+
+	int numIndices;
+	int numInstances;
+	int numBatches;
+} CameraBatches;
 
-	Triangle triangles[MAX_TRIS];
-	Vertex vertices[MAX_VERTS];
-	GLuint indices[MAX_VERTS];
+// set on the index of sort entries that refer to a sprite or a group instead of a triangle
+#define SORT_IDX_SPRITE 0x80000000u
+#define SORT_IDX_GROUP 0x40000000u
+#define SORT_IDX_MASK 0x3FFFFFFFu
+#define SORT_IDX_KIND( idx ) ( (idx) & ( SORT_IDX_SPRITE | SORT_IDX_GROUP ) )
+
+#define MAX_DRAW_GROUPS 32
+#define MAX_GROUP_DRAWS 32 // most groups that can be added to each list in a frame
+
+typedef struct {
+	// all of these hold capacity triangles, or capacity * 3 vertices or indices
+	//  vertices are what's drawn, when anything in the list moves during the tick they're interpolated from the start
+	//  and end vertices every frame
+	Vertex* startVertices;
+	Vertex* endVertices;
+
+	Triangle* triangles;
+	Vertex* vertices;
+	bool tweened;
+
+	// positions of each triangle stored separately for culling
+	float* cullX[3];
+	float* cullY[3];
+	uint32_t* cullFlags;
+	uint8_t* visible;
+	int numVisible;
+
+	// sprites are kept separately and drawn with instancing, these all hold spriteCapacity sprites
+	DrawState* spriteStates;
+	SpriteInstance* spriteInstances;
+	SpriteInstance* startSpriteInstances;
+	SpriteInstance* endSpriteInstances;
+	float* startFloatVal0;
+	float* endFloatVal0;
+	bool spritesTweened;
+	bool floatValsTweened;
+	float* spriteCullX;
+	float* spriteCullY;
+	float* spriteCullRadius;
+	uint32_t* spriteCullFlags;
+	uint8_t* spriteVisible;
+	int numVisibleSprites;
+
+	// groups are culled as a whole and take up a single sort entry
+	GroupDraw groupDraws[MAX_GROUP_DRAWS];
+	float groupCullX[MAX_GROUP_DRAWS];
+	float groupCullY[MAX_GROUP_DRAWS];
+	float groupCullRadius[MAX_GROUP_DRAWS];
+	uint32_t groupCullFlags[MAX_GROUP_DRAWS];
+	uint8_t groupVisible[MAX_GROUP_DRAWS];
+	int numVisibleGroupDraws;
+	int lastGroupDrawIndex;
+
+	// the triangles and sprites are never moved, we sort these and draw in the order they end up in, only visible
+	//  ones are sorted, holds capacity + spriteCapacity + MAX_GROUP_DRAWS entries
+	RenderSortEntry* sortEntries;
+	RenderSortEntry* sortScratch;
+	RenderSortEntry* sortedTris;
+	int numSorted;
+
+	// what each camera will draw from this list, in the same order as the cameras are iterated
+	CameraBatches cameraBatches[NUM_CULL_CAMERAS];
+
+	int capacity;
+
+	// the vertices are uploaded once a frame, the indices and instances once for each camera
 	GLuint VAO;
-	GLuint VBO;
-	GLuint IBO;
+	StreamBuffer vertexStream;
+	StreamBuffer indexStream;
 	int lastTriIndex;
-	int lastIndexBufferIndex;
+
+	int spriteCapacity;
+	GLuint spriteVAO;
+	StreamBuffer instanceStream;
+	int lastSpriteIndex;
+
+	int droppedTris; // triangles, sprites, and groups that didn't fit this frame
+	int droppedSprites;
+	int droppedGroupDraws;
+
+	// where the list was when the tick's content was finished, anything after is only drawn for a single frame
+	int tickTriIndex;
+	int tickSpriteIndex;
+	int tickGroupDrawIndex;
 } TriangleList;
 
 TriangleList solidTriangles;
 TriangleList transparentTriangles;
 
-#define Z_ORDER_OFFSET ( 1.0f / (float)( 2 * ( MAX_TRIS + 1 ) ) )
-
-static ShaderProgram shaderPrograms[NUM_SHADERS];
+static int maxTris = TRI_RENDERER_DEFAULT_MAX_TRIS;
+static int maxSprites = TRI_RENDERER_DEFAULT_MAX_SPRITES;
+static TriRendererStats stats;
+
+static DrawGroup drawGroups[MAX_DRAW_GROUPS];
+static int numGroupZSlots = 0; // each sprite in a group added this frame takes up a spot in the z order
+static int tickGroupZSlots = 0;
+
+// used to keep the triangles and sprites on the same depth in the order they were added, the offset of everything in a
+//  frame has to add up to less than one depth level. Both lists can be full of triangles and sprites, and the sprites in
+//  groups are given up to as many slots again as the sprites in the lists.
+#define Z_ORDER_OFFSET( tris, sprites ) ( 1.0f / (float)( 2 * ( (tris) + ( 2 * (sprites) ) + 1 ) ) )
+static float zOrderOffset = Z_ORDER_OFFSET( TRI_RENDERER_DEFAULT_MAX_TRIS, TRI_RENDERER_DEFAULT_MAX_SPRITES );
+
+// the first set of programs are for triangles, the second set are the same fragment shaders used for sprites
+#define NUM_PROGRAMS ( NUM_SHADERS * 2 )
+#define SPRITE_PROGRAM( shader ) ( NUM_SHADERS + (int)(shader) )
+static ShaderProgram shaderPrograms[NUM_PROGRAMS];
+static bool shadersLoaded = false;
+
+// if any of these exist they're used instead of the built in shaders, they're watched so they can be edited while
+//  the game is running, same order as the shader definitions
+#define NUM_SHADER_DEFS 6
+static const char* shaderOverrideFiles[NUM_SHADER_DEFS] = {
+	"Shaders/default.vert",
+	"Shaders/default.frag",
+	"Shaders/font.frag",
+	"Shaders/simpleSDF.frag",
+	"Shaders/imageSDF.frag",
+	"Shaders/sprite.vert"
+};
+
+// corners of the unit square each sprite instance is expanded from, in triangle strip order
+static GLuint spriteCornerVBO = 0;
 
 TriVert triVert( Vector2 pos, Vector2 uv, Color col )
 {
@@ -70,14 +264,27 @@ TriVert triVert( Vector2 pos, Vector2 uv, Color col )
 	return v;
 }
 
+static bool fileExists( const char* fileName )
+{
+	FILE* file = fopen( fileName, "r" );
+	if( file == NULL ) {
+		return false;
+	}
+	fclose( file );
+	return true;
+}
+
+static void shaderFileChanged( const char* fileName, void* data )
+{
+	triRenderer_LoadShaders( );
+}
+
 int triRenderer_LoadShaders( void )
 {
 	llog( LOG_INFO, "Loading triangle renderer shaders." );
-	ShaderDefinition shaderDefs[5];
-	ShaderProgramDefinition progDefs[NUM_SHADERS];
-
-	llog( LOG_INFO, "  Destroying shaders." );
-	shaders_Destroy( shaderPrograms, NUM_SHADERS );
+	ShaderDefinition shaderDefs[NUM_SHADER_DEFS];
+	ShaderProgramDefinition progDefs[NUM_PROGRAMS];
+	ShaderProgram newPrograms[NUM_PROGRAMS];
 
 	// Sprite shader
 	shaderDefs[0].fileName = NULL;
@@ -103,6 +310,10 @@ int triRenderer_LoadShaders( void )
 	shaderDefs[4].type = GL_FRAGMENT_SHADER;
 	shaderDefs[4].shaderText = IMAGE_SDF_FRAG_SHADER;
 
+	// instanced sprites
+	shaderDefs[5].fileName = NULL;
+	shaderDefs[5].type = GL_VERTEX_SHADER;
+	shaderDefs[5].shaderText = SPRITE_VERTEX_SHADER;
 
 	progDefs[0].fragmentShader = 1;
 	progDefs[0].vertexShader = 0;
@@ -120,48 +331,227 @@ int triRenderer_LoadShaders( void )
 	progDefs[3].vertexShader = 0;
 	progDefs[3].geometryShader = -1;
 
+	for( int i = 0; i < NUM_SHADERS; ++i ) {
+		progDefs[SPRITE_PROGRAM( i )] = progDefs[i];
+		progDefs[SPRITE_PROGRAM( i )].vertexShader = 5;
+	}
+
+	for( int i = 0; i < NUM_SHADER_DEFS; ++i ) {
+		if( fileExists( shaderOverrideFiles[i] ) ) {
+			llog( LOG_INFO, "  Using %s instead of the built in shader.", shaderOverrideFiles[i] );
+			shaderDefs[i].shaderText = NULL;
+			shaderDefs[i].fileName = shaderOverrideFiles[i];
+		}
+	}
+
+	// the old programs are kept until the new ones are ready so a mistake in a shader being edited doesn't break
+	//  everything, when reloading all of them have to work
 	llog( LOG_INFO, "  Loading shaders." );
-	if( shaders_Load( &( shaderDefs[0] ), sizeof( shaderDefs ) / sizeof( ShaderDefinition ),
-		progDefs, shaderPrograms, NUM_SHADERS ) <= 0 ) {
+	size_t numLoaded = shaders_Load( &( shaderDefs[0] ), sizeof( shaderDefs ) / sizeof( ShaderDefinition ),
+		progDefs, newPrograms, NUM_PROGRAMS );
+	if( ( numLoaded <= 0 ) || ( shadersLoaded && ( numLoaded < NUM_PROGRAMS ) ) ) {
 		llog( LOG_ERROR, "Error compiling image shaders.\n" );
+		shaders_Destroy( newPrograms, NUM_PROGRAMS );
 		return -1;
 	}
 
+	llog( LOG_INFO, "  Destroying old shaders." );
+	shaders_Destroy( shaderPrograms, NUM_PROGRAMS );
+	memcpy( shaderPrograms, newPrograms, sizeof( shaderPrograms ) );
+	shadersLoaded = true;
+
 	return 0;
 }
 
+// if any of these fail the old memory is kept, so just keep whatever did succeed and don't change the capacity
+#define RESIZE( field, count ) { \
+		void* newMem = mem_Resize( triList->field, sizeof( triList->field[0] ) * (count) ); \
+		if( newMem == NULL ) { \
+			llog( LOG_ERROR, "Unable to grow triangle list storage to %i entries.", (int)(count) ); \
+			return false; \
+		} \
+		triList->field = newMem; }
+
+static bool resizeSortEntries( TriangleList* triList, int triCapacity, int spriteCapacity )
+{
+	int count = triCapacity + spriteCapacity + MAX_GROUP_DRAWS;
+
+	RESIZE( sortEntries, count );
+	RESIZE( sortScratch, count );
+	triList->sortedTris = triList->sortEntries;
+
+	return true;
+}
+
+// grows all the storage for the list to hold at least newCapacity triangles, returns whether it was able to
+static bool resizeTriList( TriangleList* triList, int newCapacity )
+{
+	if( newCapacity <= triList->capacity ) {
+		return true;
+	}
+
+	size_t numVerts = (size_t)newCapacity * 3;
+
+	RESIZE( startVertices, numVerts );
+	RESIZE( endVertices, numVerts );
+	RESIZE( vertices, numVerts );
+	RESIZE( triangles, newCapacity );
+	for( int i = 0; i < 3; ++i ) {
+		RESIZE( cullX[i], newCapacity );
+		RESIZE( cullY[i], newCapacity );
+	}
+	RESIZE( cullFlags, newCapacity );
+	RESIZE( visible, newCapacity );
+
+	if( !resizeSortEntries( triList, newCapacity, triList->spriteCapacity ) ) {
+		return false;
+	}
+
+	triList->capacity = newCapacity;
+
+	return true;
+}
+
+// same as resizeTriList but for the sprites
+static bool resizeSpriteList( TriangleList* triList, int newCapacity )
+{
+	if( newCapacity <= triList->spriteCapacity ) {
+		return true;
+	}
+
+	RESIZE( spriteStates, newCapacity );
+	RESIZE( spriteInstances, newCapacity );
+	RESIZE( startSpriteInstances, newCapacity );
+	RESIZE( endSpriteInstances, newCapacity );
+	RESIZE( startFloatVal0, newCapacity );
+	RESIZE( endFloatVal0, newCapacity );
+	RESIZE( spriteCullX, newCapacity );
+	RESIZE( spriteCullY, newCapacity );
+	RESIZE( spriteCullRadius, newCapacity );
+	RESIZE( spriteCullFlags, newCapacity );
+	RESIZE( spriteVisible, newCapacity );
+
+	if( !resizeSortEntries( triList, triList->capacity, newCapacity ) ) {
+		return false;
+	}
+
+	triList->spriteCapacity = newCapacity;
+
+	return true;
+}
+
+#undef RESIZE
+
+// grows the list geometrically, up to the maximum number of triangles
+static bool growTriList( TriangleList* triList )
+{
+	if( triList->capacity >= maxTris ) {
+		return false;
+	}
+
+	int newCapacity = MIN( triList->capacity * 2, maxTris );
+	return resizeTriList( triList, newCapacity );
+}
+
+static bool growSpriteList( TriangleList* triList )
+{
+	if( triList->spriteCapacity >= maxSprites ) {
+		return false;
+	}
+
+	int newCapacity = MIN( triList->spriteCapacity * 2, maxSprites );
+	return resizeSpriteList( triList, newCapacity );
+}
+
+// points the attributes of the bound vertex array at the bound array buffer, starting at baseOffset bytes
+static void setVertexAttributes( size_t baseOffset )
+{
+	GL( glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof( Vertex ), (const GLvoid*)( baseOffset + offsetof( Vertex, pos ) ) ) );
+	GL( glVertexAttribPointer( 1, 2, GL_FLOAT, GL_FALSE, sizeof( Vertex ), (const GLvoid*)( baseOffset + offsetof( Vertex, uv ) ) ) );
+	GL( glVertexAttribPointer( 2, 4, GL_FLOAT, GL_FALSE, sizeof( Vertex ), (const GLvoid*)( baseOffset + offsetof( Vertex, col ) ) ) );
+}
+
+// points the per instance attributes of the bound vertex array at the bound array buffer, starting at baseOffset bytes
+static void setInstanceAttributes( size_t baseOffset )
+{
+#define INSTANCE_ATTRIB( loc, field ) \
+	GL( glVertexAttribPointer( (loc), 4, GL_FLOAT, GL_FALSE, sizeof( SpriteInstance ), (const GLvoid*)( baseOffset + offsetof( SpriteInstance, field ) ) ) )
+
+	INSTANCE_ATTRIB( 1, pos ); // position and rotation
+	INSTANCE_ATTRIB( 2, size ); // size and offset
+	INSTANCE_ATTRIB( 3, col );
+	INSTANCE_ATTRIB( 4, uvMin ); // min and max uvs
+
+#undef INSTANCE_ATTRIB
+}
+
 static int createTriListGLObjects( TriangleList* triList )
 {
+	memset( triList, 0, sizeof( TriangleList ) );
+	if( !resizeTriList( triList, MIN( INITIAL_TRIS, maxTris ) ) ||
+		!resizeSpriteList( triList, MIN( INITIAL_SPRITES, maxSprites ) ) ) {
+		return -1;
+	}
+
 	GL( glGenVertexArrays( 1, &( triList->VAO ) ) );
-	GL( glGenBuffers( 1, &( triList->VBO ) ) );
-	GL( glGenBuffers( 1, &( triList->IBO ) ) );
-	if( ( triList->VAO == 0 ) || ( triList->VBO == 0 ) || ( triList->IBO == 0 ) ) {
-		llog( LOG_ERROR, "Unable to create one or more storage objects for triangle rendering." );
+	if( triList->VAO == 0 ) {
+		llog( LOG_ERROR, "Unable to create vertex array for triangle rendering." );
 		return -1;
 	}
 
 	GL( glBindVertexArray( triList->VAO ) );
 
-	GL( glBindBuffer( GL_ARRAY_BUFFER, triList->VBO ) );
-	GL( glBufferData( GL_ARRAY_BUFFER, sizeof( triList->vertices ), NULL, GL_DYNAMIC_DRAW ) );
+	// the index buffer is bound to the vertex array here
+	if( ( streamBuffer_Init( &( triList->vertexStream ), GL_ARRAY_BUFFER, sizeof( Vertex ) * triList->capacity * 3 ) < 0 ) ||
+		( streamBuffer_Init( &( triList->indexStream ), GL_ELEMENT_ARRAY_BUFFER, sizeof( GLuint ) * triList->capacity * 3 ) < 0 ) ) {
+		llog( LOG_ERROR, "Unable to create one or more storage objects for triangle rendering." );
+		return -1;
+	}
 
-	GL( glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, triList->IBO ) );
-	GL( glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( triList->indices ), triList->indices, GL_DYNAMIC_DRAW ) );
+	GL( glBindBuffer( GL_ARRAY_BUFFER, triList->vertexStream.buffer ) );
 
 	GL( glEnableVertexAttribArray( 0 ) );
 	GL( glEnableVertexAttribArray( 1 ) );
 	GL( glEnableVertexAttribArray( 2 ) );
 
-	GL( glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof( Vertex ), (const GLvoid*)offsetof( Vertex, pos ) ) );
-	GL( glVertexAttribPointer( 1, 2, GL_FLOAT, GL_FALSE, sizeof( Vertex ), (const GLvoid*)offsetof( Vertex, uv ) ) );
-	GL( glVertexAttribPointer( 2, 4, GL_FLOAT, GL_FALSE, sizeof( Vertex ), (const GLvoid*)offsetof( Vertex, col ) ) );
+	setVertexAttributes( 0 );
+
+	GL( glBindVertexArray( 0 ) );
+
+	// the sprites use a separate vertex array, the corners of the quad are shared and everything else is per instance
+	GL( glGenVertexArrays( 1, &( triList->spriteVAO ) ) );
+	if( triList->spriteVAO == 0 ) {
+		llog( LOG_ERROR, "Unable to create vertex array for sprite rendering." );
+		return -1;
+	}
+
+	GL( glBindVertexArray( triList->spriteVAO ) );
+
+	GL( glBindBuffer( GL_ARRAY_BUFFER, spriteCornerVBO ) );
+	GL( glEnableVertexAttribArray( 0 ) );
+	GL( glVertexAttribPointer( 0, 2, GL_FLOAT, GL_FALSE, sizeof( Vector2 ), NULL ) );
+
+	if( streamBuffer_Init( &( triList->instanceStream ), GL_ARRAY_BUFFER, sizeof( SpriteInstance ) * triList->spriteCapacity ) < 0 ) {
+		llog( LOG_ERROR, "Unable to create storage object for sprite rendering." );
+		return -1;
+	}
+	for( GLuint i = 1; i <= 4; ++i ) {
+		GL( glEnableVertexAttribArray( i ) );
+		GL( glVertexAttribDivisor( i, 1 ) );
+	}
+	setInstanceAttributes( 0 );
 
 	GL( glBindVertexArray( 0 ) );
 
 	GL( glBindBuffer( GL_ARRAY_BUFFER, 0 ) );
 
-	triList->lastIndexBufferIndex = -1;
 	triList->lastTriIndex = -1;
+	triList->lastSpriteIndex = -1;
+	triList->lastGroupDrawIndex = -1;
+	triList->tickTriIndex = -1;
+	triList->tickSpriteIndex = -1;
+	triList->tickGroupDrawIndex = -1;
+	triList->sortedTris = triList->sortEntries;
 
 	return 0;
 }
@@ -172,14 +562,30 @@ Initializes all the stuff needed for rendering the triangles.
 */
 int triRenderer_Init( int renderAreaWidth, int renderAreaHeight )
 {
-	for( int i = 0; i < NUM_SHADERS; ++i ) {
+	for( int i = 0; i < NUM_PROGRAMS; ++i ) {
 		shaderPrograms[i].programID = 0;
 	}
+	shadersLoaded = false;
 
 	if( triRenderer_LoadShaders( ) < 0 ) {
 		return -1;
 	}
 
+	for( int i = 0; i < NUM_SHADER_DEFS; ++i ) {
+		fw_Watch( shaderOverrideFiles[i], shaderFileChanged, NULL );
+	}
+
+	// same order as the vertices img_Render used to generate, so the uvs and triangle strip match
+	Vector2 corners[] = { { -0.5f, -0.5f }, { -0.5f, 0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f } };
+	GL( glGenBuffers( 1, &spriteCornerVBO ) );
+	if( spriteCornerVBO == 0 ) {
+		llog( LOG_ERROR, "Unable to create sprite corner buffer." );
+		return -1;
+	}
+	GL( glBindBuffer( GL_ARRAY_BUFFER, spriteCornerVBO ) );
+	GL( glBufferData( GL_ARRAY_BUFFER, sizeof( corners ), corners, GL_STATIC_DRAW ) );
+	GL( glBindBuffer( GL_ARRAY_BUFFER, 0 ) );
+
 	llog( LOG_INFO, "Creating triangle lists." );
 	if( ( createTriListGLObjects( &solidTriangles ) < 0 ) ||
 		( createTriListGLObjects( &transparentTriangles ) < 0 ) ) {
@@ -189,70 +595,25 @@ int triRenderer_Init( int renderAreaWidth, int renderAreaHeight )
 	return 0;
 }
 
-static bool isTriAxisSeparating( Vector2* p0, Vector2* p1, Vector2* p2 )
+// depth for the next triangle or sprite added
+static float nextZPos( int8_t depth )
 {
-	float temp;
-	Vector2 projTriPt0, projTriPt2;
-	float triPt0Dot, triPt2Dot;
-	float triMin, triMax;
-	float quadMin, quadMax;
-
-	Vector2 orthoAxis;
-	vec2_Subtract( p0, p1, &orthoAxis );
-	temp = orthoAxis.x;
-	orthoAxis.x = -orthoAxis.y;
-	orthoAxis.y = temp;
-	vec2_Normalize( &orthoAxis ); // is this necessary?
-
-	// since we're generating it from p0 and p1 that means they should both project to the same
-	//  value on the axis, so we only need to project p0 and p2
-	vec2_ProjOnto( p0, &orthoAxis, &projTriPt0 );
-	vec2_ProjOnto( p2, &orthoAxis, &projTriPt2 );
-	triPt0Dot = vec2_DotProduct( &orthoAxis, &projTriPt0 );
-	triPt2Dot = vec2_DotProduct( &orthoAxis, &projTriPt2 );
-
-	if( triPt0Dot > triPt2Dot ) {
-		triMin = triPt2Dot;
-		triMax = triPt0Dot;
-	} else {
-		triMin = triPt0Dot;
-		triMax = triPt2Dot;
-	}
-
-	// now find min and max for AABB on this axis, we know all points will be <+/-1,+/-1>
-	float dotPP = orthoAxis.x + orthoAxis.y;
-	float dotPN = orthoAxis.x - orthoAxis.y;
-	float dotNN = -orthoAxis.x - orthoAxis.y;
-	float dotNP = -orthoAxis.x + orthoAxis.y;
-
-	quadMin = MIN( dotPP, MIN( dotPN, MIN( dotNN, dotNP ) ) );
-	quadMax = MAX( dotPP, MAX( dotPN, MAX( dotNN, dotNP ) ) );
-
-	return ( FLT_LT( quadMax, triMin ) || FLT_GT( quadMin, triMax ) );
+	int numAdded = ( solidTriangles.lastTriIndex + 1 ) + ( transparentTriangles.lastTriIndex + 1 ) +
+		( solidTriangles.lastSpriteIndex + 1 ) + ( transparentTriangles.lastSpriteIndex + 1 ) + numGroupZSlots;
+	return (float)depth + ( zOrderOffset * numAdded );
 }
 
-// test to see if the triangle intersects the AABB centered on (0,0) with sides of length 2
-static bool testTriangle( Vector2* p0, Vector2* p1, Vector2* p2 )
+static void setDrawState( DrawState* state, float z, ShaderType shader, GLuint texture, float floatVal0, int clippingID, uint32_t camFlags )
 {
-	// we'll need an optimized version of the SAT test, since we always know the position and size
-	//  of the AABB we can precompute things
-
-	// first test to see if there is a horizontal or vertical axis that separates
-	if( FLT_LT( p0->x, -1.0f ) && FLT_LT( p1->x, -1.0f ) && FLT_LT( p2->x, -1.0f ) ) return false;
-	if( FLT_GT( p0->x, 1.0f ) && FLT_GT( p1->x, 1.0f ) && FLT_GT( p2->x, 1.0f ) ) return false;
-
-	if( FLT_LT( p0->y, -1.0f ) && FLT_LT( p1->y, -1.0f ) && FLT_LT( p2->y, -1.0f ) ) return false;
-	if( FLT_GT( p0->y, 1.0f ) && FLT_GT( p1->y, 1.0f ) && FLT_GT( p2->y, 1.0f ) ) return false;
-
-	// now test to see if the segments of the triangle generate a separating axis
-	if( isTriAxisSeparating( p0, p1, p2 ) ) return false;
-	if( isTriAxisSeparating( p1, p2, p0 ) ) return false;
-	if( isTriAxisSeparating( p2, p0, p1 ) ) return false;
-
-	return true;
+	state->zPos = z;
+	state->camFlags = camFlags;
+	state->texture = texture;
+	state->floatVal0 = floatVal0;
+	state->shaderType = shader;
+	state->scissorID = clippingID;
 }
 
-static int addTriangle( TriangleList* triList, TriVert vert0, TriVert vert1, TriVert vert2,
+static int addTriangle( TriangleList* triList, const TriVert* startVerts, const TriVert* endVerts,
 	ShaderType shader, GLuint texture, float floatVal0, int clippingID, uint32_t camFlags, int8_t depth )
 {
 	//#define SCALE ( 3000.0f / 540.0f )/*
@@ -267,58 +628,45 @@ static int addTriangle( TriangleList* triList, TriVert vert0, TriVert vert1, Tri
 	vert2.pos.x *= SCALE;
 	vert2.pos.y *= SCALE;//*/
 
-	// test to see if the triangle can be culled
-	bool anyInside = false;
-	for( int currCamera = cam_StartIteration( ); ( currCamera != -1 ) && !anyInside; currCamera = cam_GetNextActiveCam( ) ) {
-		if( cam_GetFlags( currCamera ) & camFlags ) {
-			Matrix4 vpMat;
-			cam_GetVPMatrix( currCamera, &vpMat );
-
-			// issue! if the triangle is too large, and all it's vertices are off screen while the triangle still intersects the screen it won't draw
-			//  so we'll also have to test the sign of each access, if it's different between
-			Vector2 p0, p1, p2;
-			mat4_TransformVec2Pos( &vpMat, &( vert0.pos ), &p0 );
-			mat4_TransformVec2Pos( &vpMat, &( vert1.pos ), &p1 );
-			mat4_TransformVec2Pos( &vpMat, &( vert2.pos ), &p2 );
-			anyInside = testTriangle( &p0, &p1, &p2 );
-/*#define TEST_VERT( v )	mat4_TransformVec2Pos( &vpMat, &( v ), &test ); \
-						anyInside = anyInside || ( FLT_GE( test.x, -1.0f ) && FLT_LE( test.x, 1.0f ) && FLT_GE( test.y, -1.0f ) && FLT_LE( test.y, 1.0f ) );
-			TEST_VERT( vert0.pos );
-			TEST_VERT( vert1.pos );
-			TEST_VERT( vert2.pos );
-#undef TEST_VERT//*/
-		}
-	}
-	if( !anyInside ) return 0;
-
-	if( triList->lastTriIndex >= ( MAX_TRIS - 1 ) ) {
+	// culling is done for all the triangles at once when rendering, so everything gets added here
+	if( ( triList->lastTriIndex >= ( maxTris - 1 ) ) ||
+		( ( triList->lastTriIndex >= ( triList->capacity - 1 ) ) && !growTriList( triList ) ) ) {
 		llog( LOG_VERBOSE, "Triangle list full." );
+		++( triList->droppedTris );
 		return -1;
 	}
 
-	float z = (float)depth + ( Z_ORDER_OFFSET * ( solidTriangles.lastTriIndex + transparentTriangles.lastTriIndex + 2 ) );
+	float z = nextZPos( depth );
 
 	int idx = triList->lastTriIndex + 1;
 	triList->lastTriIndex = idx;
-	triList->triangles[idx].camFlags = camFlags;
-	triList->triangles[idx].texture = texture;
-	triList->triangles[idx].zPos = z;
-	triList->triangles[idx].shaderType = shader;
-	triList->triangles[idx].scissorID = clippingID;
-	triList->triangles[idx].floatVal0 = floatVal0;
+	setDrawState( &( triList->triangles[idx].state ), z, shader, texture, floatVal0, clippingID, camFlags );
+	triList->cullFlags[idx] = camFlags;
 	int baseIdx = idx * 3;
 
-#define ADD_VERT( v, offset ) \
-	vec2ToVec3( &( (v).pos ), z, &( triList->vertices[baseIdx + (offset)].pos ) ); \
-	triList->vertices[baseIdx + (offset)].col = (v).col; \
-	triList->vertices[baseIdx + (offset)].uv = (v).uv; \
-	triList->triangles[idx].vertexIndices[(offset)] = baseIdx + (offset);
+	// the drawn vertices start out at the start of the tick, if nothing in the list moves they never have to be touched
+	//  again, the uvs aren't interpolated so the end uses the starting ones
+	for( int v = 0; v < 3; ++v ) {
+		Vertex* start = &( triList->startVertices[baseIdx + v] );
+		Vertex* end = &( triList->endVertices[baseIdx + v] );
+
+		vec2ToVec3( &( startVerts[v].pos ), z, &( start->pos ) );
+		start->col = startVerts[v].col;
+		start->uv = startVerts[v].uv;
+
+		vec2ToVec3( &( endVerts[v].pos ), z, &( end->pos ) );
+		end->col = endVerts[v].col;
+		end->uv = startVerts[v].uv;
 
-	ADD_VERT( vert0, 0 );
-	ADD_VERT( vert1, 1 );
-	ADD_VERT( vert2, 2 );
+		triList->vertices[baseIdx + v] = (*start);
+		triList->cullX[v][idx] = startVerts[v].pos.x;
+		triList->cullY[v][idx] = startVerts[v].pos.y;
+		triList->triangles[idx].vertexIndices[v] = baseIdx + v;
 
-#undef ADD_VERT
+		if( ( startVerts != endVerts ) && ( memcmp( start, end, sizeof( Vertex ) ) != 0 ) ) {
+			triList->tweened = true;
+		}
+	}
 
 	return 0;
 }
@@ -336,52 +684,493 @@ int triRenderer_AddVertices( TriVert* verts, ShaderType shader, GLuint texture,
 int triRenderer_Add( TriVert vert0, TriVert vert1, TriVert vert2, ShaderType shader, GLuint texture, float floatVal0,
 	int clippingID, uint32_t camFlags, int8_t depth, int transparent )
 {
+	TriVert verts[3] = { vert0, vert1, vert2 };
+	return triRenderer_AddTweenedVertices( verts, verts, shader, texture, floatVal0, clippingID, camFlags, depth, transparent );
+}
+
+int triRenderer_AddTweenedVertices( const TriVert* startVerts, const TriVert* endVerts, ShaderType shader, GLuint texture,
+	float floatVal0, int clippingID, uint32_t camFlags, int8_t depth, int transparent )
+{
+	assert( startVerts != NULL );
+	assert( endVerts != NULL );
+	if( transparent ) {
+		return addTriangle( &transparentTriangles, startVerts, endVerts, shader, texture, floatVal0, clippingID, camFlags, depth );
+	} else {
+		return addTriangle( &solidTriangles, startVerts, endVerts, shader, texture, floatVal0, clippingID, camFlags, depth );
+	}
+}
+
+static void setSpriteInstance( SpriteInstance* instance, const TriSprite* sprite, float z )
+{
+	vec2ToVec3( &( sprite->pos ), z, &( instance->pos ) );
+	instance->rotation = sprite->rotation;
+	instance->size = sprite->size;
+	instance->offset = sprite->offset;
+	instance->col = sprite->col;
+	instance->uvMin = sprite->uvMin;
+	instance->uvMax = sprite->uvMax;
+}
+
+// none of the corners can be further from the position than this, no matter the rotation
+static float spriteCullRadius( const TriSprite* sprite )
+{
+	return ( 0.5f * ( fabsf( sprite->size.x ) + fabsf( sprite->size.y ) ) ) +
+		fabsf( sprite->offset.x ) + fabsf( sprite->offset.y );
+}
+
+static int addSprite( TriangleList* triList, const TriSprite* start, const TriSprite* end, ShaderType shader, GLuint texture,
+	int clippingID, uint32_t camFlags, int8_t depth )
+{
+	if( ( triList->lastSpriteIndex >= ( maxSprites - 1 ) ) ||
+		( ( triList->lastSpriteIndex >= ( triList->spriteCapacity - 1 ) ) && !growSpriteList( triList ) ) ) {
+		llog( LOG_VERBOSE, "Sprite list full." );
+		++( triList->droppedSprites );
+		return -1;
+	}
+
+	float z = nextZPos( depth );
+
+	int idx = triList->lastSpriteIndex + 1;
+	triList->lastSpriteIndex = idx;
+	setDrawState( &( triList->spriteStates[idx] ), z, shader, texture, start->floatVal0, clippingID, camFlags );
+	triList->startFloatVal0[idx] = start->floatVal0;
+	triList->endFloatVal0[idx] = end->floatVal0;
+
+	setSpriteInstance( &( triList->startSpriteInstances[idx] ), start, z );
+	triList->spriteInstances[idx] = triList->startSpriteInstances[idx];
+
+	float radius = spriteCullRadius( start );
+	if( start == end ) {
+		triList->endSpriteInstances[idx] = triList->startSpriteInstances[idx];
+		triList->spriteCullX[idx] = start->pos.x;
+		triList->spriteCullY[idx] = start->pos.y;
+	} else {
+		setSpriteInstance( &( triList->endSpriteInstances[idx] ), end, z );
+		triList->endSpriteInstances[idx].uvMin = start->uvMin;
+		triList->endSpriteInstances[idx].uvMax = start->uvMax;
+		if( memcmp( &( triList->startSpriteInstances[idx] ), &( triList->endSpriteInstances[idx] ), sizeof( SpriteInstance ) ) != 0 ) {
+			triList->spritesTweened = true;
+		}
+		if( start->floatVal0 != end->floatVal0 ) {
+			triList->floatValsTweened = true;
+		}
+
+		// the circle covers the sprite everywhere along the tick, so it doesn't have to be culled again every frame
+		Vector2 diff;
+		vec2_Subtract( &( end->pos ), &( start->pos ), &diff );
+		triList->spriteCullX[idx] = start->pos.x + ( diff.x * 0.5f );
+		triList->spriteCullY[idx] = start->pos.y + ( diff.y * 0.5f );
+		radius = MAX( radius, spriteCullRadius( end ) ) + ( 0.5f * vec2_Mag( &diff ) );
+	}
+	triList->spriteCullRadius[idx] = radius;
+	triList->spriteCullFlags[idx] = camFlags;
+
+	return 0;
+}
+
+int triRenderer_AddSprite( const TriSprite* sprite, ShaderType shader, GLuint texture,
+	int clippingID, uint32_t camFlags, int8_t depth, int transparent )
+{
+	return triRenderer_AddTweenedSprite( sprite, sprite, shader, texture, clippingID, camFlags, depth, transparent );
+}
+
+int triRenderer_AddTweenedSprite( const TriSprite* start, const TriSprite* end, ShaderType shader, GLuint texture,
+	int clippingID, uint32_t camFlags, int8_t depth, int transparent )
+{
+	assert( start != NULL );
+	assert( end != NULL );
 	if( transparent ) {
-		return addTriangle( &transparentTriangles, vert0, vert1, vert2, shader, texture, floatVal0, clippingID, camFlags, depth );
+		return addSprite( &transparentTriangles, start, end, shader, texture, clippingID, camFlags, depth );
 	} else {
-		return addTriangle( &solidTriangles, vert0, vert1, vert2, shader, texture, floatVal0, clippingID, camFlags, depth );
+		return addSprite( &solidTriangles, start, end, shader, texture, clippingID, camFlags, depth );
+	}
+}
+
+static DrawGroup* getGroup( int groupID )
+{
+	if( ( groupID < 0 ) || ( groupID >= MAX_DRAW_GROUPS ) || !drawGroups[groupID].inUse ) {
+		llog( LOG_WARN, "Attempting to use invalid draw group %i.", groupID );
+		return NULL;
+	}
+	return &( drawGroups[groupID] );
+}
+
+int triRenderer_CreateGroup( void )
+{
+	for( int i = 0; i < MAX_DRAW_GROUPS; ++i ) {
+		if( !drawGroups[i].inUse ) {
+			memset( &( drawGroups[i] ), 0, sizeof( DrawGroup ) );
+			drawGroups[i].inUse = true;
+			triRenderer_ClearGroup( i );
+			return i;
+		}
+	}
+
+	llog( LOG_WARN, "Unable to create draw group, all groups are in use." );
+	return -1;
+}
+
+void triRenderer_DestroyGroup( int groupID )
+{
+	DrawGroup* group = getGroup( groupID );
+	if( group == NULL ) {
+		return;
+	}
+
+	sb_Release( group->sbInstances );
+	sb_Release( group->sbStates );
+	sb_Release( group->sbBatches );
+
+	if( group->VBO != 0 ) {
+		GL( glDeleteBuffers( 1, &( group->VBO ) ) );
+	}
+	if( group->VAO != 0 ) {
+		GL( glDeleteVertexArrays( 1, &( group->VAO ) ) );
+	}
+
+	memset( group, 0, sizeof( DrawGroup ) );
+}
+
+void triRenderer_ClearGroup( int groupID )
+{
+	DrawGroup* group = getGroup( groupID );
+	if( group == NULL ) {
+		return;
+	}
+
+	sb_Clear( group->sbInstances );
+	sb_Clear( group->sbStates );
+	sb_Clear( group->sbBatches );
+	group->transparent = false;
+	group->needsUpload = true;
+	group->stale = false;
+	group->boundsMin = vec2( FLT_MAX, FLT_MAX );
+	group->boundsMax = vec2( -FLT_MAX, -FLT_MAX );
+}
+
+// whether the two areas of a texture overlap, either can be flipped, areas that only share an edge don't overlap so
+//  neighbors in an atlas or sheet aren't caught
+static bool uvAreasOverlap( Vector2 aMin, Vector2 aMax, Vector2 bMin, Vector2 bMax )
+{
+	return ( MIN( aMin.x, aMax.x ) < MAX( bMin.x, bMax.x ) ) && ( MAX( aMin.x, aMax.x ) > MIN( bMin.x, bMax.x ) ) &&
+		( MIN( aMin.y, aMax.y ) < MAX( bMin.y, bMax.y ) ) && ( MAX( aMin.y, aMax.y ) > MIN( bMin.y, bMax.y ) );
+}
+
+void triRenderer_ClearGroupsUsingTextureArea( GLuint texture, Vector2 uvMin, Vector2 uvMax )
+{
+	for( int i = 0; i < MAX_DRAW_GROUPS; ++i ) {
+		DrawGroup* group = &( drawGroups[i] );
+		if( !group->inUse ) {
+			continue;
+		}
+
+		for( size_t s = 0; s < sb_Count( group->sbStates ); ++s ) {
+			if( ( group->sbStates[s].texture == texture ) &&
+				uvAreasOverlap( group->sbInstances[s].uvMin, group->sbInstances[s].uvMax, uvMin, uvMax ) ) {
+				triRenderer_ClearGroup( i );
+				group->stale = true;
+				break;
+			}
+		}
+	}
+}
+
+bool triRenderer_IsGroupStale( int groupID )
+{
+	DrawGroup* group = getGroup( groupID );
+	return ( group != NULL ) && group->stale;
+}
+
+int triRenderer_AddSpriteToGroup( int groupID, const TriSprite* sprite, ShaderType shader, GLuint texture, int transparent )
+{
+	assert( sprite != NULL );
+
+	DrawGroup* group = getGroup( groupID );
+	if( group == NULL ) {
+		return -1;
+	}
+
+	// the z is relative to where the group ends up in the z order when it's added
+	float z = zOrderOffset * (float)sb_Count( group->sbInstances );
+
+	DrawState state;
+	setDrawState( &state, z, shader, texture, sprite->floatVal0, 0, 0 );
+	sb_Push( group->sbStates, state );
+
+	SpriteInstance instance;
+	setSpriteInstance( &instance, sprite, z );
+	sb_Push( group->sbInstances, instance );
+
+	float radius = spriteCullRadius( sprite );
+	group->boundsMin.x = MIN( group->boundsMin.x, sprite->pos.x - radius );
+	group->boundsMin.y = MIN( group->boundsMin.y, sprite->pos.y - radius );
+	group->boundsMax.x = MAX( group->boundsMax.x, sprite->pos.x + radius );
+	group->boundsMax.y = MAX( group->boundsMax.y, sprite->pos.y + radius );
+
+	if( transparent ) {
+		group->transparent = true;
 	}
+	group->needsUpload = true;
+
+	return 0;
+}
+
+int triRenderer_AddGroup( int groupID, Vector2 offset, int clippingID, uint32_t camFlags, int8_t depth )
+{
+	DrawGroup* group = getGroup( groupID );
+	if( group == NULL ) {
+		return -1;
+	}
+
+	int numSprites = (int)sb_Count( group->sbInstances );
+	if( numSprites == 0 ) {
+		return 0;
+	}
+
+	TriangleList* triList = group->transparent ? &transparentTriangles : &solidTriangles;
+	if( triList->lastGroupDrawIndex >= ( MAX_GROUP_DRAWS - 1 ) ) {
+		llog( LOG_VERBOSE, "Group list full." );
+		++( triList->droppedGroupDraws );
+		return -1;
+	}
+
+	// past this the group would be pushed into the next depth level
+	if( ( numGroupZSlots + numSprites ) > ( 2 * maxSprites ) ) {
+		llog( LOG_VERBOSE, "Out of z order space for groups." );
+		++( triList->droppedGroupDraws );
+		return -1;
+	}
+
+	float z = nextZPos( depth );
+	numGroupZSlots += numSprites;
+
+	int idx = triList->lastGroupDrawIndex + 1;
+	triList->lastGroupDrawIndex = idx;
+
+	GroupDraw* groupDraw = &( triList->groupDraws[idx] );
+	groupDraw->groupID = groupID;
+	groupDraw->offset = offset;
+	setDrawState( &( groupDraw->state ), z, ST_DEFAULT, 0, 0.0f, clippingID, camFlags );
+
+	// cull using a circle around the bounds of everything in the group
+	Vector2 halfSize;
+	vec2_Subtract( &( group->boundsMax ), &( group->boundsMin ), &halfSize );
+	vec2_Scale( &halfSize, 0.5f, &halfSize );
+	triList->groupCullX[idx] = group->boundsMin.x + halfSize.x + offset.x;
+	triList->groupCullY[idx] = group->boundsMin.y + halfSize.y + offset.y;
+	triList->groupCullRadius[idx] = vec2_Mag( &halfSize );
+	triList->groupCullFlags[idx] = camFlags;
+
+	return 0;
 }
 
 /*
-Clears out all the triangles currently stored.
+Clears out all the triangles and sprites currently stored.
 */
+static void clearList( TriangleList* triList )
+{
+	triList->lastTriIndex = -1;
+	triList->lastSpriteIndex = -1;
+	triList->lastGroupDrawIndex = -1;
+	triList->droppedTris = 0;
+	triList->droppedSprites = 0;
+	triList->droppedGroupDraws = 0;
+	triList->tweened = false;
+	triList->spritesTweened = false;
+	triList->floatValsTweened = false;
+	triList->tickTriIndex = -1;
+	triList->tickSpriteIndex = -1;
+	triList->tickGroupDrawIndex = -1;
+}
+
 void triRenderer_Clear( void )
 {
-	transparentTriangles.lastTriIndex = -1;
-	solidTriangles.lastTriIndex = -1;
+	clearList( &transparentTriangles );
+	clearList( &solidTriangles );
+	numGroupZSlots = 0;
+	tickGroupZSlots = 0;
 }
 
-static int sortByRenderState( const void* p1, const void* p2 )
+static void finishListTick( TriangleList* triList )
 {
-	Triangle* tri1 = (Triangle*)p1;
-	Triangle* tri2 = (Triangle*)p2;
+	triList->tickTriIndex = triList->lastTriIndex;
+	triList->tickSpriteIndex = triList->lastSpriteIndex;
+	triList->tickGroupDrawIndex = triList->lastGroupDrawIndex;
+}
 
-	int stDiff = ( (int)tri1->shaderType - (int)tri2->shaderType );
-	if( stDiff != 0 ) {
-		return stDiff;
-	}
+void triRenderer_FinishTick( void )
+{
+	finishListTick( &transparentTriangles );
+	finishListTick( &solidTriangles );
+	tickGroupZSlots = numGroupZSlots;
+	rstats_EndTick( );
+}
 
-	if( tri1->texture < tri2->texture ) {
-		return -1;
-	} else if( tri1->texture > tri2->texture ) {
-		return 1;
+static void clearListFrame( TriangleList* triList )
+{
+	triList->lastTriIndex = triList->tickTriIndex;
+	triList->lastSpriteIndex = triList->tickSpriteIndex;
+	triList->lastGroupDrawIndex = triList->tickGroupDrawIndex;
+}
+
+void triRenderer_ClearFrame( void )
+{
+	clearListFrame( &transparentTriangles );
+	clearListFrame( &solidTriangles );
+	numGroupZSlots = tickGroupZSlots;
+}
+
+static void updateZOrderOffset( void )
+{
+	zOrderOffset = Z_ORDER_OFFSET( maxTris, maxSprites );
+}
+
+/*
+Sets the most triangles each of the solid and transparent lists can hold, anything added past that is dropped.
+ Storage that's already been allocated isn't released.
+*/
+void triRenderer_SetMaxTriangles( int newMaxTris )
+{
+	assert( newMaxTris > 0 );
+	maxTris = newMaxTris;
+	updateZOrderOffset( );
+}
+
+void triRenderer_SetMaxSprites( int newMaxSprites )
+{
+	assert( newMaxSprites > 0 );
+	maxSprites = newMaxSprites;
+	updateZOrderOffset( );
+}
+
+void triRenderer_GetStats( TriRendererStats* outStats )
+{
+	assert( outStats != NULL );
+	(*outStats) = stats;
+}
+
+void triRenderer_ResetHighWaterMark( void )
+{
+	stats.highWaterMark = 0;
+}
+
+static void updateStats( void )
+{
+	stats.solidTris = solidTriangles.lastTriIndex + 1;
+	stats.transparentTris = transparentTriangles.lastTriIndex + 1;
+	stats.droppedTris = solidTriangles.droppedTris + transparentTriangles.droppedTris;
+	stats.culledTris = ( stats.solidTris - solidTriangles.numVisible ) + ( stats.transparentTris - transparentTriangles.numVisible );
+	stats.highWaterMark = MAX( stats.highWaterMark, MAX( stats.solidTris, stats.transparentTris ) );
+	stats.solidCapacity = solidTriangles.capacity;
+	stats.transparentCapacity = transparentTriangles.capacity;
+	stats.maxTris = maxTris;
+	stats.solidSprites = solidTriangles.lastSpriteIndex + 1;
+	stats.transparentSprites = transparentTriangles.lastSpriteIndex + 1;
+	stats.droppedSprites = solidTriangles.droppedSprites + transparentTriangles.droppedSprites;
+	stats.culledSprites = ( stats.solidSprites - solidTriangles.numVisibleSprites ) + ( stats.transparentSprites - transparentTriangles.numVisibleSprites );
+	stats.maxSprites = maxSprites;
+	stats.groupDraws = ( solidTriangles.lastGroupDrawIndex + 1 ) + ( transparentTriangles.lastGroupDrawIndex + 1 );
+	stats.droppedGroupDraws = solidTriangles.droppedGroupDraws + transparentTriangles.droppedGroupDraws;
+
+	RSTATS_ADD( trisSubmitted, stats.solidTris + stats.transparentTris );
+	RSTATS_ADD( trisCulled, stats.culledTris );
+	RSTATS_ADD( spritesSubmitted, stats.solidSprites + stats.transparentSprites );
+	RSTATS_ADD( spritesCulled, stats.culledSprites );
+	RSTATS_ADD( groupDraws, stats.groupDraws );
+}
+
+// marks which triangles and sprites can be seen by any of the active cameras
+static void cullList( TriangleList* triList, const CullCamera* cameras, int numCameras )
+{
+	CullTriangles tris;
+	for( int i = 0; i < 3; ++i ) {
+		tris.x[i] = triList->cullX[i];
+		tris.y[i] = triList->cullY[i];
 	}
+	tris.camFlags = triList->cullFlags;
+
+	triList->numVisible = (int)triCull_Cull( cameras, numCameras, &tris, (size_t)( triList->lastTriIndex + 1 ), triList->visible );
+
+	CullCircles sprites;
+	sprites.x = triList->spriteCullX;
+	sprites.y = triList->spriteCullY;
+	sprites.radius = triList->spriteCullRadius;
+	sprites.camFlags = triList->spriteCullFlags;
+	triList->numVisibleSprites = (int)triCull_CullCircles( cameras, numCameras, &sprites, (size_t)( triList->lastSpriteIndex + 1 ), triList->spriteVisible );
+
+	CullCircles groups;
+	groups.x = triList->groupCullX;
+	groups.y = triList->groupCullY;
+	groups.radius = triList->groupCullRadius;
+	groups.camFlags = triList->groupCullFlags;
+	triList->numVisibleGroupDraws = (int)triCull_CullCircles( cameras, numCameras, &groups, (size_t)( triList->lastGroupDrawIndex + 1 ), triList->groupVisible );
+}
 
-	return ( tri1->scissorID - tri2->scissorID );
+static uint64_t sortKey( const DrawState* state, bool byDepth )
+{
+	if( byDepth ) {
+		return renderSort_DepthKey( state->zPos );
+	} else {
+		return renderSort_StateKey( (uint32_t)state->shaderType, state->texture, state->scissorID, state->floatVal0, state->zPos );
+	}
 }
 
-static int sortByDepth( const void* p1, const void* p2 )
+// solid triangles are grouped by render state, transparent ones have to be drawn in depth order, sprites are sorted
+//  along with the triangles so they end up in the same order
+static void sortTriangles( TriangleList* triList, bool byDepth )
 {
-	Triangle* tri1 = (Triangle*)p1;
-	Triangle* tri2 = (Triangle*)p2;
-	return ( ( ( tri1->zPos ) - ( tri2->zPos ) ) > 0.0f ) ? 1 : -1;
+	int count = 0;
+	for( int i = 0; i <= triList->lastTriIndex; ++i ) {
+		if( !triList->visible[i] ) {
+			continue;
+		}
+
+		triList->sortEntries[count].idx = (uint32_t)i;
+		triList->sortEntries[count].key = sortKey( &( triList->triangles[i].state ), byDepth );
+		++count;
+	}
+
+	for( int i = 0; i <= triList->lastSpriteIndex; ++i ) {
+		if( !triList->spriteVisible[i] ) {
+			continue;
+		}
+
+		triList->sortEntries[count].idx = (uint32_t)i | SORT_IDX_SPRITE;
+		triList->sortEntries[count].key = sortKey( &( triList->spriteStates[i] ), byDepth );
+		++count;
+	}
+
+	for( int i = 0; i <= triList->lastGroupDrawIndex; ++i ) {
+		if( !triList->groupVisible[i] ) {
+			continue;
+		}
+
+		triList->sortEntries[count].idx = (uint32_t)i | SORT_IDX_GROUP;
+		triList->sortEntries[count].key = sortKey( &( triList->groupDraws[i].state ), byDepth );
+		++count;
+	}
+
+	triList->numSorted = count;
+	triList->sortedTris = renderSort_Sort( triList->sortEntries, triList->sortScratch, (size_t)count );
 }
 
 static void generateVertexArray( TriangleList* triList )
 {
-	GL( glBindBuffer( GL_ARRAY_BUFFER, triList->VBO ) );
-	GL( glBufferSubData( GL_ARRAY_BUFFER, 0, sizeof( Vertex ) * ( ( triList->lastTriIndex + 1 ) * 3 ), triList->vertices ) );
+	if( triList->lastTriIndex < 0 ) {
+		return;
+	}
+
+	// all the vertices are written at once, then the attributes are pointed at wherever they ended up
+	size_t offset;
+	if( !streamBuffer_Write( &( triList->vertexStream ), triList->vertices, sizeof( Vertex ) * ( ( triList->lastTriIndex + 1 ) * 3 ), &offset ) ) {
+		triList->numSorted = 0;
+		return;
+	}
+
+	GL( glBindVertexArray( triList->VAO ) );
+	GL( glBindBuffer( GL_ARRAY_BUFFER, triList->vertexStream.buffer ) );
+	setVertexAttributes( offset );
+	GL( glBindVertexArray( 0 ) );
 }
 
 static void setScissor( int area )
@@ -393,97 +1182,510 @@ static void setScissor( int area )
 
 	scissor_GetScissorAreaGL( area, &x, &y, &w, &h );
 	GL( glScissor( x, y, w, h ) );
+	RSTATS_ADD( scissorChanges, 1 );
+}
+
+static const DrawState* getSortedState( const TriangleList* triList, int sortedIdx )
+{
+	uint32_t idx = triList->sortedTris[sortedIdx].idx;
+	if( idx & SORT_IDX_GROUP ) {
+		return &( triList->groupDraws[idx & SORT_IDX_MASK].state );
+	}
+	if( idx & SORT_IDX_SPRITE ) {
+		return &( triList->spriteStates[idx & SORT_IDX_MASK] );
+	}
+	return &( triList->triangles[idx].state );
 }
 
-static void drawTriangles( uint32_t currCamera, TriangleList* triList )
+// sorts the sprites in the group into batches and puts them on the GPU, only needs to be done when the group changes
+static void uploadGroup( DrawGroup* group )
 {
-	// create the index buffers to access the vertex buffer
-	//  TODO: Test to see if having the index buffer or the vertex buffer in order is faster
-	GLuint lastBoundTexture = 0;
-	int triIdx = 0;
-	ShaderType lastBoundShader = NUM_SHADERS;
+	group->needsUpload = false;
+	sb_Clear( group->sbBatches );
+
+	int count = (int)sb_Count( group->sbInstances );
+	if( count == 0 ) {
+		return;
+	}
+
+	// solid sprites can be drawn in any order so group them by state, transparent ones have to stay in the order they
+	//  were recorded, the z of each sprite is stored in the instance so reordering them doesn't change how they overlap
+	if( !group->transparent && ( count > 1 ) ) {
+		RenderSortEntry* entries = mem_Allocate( sizeof( RenderSortEntry ) * count * 2 );
+		SpriteInstance* sortedInstances = mem_Allocate( sizeof( SpriteInstance ) * count );
+		DrawState* sortedStates = mem_Allocate( sizeof( DrawState ) * count );
+		if( ( entries != NULL ) && ( sortedInstances != NULL ) && ( sortedStates != NULL ) ) {
+			for( int i = 0; i < count; ++i ) {
+				entries[i].idx = (uint32_t)i;
+				entries[i].key = sortKey( &( group->sbStates[i] ), false );
+			}
+			RenderSortEntry* sorted = renderSort_Sort( entries, entries + count, (size_t)count );
+
+			for( int i = 0; i < count; ++i ) {
+				sortedInstances[i] = group->sbInstances[sorted[i].idx];
+				sortedStates[i] = group->sbStates[sorted[i].idx];
+			}
+			memcpy( group->sbInstances, sortedInstances, sizeof( SpriteInstance ) * count );
+			memcpy( group->sbStates, sortedStates, sizeof( DrawState ) * count );
+		}
+		mem_Release( entries );
+		mem_Release( sortedInstances );
+		mem_Release( sortedStates );
+	}
+
+	for( int i = 0; i < count; ++i ) {
+		DrawState* state = &( group->sbStates[i] );
+		if( sb_Count( group->sbBatches ) > 0 ) {
+			DrawBatch* last = &sb_Last( group->sbBatches );
+			if( ( last->program == SPRITE_PROGRAM( state->shaderType ) ) &&
+				( last->texture == state->texture ) &&
+				FLT_EQ( last->floatVal0, state->floatVal0 ) ) {
+				++( last->count );
+				continue;
+			}
+		}
+
+		DrawBatch batch;
+		batch.program = SPRITE_PROGRAM( state->shaderType );
+		batch.texture = state->texture;
+		batch.floatVal0 = state->floatVal0;
+		batch.scissorID = 0;
+		batch.isSprite = true;
+		batch.groupDraw = -1;
+		batch.first = i;
+		batch.count = 1;
+		sb_Push( group->sbBatches, batch );
+	}
+
+	if( group->VAO == 0 ) {
+		GL( glGenVertexArrays( 1, &( group->VAO ) ) );
+		GL( glGenBuffers( 1, &( group->VBO ) ) );
+		if( ( group->VAO == 0 ) || ( group->VBO == 0 ) ) {
+			llog( LOG_ERROR, "Unable to create storage objects for draw group." );
+			sb_Clear( group->sbBatches );
+			return;
+		}
+
+		GL( glBindVertexArray( group->VAO ) );
+
+		GL( glBindBuffer( GL_ARRAY_BUFFER, spriteCornerVBO ) );
+		GL( glEnableVertexAttribArray( 0 ) );
+		GL( glVertexAttribPointer( 0, 2, GL_FLOAT, GL_FALSE, sizeof( Vector2 ), NULL ) );
+
+		GL( glBindBuffer( GL_ARRAY_BUFFER, group->VBO ) );
+		for( GLuint i = 1; i <= 4; ++i ) {
+			GL( glEnableVertexAttribArray( i ) );
+			GL( glVertexAttribDivisor( i, 1 ) );
+		}
+		setInstanceAttributes( 0 );
+
+		GL( glBindVertexArray( 0 ) );
+	}
+
+	GL( glBindBuffer( GL_ARRAY_BUFFER, group->VBO ) );
+	GL( glBufferData( GL_ARRAY_BUFFER, sizeof( SpriteInstance ) * count, group->sbInstances, GL_STATIC_DRAW ) );
+	RSTATS_ADD( bytesUploaded, sizeof( SpriteInstance ) * count );
+	GL( glBindBuffer( GL_ARRAY_BUFFER, 0 ) );
+}
+
+// draws everything in the group, this binds its own programs and vertex array
+static void drawGroup( const GroupDraw* groupDraw, const Matrix4* vpMat )
+{
+	DrawGroup* group = &( drawGroups[groupDraw->groupID] );
+	if( !group->inUse || ( sb_Count( group->sbBatches ) == 0 ) ) {
+		return;
+	}
+
+	// the sprites were recorded relative to the origin and the start of the z order, move them to where the group
+	//  was added
+	Matrix4 translation;
+	Matrix4 groupMat;
+	mat4_CreateTranslation( groupDraw->offset.x, groupDraw->offset.y, groupDraw->state.zPos, &translation );
+	mat4_Multiply( vpMat, &translation, &groupMat );
+
+	GL( glBindVertexArray( group->VAO ) );
+	GL( glBindBuffer( GL_ARRAY_BUFFER, group->VBO ) );
+
+	int lastBoundProgram = -1;
+	for( size_t i = 0; i < sb_Count( group->sbBatches ); ++i ) {
+		DrawBatch* batch = &( group->sbBatches[i] );
+
+		if( batch->program != lastBoundProgram ) {
+			lastBoundProgram = batch->program;
+
+			GL( glUseProgram( shaderPrograms[lastBoundProgram].programID ) );
+			RSTATS_ADD( shaderBinds, 1 );
+			GL( glUniformMatrix4fv( shaderPrograms[lastBoundProgram].uniformLocs[UNIFORM_TF_MAT], 1, GL_FALSE, &( groupMat.m[0] ) ) );
+			GL( glUniform1i( shaderPrograms[lastBoundProgram].uniformLocs[UNIFORM_TEXTURE], 0 ) );
+		}
+
+		GL( glUniform1f( shaderPrograms[lastBoundProgram].uniformLocs[UNIFORM_FLOAT_0], batch->floatVal0 ) );
+		GL( glBindTexture( GL_TEXTURE_2D, batch->texture ) );
+		RSTATS_ADD( textureBinds, 1 );
+
+		setInstanceAttributes( sizeof( SpriteInstance ) * batch->first );
+		GL( glDrawArraysInstanced( GL_TRIANGLE_STRIP, 0, 4, batch->count ) );
+		RSTATS_ADD( drawCalls, 1 );
+	}
+}
+
+// creates the index buffer to access the vertex buffer and gathers the instances for the sprites, both of these are
+//  uploaded once and then each batch draws its part of them, this is run on the job queue so it can't touch GL
+//  TODO: Test to see if having the index buffer or the vertex buffer in order is faster
+static void buildBatches( const TriangleList* triList, CameraBatches* camBatches )
+{
+	uint32_t camFlags = camBatches->camFlags;
+	int numIndices = 0;
+	int numInstances = 0;
+	int numBatches = 0;
+
+#define SORTED_KIND( i ) SORT_IDX_KIND( triList->sortedTris[(i)].idx )
+
+	// walk through the triangles, sprites, and groups in sorted order
+	int sortedIdx = 0;
+	while( sortedIdx < triList->numSorted ) {
+		uint32_t kind = SORTED_KIND( sortedIdx );
+		bool isSprite = ( kind == SORT_IDX_SPRITE );
+		const DrawState* runState = getSortedState( triList, sortedIdx );
+
+		DrawBatch* batch = &( camBatches->batches[numBatches] );
+		batch->scissorID = runState->scissorID;
+
+		if( kind == SORT_IDX_GROUP ) {
+			if( ( runState->camFlags & camFlags ) != 0 ) {
+				batch->groupDraw = (int)( triList->sortedTris[sortedIdx].idx & SORT_IDX_MASK );
+				++numBatches;
+			}
+			++sortedIdx;
+			continue;
+		}
+
+		batch->isSprite = isSprite;
+		batch->groupDraw = -1;
+		batch->program = isSprite ? SPRITE_PROGRAM( runState->shaderType ) : (int)runState->shaderType;
+		batch->texture = runState->texture;
+		batch->floatVal0 = runState->floatVal0;
+		batch->first = isSprite ? numInstances : numIndices;
+
+		// gather everything that can be drawn together
+		while( sortedIdx < triList->numSorted ) {
+			const DrawState* state = getSortedState( triList, sortedIdx );
+			if( ( SORTED_KIND( sortedIdx ) != kind ) ||
+				( state->texture != runState->texture ) ||
+				( state->shaderType != runState->shaderType ) ||
+				( state->scissorID != runState->scissorID ) ||
+				!FLT_EQ( state->floatVal0, runState->floatVal0 ) ) {
+				break;
+			}
+
+			if( ( state->camFlags & camFlags ) != 0 ) {
+				uint32_t idx = triList->sortedTris[sortedIdx].idx;
+				if( isSprite ) {
+					camBatches->instances[numInstances++] = triList->spriteInstances[idx & SORT_IDX_MASK];
+				} else {
+					camBatches->indices[numIndices++] = triList->triangles[idx].vertexIndices[0];
+					camBatches->indices[numIndices++] = triList->triangles[idx].vertexIndices[1];
+					camBatches->indices[numIndices++] = triList->triangles[idx].vertexIndices[2];
+				}
+			}
+			++sortedIdx;
+		}
+
+		batch->count = ( isSprite ? numInstances : numIndices ) - batch->first;
+		if( batch->count > 0 ) {
+			++numBatches;
+		}
+	}
+
+#undef SORTED_KIND
+
+	camBatches->numIndices = numIndices;
+	camBatches->numInstances = numInstances;
+	camBatches->numBatches = numBatches;
+}
+
+// uploads and issues the draws built by buildBatches
+static void drawBatches( uint32_t currCamera, TriangleList* triList, const CameraBatches* camBatches )
+{
+	if( camBatches->numBatches == 0 ) {
+		return;
+	}
+
+	size_t indexOffset = 0;
+	if( ( camBatches->numIndices > 0 ) &&
+		!streamBuffer_Write( &( triList->indexStream ), camBatches->indices, sizeof( GLuint ) * camBatches->numIndices, &indexOffset ) ) {
+		return;
+	}
+
+	size_t instanceOffset = 0;
+	if( ( camBatches->numInstances > 0 ) &&
+		!streamBuffer_Write( &( triList->instanceStream ), camBatches->instances, sizeof( SpriteInstance ) * camBatches->numInstances, &instanceOffset ) ) {
+		return;
+	}
+
 	Matrix4 vpMat;
-	uint32_t camFlags = 0;
+	cam_GetVPMatrix( currCamera, &vpMat );
+
+	int lastBoundProgram = -1;
+	GLuint lastBoundVAO = 0;
 	int lastSetClippingArea = -1;
 
-	// we'll only be accessing the one vertex array
-	GL( glBindVertexArray( triList->VAO ) );
+	for( int i = 0; i < camBatches->numBatches; ++i ) {
+		const DrawBatch* batch = &( camBatches->batches[i] );
 
-	do {
-		GLuint texture = triList->triangles[triIdx].texture;
-		float floatVal0 = triList->triangles[triIdx].floatVal0;
-		triList->lastIndexBufferIndex = -1;
+		if( batch->scissorID != lastSetClippingArea ) {
+			// next clipping area
+			lastSetClippingArea = batch->scissorID;
+			setScissor( lastSetClippingArea );
+		}
+
+		if( batch->groupDraw >= 0 ) {
+			drawGroup( &( triList->groupDraws[batch->groupDraw] ), &vpMat );
+
+			// the group uses its own matrix and vertex array, so everything has to be set up again
+			lastBoundProgram = -1;
+			lastBoundVAO = 0;
+			continue;
+		}
 
-		if( ( triIdx <= triList->lastTriIndex ) && ( triList->triangles[triIdx].shaderType != lastBoundShader ) ) {
+		if( batch->program != lastBoundProgram ) {
 			// next shader, bind and set up
-			lastBoundShader = triList->triangles[triIdx].shaderType;
+			lastBoundProgram = batch->program;
 
-			camFlags = cam_GetFlags( currCamera );
-			cam_GetVPMatrix( currCamera, &vpMat );
+			GL( glUseProgram( shaderPrograms[lastBoundProgram].programID ) );
+			RSTATS_ADD( shaderBinds, 1 );
+			GL( glUniformMatrix4fv( shaderPrograms[lastBoundProgram].uniformLocs[UNIFORM_TF_MAT], 1, GL_FALSE, &( vpMat.m[0] ) ) ); // set view projection matrix
+			GL( glUniform1i( shaderPrograms[lastBoundProgram].uniformLocs[UNIFORM_TEXTURE], 0 ) ); // use texture 0
+		}
 
-			GL( glUseProgram( shaderPrograms[lastBoundShader].programID ) );
-			GL( glUniformMatrix4fv( shaderPrograms[lastBoundShader].uniformLocs[UNIFORM_TF_MAT], 1, GL_FALSE, &( vpMat.m[0] ) ) ); // set view projection matrix
-			GL( glUniform1i( shaderPrograms[lastBoundShader].uniformLocs[UNIFORM_TEXTURE], 0 ) ); // use texture 0
+		GLuint vao = batch->isSprite ? triList->spriteVAO : triList->VAO;
+		if( vao != lastBoundVAO ) {
+			GL( glBindVertexArray( vao ) );
+			lastBoundVAO = vao;
 		}
 
-		if( ( triIdx <= triList->lastTriIndex ) && ( triList->triangles[triIdx].scissorID != lastSetClippingArea ) ) {
-			// next clipping area
-			lastSetClippingArea = triList->triangles[triIdx].scissorID;
-			setScissor( lastSetClippingArea );
+		GL( glUniform1f( shaderPrograms[lastBoundProgram].uniformLocs[UNIFORM_FLOAT_0], batch->floatVal0 ) );
+		GL( glBindTexture( GL_TEXTURE_2D, batch->texture ) );
+		RSTATS_ADD( textureBinds, 1 );
+
+		if( batch->isSprite ) {
+			GL( glBindBuffer( GL_ARRAY_BUFFER, triList->instanceStream.buffer ) );
+			setInstanceAttributes( instanceOffset + ( sizeof( SpriteInstance ) * batch->first ) );
+			GL( glDrawArraysInstanced( GL_TRIANGLE_STRIP, 0, 4, batch->count ) );
+		} else {
+			GL( glDrawElements( GL_TRIANGLES, batch->count, GL_UNSIGNED_INT, (const GLvoid*)( indexOffset + ( sizeof( GLuint ) * batch->first ) ) ) );
 		}
+		RSTATS_ADD( drawCalls, 1 );
+	}
+}
 
-		int triCount = 0;
-		// gather the list of all the triangles to be drawn
-		while( ( triIdx <= triList->lastTriIndex ) &&
-				( triList->triangles[triIdx].texture == texture ) &&
-				( triList->triangles[triIdx].shaderType == lastBoundShader ) &&
-				( triList->triangles[triIdx].scissorID == lastSetClippingArea ) &&
-				FLT_EQ( triList->triangles[triIdx].floatVal0, floatVal0 ) ) {
-			if( ( triList->triangles[triIdx].camFlags & camFlags ) != 0 ) {
-				triList->indices[++triList->lastIndexBufferIndex] = triList->triangles[triIdx].vertexIndices[0];
-				triList->indices[++triList->lastIndexBufferIndex] = triList->triangles[triIdx].vertexIndices[1];
-				triList->indices[++triList->lastIndexBufferIndex] = triList->triangles[triIdx].vertexIndices[2];
+// everything in Vertex and SpriteInstance is a float, so both can be interpolated as one long run of floats
+static void lerpFloats( const float* start, const float* end, float t, float* out, size_t count )
+{
+	size_t i = 0;
+
+#ifdef TRI_CULL_USE_SSE
+	const __m128 tt = _mm_set1_ps( t );
+	for( ; ( i + 4 ) <= count; i += 4 ) {
+		__m128 s = _mm_loadu_ps( start + i );
+		__m128 e = _mm_loadu_ps( end + i );
+		_mm_storeu_ps( out + i, _mm_add_ps( s, _mm_mul_ps( _mm_sub_ps( e, s ), tt ) ) );
+	}
+#endif
+
+	for( ; i < count; ++i ) {
+		out[i] = start[i] + ( ( end[i] - start[i] ) * t );
+	}
+}
+
+// moves everything that changes over the tick to where it should be at t, if nothing in the list moves this does
+//  nothing since the vertices and instances were set to the start when they were added
+static void lerpVertices( TriangleList* triList, float t )
+{
+	if( triList->tweened && ( triList->lastTriIndex >= 0 ) ) {
+		size_t numVerts = (size_t)( triList->lastTriIndex + 1 ) * 3;
+		lerpFloats( (const float*)triList->startVertices, (const float*)triList->endVertices, t, (float*)triList->vertices,
+			numVerts * ( sizeof( Vertex ) / sizeof( float ) ) );
+
+		// triangles are culled with where they are this frame
+		for( int i = 0; i <= triList->lastTriIndex; ++i ) {
+			int baseIdx = i * 3;
+			for( int s = 0; s < 3; ++s ) {
+				triList->cullX[s][i] = triList->vertices[baseIdx + s].pos.x;
+				triList->cullY[s][i] = triList->vertices[baseIdx + s].pos.y;
 			}
-			++triIdx;
-			++triCount;
 		}
+	}
 
-		// send the indices of the vertex array to draw, if there is any
-		if( triList->lastIndexBufferIndex < 0 ) {
-			continue;
+	if( triList->spritesTweened && ( triList->lastSpriteIndex >= 0 ) ) {
+		lerpFloats( (const float*)triList->startSpriteInstances, (const float*)triList->endSpriteInstances, t,
+			(float*)triList->spriteInstances, (size_t)( triList->lastSpriteIndex + 1 ) * ( sizeof( SpriteInstance ) / sizeof( float ) ) );
+	}
+
+	if( triList->floatValsTweened ) {
+		for( int i = 0; i <= triList->lastSpriteIndex; ++i ) {
+			triList->spriteStates[i].floatVal0 = lerp( triList->startFloatVal0[i], triList->endFloatVal0[i], t );
 		}
-		GL( glUniform1f( shaderPrograms[lastBoundShader].uniformLocs[UNIFORM_FLOAT_0], floatVal0 ) );
-		GL( glBindTexture( GL_TEXTURE_2D, texture ) );
-		GL( glBufferSubData( GL_ELEMENT_ARRAY_BUFFER, 0, sizeof( GLuint ) * ( triList->lastIndexBufferIndex + 1 ), triList->indices ) );
-		GL( glDrawElements( GL_TRIANGLES, triList->lastIndexBufferIndex + 1, GL_UNSIGNED_INT, NULL ) );
-	} while( triIdx <= triList->lastTriIndex );
+	}
 }
 
-static void lerpVertices( TriangleList* triList, float t )
+// makes sure the array can hold at least count entries, grows geometrically so it settles after a few frames
+static bool reserveBatchStorage( void** storage, int* capacity, int count, size_t entrySize )
+{
+	if( count <= (*capacity) ) {
+		return true;
+	}
+
+	int newCapacity = MAX( count, (*capacity) * 2 );
+	void* newMem = mem_Resize( (*storage), entrySize * newCapacity );
+	if( newMem == NULL ) {
+		llog( LOG_ERROR, "Unable to grow camera batch storage to %i entries.", newCapacity );
+		return false;
+	}
+
+	(*storage) = newMem;
+	(*capacity) = newCapacity;
+	return true;
+}
+
+// the storage is only resized on the main thread, the jobs just fill it in
+static bool reserveCameraBatches( const TriangleList* triList, CameraBatches* camBatches )
+{
+	return reserveBatchStorage( (void**)&( camBatches->indices ), &( camBatches->indexCapacity ), triList->numVisible * 3, sizeof( GLuint ) ) &&
+		reserveBatchStorage( (void**)&( camBatches->instances ), &( camBatches->instanceCapacity ), triList->numVisibleSprites, sizeof( SpriteInstance ) ) &&
+		reserveBatchStorage( (void**)&( camBatches->batches ), &( camBatches->batchCapacity ), triList->numSorted, sizeof( DrawBatch ) );
+}
+
+// each camera and list is a separate piece of work, the jobs and the main thread keep claiming pieces until they're
+//  all done
+#define MAX_BATCH_HELPER_JOBS 3
+
+typedef struct {
+	const TriangleList* triList;
+	CameraBatches* camBatches;
+} BatchWork;
+
+static BatchWork batchWork[NUM_CULL_CAMERAS * 2];
+static int numBatchWork = 0;
+static SDL_atomic_t nextBatchWork;
+static SDL_atomic_t activeBatchJobs;
+
+static void processBatchWork( void )
+{
+	int idx = SDL_AtomicAdd( &nextBatchWork, 1 );
+	while( idx < numBatchWork ) {
+		buildBatches( batchWork[idx].triList, batchWork[idx].camBatches );
+		idx = SDL_AtomicAdd( &nextBatchWork, 1 );
+	}
+}
+
+#ifdef THREAD_SUPPORT
+static void batchHelperJob( void* data )
+{
+	processBatchWork( );
+	SDL_AtomicDecRef( &activeBatchJobs );
+}
+#endif
+
+static void buildAllBatches( const uint32_t* camFlags, int numCameras )
 {
-	for( int i = 0; i < triList->lastTriIndex; ++i ) {
-		int baseIdx = i * 3;
-		for( int s = 0; s < 3; ++i ) {
-			triList->vertices[baseIdx+s].uv = triList->startVertices[baseIdx+s].uv;
-			vec3_Lerp( &( triList->startVertices[baseIdx+s].pos ), &( triList->endVertices[baseIdx+s].pos ), t, &( triList->vertices[baseIdx+s].pos ) );
-			clr_Lerp( &( triList->startVertices[baseIdx+s].col ), &( triList->endVertices[baseIdx+s].col ), t, &( triList->vertices[baseIdx+s].col ) );
+	numBatchWork = 0;
+	for( int i = 0; i < numCameras; ++i ) {
+		TriangleList* lists[] = { &solidTriangles, &transparentTriangles };
+		for( int l = 0; l < 2; ++l ) {
+			CameraBatches* camBatches = &( lists[l]->cameraBatches[i] );
+			camBatches->camFlags = camFlags[i];
+			camBatches->numBatches = 0;
+			if( ( lists[l]->numSorted == 0 ) || !reserveCameraBatches( lists[l], camBatches ) ) {
+				continue;
+			}
+
+			batchWork[numBatchWork].triList = lists[l];
+			batchWork[numBatchWork].camBatches = camBatches;
+			++numBatchWork;
+		}
+	}
+
+	SDL_AtomicSet( &nextBatchWork, 0 );
+	SDL_AtomicSet( &activeBatchJobs, 0 );
+
+#ifdef THREAD_SUPPORT
+	// only ask for help if the workers are free, otherwise we could end up waiting for something like an image load to
+	//  finish before a helper can start
+	if( ( numBatchWork > 1 ) && jq_IsInitialized( ) && jq_AllJobsDone( ) ) {
+		int numHelpers = MIN( numBatchWork - 1, MAX_BATCH_HELPER_JOBS );
+		for( int i = 0; i < numHelpers; ++i ) {
+			SDL_AtomicIncRef( &activeBatchJobs );
+			if( !jq_AddJob( batchHelperJob, NULL ) ) {
+				SDL_AtomicDecRef( &activeBatchJobs );
+			}
 		}
 	}
+#endif
+
+	processBatchWork( );
+
+#ifdef THREAD_SUPPORT
+	// the helpers may still be working on the last pieces, and they use this frame's work list so we can't leave until
+	//  they've all finished, help out with anything else queued while we wait
+	while( SDL_AtomicGet( &activeBatchJobs ) > 0 ) {
+		if( !jq_ProcessNextJob( ) ) {
+			SDL_Delay( 0 );
+		}
+	}
+#endif
 }
 
 /*
-Draws out all the triangles.
+Draws out all the triangles, t is how far through the current tick this frame is in the range [0,1].
 */
-void triRenderer_Render( )
+void triRenderer_Render( float t )
 {
-	// SDL_qsort appears to break some times, so fall back onto the standard library qsort for right now, and implement our own when we have time
-	qsort( solidTriangles.triangles, solidTriangles.lastTriIndex + 1, sizeof( Triangle ), sortByRenderState );
-	qsort( transparentTriangles.triangles, transparentTriangles.lastTriIndex + 1, sizeof( Triangle ), sortByDepth );
+	streamBuffer_BeginFrame( &( solidTriangles.vertexStream ) );
+	streamBuffer_BeginFrame( &( solidTriangles.indexStream ) );
+	streamBuffer_BeginFrame( &( solidTriangles.instanceStream ) );
+	streamBuffer_BeginFrame( &( transparentTriangles.vertexStream ) );
+	streamBuffer_BeginFrame( &( transparentTriangles.indexStream ) );
+	streamBuffer_BeginFrame( &( transparentTriangles.instanceStream ) );
+
+	CullCamera cameras[NUM_CULL_CAMERAS];
+	int cameraIDs[NUM_CULL_CAMERAS];
+	uint32_t cameraFlags[NUM_CULL_CAMERAS];
+	int numCameras = 0;
+	for( int currCamera = cam_StartIteration( ); ( currCamera != -1 ) && ( numCameras < NUM_CULL_CAMERAS ); currCamera = cam_GetNextActiveCam( ) ) {
+		Matrix4 vpMat;
+		cam_GetVPMatrix( currCamera, &vpMat );
+		cameraIDs[numCameras] = currCamera;
+		cameraFlags[numCameras] = cam_GetFlags( currCamera );
+		triCull_SetupCamera( &vpMat, cameraFlags[numCameras], &( cameras[numCameras] ) );
+		++numCameras;
+	}
+
+	// anything recorded into a group since the last frame has to be on the GPU before it can be drawn
+	for( int i = 0; i < MAX_DRAW_GROUPS; ++i ) {
+		if( drawGroups[i].inUse && drawGroups[i].needsUpload ) {
+			uploadGroup( &( drawGroups[i] ) );
+		}
+	}
+
+	lerpVertices( &solidTriangles, t );
+	lerpVertices( &transparentTriangles, t );
+
+	cullList( &solidTriangles, cameras, numCameras );
+	cullList( &transparentTriangles, cameras, numCameras );
+
+	updateStats( );
 
-	// now that the triangles have been sorted create the vertex arrays
+	sortTriangles( &solidTriangles, false );
+	sortTriangles( &transparentTriangles, true );
+
+	// the vertices stay in the order they were added, the sorted order is only used when building the index buffers
 	generateVertexArray( &solidTriangles );
 	generateVertexArray( &transparentTriangles );
 
+	// everything each camera draws is worked out before any of it is drawn, so all that's left below is issuing the draws
+	buildAllBatches( cameraFlags, numCameras );
+
 	GL( glDisable( GL_CULL_FACE ) );
 	GL( glEnable( GL_DEPTH_TEST ) );
 	GL( glEnable( GL_SCISSOR_TEST ) );
@@ -492,19 +1694,27 @@ void triRenderer_Render( )
 
 	// render triangles
 	// TODO: We're ignoring any issues with cameras and transparency, probably want to handle this better.
-	for( int currCamera = cam_StartIteration( ); currCamera != -1; currCamera = cam_GetNextActiveCam( ) ) {
+	for( int i = 0; i < numCameras; ++i ) {
 		setScissor( 0 ); // set to the default scissor area for clearing
 		GL( glClear( GL_DEPTH_BUFFER_BIT ) );
 
 		GL( glDisable( GL_BLEND ) );
-		drawTriangles( currCamera, &solidTriangles );
+		drawBatches( cameraIDs[i], &solidTriangles, &( solidTriangles.cameraBatches[i] ) );
 
 		GL( glEnable( GL_BLEND ) );
 		GL( glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA ) );
-		drawTriangles( currCamera, &transparentTriangles );
+		drawBatches( cameraIDs[i], &transparentTriangles, &( transparentTriangles.cameraBatches[i] ) );
 	}
 
 	GL( glDisable( GL_SCISSOR_TEST ) );
 	GL( glBindVertexArray( 0 ) );
 	GL( glUseProgram( 0 ) );
+
+	// everything that will use the buffers this frame has been drawn
+	streamBuffer_EndFrame( &( solidTriangles.vertexStream ) );
+	streamBuffer_EndFrame( &( solidTriangles.indexStream ) );
+	streamBuffer_EndFrame( &( solidTriangles.instanceStream ) );
+	streamBuffer_EndFrame( &( transparentTriangles.vertexStream ) );
+	streamBuffer_EndFrame( &( transparentTriangles.indexStream ) );
+	streamBuffer_EndFrame( &( transparentTriangles.instanceStream ) );
 }
\ No newline at end of file
@@ -23,10 +23,58 @@ typedef struct {
 	Color col;
 } TriVert;
 
+// a quad that's expanded on the GPU, the vertices are a unit square centered on the origin that are scaled by size,
+//  moved by offset, rotated, and then moved to the position
+typedef struct {
+	Vector2 pos;
+	Vector2 size;
+	Vector2 offset;
+	float rotation;
+	Vector2 uvMin;
+	Vector2 uvMax;
+	Color col;
+	float floatVal0;
+} TriSprite;
+
+// most triangles each of the solid and transparent lists can hold by default, the lists grow up to this as needed
+#ifndef TRI_RENDERER_DEFAULT_MAX_TRIS
+	#if defined( __EMSCRIPTEN__ )
+		#define TRI_RENDERER_DEFAULT_MAX_TRIS ( 2048 * 2 )
+	#else
+		#define TRI_RENDERER_DEFAULT_MAX_TRIS ( 2048 * 8 )
+	#endif
+#endif
+
+// most sprites each of the solid and transparent lists can hold by default, each sprite used to be two triangles
+#ifndef TRI_RENDERER_DEFAULT_MAX_SPRITES
+	#define TRI_RENDERER_DEFAULT_MAX_SPRITES ( TRI_RENDERER_DEFAULT_MAX_TRIS / 2 )
+#endif
+
+typedef struct {
+	int solidTris; // triangles in each list in the last frame rendered
+	int transparentTris;
+	int droppedTris; // triangles that were dropped in the last frame because a list was full
+	int culledTris; // triangles that weren't seen by any camera in the last frame
+	int highWaterMark; // most triangles in a single list in any frame since the last reset
+	int solidCapacity; // number of triangles each list currently has storage for
+	int transparentCapacity;
+	int maxTris;
+	int solidSprites; // same as the triangle counts but for sprites
+	int transparentSprites;
+	int droppedSprites;
+	int culledSprites;
+	int maxSprites;
+	int groupDraws; // groups added in the last frame
+	int droppedGroupDraws;
+} TriRendererStats;
+
 TriVert triVert( Vector2 pos, Vector2 uv, Color col );
 
 /*
-Makes all the shaders reload.
+Makes all the shaders reload. Any of the shaders that have a file in the Shaders folder use that instead of the built
+ in version, these are reloaded automatically when they change. If anything fails to compile the current shaders
+ are kept.
+ Returns a value < 0 if there's a problem.
 */
 int triRenderer_LoadShaders( void );
 
@@ -46,13 +94,83 @@ int triRenderer_Add( TriVert vert0, TriVert vert1, TriVert vert2, ShaderType sha
 	int clippingID, uint32_t camFlags, int8_t depth, int transparent );
 
 /*
-Clears out all the triangles currently stored.
+Adds a triangle that moves over the tick, it's drawn between the start and end vertices based on how far through the
+ tick the frame being drawn is. The uvs of the start vertices are used for the whole tick. Both arrays have three
+ vertices in them.
+ Return a value < 0 if there's a problem.
+*/
+int triRenderer_AddTweenedVertices( const TriVert* startVerts, const TriVert* endVerts, ShaderType shader, GLuint texture,
+	float floatVal0, int clippingID, uint32_t camFlags, int8_t depth, int transparent );
+
+/*
+Adds a quad that will be drawn using instancing, this is much cheaper than adding two triangles. It's sorted and
+ drawn in the same order it would be if it was two triangles.
+ Return a value < 0 if there's a problem.
+*/
+int triRenderer_AddSprite( const TriSprite* sprite, ShaderType shader, GLuint texture,
+	int clippingID, uint32_t camFlags, int8_t depth, int transparent );
+
+/*
+Same as triRenderer_AddTweenedVertices but for sprites. Everything but the uvs is interpolated linearly, including the
+ rotation, so if the shortest turn is wanted the end rotation should be adjusted before adding.
+ Return a value < 0 if there's a problem.
+*/
+int triRenderer_AddTweenedSprite( const TriSprite* start, const TriSprite* end, ShaderType shader, GLuint texture,
+	int clippingID, uint32_t camFlags, int8_t depth, int transparent );
+
+/*
+Groups are sprites that are recorded once and kept on the GPU until the group is cleared, useful for things that
+ rarely change like the background. Each frame the group is drawn by adding it, which costs about the same as adding a
+ single sprite. The sprites are positioned relative to the offset the group is added at and are all drawn at the depth
+ the group is added at, in the order they were recorded. The clipping area and camera flags also come from when the
+ group is added.
+ If any sprite in the group is transparent the whole group is drawn with the transparent sprites.
+ Returns a value < 0 if there's a problem.
+*/
+int triRenderer_CreateGroup( void );
+void triRenderer_DestroyGroup( int groupID );
+void triRenderer_ClearGroup( int groupID );
+int triRenderer_AddSpriteToGroup( int groupID, const TriSprite* sprite, ShaderType shader, GLuint texture, int transparent );
+int triRenderer_AddGroup( int groupID, Vector2 offset, int clippingID, uint32_t camFlags, int8_t depth );
+
+/*
+Clears every group with a sprite drawn using the area of the texture between uvMin and uvMax, used when an image is
+ about to be released or replaced. Images packed into the same texture don't affect each other's groups.
+ The groups are marked stale until they're recorded again, check triRenderer_IsGroupStale to know when to do that.
+*/
+void triRenderer_ClearGroupsUsingTextureArea( GLuint texture, Vector2 uvMin, Vector2 uvMax );
+bool triRenderer_IsGroupStale( int groupID );
+
+/*
+Clears out all the triangles and sprites currently stored.
 */
 void triRenderer_Clear( void );
 
 /*
-Draws out all the triangles.
+Everything is meant to be added once per tick, with where it starts and ends over the tick, and then drawn for as many
+ frames as happen until the next tick. Calling triRenderer_FinishTick marks everything added since the last clear as
+ the tick's content, triRenderer_ClearFrame removes anything added after that so things that have to be regenerated
+ every frame can still be drawn.
+*/
+void triRenderer_FinishTick( void );
+void triRenderer_ClearFrame( void );
+
+/*
+Sets the most triangles each of the solid and transparent lists can hold, anything added past that is dropped.
+ Storage that's already been allocated isn't released.
+*/
+void triRenderer_SetMaxTriangles( int newMaxTris );
+void triRenderer_SetMaxSprites( int newMaxSprites );
+
+/*
+Gets the triangle and sprite counts for the last frame rendered, and how large the lists have grown.
+*/
+void triRenderer_GetStats( TriRendererStats* outStats );
+void triRenderer_ResetHighWaterMark( void );
+
+/*
+Draws out all the triangles, t is how far through the current tick this frame is in the range [0,1].
 */
-void triRenderer_Render( );
+void triRenderer_Render( float t );
 
 #endif /* inclusion guard */
\ No newline at end of file
@@ -62,4 +62,18 @@ bool ecps_cbf_CompareContains( const ComponentBitFlags* test, const ComponentBit
 	}
 
 	return true;
+}
+
+bool ecps_cbf_CompareAny( const ComponentBitFlags* test, const ComponentBitFlags* against )
+{
+	assert( test != NULL );
+	assert( against != NULL );
+
+	for( int i = 0; i < FLAGS_ARRAY_SIZE; ++i ) {
+		if( ( test->bits[i] & against->bits[i] ) != 0 ) {
+			return true;
+		}
+	}
+
+	return false;
 }
\ No newline at end of file
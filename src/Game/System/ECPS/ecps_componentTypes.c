@@ -22,10 +22,7 @@ ComponentID ecps_ct_AddType( ComponentTypeCollection* ctc, const char* name, siz
 	newType.verify = verify;
 	newType.cleanUp = cleanUp;
 
-	if( name != NULL ) {
-		strncpy( newType.name, name, sizeof( newType.name ) - 1 );
-		newType.name[sizeof( newType.name ) - 1] = 0;
-	}
+	newType.name = sym_Intern( name );
 
 	uint32_t id = sb_Count( ctc->sbTypes );
 	sb_Push( ctc->sbTypes, newType );
@@ -5,6 +5,7 @@
 #include <stdbool.h>
 
 #include "../../Utils/idSet.h"
+#include "../../Utils/symbols.h"
 #include "ecps_values.h"
 
 typedef uint32_t ComponentID;
@@ -14,7 +15,7 @@ typedef int (*VerifyComponent)( EntityID entityID );
 typedef void (*CleanUpComponent)( void* data );
 
 typedef struct {
-	char name[32];
+	Symbol name;
 	size_t size;
 	size_t align; // desired aligment of the structure
 
@@ -63,6 +64,8 @@ typedef struct {
 	// the sizes of these two should be the same
 	ComponentBitFlags* sbBitFlags;				// what components the array contains
 	PackagedComponentArray* sbComponentArrays;	// structure information and the entity data
+
+	uint32_t generation;						// incremented whenever the packaged arrays are cleared out, used to invalidate cached queries
 } ComponentData;
 
 typedef struct {
@@ -93,7 +96,37 @@ typedef struct {
 
 	ComponentBitFlags bitFlags;
 
-	char name[32];
+	Symbol name;
 } Process;
 
+typedef struct {
+	uint32_t packedArrayIdx;
+	int32_t offsets[MAX_QUERY_COMPONENTS]; // offset of each queried component in the entity, -1 if it's an optional component the array doesn't have
+} QueryArrayEntry;
+
+typedef struct {
+	uint32_t ecpsID;
+
+	ComponentBitFlags includeFlags;
+	ComponentBitFlags excludeFlags;
+
+	// the included components followed by the optional components, in the order they were passed in
+	size_t numComponents;
+	ComponentID components[MAX_QUERY_COMPONENTS];
+
+	// cached list of the packaged arrays that match the query, only arrays created since the last time the query was
+	//  started need to be tested
+	QueryArrayEntry* sbMatchingArrays;
+	size_t numArraysTested;
+	uint32_t generation;
+
+	// iteration state
+	bool isIterating;
+	bool ownsProcessState; // if the query was started while a process was running then it's not responsible for running the command buffer
+	size_t currMatch;
+	size_t currOffset;
+
+	Symbol name;
+} Query;
+
 #endif
\ No newline at end of file
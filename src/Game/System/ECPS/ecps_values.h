@@ -10,4 +10,6 @@
 #endif
 #define FLAGS_ARRAY_SIZE ( ( MAX_NUM_COMPONENT_TYPES + 31 ) / 32 )
 
+#define MAX_QUERY_COMPONENTS 8 // maximum number of included and optional components a single query can hand back
+
 #endif
\ No newline at end of file
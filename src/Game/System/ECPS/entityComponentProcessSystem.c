@@ -79,9 +79,7 @@ static bool createProcessVA( ECPS* ecps,
 	outProcess->proc = proc;
 	outProcess->postProc = postProc;
 
-	if( name != NULL ) {
-		strncpy( outProcess->name, name, sizeof( outProcess->name ) );
-	}
+	outProcess->name = sym_Intern( name );
 
 	// verify all the components are valid
 	memset( &( outProcess->bitFlags ), 0, sizeof( ComponentBitFlags ) );
@@ -257,6 +255,70 @@ static void removeEntityFromArray( ECPS* ecps, EntityID entityID )
 	modifyEntityDirectoryEntry( ecps, entityID, -1, 0 );
 }
 
+static void runCommandBuffer( ECPS* ecps )
+{
+	if( sb_Count( ecps->sbCommandBuffer ) > 0 ) {
+		// run the command buffer
+		uint8_t* cmdBuffer = ecps->sbCommandBuffer;
+		uint8_t* bufferEnd = &( sb_Last( ecps->sbCommandBuffer ) );
+
+		size_t size = sb_Count( ecps->sbCommandBuffer );
+		int numCmds = 0;
+		while( cmdBuffer < bufferEnd ) {
+			mem_Verify( );
+			++numCmds;
+			CommandType cmdType = *( (CommandType*)cmdBuffer );
+			switch( cmdType ) {
+			case CMD_ADD_COMPONENT:
+				cmdBuffer = runAddComponentCommand( ecps, cmdBuffer );
+				break;
+			case CMD_CREATE_ENTITY:
+				cmdBuffer = runCreateCommand( ecps, cmdBuffer );
+				break;
+			case CMD_DESTROY_ENTITY:
+				cmdBuffer = runDestroyEntityCommand( ecps, cmdBuffer );
+				break;
+			case CMD_REMOVE_COMPONENT:
+				cmdBuffer = runRemoveComponentCommand( ecps, cmdBuffer );
+				break;
+			default:
+				assert( false && "Invalid command" );
+				break;
+			}
+			mem_Verify( );
+			assert( cmdBuffer <= ( bufferEnd + 1 ) );
+		}
+
+		sb_Clear( ecps->sbCommandBuffer );
+	}
+}
+
+// tests any packaged arrays created since the last time the query was refreshed and caches the ones that match
+static void refreshQuery( ECPS* ecps, Query* query )
+{
+	// all the packaged arrays were thrown out, need to start over
+	if( query->generation != ecps->componentData.generation ) {
+		sb_Clear( query->sbMatchingArrays );
+		query->numArraysTested = 0;
+		query->generation = ecps->componentData.generation;
+	}
+
+	size_t numCompArrays = sb_Count( ecps->componentData.sbComponentArrays );
+	for( size_t cai = query->numArraysTested; cai < numCompArrays; ++cai ) {
+		ComponentBitFlags* cbf = &( ecps->componentData.sbBitFlags[cai] );
+		if( !ecps_cbf_CompareContains( &( query->includeFlags ), cbf ) ) continue;
+		if( ecps_cbf_CompareAny( &( query->excludeFlags ), cbf ) ) continue;
+
+		QueryArrayEntry entry;
+		entry.packedArrayIdx = (uint32_t)cai;
+		for( size_t i = 0; i < query->numComponents; ++i ) {
+			entry.offsets[i] = ecps->componentData.sbComponentArrays[cai].structure.entries[query->components[i]].offset;
+		}
+		sb_Push( query->sbMatchingArrays, entry );
+	}
+	query->numArraysTested = numCompArrays;
+}
+
 //*************************************************************************************
 // Public Interface
 // Sets up the ecps, ready to have components, processes, and entities created
@@ -279,6 +341,7 @@ void ecps_StartInitialization( ECPS* ecps )
 	ecps->componentData.sbBitFlags = NULL;
 	ecps->componentData.sbComponentArrays = NULL;
 	ecps->componentData.sbEntityDirectory = NULL;
+	ecps->componentData.generation = 0;
 }
 
 // Switches states, no way to change back to the initialization state
@@ -320,10 +383,7 @@ ComponentID ecps_AddComponentType( ECPS* ecps, const char* name, size_t size, si
 	newType.verify = verify;
 	newType.cleanUp = cleanUp;
 
-	if( name != NULL ) {
-		strncpy( newType.name, name, sizeof( newType.name ) - 1 );
-		newType.name[sizeof( newType.name ) - 1] = 0;
-	}
+	newType.name = sym_Intern( name );
 
 	ComponentID id = (ComponentID)sb_Count( ecps->componentTypes.sbTypes );
 	sb_Push( ecps->componentTypes.sbTypes, newType );
@@ -421,39 +481,151 @@ void ecps_RunProcess( ECPS* ecps, Process* process )
 		process->postProc( ecps );
 	}
 
-	if( sb_Count( ecps->sbCommandBuffer ) > 0 ) {
-		// run the command buffer
-		uint8_t* cmdBuffer = ecps->sbCommandBuffer;
-		uint8_t* bufferEnd = &( sb_Last( ecps->sbCommandBuffer ) );
+	runCommandBuffer( ecps );
+}
 
-		size_t size = sb_Count( ecps->sbCommandBuffer );
-		int numCmds = 0;
-		while( cmdBuffer < bufferEnd ) {
-			mem_Verify( );
-			++numCmds;
-			CommandType cmdType = *( (CommandType*)cmdBuffer );
-			switch( cmdType ) {
-			case CMD_ADD_COMPONENT:
-				cmdBuffer = runAddComponentCommand( ecps, cmdBuffer );
-				break;
-			case CMD_CREATE_ENTITY:
-				cmdBuffer = runCreateCommand( ecps, cmdBuffer );
-				break;
-			case CMD_DESTROY_ENTITY:
-				cmdBuffer = runDestroyEntityCommand( ecps, cmdBuffer );
-				break;
-			case CMD_REMOVE_COMPONENT:
-				cmdBuffer = runRemoveComponentCommand( ecps, cmdBuffer );
-				break;
-			default:
-				assert( false && "Invalid command" );
-				break;
+// sets up a query, expects the variable argument list to be numInclude ComponentIDs, followed by numExclude ComponentIDs,
+//  followed by numOptional ComponentIDs
+bool ecps_CreateQuery( ECPS* ecps, const char* name, Query* outQuery, size_t numInclude, size_t numExclude, size_t numOptional, ... )
+{
+	assert( ecps != NULL );
+	assert( outQuery != NULL );
+
+	if( ( numInclude + numOptional ) > MAX_QUERY_COMPONENTS ) {
+		llog( LOG_ERROR, "Too many components requested by query, maximum is %i.", MAX_QUERY_COMPONENTS );
+		return false;
+	}
+
+	memset( outQuery, 0, sizeof( Query ) );
+
+	outQuery->name = sym_Intern( name );
+
+	va_list list;
+	va_start( list, numOptional ); {
+		for( size_t i = 0; i < numInclude; ++i ) {
+			ComponentID compID = va_arg( list, ComponentID );
+			assert( ecps_ct_IsComponentTypeValid( &( ecps->componentTypes ), compID ) );
+			ecps_cbf_SetFlagOn( &( outQuery->includeFlags ), compID );
+			outQuery->components[outQuery->numComponents++] = compID;
+		}
+
+		for( size_t i = 0; i < numExclude; ++i ) {
+			ComponentID compID = va_arg( list, ComponentID );
+			assert( ecps_ct_IsComponentTypeValid( &( ecps->componentTypes ), compID ) );
+			ecps_cbf_SetFlagOn( &( outQuery->excludeFlags ), compID );
+		}
+
+		for( size_t i = 0; i < numOptional; ++i ) {
+			ComponentID compID = va_arg( list, ComponentID );
+			assert( ecps_ct_IsComponentTypeValid( &( ecps->componentTypes ), compID ) );
+			outQuery->components[outQuery->numComponents++] = compID;
+		}
+	} va_end( list );
+
+	// same as processes, all queries require the ID and enabled components
+	ecps_cbf_SetFlagOn( &( outQuery->includeFlags ), sharedComponent_Enabled );
+	ecps_cbf_SetFlagOn( &( outQuery->includeFlags ), sharedComponent_ID );
+
+	outQuery->ecpsID = ecps->id;
+	outQuery->generation = ecps->componentData.generation;
+
+	return true;
+}
+
+// releases the cached data in use by the query
+void ecps_DestroyQuery( Query* query )
+{
+	assert( query != NULL );
+	assert( !( query->isIterating ) );
+
+	sb_Release( query->sbMatchingArrays );
+	query->numArraysTested = 0;
+}
+
+// starts iterating through the entities that match the query, any changes to entities made before the iteration ends
+//  are deferred the same way they are while a process is running
+void ecps_QueryStart( ECPS* ecps, Query* query )
+{
+	assert( ecps != NULL );
+	assert( query != NULL );
+	assert( ecps->isRunning );
+	assert( ( ecps->id ) == ( query->ecpsID ) );
+	assert( !( query->isIterating ) );
+
+	refreshQuery( ecps, query );
+
+	query->currMatch = 0;
+	query->currOffset = 0;
+	query->isIterating = true;
+
+	query->ownsProcessState = !( ecps->isRunningProcess );
+	ecps->isRunningProcess = true;
+}
+
+// gets the next entity that matches the query, returns false when there are no more, at which point the iteration is ended
+//  if outComponents isn't NULL it should be able to hold a pointer for every included and optional component, they will be
+//  filled in in the order they were passed into ecps_CreateQuery( ), optional components the entity doesn't have will be NULL
+bool ecps_QueryNext( ECPS* ecps, Query* query, Entity* outEntity, void** outComponents )
+{
+	assert( ecps != NULL );
+	assert( query != NULL );
+	assert( outEntity != NULL );
+
+	if( !( query->isIterating ) ) {
+		return false;
+	}
+
+	size_t numMatches = sb_Count( query->sbMatchingArrays );
+	while( query->currMatch < numMatches ) {
+		QueryArrayEntry* match = &( query->sbMatchingArrays[query->currMatch] );
+		PackagedComponentArray* pca = &( ecps->componentData.sbComponentArrays[match->packedArrayIdx] );
+		size_t dataArraySize = sb_Count( pca->sbData );
+
+		while( query->currOffset < dataArraySize ) {
+			// first should always be the entity id
+			uint8_t* data = &( pca->sbData[query->currOffset] );
+			query->currOffset += pca->entitySize;
+
+			EntityID entityID = *( (EntityID*)data );
+			if( entityID != INVALID_ENTITY_ID ) {
+				outEntity->id = entityID;
+				outEntity->data = (void*)data;
+				outEntity->structure = &( pca->structure );
+
+				if( outComponents != NULL ) {
+					for( size_t i = 0; i < query->numComponents; ++i ) {
+						outComponents[i] = ( match->offsets[i] >= 0 ) ? (void*)( &( data[match->offsets[i]] ) ) : NULL;
+					}
+				}
+
+				return true;
 			}
-			mem_Verify( );
-			assert( cmdBuffer <= ( bufferEnd + 1 ) );
 		}
 
-		sb_Clear( ecps->sbCommandBuffer );
+		++( query->currMatch );
+		query->currOffset = 0;
+	}
+
+	ecps_QueryEnd( ecps, query );
+	return false;
+}
+
+// ends the iteration, runs any commands that were deferred while iterating, only needs to be called if you stop before
+//  ecps_QueryNext( ) returns false
+void ecps_QueryEnd( ECPS* ecps, Query* query )
+{
+	assert( ecps != NULL );
+	assert( query != NULL );
+
+	if( !( query->isIterating ) ) {
+		return;
+	}
+
+	query->isIterating = false;
+
+	if( query->ownsProcessState ) {
+		ecps->isRunningProcess = false;
+		runCommandBuffer( ecps );
 	}
 }
 
@@ -1134,6 +1306,8 @@ void ecps_DestroyAllEntities( ECPS* ecps )
 
 	sb_Release( ecps->componentData.sbEntityDirectory );
 	ecps->componentData.sbEntityDirectory = NULL;
+
+	++( ecps->componentData.generation );
 }
 
 // list out the components of one entity
@@ -1166,8 +1340,8 @@ void ecps_DumpEntity( ECPS* ecps, const Entity* entity, const char* tag )
 	char* sbTypeList = NULL;
 	for( ComponentID compID = 0; compID < sb_Count( ecps->componentTypes.sbTypes ); ++compID ) {
 		if( ecps_DoesEntityHaveComponent( entity, compID ) ) {
-			char* name = ecps->componentTypes.sbTypes[compID].name;
-			size_t len = strnlen( name, 32 );
+			const char* name = sym_GetString( ecps->componentTypes.sbTypes[compID].name );
+			size_t len = strlen( name );
 
 			if( isFirst ) {
 				isFirst = false;
@@ -1208,8 +1382,8 @@ void ecps_DumpAllEntities( ECPS* ecps, const char* tag )
 		sb_Clear( sbTypeList );
 		for( ComponentID compID = 0; compID < sb_Count( ecps->componentTypes.sbTypes ); ++compID ) {
 			if( ecps_DoesEntityHaveComponent( &entity, compID ) ) {
-				char* name = ecps->componentTypes.sbTypes[compID].name;
-				size_t len = strnlen( name, 32 );
+				const char* name = sym_GetString( ecps->componentTypes.sbTypes[compID].name );
+				size_t len = strlen( name );
 
 				if( isFirst ) {
 					isFirst = false;
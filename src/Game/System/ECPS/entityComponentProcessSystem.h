@@ -31,6 +31,30 @@ void ecps_RunCustomProcess( ECPS* ecps, PreProcFunc preProc, ProcFunc proc, Post
 // run a process, must have been created with the associated entity-component-process system
 void ecps_RunProcess( ECPS* ecps, Process* process );
 
+// sets up a query that can be used to iterate through entities without needing a callback, expects the variable argument list
+//  to be numInclude ComponentIDs, followed by numExclude ComponentIDs, followed by numOptional ComponentIDs
+//  entities must have all the included components and none of the excluded components, optional components are handed back
+//  if the entity has them
+//  the matching packaged arrays are cached in the query, so it should be created once and reused
+bool ecps_CreateQuery( ECPS* ecps, const char* name, Query* outQuery, size_t numInclude, size_t numExclude, size_t numOptional, ... );
+
+// releases the cached data in use by the query
+void ecps_DestroyQuery( Query* query );
+
+// starts iterating through the entities that match the query, any changes to entities made before the iteration ends
+//  are deferred the same way they are while a process is running, usage:
+//   ecps_QueryStart( ecps, &query );
+//   while( ecps_QueryNext( ecps, &query, &entity, components ) ) { ... }
+void ecps_QueryStart( ECPS* ecps, Query* query );
+
+// gets the next entity that matches the query, returns false when there are no more, at which point the iteration is ended
+//  if outComponents isn't NULL it should be able to hold a pointer for every included and optional component, they will be
+//  filled in in the order they were passed into ecps_CreateQuery( ), optional components the entity doesn't have will be NULL
+bool ecps_QueryNext( ECPS* ecps, Query* query, Entity* outEntity, void** outComponents );
+
+// ends the iteration and runs any deferred commands, only needs to be called if you stop before ecps_QueryNext( ) returns false
+void ecps_QueryEnd( ECPS* ecps, Query* query );
+
 // creates an entity with the associated components, excepts the variable argument list to be
 //  interleaved { ComponentID id, void* compData } groupings
 //  the memory pointed to by compData is copied into the component specified by id for the
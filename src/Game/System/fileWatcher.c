@@ -0,0 +1,283 @@
+#include "fileWatcher.h"
+
+#include <SDL_stdinc.h>
+#include <SDL_timer.h>
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platformLog.h"
+#include "../Utils/stretchyBuffer.h"
+
+#ifndef FILE_WATCHER_DISABLED
+	#if defined( _WIN32 )
+		#define WIN32_LEAN_AND_MEAN
+		#include <windows.h>
+	#else
+		#include <sys/types.h>
+		#include <sys/stat.h>
+	#endif
+
+	#if defined( __linux__ )
+		#define FILE_WATCHER_INOTIFY
+		#include <sys/inotify.h>
+		#include <unistd.h>
+	#endif
+#endif
+
+#define MAX_WATCH_PATH 256
+
+// how often files are checked when they can't be watched, in milliseconds
+#define POLL_INTERVAL 250
+
+// how long a file has to be left alone after changing before it's reported, in milliseconds
+#define SETTLE_TIME 50
+
+typedef struct {
+	char path[MAX_WATCH_PATH];
+	size_t nameOffset; // where the file name starts after the directory
+	FileChangedFunc onChanged;
+	void* data;
+	bool inUse;
+
+	bool changed;
+	Uint32 changeTime;
+
+	int wd; // inotify watch for the directory, -1 if the file is polled instead
+	int64_t modTime;
+	int64_t size;
+} FileWatch;
+
+static FileWatch* sbWatches = NULL;
+static Uint32 lastPollTime = 0;
+
+#ifdef FILE_WATCHER_INOTIFY
+static int inotifyFD = -1;
+#endif
+
+#ifndef FILE_WATCHER_DISABLED
+// gets when the file was last modified and how large it is, both are 0 if it doesn't exist
+static void getFileInfo( const char* path, int64_t* outModTime, int64_t* outSize )
+{
+	(*outModTime) = 0;
+	(*outSize) = 0;
+
+#if defined( _WIN32 )
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if( GetFileAttributesExA( path, GetFileExInfoStandard, &attributes ) ) {
+		(*outModTime) = (int64_t)( ( (uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32 ) | attributes.ftLastWriteTime.dwLowDateTime );
+		(*outSize) = (int64_t)( ( (uint64_t)attributes.nFileSizeHigh << 32 ) | attributes.nFileSizeLow );
+	}
+#else
+	struct stat fileStat;
+	if( stat( path, &fileStat ) == 0 ) {
+		(*outModTime) = (int64_t)fileStat.st_mtime;
+		(*outSize) = (int64_t)fileStat.st_size;
+	}
+#endif
+}
+
+static void markChanged( FileWatch* watch, Uint32 now )
+{
+	watch->changed = true;
+	watch->changeTime = now;
+}
+
+static void pollFiles( Uint32 now )
+{
+	if( ( now - lastPollTime ) < POLL_INTERVAL ) {
+		return;
+	}
+	lastPollTime = now;
+
+	for( size_t i = 0; i < sb_Count( sbWatches ); ++i ) {
+		FileWatch* watch = &( sbWatches[i] );
+		if( !watch->inUse || ( watch->wd >= 0 ) ) {
+			continue;
+		}
+
+		int64_t modTime, size;
+		getFileInfo( watch->path, &modTime, &size );
+		if( ( modTime != watch->modTime ) || ( size != watch->size ) ) {
+			watch->modTime = modTime;
+			watch->size = size;
+			markChanged( watch, now );
+		}
+	}
+}
+#endif
+
+#ifdef FILE_WATCHER_INOTIFY
+static void readEvents( Uint32 now )
+{
+	union {
+		struct inotify_event event;
+		char bytes[4096];
+	} buffer;
+
+	// the descriptor is non-blocking, so this stops once there's nothing left to read
+	ssize_t amtRead;
+	while( ( amtRead = read( inotifyFD, buffer.bytes, sizeof( buffer.bytes ) ) ) > 0 ) {
+		char* curr = buffer.bytes;
+		while( curr < ( buffer.bytes + amtRead ) ) {
+			struct inotify_event* event = (struct inotify_event*)curr;
+
+			if( event->mask & IN_Q_OVERFLOW ) {
+				llog( LOG_WARN, "File watcher events were lost, some changes may have been missed." );
+			} else if( event->len > 0 ) {
+				for( size_t i = 0; i < sb_Count( sbWatches ); ++i ) {
+					FileWatch* watch = &( sbWatches[i] );
+					if( watch->inUse && ( watch->wd == event->wd ) && ( strcmp( watch->path + watch->nameOffset, event->name ) == 0 ) ) {
+						markChanged( watch, now );
+					}
+				}
+			}
+
+			curr += sizeof( struct inotify_event ) + event->len;
+		}
+	}
+}
+
+// watches the directory the file is in, returns -1 if it can't be watched
+static int watchDirectory( FileWatch* watch )
+{
+	if( inotifyFD < 0 ) {
+		return -1;
+	}
+
+	char dir[MAX_WATCH_PATH];
+	if( watch->nameOffset == 0 ) {
+		SDL_strlcpy( dir, ".", sizeof( dir ) );
+	} else {
+		SDL_strlcpy( dir, watch->path, watch->nameOffset + 1 );
+	}
+
+	// watching the same directory again gives back the same descriptor
+	return inotify_add_watch( inotifyFD, dir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE );
+}
+#endif
+
+int fw_Init( void )
+{
+	sbWatches = NULL;
+	lastPollTime = 0;
+
+#ifdef FILE_WATCHER_INOTIFY
+	inotifyFD = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+	if( inotifyFD < 0 ) {
+		llog( LOG_WARN, "Unable to start inotify, watched files will be polled instead." );
+	}
+#endif
+
+	return 0;
+}
+
+void fw_CleanUp( void )
+{
+#ifdef FILE_WATCHER_INOTIFY
+	// closing it removes all the watches
+	if( inotifyFD >= 0 ) {
+		close( inotifyFD );
+		inotifyFD = -1;
+	}
+#endif
+
+	sb_Release( sbWatches );
+}
+
+int fw_Watch( const char* fileName, FileChangedFunc onChanged, void* data )
+{
+	assert( fileName != NULL );
+	assert( onChanged != NULL );
+
+#ifdef FILE_WATCHER_DISABLED
+	return -1;
+#else
+	size_t pathLen = strlen( fileName );
+	if( pathLen >= MAX_WATCH_PATH ) {
+		llog( LOG_WARN, "Path too long to watch: %s", fileName );
+		return -1;
+	}
+
+	int watchID = -1;
+	for( size_t i = 0; ( i < sb_Count( sbWatches ) ) && ( watchID < 0 ); ++i ) {
+		if( !sbWatches[i].inUse ) {
+			watchID = (int)i;
+		}
+	}
+	if( watchID < 0 ) {
+		watchID = (int)sb_Count( sbWatches );
+		sb_Add( sbWatches, 1 );
+	}
+
+	FileWatch* watch = &( sbWatches[watchID] );
+	memset( watch, 0, sizeof( FileWatch ) );
+	SDL_strlcpy( watch->path, fileName, sizeof( watch->path ) );
+	watch->onChanged = onChanged;
+	watch->data = data;
+	watch->inUse = true;
+
+	for( size_t i = 0; i < pathLen; ++i ) {
+		if( ( fileName[i] == '/' ) || ( fileName[i] == '\\' ) ) {
+			watch->nameOffset = i + 1;
+		}
+	}
+
+	watch->wd = -1;
+#ifdef FILE_WATCHER_INOTIFY
+	watch->wd = watchDirectory( watch );
+#endif
+	getFileInfo( watch->path, &( watch->modTime ), &( watch->size ) );
+
+	return watchID;
+#endif
+}
+
+void fw_Unwatch( int watchID )
+{
+	if( ( watchID < 0 ) || ( watchID >= (int)sb_Count( sbWatches ) ) || !sbWatches[watchID].inUse ) {
+		return;
+	}
+
+	FileWatch* watch = &( sbWatches[watchID] );
+	watch->inUse = false;
+
+#ifdef FILE_WATCHER_INOTIFY
+	// other files in the same directory share the directory's watch
+	bool dirUsed = false;
+	for( size_t i = 0; ( i < sb_Count( sbWatches ) ) && !dirUsed; ++i ) {
+		dirUsed = sbWatches[i].inUse && ( sbWatches[i].wd == watch->wd );
+	}
+	if( ( watch->wd >= 0 ) && !dirUsed ) {
+		inotify_rm_watch( inotifyFD, watch->wd );
+	}
+#endif
+}
+
+void fw_Process( void )
+{
+#ifndef FILE_WATCHER_DISABLED
+	Uint32 now = SDL_GetTicks( );
+
+#ifdef FILE_WATCHER_INOTIFY
+	if( inotifyFD >= 0 ) {
+		readEvents( now );
+	}
+#endif
+	pollFiles( now );
+
+	for( size_t i = 0; i < sb_Count( sbWatches ); ++i ) {
+		FileWatch* watch = &( sbWatches[i] );
+		if( !watch->inUse || !watch->changed || ( ( now - watch->changeTime ) < SETTLE_TIME ) ) {
+			continue;
+		}
+		watch->changed = false;
+
+		// the function can add and remove watches, so don't use the watch after it's called
+		char path[MAX_WATCH_PATH];
+		SDL_strlcpy( path, watch->path, sizeof( path ) );
+		llog( LOG_INFO, "%s changed, reloading.", path );
+		watch->onChanged( path, watch->data );
+	}
+#endif
+}
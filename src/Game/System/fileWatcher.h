@@ -0,0 +1,40 @@
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <stdbool.h>
+
+/*
+Watches files for changes so assets can be reloaded while the game is running. On Linux inotify is used to watch the
+ directories the files are in, everywhere else, or if a directory can't be watched, the files are polled a few times a
+ second. Editors tend to save files in a few steps, so a change isn't reported until the file has been left alone for
+ a moment.
+Files in the mounted asset pack are read from the pack instead of the loose files, so changing the loose files won't
+ change what's loaded. Don't mount a pack when iterating on assets.
+Not available on the web or on Android, watching does nothing there.
+Only meant to be used from the main thread.
+*/
+
+#if defined( __EMSCRIPTEN__ ) || defined( __ANDROID__ )
+	#define FILE_WATCHER_DISABLED
+#endif
+
+// called from fw_Process when the file has changed
+typedef void (*FileChangedFunc)( const char* fileName, void* data );
+
+int fw_Init( void );
+void fw_CleanUp( void );
+
+/*
+Starts watching the file, it doesn't have to exist yet, creating it counts as a change.
+ Returns an id used to stop watching the file, -1 if it can't be watched.
+*/
+int fw_Watch( const char* fileName, FileChangedFunc onChanged, void* data );
+
+void fw_Unwatch( int watchID );
+
+/*
+Checks for changes and calls the functions for any files that have changed. Called once a frame.
+*/
+void fw_Process( void );
+
+#endif /* inclusion guard */
@@ -19,10 +19,15 @@ bool jq_AllJobsDone( void )
 	return ( jrq_IsEmpty( &jobQueue ) && !jrq_IsBusy( &jobQueue ) );
 }
 
+bool jq_IsInitialized( void )
+{
+	return ( jobQueue.ringBuffer != NULL );
+}
+
 // non-static version for if we want the main thread to process jobs as well
 bool jq_ProcessNextJob( void )
 {
-	return jrq_ProcessNext( &jobQueue );
+	return jq_IsInitialized( ) && jrq_ProcessNext( &jobQueue );
 }
 
 static SDL_sem* jobQueueSemaphore = NULL;
@@ -144,10 +149,10 @@ bool jq_AddJob( JobProcessFunc proc, void* data )
 {
 	// trying to use these generates fatal error C1001, so fucking MSVC won't let us do any error checking...
 	//if( proc == NULL ) return false;
-	/*if( sbJobQueue == NULL ) {
+	if( !jq_IsInitialized( ) ) {
 		llog( LOG_WARN, "Attempting to add job before job queue created." );
 		return false;
-	}//*/
+	}
 	addJob( proc, data, &jobQueue );
 	SDL_SemPost( jobQueueSemaphore );
 
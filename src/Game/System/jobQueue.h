@@ -17,6 +17,9 @@ void jq_ShutDown( void );
 bool jq_AddJob( JobProcessFunc proc, void* data );
 bool jq_AddMainThreadJob( JobProcessFunc proc, void* data );
 
+// returns if jq_Initialize has been successfully called, jobs can't be added until it has
+bool jq_IsInitialized( void );
+
 // gets the next job and runs it, used if you want the main thread running jobs as well
 bool jq_ProcessNextJob( void );
 
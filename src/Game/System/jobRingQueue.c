@@ -28,6 +28,8 @@ void jrq_CleanUp( JobRingQueue* queue )
 	assert( queue != NULL );
 
 	mem_Release( queue->ringBuffer );
+	queue->ringBuffer = NULL;
+	queue->size = 0;
 }
 
 void jrq_Write( JobRingQueue* queue, Job* jobby )
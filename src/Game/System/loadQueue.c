@@ -0,0 +1,314 @@
+#include "loadQueue.h"
+
+#include <assert.h>
+#include <SDL.h>
+
+#include "jobQueue.h"
+#include "gameTime.h"
+#include "memory.h"
+#include "platformLog.h"
+#include "../Utils/stretchyBuffer.h"
+
+typedef struct {
+	char name[128];
+	LoadFunc load;
+	BindFunc bind;
+	void* data;
+
+	bool loaded;
+	Uint64 requestTime;
+	Uint64 startTime;
+	float loadTime; // set on the worker thread, only read after the bind job has been queued
+} LoadRequest;
+
+static LoadRequest** sbPending[NUM_LOAD_PRIORITIES] = { NULL };
+static int maxLoadsInFlight = 1;
+static int numInFlight = 0;
+
+static int numCompleted = 0;
+static int numFailed = 0;
+static float totalQueueTime = 0.0f;
+static float totalLoadTime = 0.0f;
+static float totalBindTime = 0.0f;
+static float totalTime = 0.0f;
+static float maxTime = 0.0f;
+
+int lq_Init( int maxInFlight )
+{
+	assert( maxInFlight > 0 );
+
+	maxLoadsInFlight = maxInFlight;
+	numInFlight = 0;
+
+	for( int i = 0; i < NUM_LOAD_PRIORITIES; ++i ) {
+		sb_Release( sbPending[i] );
+	}
+
+	numCompleted = 0;
+	numFailed = 0;
+	totalQueueTime = 0.0f;
+	totalLoadTime = 0.0f;
+	totalBindTime = 0.0f;
+	totalTime = 0.0f;
+	maxTime = 0.0f;
+
+	return 0;
+}
+
+bool lq_Add( LoadPriority priority, const char* name, LoadFunc load, BindFunc bind, void* data )
+{
+	assert( ( priority >= 0 ) && ( priority < NUM_LOAD_PRIORITIES ) );
+	assert( load != NULL );
+	assert( bind != NULL );
+
+	LoadRequest* request = mem_Allocate( sizeof( LoadRequest ) );
+	if( request == NULL ) {
+		llog( LOG_ERROR, "Unable to allocate load request for %s.", name );
+		return false;
+	}
+
+	SDL_strlcpy( request->name, ( name != NULL ) ? name : "", sizeof( request->name ) );
+	request->load = load;
+	request->bind = bind;
+	request->data = data;
+	request->loaded = false;
+	request->requestTime = gt_StartTimer( );
+	request->startTime = request->requestTime;
+	request->loadTime = 0.0f;
+
+	sb_Push( sbPending[priority], request );
+
+	return true;
+}
+
+// adds a finished load to the stats, used by both the streamed and batch loads
+static void recordLoad( bool loaded, Uint64 requestTime, Uint64 startTime, float loadTime, float bindTime )
+{
+	if( loaded ) {
+		float queueTime = (float)( startTime - requestTime ) / (float)SDL_GetPerformanceFrequency( );
+		float time = gt_StopTimer( requestTime );
+
+		++numCompleted;
+		totalQueueTime += queueTime;
+		totalLoadTime += loadTime;
+		totalBindTime += bindTime;
+		totalTime += time;
+		if( time > maxTime ) {
+			maxTime = time;
+		}
+	} else {
+		++numFailed;
+	}
+}
+
+static void bindJob( void* data )
+{
+	LoadRequest* request = (LoadRequest*)data;
+
+	Uint64 bindTimer = gt_StartTimer( );
+	request->bind( request->data, request->loaded );
+	float bindTime = gt_StopTimer( bindTimer );
+
+	--numInFlight;
+	recordLoad( request->loaded, request->requestTime, request->startTime, request->loadTime, bindTime );
+	if( !request->loaded ) {
+		llog( LOG_WARN, "Unable to load %s.", request->name );
+	}
+
+	mem_Release( request );
+
+	if( lq_IsIdle( ) ) {
+		lq_LogStats( );
+	}
+}
+
+static void runLoad( LoadRequest* request )
+{
+	Uint64 loadTimer = gt_StartTimer( );
+	request->loaded = request->load( request->data );
+	request->loadTime = gt_StopTimer( loadTimer );
+}
+
+static void loadJob( void* data )
+{
+	LoadRequest* request = (LoadRequest*)data;
+	runLoad( request );
+	jq_AddMainThreadJob( bindJob, request );
+}
+
+void lq_Process( void )
+{
+	for( int p = 0; ( p < NUM_LOAD_PRIORITIES ) && ( numInFlight < maxLoadsInFlight ); ++p ) {
+		while( ( sb_Count( sbPending[p] ) > 0 ) && ( numInFlight < maxLoadsInFlight ) ) {
+			LoadRequest* request = sbPending[p][0];
+			sb_Remove( sbPending[p], 0 );
+
+			request->startTime = gt_StartTimer( );
+			++numInFlight;
+			if( !jq_AddJob( loadJob, request ) ) {
+				// still have to load it, just do it here, the main thread jobs won't be run either so bind it as well
+				runLoad( request );
+				bindJob( request );
+			}
+		}
+	}
+}
+
+typedef struct {
+	LoadFunc load;
+	void* data;
+	bool loaded;
+	Uint64 startTime;
+	float loadTime; // set on the worker thread before the state is set to loaded
+	SDL_atomic_t state;
+} BatchLoad;
+
+enum {
+	BATCH_LOADING,
+	BATCH_LOADED,
+	BATCH_BOUND
+};
+
+static void batchLoadJob( void* data )
+{
+	BatchLoad* batchLoad = (BatchLoad*)data;
+
+	Uint64 loadTimer = gt_StartTimer( );
+	batchLoad->loaded = batchLoad->load( batchLoad->data );
+	batchLoad->loadTime = gt_StopTimer( loadTimer );
+
+	SDL_AtomicSet( &( batchLoad->state ), BATCH_LOADED );
+}
+
+int lq_LoadBatch( LoadFunc load, BindFunc bind, void** data, int count )
+{
+	assert( load != NULL );
+	assert( bind != NULL );
+	assert( ( data != NULL ) || ( count == 0 ) );
+
+	if( count <= 0 ) {
+		return 0;
+	}
+
+	int numBatchFailed = 0;
+	Uint64 requestTime = gt_StartTimer( );
+
+	BatchLoad* batch = mem_Allocate( sizeof( BatchLoad ) * count );
+	if( batch == NULL ) {
+		// still have to load them, just do it here
+		llog( LOG_WARN, "Unable to allocate batch load, loading on the calling thread." );
+		for( int i = 0; i < count; ++i ) {
+			Uint64 startTime = gt_StartTimer( );
+			bool loaded = load( data[i] );
+			float loadTime = gt_StopTimer( startTime );
+
+			Uint64 bindTimer = gt_StartTimer( );
+			bind( data[i], loaded );
+			recordLoad( loaded, requestTime, startTime, loadTime, gt_StopTimer( bindTimer ) );
+			if( !loaded ) {
+				++numBatchFailed;
+			}
+		}
+		return numBatchFailed;
+	}
+
+	for( int i = 0; i < count; ++i ) {
+		batch[i].load = load;
+		batch[i].data = data[i];
+		batch[i].loaded = false;
+		batch[i].startTime = requestTime;
+		batch[i].loadTime = 0.0f;
+		SDL_AtomicSet( &( batch[i].state ), BATCH_LOADING );
+	}
+
+	// only keep as many in the job queue as the streamed loads are allowed, so a large batch can't overflow it
+	int numStarted = 0;
+	int numBound = 0;
+	while( numBound < count ) {
+		while( ( numStarted < count ) && ( ( numStarted - numBound ) < maxLoadsInFlight ) ) {
+			batch[numStarted].startTime = gt_StartTimer( );
+			++numInFlight;
+			if( !jq_AddJob( batchLoadJob, &( batch[numStarted] ) ) ) {
+				batchLoadJob( &( batch[numStarted] ) );
+			}
+			++numStarted;
+		}
+
+		bool boundAny = false;
+		for( int i = 0; i < numStarted; ++i ) {
+			if( SDL_AtomicGet( &( batch[i].state ) ) == BATCH_LOADED ) {
+				Uint64 bindTimer = gt_StartTimer( );
+				bind( batch[i].data, batch[i].loaded );
+				float bindTime = gt_StopTimer( bindTimer );
+				SDL_AtomicSet( &( batch[i].state ), BATCH_BOUND );
+
+				--numInFlight;
+				recordLoad( batch[i].loaded, requestTime, batch[i].startTime, batch[i].loadTime, bindTime );
+				if( !batch[i].loaded ) {
+					++numBatchFailed;
+				}
+				++numBound;
+				boundAny = true;
+			}
+		}
+
+		// help out instead of just waiting, this is also what runs the loads if there's no thread support
+		if( !boundAny && ( numBound < count ) && !jq_ProcessNextJob( ) ) {
+			SDL_Delay( 1 );
+		}
+	}
+
+	mem_Release( batch );
+
+	if( lq_IsIdle( ) ) {
+		lq_LogStats( );
+	}
+
+	return numBatchFailed;
+}
+
+bool lq_IsIdle( void )
+{
+	if( numInFlight > 0 ) {
+		return false;
+	}
+
+	for( int i = 0; i < NUM_LOAD_PRIORITIES; ++i ) {
+		if( sb_Count( sbPending[i] ) > 0 ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void lq_GetStats( LoadQueueStats* outStats )
+{
+	assert( outStats != NULL );
+
+	outStats->numQueued = 0;
+	for( int i = 0; i < NUM_LOAD_PRIORITIES; ++i ) {
+		outStats->numQueued += (int)sb_Count( sbPending[i] );
+	}
+	outStats->numInFlight = numInFlight;
+	outStats->numCompleted = numCompleted;
+	outStats->numFailed = numFailed;
+
+	float count = ( numCompleted > 0 ) ? (float)numCompleted : 1.0f;
+	outStats->avgQueueTime = totalQueueTime / count;
+	outStats->avgLoadTime = totalLoadTime / count;
+	outStats->avgBindTime = totalBindTime / count;
+	outStats->avgTotalTime = totalTime / count;
+	outStats->maxTotalTime = maxTime;
+}
+
+void lq_LogStats( void )
+{
+	LoadQueueStats stats;
+	lq_GetStats( &stats );
+
+	llog( LOG_INFO, "Load queue - queued: %i  in flight: %i  completed: %i  failed: %i",
+		stats.numQueued, stats.numInFlight, stats.numCompleted, stats.numFailed );
+	llog( LOG_INFO, "  avg queue: %.4f  avg load: %.4f  avg bind: %.4f  avg total: %.4f  max total: %.4f",
+		stats.avgQueueTime, stats.avgLoadTime, stats.avgBindTime, stats.avgTotalTime, stats.maxTotalTime );
+}
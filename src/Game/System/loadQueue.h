@@ -0,0 +1,85 @@
+#ifndef LOAD_QUEUE_H
+#define LOAD_QUEUE_H
+
+#include <stdbool.h>
+
+/*
+Streams assets in the background using the job queue. Requests are kept here until there's room for them and are then
+ handed to the job queue highest priority first, so a large batch of low priority loads won't hold up something that's
+ needed right now. The loading is done on a worker thread, binding the result is done on the main thread.
+The systems that use this reserve a handle for the asset when it's requested so it can be used immediately, until the
+ asset is loaded they'll use a placeholder instead.
+Only meant to be used from the main thread.
+*/
+
+typedef enum {
+	LOAD_PRIORITY_HIGH,
+	LOAD_PRIORITY_NORMAL,
+	LOAD_PRIORITY_LOW,
+	NUM_LOAD_PRIORITIES
+} LoadPriority;
+
+// state of an asset slot that's being streamed in
+typedef enum {
+	LOAD_STATE_NONE, // not being streamed, either loaded or unused
+	LOAD_STATE_PENDING, // waiting for the data, the placeholder is used instead
+	LOAD_STATE_FAILED, // the data couldn't be loaded, the placeholder is used until it's cleaned up
+	LOAD_STATE_CANCELLED // cleaned up before the load finished, the slot is freed when it does
+} LoadState;
+
+// run on a worker thread, returns whether the data was successfully loaded
+typedef bool (*LoadFunc)( void* data );
+
+// run on the main thread after the load is done, is responsible for cleaning up the data
+typedef void (*BindFunc)( void* data, bool loaded );
+
+typedef struct {
+	int numQueued;
+	int numInFlight;
+	int numCompleted;
+	int numFailed;
+
+	// all times in seconds
+	float avgQueueTime; // from the request until the load is started
+	float avgLoadTime;
+	float avgBindTime;
+	float avgTotalTime; // from the request until the bind is done
+	float maxTotalTime;
+} LoadQueueStats;
+
+/*
+Sets up the queue, maxInFlight is how many loads can be given to the job queue at once. Has to be called after the job
+ queue has been initialized.
+ Returns < 0 on an error.
+*/
+int lq_Init( int maxInFlight );
+
+/*
+Adds a request to load something, load will be called on a worker thread and then bind on the main thread. The data
+ has to stay valid until bind is called, bind is always called, even if the load fails. name is only used for logging.
+ Returns whether the request was added, if it wasn't then neither load nor bind will be called.
+*/
+bool lq_Add( LoadPriority priority, const char* name, LoadFunc load, BindFunc bind, void* data );
+
+/*
+Starts as many of the waiting requests as it can, should be called once a frame before the main thread jobs are
+ processed.
+*/
+void lq_Process( void );
+
+/*
+Loads a group of assets immediately instead of streaming them. Each load is run on the worker threads, the calling
+ thread binds each one as soon as it's done and helps with the loading while it waits. Doesn't return until they've
+ all been bound. The load and bind functions work the same as with lq_Add, so the same ones can be used for both. They
+ are counted in the stats the same as the streamed loads.
+ Returns the number that failed to load.
+*/
+int lq_LoadBatch( LoadFunc load, BindFunc bind, void** data, int count );
+
+// Returns if there's nothing waiting or being loaded
+bool lq_IsIdle( void );
+
+void lq_GetStats( LoadQueueStats* outStats );
+void lq_LogStats( void );
+
+#endif /* inclusion guard */
@@ -35,12 +35,15 @@
 #pragma warning( pop )
 
 #include "../Utils/stretchyBuffer.h"
+#include "../Utils/typedHashMap.h"
+#include "../Utils/assetCache.h"
+#include "../Utils/assetPack.h"
 #include "../Graphics/images.h"
 #include "../Math/mathUtil.h"
 
 #include "../System/platformLog.h"
 
-#include "../System/jobQueue.h"
+#include "../System/loadQueue.h"
 
 #include "../Graphics/gfxUtil.h"
 
@@ -50,6 +53,10 @@ typedef struct {
 	float advance;
 } Glyph;
 
+// maps a codepoint to the index of it's glyph in the font's glyphsBuffer
+TYPED_HASH_MAP_DECLARE( GlyphMap, glyphMap, int32_t, int )
+TYPED_HASH_MAP_DEFINE( GlyphMap, glyphMap, int32_t, int, HASH_MAP_HASH_U32, HASH_MAP_EQUALS_VALUE )
+
 static const uint32_t LINE_FEED = 0xA;
 
 // used for when we want to modify a string but don't want to change what was passed in
@@ -61,6 +68,7 @@ typedef struct {
 	//  could also preprocess strings to just be a list of indices into the buffer
 	// will be a stretchy buffer
 	Glyph* glyphsBuffer;
+	GlyphMap glyphMap;
 	int packageID;
 
 	int missingCharGlyphIdx;
@@ -72,14 +80,31 @@ typedef struct {
 	float nextLineDescent;
 
 	int baseSize;
+
+	Symbol key; // INVALID_SYMBOL if the font isn't in the cache
+	LoadState loadState;
 } Font;
 
 static int missingChar = 0x3F; // '?'
 
 static Font fonts[MAX_FONTS] = { 0 };
+static AssetCache fontCache; // so each file is only loaded once for each size
+static int placeholderFont = -1; // used instead of fonts that are still being streamed in
 // TODO: for localization we can define stbtt_pack_range for each language and link them together to be loaded
 stbtt_pack_range fontPackRange = { 0 };
 
+// builds the lookup from codepoint to glyph, needs to be called whenever the glyphsBuffer is set
+static void buildGlyphMap( Font* font )
+{
+	int glyphCount = sb_Count( font->glyphsBuffer );
+
+	glyphMap_Clear( &( font->glyphMap ) );
+	glyphMap_Init( &( font->glyphMap ), (uint32_t)glyphCount );
+	for( int i = 0; i < glyphCount; ++i ) {
+		glyphMap_Set( &( font->glyphMap ), font->glyphsBuffer[i].codepoint, i );
+	}
+}
+
 // Sets up the default codepoints to load and clears out any currently loaded fonts.
 int txt_Init( void )
 {
@@ -93,10 +118,13 @@ int txt_Init( void )
 			sb_Release( fonts[i].glyphsBuffer );
 		}
 		fonts[i].glyphsBuffer = NULL;
+		glyphMap_Clear( &( fonts[i].glyphMap ) );
 	}
 
 	sb_Add( sbStringCodepointBuffer, 1024 );
 
+	assetCache_Init( &fontCache, MAX_FONTS );
+
 	return 0;
 }
 
@@ -121,7 +149,7 @@ int findUnusedFontID( void )
 {
 	int newFont = 0;
 
-	while( fonts[newFont].glyphsBuffer != NULL ) {
+	while( ( newFont < MAX_FONTS ) && ( ( fonts[newFont].glyphsBuffer != NULL ) || ( fonts[newFont].loadState != LOAD_STATE_NONE ) ) ) {
 		++newFont;
 	}
 	if( newFont >= MAX_FONTS ) {
@@ -131,9 +159,12 @@ int findUnusedFontID( void )
 	return newFont;
 }
 
-// Loads the font at fileName, with a height of pixelHeight.
-//  Returns an ID to be used when displaying a string, returns -1 if there was an issue.
-int txt_LoadFont( const char* fileName, int pixelHeight )
+static Symbol fontKey( const char* fileName, float pixelHeight )
+{
+	return assetCache_MakeKey( fileName, "%.2f", (double)pixelHeight );
+}
+
+static int loadFont( const char* fileName, int pixelHeight )
 {
 	uint8_t* buffer = NULL;
 	unsigned char* bmpBuffer = NULL;
@@ -178,7 +209,7 @@ int txt_LoadFont( const char* fileName, int pixelHeight )
 		goto clean_up;
 	}
 
-	SDL_RWops* rwopsFile = SDL_RWFromFile( fileName, "r" );
+	SDL_RWops* rwopsFile = assetPack_OpenFile( fileName );
 	if( rwopsFile == NULL ) {
 		llog( LOG_ERROR, "Error opening font file %s", fileName );
 		newFont = -1;
@@ -280,6 +311,7 @@ int txt_LoadFont( const char* fileName, int pixelHeight )
 		offset.y = ( quad.y0 + quad.y1 ) / 2.0f;
 		img_SetOffset( retIDs[i], offset );
 	}
+	buildGlyphMap( &( fonts[newFont] ) );
 
 	// TODO: get a way to do this with fewer temporary allocations
 clean_up:
@@ -299,9 +331,28 @@ clean_up:
 	return newFont;
 }
 
+// Loads the font at fileName, with a height of pixelHeight. If the font has already been loaded at that size a reference
+//  is added and it's returned, every load has to be matched by a txt_UnloadFont.
+//  Returns an ID to be used when displaying a string, returns -1 if there was an issue.
+int txt_LoadFont( const char* fileName, int pixelHeight )
+{
+	int fontID;
+	Symbol key = fontKey( fileName, (float)pixelHeight );
+	if( assetCache_AddRef( &fontCache, key, &fontID ) ) {
+		return fontID;
+	}
+
+	fontID = loadFont( fileName, pixelHeight );
+	if( fontID >= 0 ) {
+		fonts[fontID].key = key;
+		assetCache_Store( &fontCache, key, fontID );
+	}
+	return fontID;
+}
+
 typedef struct {
-	const char* fileName;
-	int* outFontID;
+	char* fileName;
+	int fontID;
 
 	stbtt_pack_range packRange; // in case stuff changes while loading the font
 
@@ -323,31 +374,27 @@ static void cleanUpLoadFontTaskData( LoadFontData* data )
 	mem_Release( data->packRange.chardata_for_range );
 	mem_Release( data->packRange.array_of_unicode_codepoints );
 	mem_Release( data->bmpBuffer );
+	mem_Release( data->fileName );
 
 	mem_Release( data );
 }
 
-static void bindFontTask( void* data )
+static void bindFont( void* data, bool loaded )
 {
-	int newFont = 0;
 	Vector2* mins = NULL;
 	Vector2* maxes = NULL;
 	int* retIDs = NULL;
-	LoadFontData* fontData = NULL;
+	LoadFontData* fontData = (LoadFontData*)data;
+	Font* font = &( fonts[fontData->fontID] );
 
-	if( data == NULL ) {
-		llog( LOG_ERROR, "NULL data passed to bindFontTask." );
+	if( font->loadState == LOAD_STATE_CANCELLED ) {
+		// everything that wanted it was unloaded while it was loading
+		font->loadState = LOAD_STATE_NONE;
 		goto clean_up;
 	}
-	fontData = (LoadFontData*)data;
 
-	// find an unused font ID
-	while( fonts[newFont].glyphsBuffer != NULL ) {
-		++newFont;
-	}
-	if( newFont >= MAX_FONTS ) {
-		llog( LOG_ERROR, "Unable to find empty font to use for %s", fontData->fileName );
-		goto clean_up;
+	if( !loaded ) {
+		goto failure;
 	}
 
 	// got the data, bind the images and create the font
@@ -356,9 +403,8 @@ static void bindFontTask( void* data )
 	maxes = mem_Allocate( sizeof( Vector2 ) * fontData->packRange.num_chars );
 	retIDs = mem_Allocate( sizeof( int ) * fontData->packRange.num_chars );
 	if( ( mins == NULL ) || ( maxes == NULL ) || ( retIDs == NULL ) ) {
-		newFont = -1;
 		llog( LOG_ERROR, "Unable to allocate image data for %s", fontData->fileName );
-		goto clean_up;
+		goto failure;
 	}
 
 	// extract all the rectangles so we can split the image correctly
@@ -371,33 +417,32 @@ static void bindFontTask( void* data )
 
 	// create the images for the glyphs and record everything
 	//  clamp to either on or off
-	fonts[newFont].packageID = img_SplitAlphaBitmap( fontData->bmpBuffer, fontData->bmpWidth, fontData->bmpHeight,
+	font->packageID = img_SplitAlphaBitmap( fontData->bmpBuffer, fontData->bmpWidth, fontData->bmpHeight,
 		fontData->packRange.num_chars, ST_ALPHA_ONLY, GL_NEAREST, mins, maxes, retIDs );
-	if( fonts[newFont].packageID < 0 ) {
+	if( font->packageID < 0 ) {
 		llog( LOG_ERROR, "Unable to split images for font %s", fontData->fileName );
-		newFont = -1;
-		goto clean_up;
+		goto failure;
 	}
 
-	sb_Add( fonts[newFont].glyphsBuffer, fontData->packRange.num_chars );
-	if( fonts[newFont].glyphsBuffer == NULL ) {
-		newFont = -1;
+	sb_Add( font->glyphsBuffer, fontData->packRange.num_chars );
+	if( font->glyphsBuffer == NULL ) {
 		llog( LOG_ERROR, "Unable to allocate glyphs for %s", fontData->fileName );
-		goto clean_up;
+		img_CleanPackage( font->packageID );
+		goto failure;
 	}
 
-	fonts[newFont].ascent = fontData->ascent;
-	fonts[newFont].descent = fontData->descent;
-	fonts[newFont].lineGap = fontData->lineGap;
-	fonts[newFont].nextLineDescent = fontData->nextLineDescent;
+	font->ascent = fontData->ascent;
+	font->descent = fontData->descent;
+	font->lineGap = fontData->lineGap;
+	font->nextLineDescent = fontData->nextLineDescent;
 
 	for( int i = 0; i < fontData->packRange.num_chars; ++i ) {
-		fonts[newFont].glyphsBuffer[i].codepoint = fontData->packRange.array_of_unicode_codepoints[i];
-		fonts[newFont].glyphsBuffer[i].imageID = retIDs[i];
-		fonts[newFont].glyphsBuffer[i].advance = fontData->packRange.chardata_for_range[i].xadvance;
+		font->glyphsBuffer[i].codepoint = fontData->packRange.array_of_unicode_codepoints[i];
+		font->glyphsBuffer[i].imageID = retIDs[i];
+		font->glyphsBuffer[i].advance = fontData->packRange.chardata_for_range[i].xadvance;
 
-		if( fonts[newFont].glyphsBuffer[i].codepoint == missingChar ) {
-			fonts[newFont].missingCharGlyphIdx = i;
+		if( font->glyphsBuffer[i].codepoint == missingChar ) {
+			font->missingCharGlyphIdx = i;
 		}
 
 		// set the offset for each glyph, the x0, y0, x1, and y1 of the quad determines the coordinates of the rectangle to use to render
@@ -412,9 +457,14 @@ static void bindFontTask( void* data )
 		offset.y = ( quad.y0 + quad.y1 ) / 2.0f;
 		img_SetOffset( retIDs[i], offset );
 	}
+	buildGlyphMap( font );
 
-	// all done, set our new font
-	(*(fontData->outFontID)) = newFont;
+	font->loadState = LOAD_STATE_NONE;
+	goto clean_up;
+
+failure:
+	llog( LOG_ERROR, "Unable to bind font %s", fontData->fileName );
+	font->loadState = LOAD_STATE_FAILED;
 
 clean_up:
 	mem_Release( mins );
@@ -424,14 +474,11 @@ clean_up:
 	cleanUpLoadFontTaskData( fontData );
 }
 
-static void loadFontTask( void* data )
+static bool loadFontTask( void* data )
 {
 	uint8_t* buffer = NULL;
 	SDL_RWops* rwopsFile = NULL;
-
-	if( data == NULL ) {
-		return;
-	}
+	bool success = false;
 
 	LoadFontData* fontData = (LoadFontData*)data;
 
@@ -440,13 +487,13 @@ static void loadFontTask( void* data )
 	buffer = mem_Allocate( bufferSize * sizeof( uint8_t ) ); // megabyte sized buffer, should never load a file larger than this
 	if( buffer == NULL ) {
 		llog( LOG_WARN, "Error allocating font data buffer for %s", fontData->fileName );
-		goto failure;
+		goto clean_up;
 	}
 
-	rwopsFile = SDL_RWFromFile( fontData->fileName, "r" );
+	rwopsFile = assetPack_OpenFile( fontData->fileName );
 	if( rwopsFile == NULL ) {
 		llog( LOG_ERROR, "Error opening font file %s", fontData->fileName );
-		goto failure;
+		goto clean_up;
 	}
 
 	size_t numRead = SDL_RWread( rwopsFile, (void*)buffer, sizeof( uint8_t ), bufferSize );
@@ -476,51 +523,65 @@ static void loadFontTask( void* data )
 	fontData->bmpBuffer = mem_Allocate( sizeof( unsigned char ) * fontData->bmpWidth * fontData->bmpHeight ); // the 4 allows room for expansion
 	if( fontData->bmpBuffer == NULL ) {
 		llog( LOG_ERROR, "Unable to allocate bitmap memory for %s", fontData->fileName );
-		goto failure;
+		goto clean_up;
 	}
 	// TODO: Test oversampling
 	if( !stbtt_PackBegin( &packContext, fontData->bmpBuffer, fontData->bmpWidth, fontData->bmpHeight, 0, 1, NULL ) ) {
 		llog( LOG_ERROR, "Unable to begin packing ranges for %s", fontData->fileName );
-		goto failure;
+		goto clean_up;
 	}
 
 	int wasPacked = stbtt_PackFontRanges( &packContext, (unsigned char*)buffer, 0, &( fontData->packRange ), 1 );
 	stbtt_PackEnd( &packContext );
 	if( !wasPacked ) {
 		llog( LOG_ERROR, "Unable to pack ranges for %s", fontData->fileName );
-		goto failure;
-	}
-
-	if( !jq_AddMainThreadJob( bindFontTask, data ) ) {
-		goto failure;
-	} else {
 		goto clean_up;
 	}
 
-failure:
-	cleanUpLoadFontTaskData( fontData );
+	success = true;
 
 clean_up:
 	mem_Release( buffer );
-	SDL_RWclose( rwopsFile );
+	if( rwopsFile != NULL ) {
+		SDL_RWclose( rwopsFile );
+	}
+	return success;
 }
 
-// Loads the font at file name on a seperate thread. Uses a height of pixelHeight.
-// This will initialize a bunch of stuff but not do any of the loading.
-//  Puts the resulting font ID into outFontID.
-void txt_ThreadedLoadFont( const char* fileName, float pixelHeight, int* outFontID )
+// Streams the font at file name in the background. Uses a height of pixelHeight.
+//  The returned ID can be used right away, until the font is loaded the placeholder font is used in its place. If the
+//  font is already loaded or loading a reference is added and it's returned, the same as txt_LoadFont.
+int txt_ThreadedLoadFont( const char* fileName, float pixelHeight, LoadPriority priority )
 {
-	(*outFontID) = -1;
+	int fontID;
+	Symbol key = fontKey( fileName, pixelHeight );
+	if( assetCache_AddRef( &fontCache, key, &fontID ) ) {
+		return fontID;
+	}
+
+	fontID = findUnusedFontID( );
+	if( fontID < 0 ) {
+		llog( LOG_ERROR, "Unable to find empty font to use for %s", fileName );
+		return -1;
+	}
 
 	LoadFontData* data = mem_Allocate( sizeof( LoadFontData ) );
 	if( data == NULL ) {
 		llog( LOG_WARN, "Unable to create data for threaded font load for file %s", fileName );
-		return;
+		return -1;
 	}
+	memset( data, 0, sizeof( LoadFontData ) );
 
 	// initalize all the data we'll need
-	data->fileName = fileName;
-	data->outFontID = outFontID;
+	size_t fileNameLen = strlen( fileName );
+	data->fileName = mem_Allocate( fileNameLen + 1 );
+	if( data->fileName == NULL ) {
+		llog( LOG_WARN, "Unable to create file name storage for threaded font load for file %s", fileName );
+		cleanUpLoadFontTaskData( data );
+		return -1;
+	}
+	memcpy( data->fileName, fileName, fileNameLen + 1 );
+	data->fontID = fontID;
 
 	data->packRange.font_size = pixelHeight;
 	data->packRange.num_chars = fontPackRange.num_chars;
@@ -530,34 +591,84 @@ void txt_ThreadedLoadFont( const char* fileName, float pixelHeight, int* outFont
 
 	size_t codePointsSize = sizeof( data->packRange.array_of_unicode_codepoints[0] ) * sb_Count( fontPackRange.array_of_unicode_codepoints );
 	data->packRange.array_of_unicode_codepoints = mem_Allocate( codePointsSize );
+	if( ( data->packRange.chardata_for_range == NULL ) || ( data->packRange.array_of_unicode_codepoints == NULL ) ) {
+		llog( LOG_WARN, "Unable to create glyph storage for threaded font load for file %s", fileName );
+		cleanUpLoadFontTaskData( data );
+		return -1;
+	}
 	memcpy( data->packRange.array_of_unicode_codepoints, fontPackRange.array_of_unicode_codepoints, codePointsSize );
 
-	data->bmpBuffer = NULL;
-
-	if( !jq_AddJob( loadFontTask, data ) ) {
+	if( !lq_Add( priority, fileName, loadFontTask, bindFont, data ) ) {
 		cleanUpLoadFontTaskData( data );
+		return -1;
 	}
+
+	// reserve the font so it can be used until the load is done
+	fonts[fontID].baseSize = (int)pixelHeight;
+	fonts[fontID].key = key;
+	fonts[fontID].loadState = LOAD_STATE_PENDING;
+	assetCache_Store( &fontCache, key, fontID );
+
+	return fontID;
+}
+
+void txt_SetPlaceholderFont( int fontID )
+{
+	placeholderFont = fontID;
+}
+
+// gets the font to actually display with, fonts that are still loading use the placeholder, returns -1 if there's
+//  nothing to display with
+static int resolveFont( int fontID )
+{
+	if( ( fontID < 0 ) || ( fonts[fontID].loadState == LOAD_STATE_NONE ) ) {
+		return fontID;
+	}
+
+	if( ( placeholderFont < 0 ) || ( fonts[placeholderFont].loadState != LOAD_STATE_NONE ) ) {
+		return -1;
+	}
+
+	return placeholderFont;
 }
 
 void txt_UnloadFont( int fontID )
 {
 	assert( fontID >= 0 );
 
+	if( fonts[fontID].loadState == LOAD_STATE_CANCELLED ) {
+		return;
+	}
+
+	if( !assetCache_Release( &fontCache, fonts[fontID].key, fontID ) ) {
+		return;
+	}
+	fonts[fontID].key = INVALID_SYMBOL;
+
+	if( fonts[fontID].loadState == LOAD_STATE_PENDING ) {
+		// the slot is still needed for the load, it's freed when the load finishes
+		fonts[fontID].loadState = LOAD_STATE_CANCELLED;
+		return;
+	}
+
+	if( fonts[fontID].loadState == LOAD_STATE_FAILED ) {
+		// nothing was created for it
+		fonts[fontID].loadState = LOAD_STATE_NONE;
+		return;
+	}
+
 	sb_Release( fonts[fontID].glyphsBuffer );
 	fonts[fontID].glyphsBuffer = NULL;
+	glyphMap_Clear( &( fonts[fontID].glyphMap ) );
 	img_CleanPackage( fonts[fontID].packageID );
 }
 
 Glyph* getCodepointGlyph( int fontID, int codepoint )
 {
 	Font* font = &( fonts[fontID] );
-	Glyph* out = NULL;
-	int glyphCount = sb_Count( font->glyphsBuffer );
-	// TODO: Make this faster
-	for( int i = 0; i < glyphCount; ++i ) {
-		if( font->glyphsBuffer[i].codepoint == codepoint ) {
-			return &( font->glyphsBuffer[i] );
-		}
+	int glyphIdx;
+	if( glyphMap_Find( &( font->glyphMap ), codepoint, &glyphIdx ) ) {
+		return &( font->glyphsBuffer[glyphIdx] );
 	}
 	return &( font->glyphsBuffer[ font->missingCharGlyphIdx ] );
 }
@@ -672,6 +783,7 @@ void txt_DisplayString( const char* utf8Str, Vector2 pos, Color clr, HorizTextAl
 {
 	assert( utf8Str != NULL );
 
+	fontID = resolveFont( fontID );
 	if( fontID < 0 ) return;
 
 	float scale = desiredPixelSize / fonts[fontID].baseSize;
@@ -747,6 +859,7 @@ bool txt_DisplayTextArea( const uint8_t* utf8Str, Vector2 upperLeft, Vector2 siz
 {
 	assert( utf8Str != NULL );
 
+	fontID = resolveFont( fontID );
 	if( fontID < 0 ) {
 		return false;
 	}
@@ -1048,7 +1161,7 @@ static int loadSDFFont( const char* fileName )
 	strcpy( fontFileName, fileName );
 	strcat( fontFileName, sdfFontExtension );
 
-	SDL_RWops* rwopsFile = SDL_RWFromFile( fontFileName, "r" );
+	SDL_RWops* rwopsFile = assetPack_OpenFile( fontFileName );
 	if( rwopsFile == NULL ) {
 		llog( LOG_WARN, "Unable to open sdf font for %s", fileName );
 		return -1;
@@ -1181,6 +1294,7 @@ static int loadSDFFont( const char* fileName )
 			fonts[fontID].missingCharGlyphIdx = i;
 		}
 	}
+	buildGlyphMap( &( fonts[fontID] ) );
 
 clean_up:
 
@@ -1202,9 +1316,7 @@ clean_up:
 	return fontID;
 }
 
-// Creates a font that's rendered out as a signed distance field. Will also attempt to save a version of this font that
-//  can be loaded later much quicker.
-int txt_CreateSDFFont( const char* fileName )
+static int createSDFFont( const char* fileName )
 {
 	/*
 	int font = loadSDFFont( fileName );
@@ -1263,7 +1375,7 @@ int txt_CreateSDFFont( const char* fileName )
 	buffer = mem_Allocate( bufferSize * sizeof( uint8_t ) ); // megabyte sized buffer, should never load a file larger than this
 	CHECK_POINTER( buffer, "Error allocating font data buffer" );
 
-	SDL_RWops* rwopsFile = SDL_RWFromFile( fileName, "r" );
+	SDL_RWops* rwopsFile = assetPack_OpenFile( fileName );
 	CHECK_POINTER( rwopsFile, "Error opening file" );
 
 	size_t numRead = SDL_RWread( rwopsFile, (void*)buffer, sizeof( uint8_t ), bufferSize );
@@ -1390,6 +1502,7 @@ int txt_CreateSDFFont( const char* fileName )
 		}
 	}
 	fonts[newFont].glyphsBuffer = sbGlyphStorage;
+	buildGlyphMap( &( fonts[newFont] ) );
 
 	// save out the font so next time we can load it faster
 	LoadedImage fontImg;
@@ -1428,6 +1541,24 @@ clean_up:
 #undef OUT_ERROR
 }
 
+// Creates a font that's rendered out as a signed distance field. Will also attempt to save a version of this font that
+//  can be loaded later much quicker. If the font has already been created a reference is added and it's returned.
+int txt_CreateSDFFont( const char* fileName )
+{
+	int fontID;
+	Symbol key = assetCache_MakeKey( fileName, "sdf" );
+	if( assetCache_AddRef( &fontCache, key, &fontID ) ) {
+		return fontID;
+	}
+
+	fontID = createSDFFont( fileName );
+	if( fontID >= 0 ) {
+		fonts[fontID].key = key;
+		assetCache_Store( &fontCache, key, fontID );
+	}
+	return fontID;
+}
+
 int txt_GetBaseSize( int fontID )
 {
 	assert( fontID >= 0 );
@@ -5,6 +5,7 @@
 
 #include "../Graphics/color.h"
 #include "../Math/vector2.h"
+#include "../System/loadQueue.h"
 
 typedef enum {
 	HORIZ_ALIGN_LEFT,
@@ -30,13 +31,18 @@ int txt_GetBaseSize( int fontID );
 //  display this codepoint if it had not previously been added.
 void txt_AddCharacterToLoad( int c );
 
-// Loads the font at fileName, with a height of pixelHeight.
+// Loads the font at fileName, with a height of pixelHeight. If the font has already been loaded at that size a reference
+//  is added and it's returned, every load has to be matched by a txt_UnloadFont.
 //  Returns an ID to be used when displaying a string, returns -1 if there was an issue.
 int txt_LoadFont( const char* fileName, int pixelHeight );
 
-// Loads the font at file name on a seperate thread. Uses a height of pixelHeight.
-//  Puts the resulting font ID into outFontID
-void txt_ThreadedLoadFont( const char* fileName, float pixelHeight, int* outFontID );
+// Streams the font at file name in the background. Uses a height of pixelHeight. The returned ID can be used right away,
+//  until the font is loaded the placeholder font is used to display anything using it. If the font is already loaded or
+//  loading a reference to it is added instead. Returns -1 if the load couldn't be started.
+int txt_ThreadedLoadFont( const char* fileName, float pixelHeight, LoadPriority priority );
+
+// Sets the font used in place of any font that's still loading or failed to load, -1 displays nothing instead.
+void txt_SetPlaceholderFont( int fontID );
 
 // Frees up the font specified by fontID.
 void txt_UnloadFont( int fontID );
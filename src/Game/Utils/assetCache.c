@@ -0,0 +1,79 @@
+#include "assetCache.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+
+TYPED_HASH_MAP_DEFINE( AssetCacheMap, assetCacheMap, Symbol, AssetCacheEntry, HASH_MAP_HASH_U32, HASH_MAP_EQUALS_VALUE )
+
+void assetCache_Init( AssetCache* cache, uint32_t estimatedSize )
+{
+	assert( cache != NULL );
+	assetCacheMap_Init( &( cache->map ), estimatedSize );
+}
+
+Symbol assetCache_MakeKey( const char* fileName, const char* variantFormat, ... )
+{
+	assert( fileName != NULL );
+	assert( variantFormat != NULL );
+
+	char key[512];
+	int len = snprintf( key, sizeof( key ), "%s#", fileName );
+	if( ( len < 0 ) || ( len >= (int)sizeof( key ) ) ) {
+		return sym_Intern( fileName );
+	}
+
+	va_list args;
+	va_start( args, variantFormat );
+	vsnprintf( key + len, sizeof( key ) - (size_t)len, variantFormat, args );
+	va_end( args );
+
+	return sym_Intern( key );
+}
+
+bool assetCache_AddRef( AssetCache* cache, Symbol key, int* outIdx )
+{
+	assert( cache != NULL );
+	assert( outIdx != NULL );
+
+	AssetCacheEntry* entry = assetCacheMap_Get( &( cache->map ), key );
+	if( entry == NULL ) {
+		return false;
+	}
+
+	++entry->refCount;
+	(*outIdx) = entry->index;
+	return true;
+}
+
+void assetCache_Store( AssetCache* cache, Symbol key, int idx )
+{
+	assert( cache != NULL );
+	assert( idx >= 0 );
+
+	if( key == INVALID_SYMBOL ) {
+		return;
+	}
+
+	assert( assetCacheMap_Get( &( cache->map ), key ) == NULL );
+
+	AssetCacheEntry newEntry = { idx, 1 };
+	assetCacheMap_Set( &( cache->map ), key, newEntry );
+}
+
+bool assetCache_Release( AssetCache* cache, Symbol key, int idx )
+{
+	assert( cache != NULL );
+
+	AssetCacheEntry* entry = assetCacheMap_Get( &( cache->map ), key );
+	if( ( entry == NULL ) || ( entry->index != idx ) ) {
+		return true;
+	}
+
+	--entry->refCount;
+	if( entry->refCount > 0 ) {
+		return false;
+	}
+
+	assetCacheMap_Remove( &( cache->map ), key );
+	return true;
+}
@@ -0,0 +1,56 @@
+#ifndef ASSET_CACHE_H
+#define ASSET_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "symbols.h"
+#include "typedHashMap.h"
+
+/*
+Reference counted lookup of loaded assets by key, used so the same file is only ever loaded once. Each system that loads
+ assets has its own cache, the cache only stores the index the system uses for the asset, the system still owns the
+ asset itself.
+Threaded loads reserve their index when they're requested and are stored then, so any request for the same key while
+ it's loading gets the same index.
+Only meant to be used from the main thread.
+*/
+
+typedef struct {
+	int index;
+	int refCount;
+} AssetCacheEntry;
+
+TYPED_HASH_MAP_DECLARE( AssetCacheMap, assetCacheMap, Symbol, AssetCacheEntry )
+
+typedef struct {
+	AssetCacheMap map;
+} AssetCache;
+
+void assetCache_Init( AssetCache* cache, uint32_t estimatedSize );
+
+/*
+Builds the key for an asset that can be loaded with different settings, e.g. a font at different sizes, so each one
+ is stored separately.
+*/
+Symbol assetCache_MakeKey( const char* fileName, const char* variantFormat, ... );
+
+/*
+If the asset is loaded or loading adds a reference to it and puts its index in outIdx.
+ Returns whether the asset was found.
+*/
+bool assetCache_AddRef( AssetCache* cache, Symbol key, int* outIdx );
+
+/*
+Records the asset after it's been loaded or reserved for a threaded load, with one reference.
+*/
+void assetCache_Store( AssetCache* cache, Symbol key, int idx );
+
+/*
+Removes a reference to the asset.
+ Returns true if that was the last reference and the caller should actually release the asset. Assets that were never
+ stored in the cache always return true.
+*/
+bool assetCache_Release( AssetCache* cache, Symbol key, int idx );
+
+#endif /* inclusion guard */
@@ -0,0 +1,169 @@
+#include "assetPack.h"
+
+#include <SDL.h>
+#include <string.h>
+#include <assert.h>
+
+#include "assetPackFormat.h"
+#include "mappedFile.h"
+#include "../System/platformLog.h"
+
+typedef struct {
+	MappedFile file;
+
+	const AssetPackHeader* header;
+	const AssetPackEntry* table;
+	const char* names;
+} MountedPack;
+
+static MountedPack pack = { 0 };
+
+static void closePack( void )
+{
+	mappedFile_Close( &( pack.file ) );
+	memset( &pack, 0, sizeof( pack ) );
+}
+
+// makes sure everything in the table of contents is inside the pack, so nothing needs to be checked when it's used
+static bool validatePack( void )
+{
+	const uint8_t* base = pack.file.data;
+	size_t size = pack.file.size;
+
+	if( size < sizeof( AssetPackHeader ) ) {
+		return false;
+	}
+
+	const AssetPackHeader* header = (const AssetPackHeader*)base;
+	if( ( header->magic != ASSET_PACK_MAGIC ) || ( header->version != ASSET_PACK_VERSION ) ) {
+		return false;
+	}
+
+	if( ( header->tableSize == 0 ) || ( ( header->tableSize & ( header->tableSize - 1 ) ) != 0 ) ||
+		( header->numEntries > header->tableSize ) ) {
+		return false;
+	}
+
+	uint64_t tableEnd = sizeof( AssetPackHeader ) + ( (uint64_t)header->tableSize * sizeof( AssetPackEntry ) );
+	if( ( tableEnd > size ) || ( header->namesOffset < tableEnd ) ||
+		( ( header->namesOffset + header->namesSize ) > size ) ) {
+		return false;
+	}
+
+	const AssetPackEntry* table = (const AssetPackEntry*)( base + sizeof( AssetPackHeader ) );
+	const char* names = (const char*)( base + header->namesOffset );
+	for( uint32_t i = 0; i < header->tableSize; ++i ) {
+		if( table[i].nameLength == 0 ) {
+			continue;
+		}
+
+		// names have to be null terminated inside the name block
+		if( ( table[i].nameOffset + table[i].nameLength ) >= header->namesSize ) {
+			return false;
+		}
+		if( names[table[i].nameOffset + table[i].nameLength] != 0 ) {
+			return false;
+		}
+
+		if( ( table[i].dataOffset > size ) || ( table[i].dataSize > ( size - table[i].dataOffset ) ) ) {
+			return false;
+		}
+	}
+
+	pack.header = header;
+	pack.table = table;
+	pack.names = names;
+
+	return true;
+}
+
+int assetPack_Mount( const char* fileName )
+{
+	assert( fileName != NULL );
+
+	assetPack_Unmount( );
+
+	if( !mappedFile_Open( fileName, &( pack.file ) ) ) {
+		llog( LOG_INFO, "Unable to open asset pack %s, using loose files.", fileName );
+		closePack( );
+		return -1;
+	}
+
+	if( !validatePack( ) ) {
+		llog( LOG_ERROR, "Asset pack %s is invalid, using loose files.", fileName );
+		closePack( );
+		return -1;
+	}
+
+	llog( LOG_INFO, "Mounted asset pack %s with %u files.", fileName, pack.header->numEntries );
+	return 0;
+}
+
+void assetPack_Unmount( void )
+{
+	closePack( );
+}
+
+bool assetPack_IsMounted( void )
+{
+	return ( pack.header != NULL );
+}
+
+bool assetPack_GetFile( const char* fileName, const uint8_t** outData, size_t* outSize )
+{
+	assert( fileName != NULL );
+	assert( outData != NULL );
+	assert( outSize != NULL );
+
+	if( pack.header == NULL ) {
+		return false;
+	}
+
+	char name[ASSET_PACK_MAX_NAME_LENGTH];
+	uint32_t nameLength = assetPack_NormalizeName( fileName, name, sizeof( name ) );
+	if( nameLength == 0 ) {
+		return false;
+	}
+
+	uint32_t hash = assetPack_HashName( name );
+	uint32_t mask = pack.header->tableSize - 1;
+	for( uint32_t probe = 0; probe < pack.header->tableSize; ++probe ) {
+		const AssetPackEntry* entry = &( pack.table[( hash + probe ) & mask] );
+		if( entry->nameLength == 0 ) {
+			// hit an empty slot, it's not in here
+			return false;
+		}
+
+		if( ( entry->hash == hash ) && ( entry->nameLength == nameLength ) &&
+			( memcmp( pack.names + entry->nameOffset, name, nameLength ) == 0 ) ) {
+			(*outData) = pack.file.data + entry->dataOffset;
+			(*outSize) = (size_t)entry->dataSize;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+SDL_RWops* assetPack_OpenFile( const char* fileName )
+{
+	const uint8_t* data;
+	size_t size;
+	if( assetPack_GetFile( fileName, &data, &size ) ) {
+		return SDL_RWFromConstMem( data, (int)size );
+	}
+
+	return SDL_RWFromFile( fileName, "rb" );
+}
+
+bool assetPack_MapFile( const char* fileName, MappedFile* outFile )
+{
+	const uint8_t* data;
+	size_t size;
+	if( assetPack_GetFile( fileName, &data, &size ) ) {
+		mappedFile_View( data, size, outFile );
+		return true;
+	}
+
+	return mappedFile_Open( fileName, outFile );
+}
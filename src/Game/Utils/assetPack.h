@@ -0,0 +1,52 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <SDL_rwops.h>
+
+#include "mappedFile.h"
+
+/*
+Reads assets out of a single packed file built by the AssetPacker tool instead of opening each file on its own. The pack
+ is memory mapped where we can, so getting a file out of it is just a look up in the table of contents and the data can
+ be used directly without any copies. On platforms where it can't be mapped it's read into memory in one go.
+Anything that isn't in the pack, or everything if no pack is mounted, falls back to the loose files so the packed and
+ unpacked data can be used interchangeably.
+Once mounted it's only read from, so it's safe to use from the loading threads.
+*/
+
+/*
+Mounts the pack, replacing any that was already mounted.
+ Returns < 0 if the pack couldn't be opened or isn't valid, the loose files are used instead.
+*/
+int assetPack_Mount( const char* fileName );
+
+/*
+Unmounts the pack, any views into it are invalid after this.
+*/
+void assetPack_Unmount( void );
+
+bool assetPack_IsMounted( void );
+
+/*
+Gets a view of the file stored in the pack, it stays valid until the pack is unmounted.
+ Returns false if no pack is mounted or the file isn't in it.
+*/
+bool assetPack_GetFile( const char* fileName, const uint8_t** outData, size_t* outSize );
+
+/*
+Opens the file for reading, from the pack if it's in there, otherwise from the loose file.
+ Returns NULL if the file couldn't be found in either.
+*/
+SDL_RWops* assetPack_OpenFile( const char* fileName );
+
+/*
+Gets the whole file at once, a view into the pack if it's in there, otherwise the loose file is mapped. Has to be
+ closed with mappedFile_Close.
+ Returns false if the file couldn't be found in either or is empty.
+*/
+bool assetPack_MapFile( const char* fileName, MappedFile* outFile );
+
+#endif /* inclusion guard */
@@ -0,0 +1,32 @@
+#include "assetPackFormat.h"
+
+uint32_t assetPack_HashName( const char* name )
+{
+	uint32_t hash = 0x811C9DC5;
+	while( *name != 0 ) {
+		hash ^= (uint8_t)( *name );
+		hash *= 0x01000193;
+		++name;
+	}
+	return hash;
+}
+
+uint32_t assetPack_NormalizeName( const char* name, char* out, uint32_t outSize )
+{
+	// loose file paths will sometimes start with ./ but nothing stored in the pack will
+	while( ( name[0] == '.' ) && ( ( name[1] == '/' ) || ( name[1] == '\\' ) ) ) {
+		name += 2;
+	}
+
+	uint32_t len = 0;
+	while( name[len] != 0 ) {
+		if( ( len + 1 ) >= outSize ) {
+			return 0;
+		}
+		out[len] = ( name[len] == '\\' ) ? '/' : name[len];
+		++len;
+	}
+	out[len] = 0;
+
+	return len;
+}
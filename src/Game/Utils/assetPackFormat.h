@@ -0,0 +1,47 @@
+#ifndef ASSET_PACK_FORMAT_H
+#define ASSET_PACK_FORMAT_H
+
+#include <stdint.h>
+
+/*
+Layout of the asset pack, shared between the game and the AssetPacker tool so it doesn't need anything else from the
+ game to build.
+ header
+ table of contents, tableSize entries, an open addressed hash table keyed on the hash of the file name
+ names, each null terminated
+ file data, each file starts on an ASSET_PACK_ALIGNMENT boundary
+All offsets are from the start of the pack. Everything is stored little endian, which is all we run on.
+File names are stored relative to the directory that was packed, using '/' as the separator. Look ups should go
+ through assetPack_NormalizeName first so they match.
+Doesn't use anything from SDL so the tool can be built with just this.
+*/
+
+#define ASSET_PACK_MAGIC 0x4B50444C // "LDPK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_ALIGNMENT 16
+#define ASSET_PACK_MAX_NAME_LENGTH 256
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t numEntries;
+	uint32_t tableSize; // always a power of two
+	uint64_t namesOffset;
+	uint64_t namesSize;
+} AssetPackHeader;
+
+typedef struct {
+	uint32_t hash;
+	uint32_t nameLength; // 0 if the slot is empty
+	uint64_t nameOffset;
+	uint64_t dataOffset;
+	uint64_t dataSize;
+} AssetPackEntry;
+
+// FNV-1a of the name, the names are short so there's no need for anything fancier
+uint32_t assetPack_HashName( const char* name );
+
+// copies the name to out converting the separators, returns the length or 0 if it won't fit
+uint32_t assetPack_NormalizeName( const char* name, char* out, uint32_t outSize );
+
+#endif /* inclusion guard */
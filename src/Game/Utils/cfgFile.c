@@ -5,25 +5,97 @@
 
 #include "../Utils/stretchyBuffer.h"
 #include "helpers.h"
+#include "symbols.h"
+#include "mappedFile.h"
+#include "tokenizer.h"
 
 #include "../System/platformLog.h"
+#include "../System/fileWatcher.h"
 
 // TODO: make this better overall, this is just a quick hack to test some stuff
 
-#define READ_BUFFER_SIZE 512
 #define FILE_PATH_LEN 128
 
+#define ATTR_NAME_LEN 64
+
 typedef struct {
-	char fileName[64];
+	char fileName[ATTR_NAME_LEN];
+	Symbol lookupName; // lower case version of the name, attribute names aren't case sensitive
 	int value;
 } CFGAttribute;
 
 typedef struct {
 	char filePath[FILE_PATH_LEN];
 	CFGAttribute* sbAttributes;
+
+	int watchID;
+	CfgChangedFunc onChanged;
+	void* changedData;
 } CFGFile;
 
-// opens the file, returns NULL if it fails.
+// attribute names are case insensitive, so we match on the symbol of the lower case version of the name
+static Symbol lookupSymbol( const char* attrName, bool intern )
+{
+	char lower[ATTR_NAME_LEN];
+	size_t i;
+	for( i = 0; ( i < ( ATTR_NAME_LEN - 1 ) ) && ( attrName[i] != 0 ); ++i ) {
+		lower[i] = (char)SDL_tolower( attrName[i] );
+	}
+	lower[i] = 0;
+
+	return intern ? sym_Intern( lower ) : sym_Find( lower );
+}
+
+// reads in all the attributes in the file, if the file doesn't exist there are no attributes
+static void parseFile( CFGFile* file )
+{
+	// the game writes these back out, so always use the loose file even if there's one in the asset pack
+	MappedFile mappedFile;
+	if( !mappedFile_Open( file->filePath, &mappedFile ) ) {
+		return;
+	}
+
+	// each line is the attribute name and then the value, separated by '=', any white space around them is ignored
+	const char* delimiters = "\f\v\t =";
+	Tokenizer tok;
+	tok_Init( &tok, (const char*)mappedFile.data, mappedFile.size );
+
+	StringSlice line;
+	while( tok_NextLine( &tok, &line ) ) {
+		StringSlice rest = line;
+		StringSlice name, value;
+		if( !tok_NextToken( &rest, delimiters, &name ) ) {
+			continue;
+		}
+
+		CFGAttribute attr;
+		if( !tok_NextToken( &rest, delimiters, &value ) || !tok_ToInt( value, &( attr.value ) ) ) {
+			llog( LOG_WARN, "Invalid attribute \"%.*s\" in configuration file %s", (int)line.length, line.start, file->filePath );
+			continue;
+		}
+
+		tok_Copy( name, attr.fileName, sizeof( attr.fileName ) );
+		attr.lookupName = lookupSymbol( attr.fileName, true );
+		sb_Push( file->sbAttributes, attr );
+		llog( LOG_INFO, "New attribute: %s  %i", attr.fileName, attr.value );
+	}
+
+	mappedFile_Close( &mappedFile );
+}
+
+static void fileChanged( const char* fileName, void* data )
+{
+	CFGFile* file = (CFGFile*)data;
+
+	sb_Clear( file->sbAttributes );
+	parseFile( file );
+
+	if( file->onChanged != NULL ) {
+		file->onChanged( file, file->changedData );
+	}
+}
+
+// opens the file, returns NULL if it fails. The file is watched and read in again whenever it changes.
 void* cfg_OpenFile( const char* fileName )
 {
 	if( SDL_strlen( fileName ) >= ( FILE_PATH_LEN - 1 ) ) {
@@ -37,60 +109,26 @@ void* cfg_OpenFile( const char* fileName )
 		return NULL;
 	}
 	newFile->sbAttributes = NULL;
+	newFile->onChanged = NULL;
+	newFile->changedData = NULL;
 	SDL_strlcpy( newFile->filePath, fileName, FILE_PATH_LEN - 1 );
 	newFile->filePath[FILE_PATH_LEN-1] = 0;
 
-	SDL_RWops* rwopsFile = SDL_RWFromFile( fileName, "r" );
-	if( rwopsFile == NULL ) {
-		// file doesn't exist, just create a new empty configuration file to use
-		return newFile;
-	}
+	// if the file doesn't exist this just creates a new empty configuration file to use
+	parseFile( newFile );
 
-	// TODO: change this so everything is happening in place and there are no allocations
-	// parse what this configuration file currently has in it
-	char buffer[READ_BUFFER_SIZE];
-	size_t numRead;
-	char* fileText = NULL;
-	llog( LOG_INFO, "Stream size: %i", (int)SDL_RWsize( rwopsFile ) );
-	while( ( numRead = SDL_RWread( rwopsFile, (void*)buffer, sizeof( char ), sizeof( buffer ) ) ) != 0 ) {
-		char* c = sb_Add( fileText, (int)numRead );
-		for( size_t i = 0; i < numRead; ++i ) {
-			*c++ = buffer[i];
-		}
-	}
-	sb_Push( fileText, 0 ); // make this c-string compatible
-
-	// got the entire file text, now tokenize and parse
-	//  only tokens we're worried about are '=' and '/r/n'
-	//  everything before the '=' is the attribute name, everything
-	//  after is the attribute value, all white space should be cut
-	//  off of each end
-	int gettingAttrName = 1;
-	const char* delimiters = "\f\v\t =\r\n";
-	char* token = strtok( fileText, delimiters );
-	CFGAttribute attr;
-
-	while( token != NULL ) {
-
-		// cut off white space, don't care about preserving memory
-		if( gettingAttrName ) {
-			SDL_strlcpy( attr.fileName, token, sizeof( attr.fileName ) - 1 );
-			attr.fileName[sizeof( attr.fileName ) - 1] = 0;
-			gettingAttrName = 0;
-		} else {
-			attr.value = SDL_atoi( token );
-			sb_Push( newFile->sbAttributes, attr );
-			llog( LOG_INFO, "New attribute: %s  %i", attr.fileName, attr.value );
-			gettingAttrName = 1;
-		}
+	newFile->watchID = fw_Watch( newFile->filePath, fileChanged, newFile );
 
-		token = strtok( NULL, delimiters );
-	}
+	return newFile;
+}
 
-	sb_Release( fileText );
-	SDL_RWclose( rwopsFile );
+void cfg_SetChangedCallback( void* cfgFile, CfgChangedFunc onChanged, void* data )
+{
+	assert( cfgFile != NULL );
 
-	return newFile;
+	CFGFile* file = (CFGFile*)cfgFile;
+	file->onChanged = onChanged;
+	file->changedData = data;
 }
 
 // Saves out the file.
@@ -149,22 +187,27 @@ void cfg_CloseFile( void* cfgFile )
 {
 	assert( cfgFile != NULL );
 	CFGFile* data = (CFGFile*)cfgFile;
-	if( ( data == NULL ) || ( data->sbAttributes == NULL  ) ) {
+	if( data == NULL ) {
 		return;
 	}
 
+	fw_Unwatch( data->watchID );
 	sb_Release( data->sbAttributes );
 	mem_Release( data );
 }
 
 // Returns the index of the attribute given the name. Returns -1 if it isn't found.
-int AttributeIndex( CFGFile* fileData, const char* attrName )
+int AttributeIndex( CFGFile* fileData, Symbol lookupName )
 {
 	int idx = -1;
 
+	if( lookupName == INVALID_SYMBOL ) {
+		return idx;
+	}
+
 	size_t count = sb_Count( fileData->sbAttributes );
 	for( size_t i = 0; ( i < count ) && ( idx < 0 ); ++i ) {
-		if( SDL_strncasecmp( attrName, fileData->sbAttributes[i].fileName, sizeof( fileData->sbAttributes[i].fileName ) - 1 ) == 0 ) {
+		if( fileData->sbAttributes[i].lookupName == lookupName ) {
 			idx = (int)i;
 		}
 	}
@@ -176,6 +219,41 @@ int AttributeIndex( CFGFile* fileData, const char* attrName )
 //  attribute if it can't find it, and a spot to put the value if it does. Returns 0 if it finds the value, a
 //  negative number if it doesn't.
 int cfg_GetInt( void* cfgFile, const char* attrName, int defaultVal, int* retVal )
+{
+	// if the name was never interned then no file has it
+	return cfg_GetIntBySymbol( cfgFile, lookupSymbol( attrName, false ), defaultVal, retVal );
+}
+
+// If the attribute already exists it sets the associated value, if it doesn't exist it is added.
+void cfg_SetInt( void* cfgFile, const char* attrName, int val )
+{
+	assert( cfgFile != NULL );
+
+	CFGFile* data = (CFGFile*)cfgFile;
+
+	Symbol lookupName = lookupSymbol( attrName, true );
+	int idx = AttributeIndex( data, lookupName );
+	if( idx >= 0 ) {
+		data->sbAttributes[idx].value = val;
+	} else {
+		CFGAttribute newAttr;
+
+		SDL_strlcpy( newAttr.fileName, attrName, sizeof( newAttr.fileName ) - 1 );
+		newAttr.fileName[sizeof( newAttr.fileName ) - 1] = 0;
+		newAttr.lookupName = lookupName;
+		newAttr.value = val;
+
+		sb_Push( data->sbAttributes, newAttr );
+	}
+}
+
+Symbol cfg_AttributeSymbol( const char* attrName )
+{
+	assert( attrName != NULL );
+	return lookupSymbol( attrName, true );
+}
+
+int cfg_GetIntBySymbol( void* cfgFile, Symbol attrSymbol, int defaultVal, int* retVal )
 {
 	assert( cfgFile != NULL );
 
@@ -184,7 +262,7 @@ int cfg_GetInt( void* cfgFile, const char* attrName, int defaultVal, int* retVal
 	int result = defaultVal;
 	int ret = -1;
 
-	int idx = AttributeIndex( data, attrName );
+	int idx = AttributeIndex( data, attrSymbol );
 	if( idx >= 0 ) {
 		result = data->sbAttributes[idx].value;
 		ret = 0;
@@ -194,23 +272,24 @@ int cfg_GetInt( void* cfgFile, const char* attrName, int defaultVal, int* retVal
 	return ret;
 }
 
-// If the attribute already exists it sets the associated value, if it doesn't exist it is added.
-void cfg_SetInt( void* cfgFile, const char* attrName, int val )
+// new attributes are written out with the lower case name the symbol was made from
+void cfg_SetIntBySymbol( void* cfgFile, Symbol attrSymbol, int val )
 {
 	assert( cfgFile != NULL );
+	assert( attrSymbol != INVALID_SYMBOL );
 
 	CFGFile* data = (CFGFile*)cfgFile;
 
-	int idx = AttributeIndex( data, attrName );
+	int idx = AttributeIndex( data, attrSymbol );
 	if( idx >= 0 ) {
 		data->sbAttributes[idx].value = val;
 	} else {
 		CFGAttribute newAttr;
 
-		SDL_strlcpy( newAttr.fileName, attrName, sizeof( newAttr.fileName ) - 1 );
-		newAttr.fileName[sizeof( newAttr.fileName ) - 1] = 0;
+		SDL_strlcpy( newAttr.fileName, sym_GetString( attrSymbol ), sizeof( newAttr.fileName ) );
+		newAttr.lookupName = attrSymbol;
 		newAttr.value = val;
 
 		sb_Push( data->sbAttributes, newAttr );
 	}
-}
\ No newline at end of file
+}
@@ -1,14 +1,22 @@
 #ifndef CFG_PARSER_H
 #define CFG_PARSER_H
 
+#include "symbols.h"
+
 // quick and dirty cfg file parser
 //  simple format: 
 //   attrName = value
 //  each on it's own line, ignores white space
 
-// opens the file, returns NULL if it fails.
+// called after the file has been changed outside of the game and read in again
+typedef void (*CfgChangedFunc)( void* cfgFile, void* data );
+
+// opens the file, returns NULL if it fails. The file is watched and read in again whenever it changes.
 void* cfg_OpenFile( const char* fileName );
 
+// Sets the function called after the file has been read in again, so the values can be applied.
+void cfg_SetChangedCallback( void* cfgFile, CfgChangedFunc onChanged, void* data );
+
 // Closes the file and cleans up after it. Should always be called.
 void cfg_CloseFile( void* cfgFile );
 
@@ -23,4 +31,11 @@ int cfg_GetInt( void* cfgFile, const char* attrName, int defaultVal, int* retVal
 // If the attribute already exists it sets the associated value, if it doesn't exist it is added.
 void cfg_SetInt( void* cfgFile, const char* attrName, int val );
 
+// Gets the symbol used to look up the attribute, attribute names aren't case sensitive so this is the same for every
+//  spelling of the name. Anything looked up often should get this once and use the symbol versions of the accessors
+//  so the name doesn't need to be converted each time.
+Symbol cfg_AttributeSymbol( const char* attrName );
+int cfg_GetIntBySymbol( void* cfgFile, Symbol attrSymbol, int defaultVal, int* retVal );
+void cfg_SetIntBySymbol( void* cfgFile, Symbol attrSymbol, int val );
+
 #endif // inclusion guard
\ No newline at end of file
@@ -27,6 +27,63 @@ static uint32_t hashFunc_DJB2( const char* str )
 	return hash;
 }
 
+static uint32_t rotl32( uint32_t x, int r )
+{
+	return ( x << r ) | ( x >> ( 32 - r ) );
+}
+
+// MurmurHash3 x86_32, works on four bytes at a time instead of one so it's quite a bit faster for the longer paths we use as keys,
+//  and the finalizer spreads the bits out better so similar strings don't end up clustered together
+static uint32_t hashFunc_Murmur3( const char* str )
+{
+	const uint32_t c1 = 0xCC9E2D51;
+	const uint32_t c2 = 0x1B873593;
+
+	size_t len = strlen( str );
+	const uint8_t* data = (const uint8_t*)str;
+	size_t numBlocks = len / 4;
+
+	uint32_t hash = 0x9747B28C;
+
+	for( size_t i = 0; i < numBlocks; ++i ) {
+		uint32_t k;
+		memcpy( &k, data + ( i * 4 ), sizeof( k ) );
+
+		k *= c1;
+		k = rotl32( k, 15 );
+		k *= c2;
+
+		hash ^= k;
+		hash = rotl32( hash, 13 );
+		hash = ( hash * 5 ) + 0xE6546B64;
+	}
+
+	const uint8_t* tail = data + ( numBlocks * 4 );
+	uint32_t k = 0;
+	switch( len & 3 ) {
+	case 3: k ^= (uint32_t)tail[2] << 16; // fall through
+	case 2: k ^= (uint32_t)tail[1] << 8; // fall through
+	case 1: k ^= (uint32_t)tail[0];
+		k *= c1;
+		k = rotl32( k, 15 );
+		k *= c2;
+		hash ^= k;
+	}
+
+	hash ^= (uint32_t)len;
+	return hashMap_HashU32( hash );
+}
+
+uint32_t hashMap_HashString( const char* str )
+{
+	return hashFunc_Murmur3( str );
+}
+
+uint32_t hashMap_HashStringDJB2( const char* str )
+{
+	return hashFunc_DJB2( str );
+}
+
 static bool isPowerOfTwoU32( uint32_t val )
 {
 	return ( ( val == 1 ) || ( ( val & ( val - 1 ) ) == 0 ) );
@@ -41,32 +98,50 @@ static uint32_t powerTwoModulus( uint32_t num, uint32_t denom )
 
 static uint32_t chooseCapacity( uint32_t baseSize )
 {
-	size_t size = baseSize - 1;
+	uint32_t size = ( baseSize < 2 ) ? 1 : ( baseSize - 1 );
 	size = size | ( size >> 1 );
 	size = size | ( size >> 2 );
 	size = size | ( size >> 4 );
-	size = size | ( size >> 6 );
+	size = size | ( size >> 8 );
 	size = size | ( size >> 16 );
 
 	return ( size + 1 );
 }
 
-// wraps the modulus function, so it doesn't have to be in the hash function
-static uint32_t hash( HashMap* hashMap, const char* key )
+#define NEXT_IDX( hm, curr ) ( ( ( (curr) + 1 ) >= ( (hm)->capacity ) ) ? 0 : ( (curr) + 1 ) )
+
+static void allocateStorage( HashMap* hashMap, uint32_t capacity )
 {
-	return powerTwoModulus( hashMap->hashFunc( key ), hashMap->capacity );
-}
+	hashMap->capacity = capacity;
 
-#define NEXT_IDX( hm, curr ) ( ( ( (curr) + 1 ) >= ( (hm)->capacity ) ) ? 0 : ( (curr) + 1 ) )
+	hashMap->keys = (HashMapKey*)mem_Allocate( sizeof( HashMapKey ) * hashMap->capacity );
+	hashMap->values = (int*)mem_Allocate( sizeof( int ) * hashMap->capacity );
+
+	for( size_t i = 0; i < hashMap->capacity; ++i ) {
+		hashMap->keys[i].key = NULL;
+		hashMap->keys[i].hash = 0;
+		hashMap->keys[i].probeLength = UINT8_MAX;
+	}
+
+	hashMap->probeLimit = (uint32_t)log2( (double)hashMap->capacity );
+}
 
 void hashMap_Init( HashMap* hashMap, uint32_t estimatedSize, HashFunc hashFunc )
 {
-	//hashMap->hashFunc = hashFunc_Test;
+	hashMap_InitWithArena( hashMap, estimatedSize, hashFunc, NULL );
+}
+
+void hashMap_InitWithArena( HashMap* hashMap, uint32_t estimatedSize, HashFunc hashFunc, StringArena* keyArena )
+{
+	assert( hashMap != NULL );
+
 	hashMap->keys = NULL;
 	hashMap->values = NULL;
 	hashMap->capacity = 0;
+	hashMap->probeLimit = 0;
+	hashMap->keyArena = keyArena;
 
-	hashMap->hashFunc = hashFunc_DJB2;
+	hashMap->hashFunc = hashFunc_Murmur3;
 	if( hashFunc != NULL ) {
 		hashMap->hashFunc = hashFunc;
 	}
@@ -76,56 +151,113 @@ void hashMap_Init( HashMap* hashMap, uint32_t estimatedSize, HashFunc hashFunc )
 	}
 
 	// set an initial size based on the estimated size
-	hashMap->capacity = chooseCapacity( estimatedSize * 2 );
-
-	hashMap->keys = (HashMapKey*)mem_Allocate( sizeof( HashMapKey ) * hashMap->capacity );
-	hashMap->values = (int*)mem_Allocate( sizeof( int ) * hashMap->capacity );
+	allocateStorage( hashMap, chooseCapacity( estimatedSize * 2 ) );
+}
 
-	for( size_t i = 0; i < hashMap->capacity; ++i ) {
-		hashMap->keys[i].key = NULL;
-		hashMap->keys[i].probeLength = UINT8_MAX;
+static char* copyKey( HashMap* hashMap, const char* key )
+{
+	if( hashMap->keyArena != NULL ) {
+		return strArena_Add( hashMap->keyArena, key );
 	}
 
-	hashMap->probeLimit = (size_t)log2( (double)hashMap->capacity );
+	size_t len = SDL_strlen( key ) + 1;
+	char* newKey = mem_Allocate( sizeof( char ) * len );
+	SDL_strlcpy( newKey, key, len );
+	return newKey;
+}
+
+static void releaseKey( HashMap* hashMap, char* key )
+{
+	// keys stored in an arena are released when the arena is cleared
+	if( hashMap->keyArena == NULL ) {
+		mem_Release( key );
+	}
 }
 
+static void insert( HashMap* hashMap, char* key, uint32_t keyHash, int value );
+
 static void resize( HashMap* hashMap, uint32_t newSize )
 {
-	// allocate new list and move data
-	HashMap newHashMap;
-	hashMap_Init( &newHashMap, newSize, hashMap->hashFunc );
+	HashMap oldHashMap = (*hashMap);
+	allocateStorage( hashMap, newSize );
 
-	// insert elements from old hashmap
-	for( size_t i = 0; i < hashMap->capacity; ++i ) {
-		if( hashMap->keys[i].probeLength != UINT8_MAX ) {
-			hashMap_Set( &newHashMap, hashMap->keys[i].key, hashMap->values[i] );
-			mem_Release( hashMap->keys[i].key );
+	// move the elements over, we already have the hashes and own the keys so we don't need to recalculate or copy either
+	for( size_t i = 0; i < oldHashMap.capacity; ++i ) {
+		if( oldHashMap.keys[i].probeLength != UINT8_MAX ) {
+			insert( hashMap, oldHashMap.keys[i].key, oldHashMap.keys[i].hash, oldHashMap.values[i] );
 		}
 	}
 
-	// release old data
-	mem_Release( hashMap->keys );
-	mem_Release( hashMap->values );
-
-	// copy over new data
-	(*hashMap) = newHashMap;
+	mem_Release( oldHashMap.keys );
+	mem_Release( oldHashMap.values );
 }
 
-static bool matches( HashMap* hashMap, const char* key, int idx, uint8_t currLength )
+// the key should have already been copied and be known to not be in the map
+static void insert( HashMap* hashMap, char* key, uint32_t keyHash, int value )
 {
-	return ( ( hashMap->keys[idx].probeLength == currLength ) && ( strcmp( key, hashMap->keys[idx].key ) == 0 ) );
+	if( hashMap->capacity == 0 ) {
+		allocateStorage( hashMap, 8 );
+	}
+
+	// find the ideal position
+	// from there scan forward until we find an empty spot
+	// if the spot is empty insert the key and values, also set the probe distance
+	// else if the current distance is greater than the probe limit rehash in a larger hashmap, start the insert from the beginning
+	// else if the current distance is greater then the distance for the entry at this spot, swap all the values and continue
+	uint32_t idx = powerTwoModulus( keyHash, (uint32_t)hashMap->capacity );
+	uint8_t currLength = 0;
+
+	while( hashMap->keys[idx].probeLength != UINT8_MAX ) {
+		if( currLength > hashMap->probeLimit ) {
+			// past the probe limit, this is a failed insert, rebuild and reset insertion stuff
+			resize( hashMap, (uint32_t)( hashMap->capacity * 2 ) );
+			idx = powerTwoModulus( keyHash, (uint32_t)hashMap->capacity );
+			currLength = 0;
+			continue;
+		}
+
+		if( currLength > hashMap->keys[idx].probeLength ) {
+			// current index is greater, take from the rich and give to the poor
+			HashMapKey swapKey = hashMap->keys[idx];
+			hashMap->keys[idx].key = key;
+			hashMap->keys[idx].hash = keyHash;
+			hashMap->keys[idx].probeLength = currLength;
+			key = swapKey.key;
+			keyHash = swapKey.hash;
+			currLength = swapKey.probeLength;
+
+			int swapValue = hashMap->values[idx];
+			hashMap->values[idx] = value;
+			value = swapValue;
+		}
+
+		idx = NEXT_IDX( hashMap, idx );
+		++currLength;
+	}
+
+	// got a good spot, insert
+	hashMap->keys[idx].key = key;
+	hashMap->keys[idx].hash = keyHash;
+	hashMap->keys[idx].probeLength = currLength;
+	hashMap->values[idx] = value;
 }
 
 // returns whether the key was found, if it was outIdx will contain the index
-static bool findIndex( HashMap* hashMap, const char* key, uint32_t* outIdx )
+static bool findIndex( HashMap* hashMap, const char* key, uint32_t keyHash, uint32_t* outIdx )
 {
-	uint32_t idx = hash( hashMap, key );
+	if( hashMap->capacity == 0 ) {
+		return false;
+	}
+
+	uint32_t idx = powerTwoModulus( keyHash, (uint32_t)hashMap->capacity );
 	uint8_t currLength = 0;
 
 	while( ( hashMap->keys[idx].probeLength != UINT8_MAX ) && ( currLength <= hashMap->keys[idx].probeLength ) ) {
 
-		// seeing if the probe lengths are equal is a good first pass fail thing
-		if( matches( hashMap, key, idx, currLength ) ) {
+		// seeing if the probe lengths and stored hashes are equal is a good first pass fail thing, only touch the key string
+		//  if both of those match
+		if( ( hashMap->keys[idx].probeLength == currLength ) && ( hashMap->keys[idx].hash == keyHash ) &&
+			( strcmp( key, hashMap->keys[idx].key ) == 0 ) ) {
 			(*outIdx) = idx;
 			return true;
 		}
@@ -137,57 +269,21 @@ static bool findIndex( HashMap* hashMap, const char* key, uint32_t* outIdx )
 	return false;
 }
 
-#define SWAP( l, r, type ) { type swap = (type)l; l = (type)r; r = swap; }
-
-// this is the biggie
 void hashMap_Set( HashMap* hashMap, const char* key, int value )
 {
 	assert( hashMap != NULL );
+	assert( key != NULL );
 
-	// find the ideal position
-	// from there scan forward until we find an empty spot
-	// if the spot matches (the key already exists) then set the new value
-	// otherwise if the spot is empty insert the key and values, also set the probe distance
-	// else if the current distance is greater than the probe distance rehash in a larger hashmap, start the Set from the beginning
-	// else if the current distance is greater then the distance for the entry at this spot, swap all the values and continue
-
-	// copy the key
-	size_t len = SDL_strlen( key ) + 1;
-	char* newKey = mem_Allocate( sizeof( char ) * len );
-	SDL_strlcpy( newKey, key, len );
-	
-	uint32_t idx = hash( hashMap, newKey );
-	uint8_t currLength = 0;
-	bool increaseLength = true;
-
-	while( ( hashMap->keys[idx].probeLength != UINT8_MAX ) &&
-		   !matches( hashMap, newKey, idx, currLength ) ) {
-
-		uint32_t nextIdx = NEXT_IDX( hashMap, idx );
-
-		if( currLength > hashMap->probeLimit ) {
-			// past the probe limit, this is a failed insert, rebuild and reset insertion stuff
-			resize( hashMap, chooseCapacity( hashMap->capacity ) );
-
-			nextIdx = hash( hashMap, newKey );
-			currLength = 0;
-			increaseLength = false;
-		} else if( currLength > hashMap->keys[idx].probeLength ) {
-			// current index is greater, take from the rich and give to the poor
-			SWAP( hashMap->keys[idx].key, newKey, char* );
-			SWAP( hashMap->keys[idx].probeLength, currLength, uint8_t );
-			SWAP( hashMap->values[idx], value, int );
-		}
+	uint32_t keyHash = hashMap->hashFunc( key );
 
-		if( increaseLength ) ++currLength;
-		idx = nextIdx;
-		increaseLength = true;
+	// if it already exists just replace the value, we already have a copy of the key
+	uint32_t idx;
+	if( findIndex( hashMap, key, keyHash, &idx ) ) {
+		hashMap->values[idx] = value;
+		return;
 	}
 
-	// got a good spot, insert
-	hashMap->keys[idx].key = newKey;
-	hashMap->keys[idx].probeLength = currLength;
-	hashMap->values[idx] = value;
+	insert( hashMap, copyKey( hashMap, key ), keyHash, value );
 }
 
 // returns whether the find was a success
@@ -196,7 +292,7 @@ bool hashMap_Find( HashMap* hashMap, const char* key, int* outValue )
 	assert( hashMap != NULL );
 
 	uint32_t idx;
-	if( !findIndex( hashMap, key, &idx ) ) {
+	if( !findIndex( hashMap, key, hashMap->hashFunc( key ), &idx ) ) {
 		return false;
 	}
 
@@ -208,14 +304,14 @@ bool hashMap_Exists( HashMap* hashMap, const char* key )
 {
 	assert( hashMap != NULL );
 	uint32_t idx;
-	return findIndex( hashMap, key, &idx );
+	return findIndex( hashMap, key, hashMap->hashFunc( key ), &idx );
 }
 
 static void removeAtIdx( HashMap* hashMap, uint32_t idx )
 {
 	// mark idx as unused
 	hashMap->keys[idx].probeLength = UINT8_MAX;
-	mem_Release( hashMap->keys[idx].key );
+	releaseKey( hashMap, hashMap->keys[idx].key );
 	hashMap->keys[idx].key = NULL;
 	uint32_t prevIdx = idx;
 	idx = NEXT_IDX( hashMap, idx );
@@ -224,9 +320,11 @@ static void removeAtIdx( HashMap* hashMap, uint32_t idx )
 	while( ( hashMap->keys[idx].probeLength != UINT8_MAX ) && ( hashMap->keys[idx].probeLength != 0 ) ) {
 		hashMap->keys[prevIdx].probeLength = hashMap->keys[idx].probeLength - 1;
 		hashMap->keys[prevIdx].key = hashMap->keys[idx].key;
+		hashMap->keys[prevIdx].hash = hashMap->keys[idx].hash;
 		hashMap->values[prevIdx] = hashMap->values[idx];
 
 		hashMap->keys[idx].probeLength = UINT8_MAX;
+		hashMap->keys[idx].key = NULL;
 
 		prevIdx = idx;
 		idx = NEXT_IDX( hashMap, idx );
@@ -239,7 +337,7 @@ void hashMap_Remove( HashMap* hashMap, const char* key )
 
 	// first see if what wants to be removed exists
 	uint32_t idx;
-	if( !findIndex( hashMap, key, &idx ) ) {
+	if( !findIndex( hashMap, key, hashMap->hashFunc( key ), &idx ) ) {
 		return;
 	}
 
@@ -267,7 +365,9 @@ void hashMap_Clear( HashMap* hashMap )
 
 	// clear out keys
 	for( size_t i = 0; i < hashMap->capacity; ++i ) {
-		mem_Release( hashMap->keys[i].key );
+		if( hashMap->keys[i].probeLength != UINT8_MAX ) {
+			releaseKey( hashMap, hashMap->keys[i].key );
+		}
 	}
 
 	mem_Release( hashMap->keys );
@@ -287,6 +387,44 @@ void hashMap_Report( HashMap* hashMap, size_t* capacity )
 	(*capacity) = hashMap->capacity;
 }
 
+// finalizer from MurmurHash3, mixes all the bits so sequential ids don't end up in sequential slots
+uint32_t hashMap_HashU32( uint32_t key )
+{
+	key ^= key >> 16;
+	key *= 0x85EBCA6B;
+	key ^= key >> 13;
+	key *= 0xC2B2AE35;
+	key ^= key >> 16;
+	return key;
+}
+
+uint32_t hashMap_HashU64( uint64_t key )
+{
+	key ^= key >> 33;
+	key *= 0xFF51AFD7ED558CCDULL;
+	key ^= key >> 33;
+	key *= 0xC4CEB9FE1A85EC53ULL;
+	key ^= key >> 33;
+	return (uint32_t)key;
+}
+
+uint32_t hashMap_HashPtr( const void* key )
+{
+	return hashMap_HashU64( (uint64_t)(uintptr_t)key );
+}
+
+// FNV-1a, for fixed size structures
+uint32_t hashMap_HashBytes( const void* key, size_t size )
+{
+	const uint8_t* bytes = (const uint8_t*)key;
+	uint32_t hash = 2166136261u;
+	for( size_t i = 0; i < size; ++i ) {
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
 void hashMap_Test( void )
 {
 	HashMap testMap;
@@ -12,7 +12,9 @@ based on this: https://probablydance.com/2017/02/26/i-wrote-the-fastest-hashtabl
     hit the upper limit probe count we resize the table to be larger, generally this was at about 2/3 full. Can add a test for retrieving, if the distance
     from the ideal spot is greater than the max probe count we know the item cannot exist (this will end up being equivilant to the test from the Robin
     Hood hashing retrieval test).
-NOTE: We're storing the string pointer passed in, so we're assuming it will not change. Can modify it later to make a copy of the string instead.
+NOTE: The keys are copied when they're added. If a StringArena is passed into hashMap_InitWithArena the copies are placed in that instead
+ of being allocated separately, they then live until the arena is cleared. The full hash of each key is stored with it, so when probing we
+ only have to compare the strings if the hashes match, and growing the map never has to rehash or copy the keys.
 */
 
 #ifndef HASH_MAP_H
@@ -22,10 +24,13 @@ NOTE: We're storing the string pointer passed in, so we're assuming it will not
 #include <stdbool.h>
 #include <string.h>
 
+#include "stringArena.h"
+
 typedef uint32_t (*HashFunc)( const char* );
 
 typedef struct {
 	char* key;
+	uint32_t hash; // full hash of the key, checked before the key itself so we rarely have to touch the string
 	uint8_t probeLength; // how far we are from our ideal spot
 	// using the system we'll have setup, the probe length should never be greater than log2(n), so if we set it to UINT8_MAX we can use that
 	//  as the empty spot flag
@@ -37,11 +42,15 @@ typedef struct {
 	int* values;
 	uint32_t probeLimit;
 	HashFunc hashFunc;
+	StringArena* keyArena; // if NULL each key is allocated separately
 } HashMap;
 
 // if hashFunc == NULL will use a default function
 void hashMap_Init( HashMap* hashMap, uint32_t estimatedSize, HashFunc hashFunc );
 
+// same as hashMap_Init but the key copies are stored in keyArena, the arena must outlive the hash map and can be shared between maps
+void hashMap_InitWithArena( HashMap* hashMap, uint32_t estimatedSize, HashFunc hashFunc, StringArena* keyArena );
+
 // if the value already exists it will replace it, otherwise it will add it
 void hashMap_Set( HashMap* hashMap, const char* key, int value );
 
@@ -66,4 +75,14 @@ void hashMap_Report( HashMap* hashMap, size_t* capacity );
 // Runs tests on the hash map functions
 void hashMap_Test( void );
 
+// The default hash function for string keys (MurmurHash3), and the DJB2 function that used to be the default
+uint32_t hashMap_HashString( const char* str );
+uint32_t hashMap_HashStringDJB2( const char* str );
+
+// Hash functions for non-string keys, used by the maps generated in typedHashMap.h
+uint32_t hashMap_HashU32( uint32_t key );
+uint32_t hashMap_HashU64( uint64_t key );
+uint32_t hashMap_HashPtr( const void* key );
+uint32_t hashMap_HashBytes( const void* key, size_t size );
+
 #endif /* inclusion guard */
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "lz4Block.h"
+
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define MIN_MATCH 4
+#define LAST_LITERALS 5 // the last bytes of a block are always literals
+#define MATCH_FIND_LIMIT 12 // no match can start this close to the end of a block
+#define MAX_OFFSET 65535
+#define HASH_LOG 12
+#define RUN_MASK 15
+
+static uint32_t read32( const uint8_t* p )
+{
+	uint32_t v;
+	memcpy( &v, p, sizeof( v ) );
+	return v;
+}
+
+static uint32_t hashSequence( uint32_t sequence )
+{
+	return ( sequence * 2654435761u ) >> ( 32 - HASH_LOG );
+}
+
+// lengths of 15 or more are continued in the following bytes
+static uint8_t* writeLength( uint8_t* op, size_t length )
+{
+	while( length >= 255 ) {
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = (uint8_t)length;
+	return op;
+}
+
+int lz4_CompressBound( int srcSize )
+{
+	return srcSize + ( srcSize / 255 ) + 16;
+}
+
+int lz4_Compress( const uint8_t* src, int srcSize, uint8_t* dst, int dstCapacity )
+{
+	uint32_t table[1 << HASH_LOG];
+	memset( table, 0, sizeof( table ) );
+
+	const uint8_t* ip = src;
+	const uint8_t* anchor = src;
+	const uint8_t* end = src + srcSize;
+	const uint8_t* matchLimit = end - LAST_LITERALS;
+	const uint8_t* findLimit = end - MATCH_FIND_LIMIT;
+
+	uint8_t* op = dst;
+	uint8_t* opEnd = dst + dstCapacity;
+
+	if( srcSize > MATCH_FIND_LIMIT ) {
+		while( ip < findLimit ) {
+			uint32_t sequence = read32( ip );
+			uint32_t h = hashSequence( sequence );
+			const uint8_t* ref = src + table[h];
+			table[h] = (uint32_t)( ip - src );
+
+			if( ( ref >= ip ) || ( ( ip - ref ) > MAX_OFFSET ) || ( read32( ref ) != sequence ) ) {
+				++ip;
+				continue;
+			}
+
+			// extend the match as far as it goes in both directions
+			const uint8_t* matchEnd = ip + MIN_MATCH;
+			const uint8_t* refEnd = ref + MIN_MATCH;
+			while( ( matchEnd < matchLimit ) && ( *matchEnd == *refEnd ) ) {
+				++matchEnd;
+				++refEnd;
+			}
+			while( ( ip > anchor ) && ( ref > src ) && ( ip[-1] == ref[-1] ) ) {
+				--ip;
+				--ref;
+			}
+
+			size_t literalLength = (size_t)( ip - anchor );
+			size_t matchLength = (size_t)( matchEnd - ip ) - MIN_MATCH;
+
+			// token, literals, offset, and both lengths
+			size_t worstCase = 1 + ( literalLength / 255 ) + 1 + literalLength + 2 + ( matchLength / 255 ) + 1;
+			if( worstCase > (size_t)( opEnd - op ) ) {
+				return 0;
+			}
+
+			uint8_t* token = op++;
+			if( literalLength >= RUN_MASK ) {
+				*token = RUN_MASK << 4;
+				op = writeLength( op, literalLength - RUN_MASK );
+			} else {
+				*token = (uint8_t)( literalLength << 4 );
+			}
+			memcpy( op, anchor, literalLength );
+			op += literalLength;
+
+			uint16_t offset = (uint16_t)( ip - ref );
+			*op++ = (uint8_t)( offset & 0xFF );
+			*op++ = (uint8_t)( offset >> 8 );
+
+			if( matchLength >= RUN_MASK ) {
+				*token |= RUN_MASK;
+				op = writeLength( op, matchLength - RUN_MASK );
+			} else {
+				*token |= (uint8_t)matchLength;
+			}
+
+			ip = matchEnd;
+			anchor = ip;
+		}
+	}
+
+	// everything left over goes in as literals
+	size_t literalLength = (size_t)( end - anchor );
+	size_t worstCase = 1 + ( literalLength / 255 ) + 1 + literalLength;
+	if( worstCase > (size_t)( opEnd - op ) ) {
+		return 0;
+	}
+
+	if( literalLength >= RUN_MASK ) {
+		*op++ = RUN_MASK << 4;
+		op = writeLength( op, literalLength - RUN_MASK );
+	} else {
+		*op++ = (uint8_t)( literalLength << 4 );
+	}
+	memcpy( op, anchor, literalLength );
+	op += literalLength;
+
+	return (int)( op - dst );
+}
+
+// returns false if the length runs past the end of the input
+static bool readLength( const uint8_t** ip, const uint8_t* end, size_t* length )
+{
+	uint8_t b;
+	do {
+		if( (*ip) >= end ) {
+			return false;
+		}
+		b = *( (*ip)++ );
+		(*length) += b;
+	} while( b == 255 );
+
+	return true;
+}
+
+int lz4_Decompress( const uint8_t* src, int srcSize, uint8_t* dst, int dstSize )
+{
+	const uint8_t* ip = src;
+	const uint8_t* end = src + srcSize;
+	uint8_t* op = dst;
+	uint8_t* opEnd = dst + dstSize;
+
+	while( ip < end ) {
+		uint8_t token = *ip++;
+
+		size_t literalLength = token >> 4;
+		if( ( literalLength == RUN_MASK ) && !readLength( &ip, end, &literalLength ) ) {
+			return -1;
+		}
+		if( ( literalLength > (size_t)( end - ip ) ) || ( literalLength > (size_t)( opEnd - op ) ) ) {
+			return -1;
+		}
+		memcpy( op, ip, literalLength );
+		op += literalLength;
+		ip += literalLength;
+
+		// the last sequence is only literals
+		if( ip >= end ) {
+			break;
+		}
+
+		if( ( end - ip ) < 2 ) {
+			return -1;
+		}
+		size_t offset = (size_t)ip[0] | ( (size_t)ip[1] << 8 );
+		ip += 2;
+		if( ( offset == 0 ) || ( offset > (size_t)( op - dst ) ) ) {
+			return -1;
+		}
+
+		size_t matchLength = token & RUN_MASK;
+		if( ( matchLength == RUN_MASK ) && !readLength( &ip, end, &matchLength ) ) {
+			return -1;
+		}
+		matchLength += MIN_MATCH;
+		if( matchLength > (size_t)( opEnd - op ) ) {
+			return -1;
+		}
+
+		// matches can overlap what they're writing, which is how runs are stored, so those have to go a byte at a time
+		const uint8_t* match = op - offset;
+		if( offset >= matchLength ) {
+			memcpy( op, match, matchLength );
+		} else {
+			for( size_t i = 0; i < matchLength; ++i ) {
+				op[i] = match[i];
+			}
+		}
+		op += matchLength;
+	}
+
+	return (int)( op - dst );
+}
@@ -0,0 +1,24 @@
+#ifndef LZ4_BLOCK_H
+#define LZ4_BLOCK_H
+
+#include <stdint.h>
+
+/*
+Compression and decompression of single LZ4 blocks, compatible with the reference implementation's block format. There's
+ no frame format, so the caller has to keep track of the compressed and decompressed sizes.
+The compressor is a simple greedy one, it's meant for offline tools where the output is decompressed many more times than
+ it's compressed. Decompression never reads or writes outside the buffers it's given, so it's safe to use on data read
+ from files.
+Doesn't use anything from SDL so the tools can be built with just this.
+*/
+
+// the largest size compressing srcSize bytes can result in
+int lz4_CompressBound( int srcSize );
+
+// returns the size of the compressed data, or 0 if it didn't fit in dstCapacity
+int lz4_Compress( const uint8_t* src, int srcSize, uint8_t* dst, int dstCapacity );
+
+// returns the number of bytes decompressed, or < 0 if the data is invalid or won't fit in dstSize
+int lz4_Decompress( const uint8_t* src, int srcSize, uint8_t* dst, int dstSize );
+
+#endif /* inclusion guard */
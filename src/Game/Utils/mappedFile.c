@@ -0,0 +1,149 @@
+#include "mappedFile.h"
+
+#include <SDL_rwops.h>
+#include <string.h>
+#include <assert.h>
+
+#include "../System/memory.h"
+
+// the apk contents on android and the preloaded files on the web can't be mapped, just read the whole file in
+#if defined( __ANDROID__ ) || defined( __EMSCRIPTEN__ )
+	#define MAP_READ_INTO_MEMORY
+#elif defined( _WIN32 )
+	#define MAP_WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#define MAP_POSIX
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+static bool mapFile( const char* fileName, MappedFile* file )
+{
+#if defined( MAP_WIN32 )
+	HANDLE fileHandle = CreateFileA( fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+	if( fileHandle == INVALID_HANDLE_VALUE ) {
+		return false;
+	}
+	file->fileHandle = fileHandle;
+
+	LARGE_INTEGER fileSize;
+	if( !GetFileSizeEx( fileHandle, &fileSize ) || ( fileSize.QuadPart == 0 ) ) {
+		return false;
+	}
+	file->size = (size_t)fileSize.QuadPart;
+
+	file->mappingHandle = CreateFileMappingA( fileHandle, NULL, PAGE_READONLY, 0, 0, NULL );
+	if( file->mappingHandle == NULL ) {
+		return false;
+	}
+
+	file->data = (const uint8_t*)MapViewOfFile( file->mappingHandle, FILE_MAP_READ, 0, 0, 0 );
+	return ( file->data != NULL );
+#elif defined( MAP_POSIX )
+	int fd = open( fileName, O_RDONLY );
+	if( fd < 0 ) {
+		return false;
+	}
+
+	struct stat fileStat;
+	if( ( fstat( fd, &fileStat ) < 0 ) || ( fileStat.st_size <= 0 ) ) {
+		close( fd );
+		return false;
+	}
+	file->size = (size_t)fileStat.st_size;
+
+	// the mapping keeps the file open, so we don't need to
+	void* mapped = mmap( NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	close( fd );
+	if( mapped == MAP_FAILED ) {
+		return false;
+	}
+
+	file->data = (const uint8_t*)mapped;
+	return true;
+#else
+	SDL_RWops* rwopsFile = SDL_RWFromFile( fileName, "rb" );
+	if( rwopsFile == NULL ) {
+		return false;
+	}
+
+	Sint64 fileSize = SDL_RWsize( rwopsFile );
+	if( fileSize <= 0 ) {
+		SDL_RWclose( rwopsFile );
+		return false;
+	}
+	file->size = (size_t)fileSize;
+
+	uint8_t* buffer = mem_Allocate( file->size );
+	if( buffer == NULL ) {
+		SDL_RWclose( rwopsFile );
+		return false;
+	}
+	file->data = buffer;
+
+	size_t readTotal = 0;
+	size_t amtRead = 1;
+	while( ( readTotal < file->size ) && ( amtRead > 0 ) ) {
+		amtRead = SDL_RWread( rwopsFile, buffer + readTotal, sizeof( uint8_t ), file->size - readTotal );
+		readTotal += amtRead;
+	}
+	SDL_RWclose( rwopsFile );
+
+	return ( readTotal == file->size );
+#endif
+}
+
+bool mappedFile_Open( const char* fileName, MappedFile* outFile )
+{
+	assert( fileName != NULL );
+	assert( outFile != NULL );
+
+	memset( outFile, 0, sizeof( *outFile ) );
+	if( !mapFile( fileName, outFile ) ) {
+		mappedFile_Close( outFile );
+		return false;
+	}
+
+	return true;
+}
+
+void mappedFile_View( const uint8_t* data, size_t size, MappedFile* outFile )
+{
+	assert( outFile != NULL );
+
+	memset( outFile, 0, sizeof( *outFile ) );
+	outFile->data = data;
+	outFile->size = size;
+	outFile->isView = true;
+}
+
+void mappedFile_Close( MappedFile* file )
+{
+	assert( file != NULL );
+
+	if( !file->isView ) {
+#if defined( MAP_WIN32 )
+		if( file->data != NULL ) {
+			UnmapViewOfFile( file->data );
+		}
+		if( file->mappingHandle != NULL ) {
+			CloseHandle( (HANDLE)file->mappingHandle );
+		}
+		if( file->fileHandle != NULL ) {
+			CloseHandle( (HANDLE)file->fileHandle );
+		}
+#elif defined( MAP_POSIX )
+		if( file->data != NULL ) {
+			munmap( (void*)file->data, file->size );
+		}
+#else
+		mem_Release( (void*)file->data );
+#endif
+	}
+
+	memset( file, 0, sizeof( *file ) );
+}
@@ -0,0 +1,37 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+Gives read only access to the whole contents of a file at once. The file is memory mapped where we can, so nothing is
+ copied and only the pages that are touched get read in. On Android and the web it's read into memory in one go.
+ The data isn't null terminated.
+*/
+
+typedef struct {
+	const uint8_t* data;
+	size_t size;
+
+	// used to release the file, shouldn't be touched
+	bool isView; // data is owned by something else, closing does nothing
+	void* fileHandle;
+	void* mappingHandle;
+} MappedFile;
+
+/*
+Opens the file, it stays open until mappedFile_Close is called.
+ Returns false if the file doesn't exist or is empty, outFile is cleared then so it's always safe to close.
+*/
+bool mappedFile_Open( const char* fileName, MappedFile* outFile );
+
+/*
+Wraps memory that's already loaded so it can be used the same way as a mapped file.
+*/
+void mappedFile_View( const uint8_t* data, size_t size, MappedFile* outFile );
+
+void mappedFile_Close( MappedFile* file );
+
+#endif /* inclusion guard */
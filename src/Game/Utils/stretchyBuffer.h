@@ -56,7 +56,7 @@ static void* sb__GrowData( void* p, int increment, size_t itemSize, const char*
 	int currBased = currSize + ( currSize / 2 ); // 1.5 * current
 	int min = currSize + increment;
 	int newCount = ( min > currBased ) ? min : currBased;
-	int* np = mem_Resize_Data( p ? (void*)( sb__Raw(p) ) : NULL, ( newCount * itemSize ) + ( sizeof( int) * 2 ), fileName, fileLine );
+	size_t* np = mem_Resize_Data( p ? (void*)( sb__Raw(p) ) : NULL, ( newCount * itemSize ) + ( sizeof( size_t ) * 2 ), fileName, fileLine );
 	//int* np = mem_Resize( p ? (void*)( sb__Raw(p) ) : NULL, ( newCount * itemSize ) + ( sizeof( int) * 2 ) );
 	if( np != NULL ) {
 		if( p == NULL ) {
@@ -0,0 +1,71 @@
+#include "stringArena.h"
+
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "../System/memory.h"
+
+#define DEFAULT_BLOCK_SIZE 4096
+
+void strArena_Init( StringArena* arena, size_t blockSize )
+{
+	assert( arena != NULL );
+
+	arena->currBlock = NULL;
+	arena->blockSize = ( blockSize == 0 ) ? DEFAULT_BLOCK_SIZE : blockSize;
+	arena->totalUsed = 0;
+}
+
+char* strArena_Add( StringArena* arena, const char* str )
+{
+	assert( str != NULL );
+	return strArena_AddLen( arena, str, strlen( str ) );
+}
+
+char* strArena_AddLen( StringArena* arena, const char* str, size_t len )
+{
+	assert( arena != NULL );
+	assert( str != NULL );
+
+	size_t needed = len + 1;
+
+	// if the current block can't fit it then create a new one, strings larger than the block size get their own block
+	if( ( arena->currBlock == NULL ) || ( ( arena->currBlock->size - arena->currBlock->used ) < needed ) ) {
+		size_t blockSize = ( arena->blockSize == 0 ) ? DEFAULT_BLOCK_SIZE : arena->blockSize;
+		size_t size = ( needed > blockSize ) ? needed : blockSize;
+		StringArenaBlock* newBlock = mem_Allocate( sizeof( StringArenaBlock ) + size );
+		if( newBlock == NULL ) {
+			return NULL;
+		}
+
+		newBlock->next = arena->currBlock;
+		newBlock->used = 0;
+		newBlock->size = size;
+		arena->currBlock = newBlock;
+	}
+
+	char* copy = (char*)( (uint8_t*)( arena->currBlock ) + sizeof( StringArenaBlock ) + arena->currBlock->used );
+	memcpy( copy, str, len );
+	copy[len] = 0;
+
+	arena->currBlock->used += needed;
+	arena->totalUsed += needed;
+
+	return copy;
+}
+
+void strArena_Clear( StringArena* arena )
+{
+	assert( arena != NULL );
+
+	StringArenaBlock* block = arena->currBlock;
+	while( block != NULL ) {
+		StringArenaBlock* next = block->next;
+		mem_Release( block );
+		block = next;
+	}
+
+	arena->currBlock = NULL;
+	arena->totalUsed = 0;
+}
@@ -0,0 +1,37 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <stddef.h>
+
+/*
+Stores copies of strings packed together in large blocks, used so things like hash map keys don't each need their own
+ allocation and end up next to each other in memory. Strings can't be released individually, they're all released
+ when the arena is cleared. A zeroed out StringArena is ready to use with the default block size.
+*/
+
+typedef struct StringArenaBlock {
+	struct StringArenaBlock* next;
+	size_t used;
+	size_t size;
+	// string data follows the header
+} StringArenaBlock;
+
+typedef struct {
+	StringArenaBlock* currBlock;
+	size_t blockSize;
+	size_t totalUsed;
+} StringArena;
+
+// blockSize is the minimum size of each block allocated, 0 will use a default size
+void strArena_Init( StringArena* arena, size_t blockSize );
+
+// copies the string into the arena and returns a pointer to the copy
+char* strArena_Add( StringArena* arena, const char* str );
+
+// copies len characters of the string into the arena, adds a null terminator
+char* strArena_AddLen( StringArena* arena, const char* str, size_t len );
+
+// releases all the strings stored in the arena, any pointers to them are now invalid
+void strArena_Clear( StringArena* arena );
+
+#endif /* inclusion guard */
@@ -0,0 +1,124 @@
+#include "symbols.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <SDL_atomic.h>
+
+#include "typedHashMap.h"
+#include "stringArena.h"
+#include "stretchyBuffer.h"
+#include "../System/memory.h"
+
+#define HASH_SYMBOL_STRING( key ) hashMap_HashString( key )
+#define SYMBOL_STRINGS_EQUAL( a, b ) ( strcmp( ( a ), ( b ) ) == 0 )
+
+TYPED_HASH_MAP_DECLARE( SymbolMap, symbolMap, const char*, Symbol )
+TYPED_HASH_MAP_DEFINE( SymbolMap, symbolMap, const char*, Symbol, HASH_SYMBOL_STRING, SYMBOL_STRINGS_EQUAL )
+
+// interning shouldn't happen often or take long, so a spin lock is enough and doesn't need to be created before use
+static SDL_SpinLock symbolLock = 0;
+
+// the keys in the map point into the arena, so each string is only stored once
+static StringArena symbolStrings = { NULL, 0, 0 };
+static SymbolMap symbolMap = { 0, NULL, NULL, 0, 0 };
+
+// the symbol is the index into this plus one, so 0 can be the invalid symbol
+static const char** sbSymbolStrings = NULL;
+
+Symbol sym_Intern( const char* str )
+{
+	if( str == NULL ) {
+		return INVALID_SYMBOL;
+	}
+
+	Symbol symbol = INVALID_SYMBOL;
+
+	SDL_AtomicLock( &symbolLock ); {
+		if( !symbolMap_Find( &symbolMap, str, &symbol ) ) {
+			const char* copy = strArena_Add( &symbolStrings, str );
+			if( copy != NULL ) {
+				sb_Push( sbSymbolStrings, copy );
+				symbol = (Symbol)sb_Count( sbSymbolStrings );
+				symbolMap_Set( &symbolMap, copy, symbol );
+			}
+		}
+	} SDL_AtomicUnlock( &symbolLock );
+
+	return symbol;
+}
+
+Symbol sym_InternSlice( const char* str, size_t length )
+{
+	if( str == NULL ) {
+		return INVALID_SYMBOL;
+	}
+
+	// the map is keyed on null terminated strings, short ones are terminated on the stack so nothing is allocated
+	char stackBuffer[256];
+	char* buffer = stackBuffer;
+	if( length >= sizeof( stackBuffer ) ) {
+		buffer = mem_Allocate( length + 1 );
+		if( buffer == NULL ) {
+			return INVALID_SYMBOL;
+		}
+	}
+
+	memcpy( buffer, str, length );
+	buffer[length] = 0;
+	Symbol symbol = sym_Intern( buffer );
+
+	if( buffer != stackBuffer ) {
+		mem_Release( buffer );
+	}
+
+	return symbol;
+}
+
+Symbol sym_Find( const char* str )
+{
+	if( str == NULL ) {
+		return INVALID_SYMBOL;
+	}
+
+	Symbol symbol = INVALID_SYMBOL;
+
+	SDL_AtomicLock( &symbolLock ); {
+		symbolMap_Find( &symbolMap, str, &symbol );
+	} SDL_AtomicUnlock( &symbolLock );
+
+	return symbol;
+}
+
+const char* sym_GetString( Symbol symbol )
+{
+	const char* str = "";
+
+	SDL_AtomicLock( &symbolLock ); {
+		if( ( symbol != INVALID_SYMBOL ) && ( symbol <= sb_Count( sbSymbolStrings ) ) ) {
+			str = sbSymbolStrings[symbol - 1];
+		}
+	} SDL_AtomicUnlock( &symbolLock );
+
+	return str;
+}
+
+uint32_t sym_Count( void )
+{
+	uint32_t count;
+
+	SDL_AtomicLock( &symbolLock ); {
+		count = (uint32_t)sb_Count( sbSymbolStrings );
+	} SDL_AtomicUnlock( &symbolLock );
+
+	return count;
+}
+
+void sym_CleanUp( void )
+{
+	SDL_AtomicLock( &symbolLock ); {
+		symbolMap_Clear( &symbolMap );
+		sb_Release( sbSymbolStrings );
+		strArena_Clear( &symbolStrings );
+	} SDL_AtomicUnlock( &symbolLock );
+}
@@ -0,0 +1,36 @@
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+Global string interning. Each unique string is stored once and given a 32-bit symbol, so comparing two interned strings is
+ just comparing the symbols. Symbols stay valid until sym_CleanUp( ) is called, and the strings they refer to never move.
+ Safe to call from any thread.
+*/
+
+typedef uint32_t Symbol;
+#define INVALID_SYMBOL 0
+
+// returns the symbol for the string, adding it if it hasn't been interned yet, returns INVALID_SYMBOL if str is NULL
+Symbol sym_Intern( const char* str );
+
+// same as sym_Intern but the string doesn't have to be null terminated, used for pieces of a larger string
+Symbol sym_InternSlice( const char* str, size_t length );
+
+// returns the symbol for the string if it's already been interned, otherwise returns INVALID_SYMBOL
+//  use this for lookups, if the string was never interned then nothing can be stored under it
+Symbol sym_Find( const char* str );
+
+// reverse lookup, returns the string the symbol was created from, returns an empty string for INVALID_SYMBOL
+const char* sym_GetString( Symbol symbol );
+
+// number of unique strings that have been interned
+uint32_t sym_Count( void );
+
+// releases all the interned strings, every symbol is invalid after this
+void sym_CleanUp( void );
+
+#endif /* inclusion guard */
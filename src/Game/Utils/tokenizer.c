@@ -0,0 +1,160 @@
+#include "tokenizer.h"
+
+#include <assert.h>
+#include <string.h>
+#include <limits.h>
+
+static bool isWhiteSpace( char c )
+{
+	return ( c == ' ' ) || ( c == '\t' ) || ( c == '\r' ) || ( c == '\n' ) || ( c == '\f' ) || ( c == '\v' );
+}
+
+static bool isDelimiter( char c, const char* delimiters )
+{
+	for( const char* d = delimiters; (*d) != 0; ++d ) {
+		if( (*d) == c ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void tok_Init( Tokenizer* tok, const char* text, size_t length )
+{
+	assert( tok != NULL );
+	assert( ( text != NULL ) || ( length == 0 ) );
+
+	tok->curr = text;
+	tok->end = text + length;
+}
+
+bool tok_NextLine( Tokenizer* tok, StringSlice* outLine )
+{
+	assert( tok != NULL );
+	assert( outLine != NULL );
+
+	while( ( tok->curr < tok->end ) && ( ( (*tok->curr) == '\r' ) || ( (*tok->curr) == '\n' ) ) ) {
+		++tok->curr;
+	}
+
+	if( tok->curr >= tok->end ) {
+		return false;
+	}
+
+	const char* lineEnd = memchr( tok->curr, '\n', (size_t)( tok->end - tok->curr ) );
+	if( lineEnd == NULL ) {
+		lineEnd = tok->end;
+	}
+
+	outLine->start = tok->curr;
+	outLine->length = (size_t)( lineEnd - tok->curr );
+	if( ( outLine->length > 0 ) && ( outLine->start[outLine->length - 1] == '\r' ) ) {
+		--outLine->length;
+	}
+
+	tok->curr = lineEnd;
+	return true;
+}
+
+bool tok_NextToken( StringSlice* line, const char* delimiters, StringSlice* outToken )
+{
+	assert( line != NULL );
+	assert( delimiters != NULL );
+	assert( outToken != NULL );
+
+	const char* curr = line->start;
+	const char* end = line->start + line->length;
+	while( ( curr < end ) && isDelimiter( (*curr), delimiters ) ) {
+		++curr;
+	}
+
+	if( curr >= end ) {
+		line->start = end;
+		line->length = 0;
+		return false;
+	}
+
+	outToken->start = curr;
+	while( ( curr < end ) && !isDelimiter( (*curr), delimiters ) ) {
+		++curr;
+	}
+	outToken->length = (size_t)( curr - outToken->start );
+
+	line->start = curr;
+	line->length = (size_t)( end - curr );
+	return true;
+}
+
+StringSlice tok_Trim( StringSlice slice )
+{
+	while( ( slice.length > 0 ) && isWhiteSpace( slice.start[0] ) ) {
+		++slice.start;
+		--slice.length;
+	}
+
+	while( ( slice.length > 0 ) && isWhiteSpace( slice.start[slice.length - 1] ) ) {
+		--slice.length;
+	}
+
+	return slice;
+}
+
+bool tok_Equals( StringSlice slice, const char* str )
+{
+	assert( str != NULL );
+
+	size_t len = strlen( str );
+	return ( len == slice.length ) && ( memcmp( slice.start, str, len ) == 0 );
+}
+
+bool tok_ToInt( StringSlice slice, int* outValue )
+{
+	assert( outValue != NULL );
+
+	size_t i = 0;
+	bool negative = false;
+	if( ( slice.length > 0 ) && ( ( slice.start[0] == '-' ) || ( slice.start[0] == '+' ) ) ) {
+		negative = ( slice.start[0] == '-' );
+		++i;
+	}
+
+	if( i >= slice.length ) {
+		return false;
+	}
+
+	// accumulate as a negative number so INT_MIN fits
+	long long value = 0;
+	for( ; i < slice.length; ++i ) {
+		char c = slice.start[i];
+		if( ( c < '0' ) || ( c > '9' ) ) {
+			return false;
+		}
+
+		value = ( value * 10 ) - ( c - '0' );
+		if( value < INT_MIN ) {
+			return false;
+		}
+	}
+
+	if( !negative ) {
+		value = -value;
+		if( value > INT_MAX ) {
+			return false;
+		}
+	}
+
+	(*outValue) = (int)value;
+	return true;
+}
+
+size_t tok_Copy( StringSlice slice, char* buffer, size_t bufferSize )
+{
+	assert( buffer != NULL );
+	assert( bufferSize > 0 );
+
+	size_t amt = ( slice.length < bufferSize ) ? slice.length : ( bufferSize - 1 );
+	memcpy( buffer, slice.start, amt );
+	buffer[amt] = 0;
+
+	return amt;
+}
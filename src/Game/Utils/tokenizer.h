@@ -0,0 +1,47 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+Splits text into lines and tokens without copying or changing it, every piece is a slice pointing back into the
+ original text. The text doesn't need to be null terminated, so it can be used straight out of a mapped file.
+ Nothing is allocated and there's no global state, so it's safe to use from any thread.
+Doesn't use anything from the rest of the game so the tools can share it.
+*/
+
+typedef struct {
+	const char* start;
+	size_t length;
+} StringSlice;
+
+typedef struct {
+	const char* curr;
+	const char* end;
+} Tokenizer;
+
+void tok_Init( Tokenizer* tok, const char* text, size_t length );
+
+// gets the next line that isn't empty, without the line ending. Returns false when there are no more lines.
+bool tok_NextLine( Tokenizer* tok, StringSlice* outLine );
+
+/*
+Gets the next token in the line, tokens are separated by any of the characters in delimiters. The token is removed
+ from the start of the line.
+ Returns false if there are no more tokens in the line.
+*/
+bool tok_NextToken( StringSlice* line, const char* delimiters, StringSlice* outToken );
+
+// removes any white space from both ends
+StringSlice tok_Trim( StringSlice slice );
+
+bool tok_Equals( StringSlice slice, const char* str );
+
+// parses a base 10 integer, the whole slice has to be used. Returns false if it isn't a valid integer.
+bool tok_ToInt( StringSlice slice, int* outValue );
+
+// copies the slice into buffer and null terminates it, truncating it if it doesn't fit. Returns the length copied.
+size_t tok_Copy( StringSlice slice, char* buffer, size_t bufferSize );
+
+#endif /* inclusion guard */
@@ -0,0 +1,248 @@
+/*
+Generates hash maps with keys and values of any type, uses the same Robin Hood open addressing as hashMap.h but the keys are
+ stored directly in the slots instead of through a pointer, so finding a key never has to leave the keys array.
+ Keys need to be plain old data, they're copied in and compared with the equals function passed into the define.
+
+Usage:
+ in a header (or at the top of a .c file if it's only used there):
+   TYPED_HASH_MAP_DECLARE( GlyphMap, glyphMap, int32_t, int )
+ in exactly one .c file:
+   TYPED_HASH_MAP_DEFINE( GlyphMap, glyphMap, int32_t, int, HASH_MAP_HASH_U32, HASH_MAP_EQUALS_VALUE )
+
+ This creates the type GlyphMap and the functions glyphMap_Init( ), glyphMap_Set( ), glyphMap_Find( ), glyphMap_Get( ),
+ glyphMap_Exists( ), glyphMap_Remove( ), and glyphMap_Clear( ).
+
+The hash function is given the key variable and should return a uint32_t, the equals function is given two key variables and
+ should return whether they're the same. The HASH_MAP_* macros below cover integers, pointers, and fixed size structures.
+*/
+
+#ifndef TYPED_HASH_MAP_H
+#define TYPED_HASH_MAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#include "hashMap.h"
+#include "../System/memory.h"
+
+// hash functions for the common key types
+#define HASH_MAP_HASH_U32( key ) hashMap_HashU32( (uint32_t)( key ) )
+#define HASH_MAP_HASH_U64( key ) hashMap_HashU64( (uint64_t)( key ) )
+#define HASH_MAP_HASH_PTR( key ) hashMap_HashPtr( (const void*)( key ) )
+#define HASH_MAP_HASH_POD( key ) hashMap_HashBytes( &( key ), sizeof( key ) )
+
+// comparisons for the common key types, use HASH_MAP_EQUALS_POD for structures, make sure any padding is zeroed out
+#define HASH_MAP_EQUALS_VALUE( a, b ) ( ( a ) == ( b ) )
+#define HASH_MAP_EQUALS_POD( a, b ) ( memcmp( &( a ), &( b ), sizeof( a ) ) == 0 )
+
+#define TYPED_HASH_MAP_DECLARE( TypeName, prefix, KeyType, ValueType ) \
+	typedef struct { \
+		KeyType key; \
+		uint8_t probeLength; /* UINT8_MAX marks an empty slot */ \
+	} TypeName##Key; \
+	\
+	typedef struct { \
+		size_t capacity; \
+		TypeName##Key* keys; \
+		ValueType* values; \
+		uint32_t probeLimit; \
+		size_t count; \
+	} TypeName; \
+	\
+	/* estimatedSize can be 0, the map will allocate it's storage when the first key is added */ \
+	void prefix##_Init( TypeName* map, uint32_t estimatedSize ); \
+	/* if the key already exists it will replace the value, otherwise it will add it */ \
+	void prefix##_Set( TypeName* map, KeyType key, ValueType value ); \
+	/* returns whether the key was found, if it was the value is placed in outValue */ \
+	bool prefix##_Find( TypeName* map, KeyType key, ValueType* outValue ); \
+	/* returns a pointer to the stored value, or NULL if the key doesn't exist, invalidated by any Set or Remove */ \
+	ValueType* prefix##_Get( TypeName* map, KeyType key ); \
+	bool prefix##_Exists( TypeName* map, KeyType key ); \
+	void prefix##_Remove( TypeName* map, KeyType key ); \
+	/* releases all the storage, the map can be used again after this */ \
+	void prefix##_Clear( TypeName* map );
+
+#define TYPED_HASH_MAP_DEFINE( TypeName, prefix, KeyType, ValueType, hashKey, keysEqual ) \
+	static uint32_t prefix##__Capacity( uint32_t baseSize ) \
+	{ \
+		uint32_t size = ( baseSize < 2 ) ? 1 : ( baseSize - 1 ); \
+		size = size | ( size >> 1 ); \
+		size = size | ( size >> 2 ); \
+		size = size | ( size >> 4 ); \
+		size = size | ( size >> 8 ); \
+		size = size | ( size >> 16 ); \
+		return ( size + 1 ); \
+	} \
+	\
+	static void prefix##__Allocate( TypeName* map, uint32_t capacity ) \
+	{ \
+		map->capacity = capacity; \
+		map->keys = (TypeName##Key*)mem_Allocate( sizeof( TypeName##Key ) * map->capacity ); \
+		map->values = (ValueType*)mem_Allocate( sizeof( ValueType ) * map->capacity ); \
+		for( size_t i = 0; i < map->capacity; ++i ) { \
+			map->keys[i].probeLength = UINT8_MAX; \
+		} \
+		map->probeLimit = (uint32_t)log2( (double)map->capacity ); \
+		map->count = 0; \
+	} \
+	\
+	static void prefix##__Insert( TypeName* map, KeyType key, ValueType value ); \
+	\
+	static void prefix##__Resize( TypeName* map, uint32_t newCapacity ) \
+	{ \
+		TypeName old = (*map); \
+		prefix##__Allocate( map, newCapacity ); \
+		for( size_t i = 0; i < old.capacity; ++i ) { \
+			if( old.keys[i].probeLength != UINT8_MAX ) { \
+				prefix##__Insert( map, old.keys[i].key, old.values[i] ); \
+			} \
+		} \
+		mem_Release( old.keys ); \
+		mem_Release( old.values ); \
+	} \
+	\
+	/* assumes the key doesn't already exist in the map */ \
+	static void prefix##__Insert( TypeName* map, KeyType key, ValueType value ) \
+	{ \
+		if( map->capacity == 0 ) { \
+			prefix##__Allocate( map, 8 ); \
+		} \
+		\
+		uint32_t idx = ( hashKey( key ) ) & (uint32_t)( map->capacity - 1 ); \
+		uint8_t currLength = 0; \
+		while( map->keys[idx].probeLength != UINT8_MAX ) { \
+			if( currLength > map->probeLimit ) { \
+				/* past the probe limit, grow and start the insertion over with whatever we're currently holding */ \
+				prefix##__Resize( map, (uint32_t)( map->capacity * 2 ) ); \
+				idx = ( hashKey( key ) ) & (uint32_t)( map->capacity - 1 ); \
+				currLength = 0; \
+				continue; \
+			} \
+			\
+			if( currLength > map->keys[idx].probeLength ) { \
+				/* take from the rich and give to the poor */ \
+				KeyType swapKey = map->keys[idx].key; map->keys[idx].key = key; key = swapKey; \
+				uint8_t swapLength = map->keys[idx].probeLength; map->keys[idx].probeLength = currLength; currLength = swapLength; \
+				ValueType swapValue = map->values[idx]; map->values[idx] = value; value = swapValue; \
+			} \
+			\
+			idx = ( idx + 1 ) & (uint32_t)( map->capacity - 1 ); \
+			++currLength; \
+		} \
+		\
+		map->keys[idx].key = key; \
+		map->keys[idx].probeLength = currLength; \
+		map->values[idx] = value; \
+		++( map->count ); \
+	} \
+	\
+	static bool prefix##__FindIndex( TypeName* map, KeyType key, uint32_t* outIdx ) \
+	{ \
+		if( map->capacity == 0 ) return false; \
+		\
+		uint32_t idx = ( hashKey( key ) ) & (uint32_t)( map->capacity - 1 ); \
+		uint8_t currLength = 0; \
+		while( ( map->keys[idx].probeLength != UINT8_MAX ) && ( currLength <= map->keys[idx].probeLength ) ) { \
+			if( ( map->keys[idx].probeLength == currLength ) && ( keysEqual( map->keys[idx].key, key ) ) ) { \
+				(*outIdx) = idx; \
+				return true; \
+			} \
+			idx = ( idx + 1 ) & (uint32_t)( map->capacity - 1 ); \
+			++currLength; \
+		} \
+		return false; \
+	} \
+	\
+	void prefix##_Init( TypeName* map, uint32_t estimatedSize ) \
+	{ \
+		assert( map != NULL ); \
+		map->capacity = 0; \
+		map->keys = NULL; \
+		map->values = NULL; \
+		map->probeLimit = 0; \
+		map->count = 0; \
+		if( estimatedSize > 0 ) { \
+			prefix##__Allocate( map, prefix##__Capacity( estimatedSize * 2 ) ); \
+		} \
+	} \
+	\
+	void prefix##_Set( TypeName* map, KeyType key, ValueType value ) \
+	{ \
+		assert( map != NULL ); \
+		uint32_t idx; \
+		if( prefix##__FindIndex( map, key, &idx ) ) { \
+			map->values[idx] = value; \
+			return; \
+		} \
+		prefix##__Insert( map, key, value ); \
+	} \
+	\
+	bool prefix##_Find( TypeName* map, KeyType key, ValueType* outValue ) \
+	{ \
+		assert( map != NULL ); \
+		uint32_t idx; \
+		if( !prefix##__FindIndex( map, key, &idx ) ) { \
+			return false; \
+		} \
+		if( outValue != NULL ) { \
+			(*outValue) = map->values[idx]; \
+		} \
+		return true; \
+	} \
+	\
+	ValueType* prefix##_Get( TypeName* map, KeyType key ) \
+	{ \
+		assert( map != NULL ); \
+		uint32_t idx; \
+		if( !prefix##__FindIndex( map, key, &idx ) ) { \
+			return NULL; \
+		} \
+		return &( map->values[idx] ); \
+	} \
+	\
+	bool prefix##_Exists( TypeName* map, KeyType key ) \
+	{ \
+		assert( map != NULL ); \
+		uint32_t idx; \
+		return prefix##__FindIndex( map, key, &idx ); \
+	} \
+	\
+	void prefix##_Remove( TypeName* map, KeyType key ) \
+	{ \
+		assert( map != NULL ); \
+		uint32_t idx; \
+		if( !prefix##__FindIndex( map, key, &idx ) ) { \
+			return; \
+		} \
+		\
+		/* shift everything after it back a spot until we hit an empty slot or one that's in it's ideal spot */ \
+		map->keys[idx].probeLength = UINT8_MAX; \
+		uint32_t prevIdx = idx; \
+		idx = ( idx + 1 ) & (uint32_t)( map->capacity - 1 ); \
+		while( ( map->keys[idx].probeLength != UINT8_MAX ) && ( map->keys[idx].probeLength != 0 ) ) { \
+			map->keys[prevIdx].key = map->keys[idx].key; \
+			map->keys[prevIdx].probeLength = map->keys[idx].probeLength - 1; \
+			map->values[prevIdx] = map->values[idx]; \
+			map->keys[idx].probeLength = UINT8_MAX; \
+			prevIdx = idx; \
+			idx = ( idx + 1 ) & (uint32_t)( map->capacity - 1 ); \
+		} \
+		--( map->count ); \
+	} \
+	\
+	void prefix##_Clear( TypeName* map ) \
+	{ \
+		assert( map != NULL ); \
+		mem_Release( map->keys ); \
+		mem_Release( map->values ); \
+		map->keys = NULL; \
+		map->values = NULL; \
+		map->capacity = 0; \
+		map->probeLimit = 0; \
+		map->count = 0; \
+	}
+
+#endif /* inclusion guard */
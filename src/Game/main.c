@@ -19,6 +19,8 @@
 #include "Math/mathUtil.h"
 #include "sound.h"
 #include "Utils/cfgFile.h"
+#include "Utils/symbols.h"
+#include "Utils/assetPack.h"
 #include "IMGUI/nuklearWrapper.h"
 #include "world.h"
 
@@ -38,9 +40,13 @@
 #include "System/random.h"
 
 #include "Graphics/debugRendering.h"
+#include "Graphics/renderStats.h"
+#include "Graphics/textureUpload.h"
 #include "Graphics/glPlatform.h"
 
 #include "System/jobQueue.h"
+#include "System/loadQueue.h"
+#include "System/fileWatcher.h"
 
 // 540 x 960
 
@@ -88,6 +94,9 @@ int getWindowRefreshRate( SDL_Window* w )
 
 void cleanUp( void )
 {
+	// before the job queue is shut down, any texture uploads still being copied on the workers have to finish
+	gfx_CleanUp( );
+
 	jq_ShutDown( );
 
 	SDL_DestroyWindow( window );
@@ -95,6 +104,12 @@ void cleanUp( void )
 
 	snd_CleanUp( );
 
+	sym_CleanUp( );
+
+	assetPack_Unmount( );
+
+	fw_CleanUp( );
+
 	SDL_Quit( );
 
 	if( logFile != NULL ) {
@@ -184,6 +199,29 @@ int initEverything( void )
 	llog( LOG_INFO, "SDL successfully initialized." );
 	atexit( cleanUp );
 
+	// the pack is optional, anything not in it is loaded from the loose files
+	assetPack_Mount( "data.pak" );
+
+	// leave a core for the main thread
+	int numWorkers = SDL_GetCPUCount( ) - 1;
+	numWorkers = MAX( 1, MIN( numWorkers, 4 ) );
+	if( jq_Initialize( (uint8_t)numWorkers ) < 0 ) {
+		return -1;
+	}
+	llog( LOG_INFO, "Job queue successfully initialized." );
+
+	// enough to keep the workers busy without flooding the job queue
+	if( lq_Init( numWorkers * 2 ) < 0 ) {
+		return -1;
+	}
+	llog( LOG_INFO, "Load queue successfully initialized." );
+
+	// before anything is loaded so it can all be watched
+	if( fw_Init( ) < 0 ) {
+		return -1;
+	}
+	llog( LOG_INFO, "File watcher successfully initialized." );
+
 	// set up opengl
 	//  try opening and parsing the config file
 	int majorVersion;
@@ -300,10 +338,12 @@ int initEverything( void )
 
 	rand_Seed( NULL, (uint32_t)time( NULL ) );
 
+	Uint64 loadTimer = gt_StartTimer( );
 	if( !loadAssets( ) ) {
 		llog( LOG_ERROR, "Unable to load assets." );
 		return -2;
 	}
+	llog( LOG_INFO, "Assets loaded in %.4f seconds", gt_StopTimer( loadTimer ) );
 
 	return 0;
 }
@@ -346,6 +386,11 @@ void processEvents( int windowsEventsOnly )
 			continue;
 		}
 
+		// show what the renderers are doing
+		if( ( e.type == SDL_KEYDOWN ) && ( e.key.keysym.sym == SDLK_F3 ) && !e.key.repeat ) {
+			rstats_ToggleOverlay( );
+		}
+
 		sys_ProcessEvents( &e );
 		input_ProcessEvents( &e );
 		gsm_ProcessEvents( &globalFSM, &e );
@@ -392,6 +437,7 @@ void mainLoop( void* v )
 	// handle per frame update
 	sys_Process( );
 	gsm_Process( &globalFSM );
+	rstats_DoOverlay( &( editorIMGUI.ctx ) );
 	float procTimerSec = gt_StopTimer( procTimer );
 
 	Uint64 physicsTimer = gt_StartTimer( );
@@ -420,8 +466,11 @@ void mainLoop( void* v )
 	float drawTimerSec = gt_StopTimer( drawTimer );
 
 	Uint64 mainJobsTimer = gt_StartTimer( );
-	// process all the jobs we need the main thread for, using this reduces the need for synchronization
+	// reload anything that's changed, start any waiting asset loads, then process all the jobs we need the main thread for, using this reduces the need for synchronization
+	fw_Process( );
+	lq_Process( );
 	jq_ProcessMainThreadJobs( );
+	texUpload_Process( );
 	float mainJobsTimerSec = gt_StopTimer( mainJobsTimer );
 
 	Uint64 renderTimer = gt_StartTimer( );
@@ -15,7 +15,9 @@
 #include "Utils\stretchyBuffer.h"
 #include "Utils\helpers.h"
 #include "Utils\cfgFile.h"
-#include "System\jobQueue.h"
+#include "Utils\assetCache.h"
+#include "Utils\assetPack.h"
+#include "System\loadQueue.h"
 
 #define MAX_SAMPLES 256
 #define MAX_PLAYING_SOUNDS 32
@@ -37,6 +39,8 @@ typedef struct {
 	float* data;
 	int numSamples;
 	bool loops;
+	Symbol key; // INVALID_SYMBOL if the sample isn't in the cache
+	LoadState loadState;
 } Sample;
 
 // TODO: Get pitch working with streaming sounds, was running into problems with clicking when doing streaming sounds with pitch
@@ -79,12 +83,15 @@ static Sample sineWave;
 static float* workingBuffer = NULL;
 
 static Sample samples[MAX_SAMPLES];
+static AssetCache sampleCache; // so each file is only decoded once for each set of settings
+static int placeholderSample = -1; // played instead of samples that are still being streamed in
 static Sound playingSounds[MAX_PLAYING_SOUNDS];
 static IDSet playingIDSet; // we want to be able to change the currently playing sounds, this will help
 
 static StreamingSound streamingSounds[MAX_STREAMING_SOUNDS];
 
 static void* soundCfgFile;
+static Symbol volumeCfgSymbol = INVALID_SYMBOL;
 
 typedef struct {
 	float volume;
@@ -232,17 +239,47 @@ void mixerCallback( void* userdata, Uint8* streamData, int len )
 	memcpy( streamData, workingBuffer, len );
 }
 
+static Symbol sampleKey( const char* fileName, Uint8 desiredChannels, bool loops )
+{
+	return assetCache_MakeKey( fileName, "%i,%i", (int)desiredChannels, loops ? 1 : 0 );
+}
+
+static int findFreeSample( void )
+{
+	for( int i = 0; i < ARRAY_SIZE( samples ); ++i ) {
+		if( ( samples[i].data == NULL ) && ( samples[i].loadState == LOAD_STATE_NONE ) ) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+// decodes the entire file, straight out of the asset pack if it's in there
+static int decodeVorbisFile( const char* fileName, int* outChannels, int* outRate, short** outData )
+{
+	const uint8_t* packedData;
+	size_t packedSize;
+	if( assetPack_GetFile( fileName, &packedData, &packedSize ) ) {
+		return stb_vorbis_decode_memory( packedData, (int)packedSize, outChannels, outRate, outData );
+	}
+
+	return stb_vorbis_decode_filename( fileName, outChannels, outRate, outData );
+}
+
+// If the sample has already been loaded with the same settings a reference is added and it's returned, every load has to
+//  be matched by an snd_UnloadSample.
 int snd_LoadSample( const char* fileName, Uint8 desiredChannels, bool loops )
 {
 	assert( ( desiredChannels >= 1 ) && ( desiredChannels <= 2 ) );
 
 	int newIdx = -1;
-	for( int i = 0; ( i < ARRAY_SIZE( samples ) ) && ( newIdx < 0 ); ++i ) {
-		if( samples[i].data == NULL ) {
-			newIdx = i;
-		}
+	Symbol key = sampleKey( fileName, desiredChannels, loops );
+	if( assetCache_AddRef( &sampleCache, key, &newIdx ) ) {
+		return newIdx;
 	}
 
+	newIdx = findFreeSample( );
 	if( newIdx < 0 ) {
 		llog( LOG_ERROR, "Unable to find free space for sample." );
 		return -1;
@@ -252,7 +289,7 @@ int snd_LoadSample( const char* fileName, Uint8 desiredChannels, bool loops )
 	int channels;
 	int rate;
 	short* data = NULL;
-	int numSamples = stb_vorbis_decode_filename( fileName, &channels, &rate, &data );
+	int numSamples = decodeVorbisFile( fileName, &channels, &rate, &data );
 
 	if( numSamples <= 0 ) {
 		newIdx = -1;
@@ -296,6 +333,8 @@ int snd_LoadSample( const char* fileName, Uint8 desiredChannels, bool loops )
 	samples[newIdx].numChannels = desiredChannels;
 	samples[newIdx].numSamples = loadConverter.len_cvt / ( desiredChannels * ( ( SDL_AUDIO_MASK_BITSIZE & WORKING_FORMAT ) / 8 ) );
 	samples[newIdx].loops = loops;
+	samples[newIdx].key = key;
+	assetCache_Store( &sampleCache, key, newIdx );
 
 clean_up:
 	// clean up the working data
@@ -304,10 +343,9 @@ clean_up:
 }
 
 typedef struct {
-	const char* fileName;
+	char* fileName;
+	int idx;
 	Uint8 desiredChannels;
-	bool loops;
-	int* outID;
 	SDL_AudioCVT loadConverter;
 } ThreadedSoundLoadData;
 
@@ -316,61 +354,55 @@ static void cleanUpThreadedSoundLoadData( ThreadedSoundLoadData* data )
 	mem_Release( data->loadConverter.buf );
 	data->loadConverter.buf = NULL;
 
+	mem_Release( data->fileName );
 	mem_Release( data );
 }
 
-static void bindSampleJob( void* data )
+static void bindSample( void* data, bool loaded )
 {
-	if( data == NULL ) {
-		llog( LOG_ERROR, "NULL data passed into loadSampleJob!" );
-		return;
-	}
-
 	ThreadedSoundLoadData* loadData = (ThreadedSoundLoadData*)data;
+	Sample* sample = &( samples[loadData->idx] );
 
-	int newIdx = -1;
-	for( int i = 0; ( i < ARRAY_SIZE( samples ) ) && ( newIdx < 0 ); ++i ) {
-		if( samples[i].data == NULL ) {
-			newIdx = i;
-		}
-	}
-
-	if( newIdx < 0 ) {
-		llog( LOG_ERROR, "Unable to find free space for sample." );
+	if( sample->loadState == LOAD_STATE_CANCELLED ) {
+		// everything that wanted it was unloaded while it was loading
+		sample->loadState = LOAD_STATE_NONE;
 		goto clean_up;
 	}
 
-	// store it
-	samples[newIdx].data = mem_Allocate( loadData->loadConverter.len_cvt );
+	float* sampleData = NULL;
+	if( loaded ) {
+		sampleData = mem_Allocate( loadData->loadConverter.len_cvt );
+	}
 
-	memcpy( samples[newIdx].data, loadData->loadConverter.buf, loadData->loadConverter.len_cvt );
+	if( sampleData == NULL ) {
+		llog( LOG_ERROR, "Unable to bind sound sample %s", loadData->fileName );
+		sample->loadState = LOAD_STATE_FAILED;
+		goto clean_up;
+	}
 
-	samples[newIdx].numChannels = loadData->desiredChannels;
-	samples[newIdx].numSamples = loadData->loadConverter.len_cvt / ( loadData->desiredChannels * ( ( SDL_AUDIO_MASK_BITSIZE & WORKING_FORMAT ) / 8 ) );
-	samples[newIdx].loops = loadData->loops;
+	memcpy( sampleData, loadData->loadConverter.buf, loadData->loadConverter.len_cvt );
 
-	(*(loadData->outID)) = newIdx;
+	SDL_LockAudioDevice( devID ); {
+		sample->data = sampleData;
+		sample->numSamples = loadData->loadConverter.len_cvt / ( loadData->desiredChannels * ( ( SDL_AUDIO_MASK_BITSIZE & WORKING_FORMAT ) / 8 ) );
+		sample->loadState = LOAD_STATE_NONE;
+	} SDL_UnlockAudioDevice( devID );
 
 clean_up:
 	cleanUpThreadedSoundLoadData( loadData );
 }
 
-static void loadSampleJob( void* data )
+static bool loadSample( void* data )
 {
-	if( data == NULL ) {
-		llog( LOG_ERROR, "NULL data passed into loadSampleJob!" );
-		return;
-	}
-
 	ThreadedSoundLoadData* loadData = (ThreadedSoundLoadData*)data;
 
 	// read the entire file into memory and decode it
 	int channels;
 	int rate;
-	short* buffer;
-	int numSamples = stb_vorbis_decode_filename( loadData->fileName, &channels, &rate, &buffer );
+	short* buffer = NULL;
+	int numSamples = decodeVorbisFile( loadData->fileName, &channels, &rate, &buffer );
 
-	if( numSamples < 0 ) {
+	if( numSamples <= 0 ) {
 		llog( LOG_ERROR, "Error decoding sound sample %s", loadData->fileName );
 		goto error;
 	}
@@ -384,7 +416,6 @@ static void loadSampleJob( void* data )
 	}
 
 	loadData->loadConverter.len = numSamples * channels * sizeof( buffer[0] );
-	size_t totLen = loadData->loadConverter.len * loadData->loadConverter.len_mult;
 	if( loadData->loadConverter.len_mult > 1 ) {
 		buffer = mem_Resize( buffer, loadData->loadConverter.len * loadData->loadConverter.len_mult ); // need to make sure there's enough room
 		if( buffer == NULL ) {
@@ -394,36 +425,86 @@ static void loadSampleJob( void* data )
 	}
 	loadData->loadConverter.buf = (Uint8*)buffer;
 
-	SDL_ConvertAudio( &( loadData->loadConverter ) );
-
-	jq_AddMainThreadJob( bindSampleJob, (void*)loadData );
+	if( SDL_ConvertAudio( &( loadData->loadConverter ) ) < 0 ) {
+		llog( LOG_ERROR, "Unable to convert sound: %s", SDL_GetError( ) );
+		return false;
+	}
 
-	return;
+	return true;
 
 error:
-	cleanUpThreadedSoundLoadData( loadData );
+	mem_Release( buffer );
+	return false;
 }
 
-void snd_ThreadedLoadSample( const char* fileName, Uint8 desiredChannels, bool loops, int* outID )
+// Streams the sample in the background, the returned id can be used right away. Until the sample is loaded playing it
+//  plays the placeholder sample instead. If the sample has already been loaded or is loading with the same settings a
+//  reference is added and it's returned, the same as snd_LoadSample.
+int snd_ThreadedLoadSample( const char* fileName, Uint8 desiredChannels, bool loops, LoadPriority priority )
 {
 	assert( ( desiredChannels >= 1 ) && ( desiredChannels <= 2 ) );
-	assert( outID != NULL );
 
-	(*outID) = -1;
+	int newIdx = -1;
+	Symbol key = sampleKey( fileName, desiredChannels, loops );
+	if( assetCache_AddRef( &sampleCache, key, &newIdx ) ) {
+		return newIdx;
+	}
+
+	newIdx = findFreeSample( );
+	if( newIdx < 0 ) {
+		llog( LOG_ERROR, "Unable to find free space for sample." );
+		return -1;
+	}
 
 	ThreadedSoundLoadData* loadData = mem_Allocate( sizeof( ThreadedSoundLoadData ) );
 	if( loadData == NULL ) {
 		llog( LOG_ERROR, "Unable to allocated data struct for threaded loading of sound sample" );
-		return;
+		return -1;
 	}
 
-	loadData->fileName = fileName;
+	size_t fileNameLen = SDL_strlen( fileName );
+	loadData->fileName = mem_Allocate( fileNameLen + 1 );
+	if( loadData->fileName == NULL ) {
+		llog( LOG_ERROR, "Unable to allocate file name for threaded loading of sound sample" );
+		mem_Release( loadData );
+		return -1;
+	}
+	SDL_strlcpy( loadData->fileName, fileName, fileNameLen + 1 );
+
+	loadData->idx = newIdx;
 	loadData->desiredChannels = desiredChannels;
-	loadData->loops = loops;
-	loadData->outID = outID;
 	loadData->loadConverter.buf = NULL;
 
-	jq_AddJob( loadSampleJob, (void*)loadData );
+	if( !lq_Add( priority, fileName, loadSample, bindSample, (void*)loadData ) ) {
+		cleanUpThreadedSoundLoadData( loadData );
+		return -1;
+	}
+
+	// reserve the slot so it can be used until the load is done
+	samples[newIdx].data = NULL;
+	samples[newIdx].numSamples = 0;
+	samples[newIdx].numChannels = desiredChannels;
+	samples[newIdx].loops = loops;
+	samples[newIdx].key = key;
+	samples[newIdx].loadState = LOAD_STATE_PENDING;
+	assetCache_Store( &sampleCache, key, newIdx );
+
+	return newIdx;
+}
+
+void snd_SetPlaceholderSample( int sampleID )
+{
+	placeholderSample = sampleID;
+}
+
+// the volume is stored as a percentage, also used when the file is changed while the game is running
+static void readVolumeCfg( void* cfgFile, void* data )
+{
+	int vol;
+	cfg_GetIntBySymbol( cfgFile, volumeCfgSymbol, 100, &vol );
+	SDL_LockAudioDevice( devID ); {
+		masterVolume = (float)vol / 100.0f;
+	} SDL_UnlockAudioDevice( devID );
 }
 
 /* Sets up the SDL mixer. Returns 0 on success. */
@@ -433,6 +514,7 @@ int snd_Init( unsigned int numGroups )
 
 	// clear out the samples storage
 	SDL_memset( samples, 0, ARRAY_SIZE( samples ) * sizeof( samples[0] ) );
+	assetCache_Init( &sampleCache, 32 );
 	for( int i = 0; i < MAX_STREAMING_SOUNDS; ++i ) {
 		streamingSounds[i].access = NULL;
 		streamingSounds[i].sdlStream = NULL;
@@ -480,11 +562,11 @@ int snd_Init( unsigned int numGroups )
 	}
 
 	// load the master volume
+	volumeCfgSymbol = cfg_AttributeSymbol( "vol" );
 	soundCfgFile = cfg_OpenFile( "snd.cfg" );
 	if( soundCfgFile != NULL ) {
-		int vol;
-		cfg_GetInt( soundCfgFile, "vol", 100, &vol );
-		masterVolume = (float)vol / 100.0f;
+		readVolumeCfg( soundCfgFile, NULL );
+		cfg_SetChangedCallback( soundCfgFile, readVolumeCfg, NULL );
 	} else {
 		masterVolume = 1.0f;
 	}
@@ -527,7 +609,7 @@ void snd_SetMasterVolume( float volume )
 
 	// just save this out every single time
 	if( soundCfgFile != NULL ) {
-		cfg_SetInt( soundCfgFile, "vol", (int)volume );
+		cfg_SetIntBySymbol( soundCfgFile, volumeCfgSymbol, (int)( volume * 100.0f ) );
 		cfg_SaveFile( soundCfgFile );
 	}
 }
@@ -561,6 +643,14 @@ EntityID snd_Play( int sampleID, float volume, float pitch, float pan, unsigned
 		return INVALID_ENTITY_ID;
 	}
 
+	// hasn't been loaded yet, play the placeholder instead if there is one
+	if( samples[sampleID].data == NULL ) {
+		if( ( placeholderSample < 0 ) || ( samples[placeholderSample].data == NULL ) ) {
+			return INVALID_ENTITY_ID;
+		}
+		sampleID = placeholderSample;
+	}
+
 	assert( group >= 0 );
 	assert( group < sb_Count( sbSoundGroups ) );
 
@@ -626,7 +716,25 @@ void snd_UnloadSample( int sampleID )
 	assert( sampleID >= 0 );
 	assert( sampleID < MAX_SAMPLES );
 
-	if( samples[sampleID].data == NULL ) {
+	if( ( samples[sampleID].data == NULL ) &&
+		( ( samples[sampleID].loadState == LOAD_STATE_NONE ) || ( samples[sampleID].loadState == LOAD_STATE_CANCELLED ) ) ) {
+		return;
+	}
+
+	if( !assetCache_Release( &sampleCache, samples[sampleID].key, sampleID ) ) {
+		return;
+	}
+	samples[sampleID].key = INVALID_SYMBOL;
+
+	if( samples[sampleID].loadState == LOAD_STATE_PENDING ) {
+		// the slot is still needed for the load, it's freed when the load finishes
+		samples[sampleID].loadState = LOAD_STATE_CANCELLED;
+		return;
+	}
+
+	if( samples[sampleID].loadState == LOAD_STATE_FAILED ) {
+		// nothing was ever played with it
+		samples[sampleID].loadState = LOAD_STATE_NONE;
 		return;
 	}
 
@@ -663,8 +771,15 @@ int snd_LoadStreaming( const char* fileName, bool loops, unsigned int group )
 		return -1;
 	}
 
+	// packed files can be streamed straight from the pack, it stays mapped until we shut down
 	int error;
-	streamingSounds[newIdx].access = stb_vorbis_open_filename( fileName, &error, NULL );
+	const uint8_t* packedData;
+	size_t packedSize;
+	if( assetPack_GetFile( fileName, &packedData, &packedSize ) ) {
+		streamingSounds[newIdx].access = stb_vorbis_open_memory( packedData, (int)packedSize, &error, NULL );
+	} else {
+		streamingSounds[newIdx].access = stb_vorbis_open_filename( fileName, &error, NULL );
+	}
 	if( streamingSounds[newIdx].access == NULL ) {
 		llog( LOG_ERROR, "Unable to acquire a handle to streaming sound %s", fileName );
 		return -1;
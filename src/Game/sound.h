@@ -5,6 +5,7 @@
 #include <SDL_types.h>
 
 #include "Utils\idSet.h"
+#include "System\loadQueue.h"
 
 // Sets up the SDL mixer. Returns 0 on success.
 int snd_Init( unsigned int numGroups );
@@ -23,7 +24,13 @@ void snd_SetVolume( float volume, unsigned int group );
 
 //***** Loaded all at once
 int snd_LoadSample( const char* fileName, Uint8 desiredChannels, bool loops );
-void snd_ThreadedLoadSample( const char* fileName, Uint8 desiredChannels, bool loops, int* outID );
+
+// Streams the sample in the background, the returned id can be used right away. Until the sample is loaded playing it
+//  plays the placeholder sample instead. Returns -1 if the load couldn't be started.
+int snd_ThreadedLoadSample( const char* fileName, Uint8 desiredChannels, bool loops, LoadPriority priority );
+
+// Sets the sample played in place of any sample that's still loading or failed to load, -1 plays nothing instead.
+void snd_SetPlaceholderSample( int sampleID );
 
 // Returns an id that can be used to change the volume and pitch
 //  volume - how loud the sound will be, in the range [0,1], 0 being off, 1 being loudest
@@ -0,0 +1,328 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined( _WIN32 )
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <dirent.h>
+	#include <sys/stat.h>
+#endif
+
+#include "../Game/Graphics/spriteSheetFormat.h"
+#include "../Game/Utils/tokenizer.h"
+
+// Compiles the text sprite sheet definitions into the binary format the game can load without parsing, see
+//  spriteSheetFormat.h. The binary file is written next to each definition, and is only rebuilt if the text has changed.
+
+#define PATH_LENGTH 512
+
+static bool force = false;
+static bool verbose = false;
+
+static int numConverted = 0;
+static int numSkipped = 0;
+static int numFailed = 0;
+
+// returns if strToTest ends with strValue, ignoring case
+static bool endsWith( const char* strToTest, const char* strValue )
+{
+	size_t valLen = strlen( strValue );
+	size_t testLen = strlen( strToTest );
+
+	if( valLen > testLen ) {
+		return false;
+	}
+
+	const char* test = strToTest + ( testLen - valLen );
+	for( size_t i = 0; i < valLen; ++i ) {
+		char c = test[i];
+		if( ( c >= 'A' ) && ( c <= 'Z' ) ) {
+			c = c - 'A' + 'a';
+		}
+		if( c != strValue[i] ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static uint8_t* readFile( const char* path, size_t* outSize )
+{
+	FILE* file = fopen( path, "rb" );
+	if( file == NULL ) {
+		return NULL;
+	}
+
+	fseek( file, 0, SEEK_END );
+	long size = ftell( file );
+	fseek( file, 0, SEEK_SET );
+
+	uint8_t* data = ( size > 0 ) ? malloc( (size_t)size ) : NULL;
+	if( ( data != NULL ) && ( fread( data, 1, (size_t)size, file ) != (size_t)size ) ) {
+		free( data );
+		data = NULL;
+	}
+	fclose( file );
+
+	(*outSize) = (size_t)size;
+	return data;
+}
+
+static bool binaryUpToDate( const char* binPath, uint64_t sourceHash )
+{
+	FILE* file = fopen( binPath, "rb" );
+	if( file == NULL ) {
+		return false;
+	}
+
+	SheetBinHeader header;
+	bool upToDate = ( fread( &header, sizeof( header ), 1, file ) == 1 ) &&
+		( header.magic == SHEET_BIN_MAGIC ) && ( header.version == SHEET_BIN_VERSION ) &&
+		( header.sourceHash == sourceHash );
+	fclose( file );
+
+	return upToDate;
+}
+
+// adds the slice to the end of the strings, returning where it was put
+static uint32_t addString( char** strings, size_t* stringsSize, StringSlice str )
+{
+	uint32_t offset = (uint32_t)(*stringsSize);
+
+	char* newStrings = realloc( (*strings), (*stringsSize) + str.length + 1 );
+	if( newStrings == NULL ) {
+		fprintf( stderr, "Out of memory.\n" );
+		exit( 1 );
+	}
+	(*strings) = newStrings;
+
+	memcpy( (*strings) + (*stringsSize), str.start, str.length );
+	(*stringsSize) += str.length;
+
+	return offset;
+}
+
+// has to accept exactly what the game does, see parseTextSheet in imageSheets.c
+static bool compileSheet( const char* path )
+{
+	char binPath[PATH_LENGTH];
+	if( snprintf( binPath, sizeof( binPath ), "%s%s", path, SHEET_BIN_EXTENSION ) >= (int)sizeof( binPath ) ) {
+		fprintf( stderr, "Path too long: %s\n", path );
+		return false;
+	}
+
+	size_t sourceSize;
+	uint8_t* source = readFile( path, &sourceSize );
+	if( source == NULL ) {
+		fprintf( stderr, "Unable to read %s\n", path );
+		return false;
+	}
+
+	uint64_t sourceHash = sheetBin_HashData( source, sourceSize );
+	if( !force && binaryUpToDate( binPath, sourceHash ) ) {
+		free( source );
+		++numSkipped;
+		return true;
+	}
+
+	bool success = false;
+	SheetBinSprite* sprites = NULL;
+	size_t numSprites = 0;
+	size_t spritesCapacity = 0;
+	char* strings = NULL;
+	size_t stringsSize = 0;
+
+	SheetBinHeader header;
+	memset( &header, 0, sizeof( header ) );
+	header.magic = SHEET_BIN_MAGIC;
+	header.version = SHEET_BIN_VERSION;
+	header.sourceHash = sourceHash;
+
+	Tokenizer tok;
+	tok_Init( &tok, (const char*)source, sourceSize );
+
+	// first line is the version, second is the image file name
+	StringSlice line;
+	if( !tok_NextLine( &tok, &line ) || !tok_NextLine( &tok, &line ) ) {
+		fprintf( stderr, "Missing image file name in %s\n", path );
+		goto clean_up;
+	}
+	line = tok_Trim( line );
+	header.imageNameLength = (uint32_t)line.length;
+	header.imageNameOffset = addString( &strings, &stringsSize, line );
+
+	while( tok_NextLine( &tok, &line ) ) {
+		StringSlice rest = line;
+		StringSlice id, x, y, w, h;
+		SheetBinSprite sprite;
+		int rect[4];
+		if( !tok_NextToken( &rest, " \t", &id ) ||
+			!tok_NextToken( &rest, " \t", &x ) || !tok_ToInt( x, &( rect[0] ) ) ||
+			!tok_NextToken( &rest, " \t", &y ) || !tok_ToInt( y, &( rect[1] ) ) ||
+			!tok_NextToken( &rest, " \t", &w ) || !tok_ToInt( w, &( rect[2] ) ) ||
+			!tok_NextToken( &rest, " \t", &h ) || !tok_ToInt( h, &( rect[3] ) ) ) {
+			fprintf( stderr, "Invalid sprite definition \"%.*s\" in %s\n", (int)line.length, line.start, path );
+			goto clean_up;
+		}
+
+		sprite.idLength = (uint32_t)id.length;
+		sprite.idOffset = addString( &strings, &stringsSize, id );
+		sprite.x = rect[0];
+		sprite.y = rect[1];
+		sprite.w = rect[2];
+		sprite.h = rect[3];
+
+		if( numSprites >= spritesCapacity ) {
+			spritesCapacity = ( spritesCapacity == 0 ) ? 64 : ( spritesCapacity * 2 );
+			SheetBinSprite* newSprites = realloc( sprites, spritesCapacity * sizeof( SheetBinSprite ) );
+			if( newSprites == NULL ) {
+				fprintf( stderr, "Out of memory.\n" );
+				goto clean_up;
+			}
+			sprites = newSprites;
+		}
+		sprites[numSprites++] = sprite;
+	}
+
+	header.numSprites = (uint32_t)numSprites;
+	header.stringsSize = (uint32_t)stringsSize;
+
+	FILE* out = fopen( binPath, "wb" );
+	if( out != NULL ) {
+		success = ( fwrite( &header, sizeof( header ), 1, out ) == 1 ) &&
+			( fwrite( sprites, sizeof( SheetBinSprite ), numSprites, out ) == numSprites ) &&
+			( fwrite( strings, 1, stringsSize, out ) == stringsSize );
+		success = ( fclose( out ) == 0 ) && success;
+	}
+
+	if( success ) {
+		++numConverted;
+		if( verbose ) {
+			fprintf( stdout, "  %s %i sprites\n", path, (int)numSprites );
+		}
+	} else {
+		fprintf( stderr, "Unable to write %s\n", binPath );
+		remove( binPath );
+	}
+
+clean_up:
+	free( strings );
+	free( sprites );
+	free( source );
+
+	return success;
+}
+
+static void processPath( const char* path );
+
+static void processDirectory( const char* dirPath )
+{
+#if defined( _WIN32 )
+	char search[PATH_LENGTH];
+	snprintf( search, sizeof( search ), "%s/*", dirPath );
+
+	WIN32_FIND_DATAA findData;
+	HANDLE find = FindFirstFileA( search, &findData );
+	if( find == INVALID_HANDLE_VALUE ) {
+		fprintf( stderr, "Unable to open directory %s\n", dirPath );
+		++numFailed;
+		return;
+	}
+
+	do {
+		if( ( strcmp( findData.cFileName, "." ) == 0 ) || ( strcmp( findData.cFileName, ".." ) == 0 ) ) {
+			continue;
+		}
+
+		char fullPath[PATH_LENGTH];
+		snprintf( fullPath, sizeof( fullPath ), "%s/%s", dirPath, findData.cFileName );
+		processPath( fullPath );
+	} while( FindNextFileA( find, &findData ) );
+	FindClose( find );
+#else
+	DIR* dir = opendir( dirPath );
+	if( dir == NULL ) {
+		fprintf( stderr, "Unable to open directory %s\n", dirPath );
+		++numFailed;
+		return;
+	}
+
+	struct dirent* entry;
+	while( ( entry = readdir( dir ) ) != NULL ) {
+		if( ( strcmp( entry->d_name, "." ) == 0 ) || ( strcmp( entry->d_name, ".." ) == 0 ) ) {
+			continue;
+		}
+
+		char fullPath[PATH_LENGTH];
+		snprintf( fullPath, sizeof( fullPath ), "%s/%s", dirPath, entry->d_name );
+		processPath( fullPath );
+	}
+	closedir( dir );
+#endif
+}
+
+// compiles the path if it's a sprite sheet, or everything under it if it's a directory
+static void processPath( const char* path )
+{
+#if defined( _WIN32 )
+	DWORD attributes = GetFileAttributesA( path );
+	bool exists = ( attributes != INVALID_FILE_ATTRIBUTES );
+	bool isDirectory = exists && ( attributes & FILE_ATTRIBUTE_DIRECTORY );
+#else
+	struct stat fileStat;
+	bool exists = ( stat( path, &fileStat ) == 0 );
+	bool isDirectory = exists && S_ISDIR( fileStat.st_mode );
+#endif
+
+	if( !exists ) {
+		fprintf( stderr, "Unable to find %s\n", path );
+		++numFailed;
+	} else if( isDirectory ) {
+		processDirectory( path );
+	} else if( endsWith( path, ".ss" ) ) {
+		if( !compileSheet( path ) ) {
+			++numFailed;
+		}
+	}
+}
+
+int main( int argc, char** argv )
+{
+	int argIdx = 1;
+	for( ; ( argIdx < argc ) && ( argv[argIdx][0] == '-' ); ++argIdx ) {
+		if( strcmp( "-h", argv[argIdx] ) == 0 ) {
+			fprintf( stdout, "Compiles sprite sheet definitions into binary files the game can load without parsing.\n" );
+			fprintf( stdout, "Each binary file is written next to its definition, only definitions that have changed are rebuilt.\n" );
+			fprintf( stdout, "Useage: SheetCompiler [-f] [-v] path [path ...]\n" );
+			fprintf( stdout, "  paths can be sprite sheets or directories, directories are searched for .ss files\n" );
+			fprintf( stdout, "  -f - rebuild all the binary files, even if they're up to date\n" );
+			fprintf( stdout, "  -v - list each sprite sheet as it's compiled\n" );
+			return 0;
+		} else if( strcmp( "-f", argv[argIdx] ) == 0 ) {
+			force = true;
+		} else if( strcmp( "-v", argv[argIdx] ) == 0 ) {
+			verbose = true;
+		} else {
+			fprintf( stderr, "Unknown option %s, use -h to get help.\n", argv[argIdx] );
+			return 1;
+		}
+	}
+
+	if( argIdx >= argc ) {
+		fprintf( stderr, "Invalid arguments, use -h to get help.\n" );
+		return 1;
+	}
+
+	for( ; argIdx < argc; ++argIdx ) {
+		processPath( argv[argIdx] );
+	}
+
+	fprintf( stdout, "Compiled %i sprite sheets, %i up to date, %i failed.\n", numConverted, numSkipped, numFailed );
+
+	return ( numFailed > 0 ) ? 1 : 0;
+}
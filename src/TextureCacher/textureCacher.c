@@ -0,0 +1,308 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined( _WIN32 )
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <dirent.h>
+	#include <sys/stat.h>
+#endif
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_FAILURE_USERMSG
+#include <stb_image.h>
+
+#include "../Game/Graphics/textureCacheFormat.h"
+#include "../Game/Utils/lz4Block.h"
+
+// Decodes images ahead of time into the texture cache format the game can load without decoding, see
+//  textureCacheFormat.h. The cache file is written next to each image, and is only rebuilt if the image has changed.
+
+#define PATH_LENGTH 512
+
+static bool useLZ4 = false;
+static bool force = false;
+static bool verbose = false;
+
+static int numConverted = 0;
+static int numSkipped = 0;
+static int numFailed = 0;
+static uint64_t totalPixelBytes = 0;
+static uint64_t totalStoredBytes = 0;
+
+// returns if strToTest ends with strValue, ignoring case
+static bool endsWith( const char* strToTest, const char* strValue )
+{
+	size_t valLen = strlen( strValue );
+	size_t testLen = strlen( strToTest );
+
+	if( valLen > testLen ) {
+		return false;
+	}
+
+	const char* test = strToTest + ( testLen - valLen );
+	for( size_t i = 0; i < valLen; ++i ) {
+		char c = test[i];
+		if( ( c >= 'A' ) && ( c <= 'Z' ) ) {
+			c = c - 'A' + 'a';
+		}
+		if( c != strValue[i] ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static uint8_t* readFile( const char* path, size_t* outSize )
+{
+	FILE* file = fopen( path, "rb" );
+	if( file == NULL ) {
+		return NULL;
+	}
+
+	fseek( file, 0, SEEK_END );
+	long size = ftell( file );
+	fseek( file, 0, SEEK_SET );
+
+	uint8_t* data = ( size > 0 ) ? malloc( (size_t)size ) : NULL;
+	if( ( data != NULL ) && ( fread( data, 1, (size_t)size, file ) != (size_t)size ) ) {
+		free( data );
+		data = NULL;
+	}
+	fclose( file );
+
+	(*outSize) = (size_t)size;
+	return data;
+}
+
+static bool cacheUpToDate( const char* cachePath, uint64_t sourceHash )
+{
+	FILE* file = fopen( cachePath, "rb" );
+	if( file == NULL ) {
+		return false;
+	}
+
+	TexCacheHeader header;
+	// raw caches are fine when compressing, they're the ones that didn't get any smaller
+	bool upToDate = ( fread( &header, sizeof( header ), 1, file ) == 1 ) &&
+		( header.magic == TEX_CACHE_MAGIC ) && ( header.version == TEX_CACHE_VERSION ) &&
+		( header.sourceHash == sourceHash ) && ( useLZ4 || !( header.flags & TEX_CACHE_FLAG_LZ4 ) );
+	fclose( file );
+
+	return upToDate;
+}
+
+static bool convertImage( const char* path )
+{
+	char cachePath[PATH_LENGTH];
+	if( snprintf( cachePath, sizeof( cachePath ), "%s%s", path, TEX_CACHE_EXTENSION ) >= (int)sizeof( cachePath ) ) {
+		fprintf( stderr, "Path too long: %s\n", path );
+		return false;
+	}
+
+	size_t sourceSize;
+	uint8_t* source = readFile( path, &sourceSize );
+	if( source == NULL ) {
+		fprintf( stderr, "Unable to read %s\n", path );
+		return false;
+	}
+
+	uint64_t sourceHash = texCache_HashData( source, sourceSize );
+	if( !force && cacheUpToDate( cachePath, sourceHash ) ) {
+		free( source );
+		++numSkipped;
+		return true;
+	}
+
+	int width, height, comp;
+	uint8_t* pixels = stbi_load_from_memory( source, (int)sourceSize, &width, &height, &comp, 4 );
+	free( source );
+	if( pixels == NULL ) {
+		fprintf( stderr, "Unable to decode %s: %s\n", path, stbi_failure_reason( ) );
+		return false;
+	}
+
+	TexCacheHeader header;
+	memset( &header, 0, sizeof( header ) );
+	header.magic = TEX_CACHE_MAGIC;
+	header.version = TEX_CACHE_VERSION;
+	header.width = (uint32_t)width;
+	header.height = (uint32_t)height;
+	header.format = TEX_CACHE_FORMAT_RGBA8;
+	header.sourceHash = sourceHash;
+
+	// the same check the game does when creating a texture
+	size_t pixelSize = texCache_PixelDataSize( &header );
+	for( size_t i = 3; i < pixelSize; i += 4 ) {
+		if( ( pixels[i] > 0x00 ) && ( pixels[i] < 0xFF ) ) {
+			header.flags |= TEX_CACHE_FLAG_TRANSLUCENT;
+			break;
+		}
+	}
+
+	const uint8_t* data = pixels;
+	header.dataSize = (uint32_t)pixelSize;
+
+	uint8_t* compressed = NULL;
+	if( useLZ4 ) {
+		int bound = lz4_CompressBound( (int)pixelSize );
+		compressed = malloc( (size_t)bound );
+		int compressedSize = ( compressed != NULL ) ? lz4_Compress( pixels, (int)pixelSize, compressed, bound ) : 0;
+
+		// keep it raw if compressing doesn't gain anything, then it can be used without copying
+		if( ( compressedSize > 0 ) && ( (size_t)compressedSize < pixelSize ) ) {
+			data = compressed;
+			header.dataSize = (uint32_t)compressedSize;
+			header.flags |= TEX_CACHE_FLAG_LZ4;
+		}
+	}
+
+	bool success = false;
+	FILE* out = fopen( cachePath, "wb" );
+	if( out != NULL ) {
+		success = ( fwrite( &header, sizeof( header ), 1, out ) == 1 ) &&
+			( fwrite( data, 1, header.dataSize, out ) == header.dataSize );
+		success = ( fclose( out ) == 0 ) && success;
+	}
+
+	if( success ) {
+		++numConverted;
+		totalPixelBytes += pixelSize;
+		totalStoredBytes += header.dataSize;
+		if( verbose ) {
+			fprintf( stdout, "  %s %ix%i %s%s\n", path, width, height,
+				( header.flags & TEX_CACHE_FLAG_TRANSLUCENT ) ? "translucent " : "",
+				( header.flags & TEX_CACHE_FLAG_LZ4 ) ? "lz4" : "raw" );
+		}
+	} else {
+		fprintf( stderr, "Unable to write %s\n", cachePath );
+		remove( cachePath );
+	}
+
+	free( compressed );
+	stbi_image_free( pixels );
+
+	return success;
+}
+
+static void processPath( const char* path );
+
+static void processDirectory( const char* dirPath )
+{
+#if defined( _WIN32 )
+	char search[PATH_LENGTH];
+	snprintf( search, sizeof( search ), "%s/*", dirPath );
+
+	WIN32_FIND_DATAA findData;
+	HANDLE find = FindFirstFileA( search, &findData );
+	if( find == INVALID_HANDLE_VALUE ) {
+		fprintf( stderr, "Unable to open directory %s\n", dirPath );
+		++numFailed;
+		return;
+	}
+
+	do {
+		if( ( strcmp( findData.cFileName, "." ) == 0 ) || ( strcmp( findData.cFileName, ".." ) == 0 ) ) {
+			continue;
+		}
+
+		char fullPath[PATH_LENGTH];
+		snprintf( fullPath, sizeof( fullPath ), "%s/%s", dirPath, findData.cFileName );
+		processPath( fullPath );
+	} while( FindNextFileA( find, &findData ) );
+	FindClose( find );
+#else
+	DIR* dir = opendir( dirPath );
+	if( dir == NULL ) {
+		fprintf( stderr, "Unable to open directory %s\n", dirPath );
+		++numFailed;
+		return;
+	}
+
+	struct dirent* entry;
+	while( ( entry = readdir( dir ) ) != NULL ) {
+		if( ( strcmp( entry->d_name, "." ) == 0 ) || ( strcmp( entry->d_name, ".." ) == 0 ) ) {
+			continue;
+		}
+
+		char fullPath[PATH_LENGTH];
+		snprintf( fullPath, sizeof( fullPath ), "%s/%s", dirPath, entry->d_name );
+		processPath( fullPath );
+	}
+	closedir( dir );
+#endif
+}
+
+// converts the path if it's an image, or everything under it if it's a directory
+static void processPath( const char* path )
+{
+#if defined( _WIN32 )
+	DWORD attributes = GetFileAttributesA( path );
+	bool exists = ( attributes != INVALID_FILE_ATTRIBUTES );
+	bool isDirectory = exists && ( attributes & FILE_ATTRIBUTE_DIRECTORY );
+#else
+	struct stat fileStat;
+	bool exists = ( stat( path, &fileStat ) == 0 );
+	bool isDirectory = exists && S_ISDIR( fileStat.st_mode );
+#endif
+
+	if( !exists ) {
+		fprintf( stderr, "Unable to find %s\n", path );
+		++numFailed;
+	} else if( isDirectory ) {
+		processDirectory( path );
+	} else if( endsWith( path, ".png" ) ) {
+		if( !convertImage( path ) ) {
+			++numFailed;
+		}
+	}
+}
+
+int main( int argc, char** argv )
+{
+	int argIdx = 1;
+	for( ; ( argIdx < argc ) && ( argv[argIdx][0] == '-' ); ++argIdx ) {
+		if( strcmp( "-h", argv[argIdx] ) == 0 ) {
+			fprintf( stdout, "Decodes images into texture cache files the game can load without decoding.\n" );
+			fprintf( stdout, "Each cache file is written next to its image, only images that have changed are rebuilt.\n" );
+			fprintf( stdout, "Useage: TextureCacher [-lz4] [-f] [-v] path [path ...]\n" );
+			fprintf( stdout, "  paths can be images or directories, directories are searched for .png files\n" );
+			fprintf( stdout, "  -lz4 - compress the pixels, smaller on disk but needs a copy to decompress when loaded\n" );
+			fprintf( stdout, "         use with -f to compress caches that were already built raw\n" );
+			fprintf( stdout, "  -f - rebuild all the caches, even if they're up to date\n" );
+			fprintf( stdout, "  -v - list each image as it's converted\n" );
+			return 0;
+		} else if( strcmp( "-lz4", argv[argIdx] ) == 0 ) {
+			useLZ4 = true;
+		} else if( strcmp( "-f", argv[argIdx] ) == 0 ) {
+			force = true;
+		} else if( strcmp( "-v", argv[argIdx] ) == 0 ) {
+			verbose = true;
+		} else {
+			fprintf( stderr, "Unknown option %s, use -h to get help.\n", argv[argIdx] );
+			return 1;
+		}
+	}
+
+	if( argIdx >= argc ) {
+		fprintf( stderr, "Invalid arguments, use -h to get help.\n" );
+		return 1;
+	}
+
+	for( ; argIdx < argc; ++argIdx ) {
+		processPath( argv[argIdx] );
+	}
+
+	fprintf( stdout, "Converted %i images, %i up to date, %i failed.\n", numConverted, numSkipped, numFailed );
+	if( numConverted > 0 ) {
+		fprintf( stdout, "Stored %llu bytes of pixels in %llu bytes.\n",
+			(unsigned long long)totalPixelBytes, (unsigned long long)totalStoredBytes );
+	}
+
+	return ( numFailed > 0 ) ? 1 : 0;
+}